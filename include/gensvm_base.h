@@ -52,6 +52,7 @@
  * @param gamma 	kernel parameter for RBF, poly, and sigmoid
  * @param coef 		kernel parameter for poly and sigmoid
  * @param degree 	kernel parameter for poly
+ * @param kernel 	precomputed kernel matrix for K_PRECOMPUTED
  *
  */
 struct GenData {
@@ -83,6 +84,34 @@ struct GenData {
 	///< kernel parameter for poly and sigmoid
 	double degree;
 	///< kernel parameter for poly
+	double *kernel;
+	///< precomputed kernel matrix, only used with K_PRECOMPUTED. For
+	///< training data this is the n x n kernel matrix, for test data the
+	///< n x n_train cross kernel matrix with the training data.
+	void *map;
+	///< memory mapped binary data file of which GenData::y and the
+	///< instances are part, or NULL (see gensvm_read_data_binary())
+	size_t map_size;
+	///< size of the memory mapped data file
+	long hash_bits;
+	///< number of bits of the space that the feature indices of a LibSVM
+	///< file are hashed into (0 = no hashing), see gensvm_parse_hash()
+	bool hash_signed;
+	///< whether the hashed features get a random sign
+	bool compact;
+	///< whether to build GenData::col_map from the columns that are used
+	///< in a LibSVM file, see gensvm_parse_column_map()
+	long *col_map;
+	///< sorted feature columns of the LibSVM file that are kept, column
+	///< j of the data is column col_map[j-1] of the file (NULL = no map)
+	long col_map_size;
+	///< number of elements of GenData::col_map
+	bool wrapped;
+	///< whether the instances are arrays of the caller without the column
+	///< of ones, which are not freed (see gensvm_wrap_dense())
+	bool view;
+	///< whether the instances are rows of a GenFolds, which are not freed
+	///< (see gensvm_get_fold_views())
 };
 
 /**
@@ -144,6 +173,32 @@ struct GenModel {
 	///< status of the model after training
 	long seed;
 	///< seed for the random number generator (-1 = random)
+	struct GenData *basis;
+	///< training data needed for prediction with a nonlinear kernel, see
+	///< gensvm_kernel_store_basis()
+	double *W;
+	///< collapsed coefficient matrix for prediction with a nonlinear
+	///< kernel, see gensvm_kernel_collapse()
+	double basis_tol;
+	///< tolerance in [0, 1] on the relative norm of the coefficients for
+	///< pruning the basis of a nonlinear model (0 = no pruning), see
+	///< gensvm_kernel_prune_basis()
+	void *map;
+	///< memory mapped binary model file of which GenModel::V,
+	///< GenModel::W and the basis instances are part, or NULL (see
+	///< gensvm_read_model_binary())
+	size_t map_size;
+	///< size of the memory mapped model file
+	long hash_bits;
+	///< GenData::hash_bits of the training data, such that test data is
+	///< hashed in the same way (0 = no hashing)
+	bool hash_signed;
+	///< GenData::hash_signed of the training data
+	long *col_map;
+	///< GenData::col_map of the training data, such that test data is
+	///< compacted in the same way (NULL = no map)
+	long col_map_size;
+	///< number of elements of GenModel::col_map
 };
 
 /**
@@ -181,9 +236,16 @@ struct GenModel *gensvm_init_model(void);
 void gensvm_allocate_model(struct GenModel *model);
 void gensvm_reallocate_model(struct GenModel *model, long n, long m);
 void gensvm_free_model(struct GenModel *model);
+void gensvm_unmap_model(struct GenModel *model);
 
 struct GenData *gensvm_init_data(void);
 void gensvm_free_data(struct GenData *data);
+void gensvm_unmap_data(struct GenData *data);
+struct GenData *gensvm_wrap_dense(long n, long m, double *X, long *y);
+struct GenData *gensvm_wrap_csr(long n, long m, double *values, long *ia,
+		long *ja, long *y);
+void gensvm_wrap_labels(struct GenData *data, long *y);
+void gensvm_unwrap_data(struct GenData *data);
 
 struct GenWork *gensvm_init_work(struct GenModel *model);
 void gensvm_free_work(struct GenWork *work);
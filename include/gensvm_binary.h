@@ -0,0 +1,240 @@
+/**
+ * @file gensvm_binary.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_binary.c
+ *
+ * @details
+ * Contains the header structures of the binary model and data files and the
+ * function declarations for reading and writing binary files.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_BINARY_H
+#define GENSVM_BINARY_H
+
+// includes
+#include "gensvm_io.h"
+
+/**
+ * Magic bytes at the start of a binary model file
+ */
+#define GENSVM_BINARY_MODEL_MAGIC "GENSVMBM"
+
+/**
+ * Version of the binary model file format
+ */
+#define GENSVM_BINARY_MODEL_VERSION 2
+
+/**
+ * Magic bytes at the start of a binary data file
+ */
+#define GENSVM_BINARY_DATA_MAGIC "GENSVMBD"
+
+/**
+ * Version of the binary data file format
+ */
+#define GENSVM_BINARY_DATA_VERSION 1
+
+/**
+ * Type of the values in a binary data file: 64-bit floating point
+ */
+#define GENSVM_BINARY_FLOAT64 1
+
+/**
+ * Marker to detect files written on a machine with a different byte order
+ */
+#define GENSVM_BINARY_BYTE_ORDER 0x01020304
+
+/**
+ * Alignment in bytes of the arrays in a binary file
+ */
+#define GENSVM_BINARY_ALIGN 64
+
+/**
+ * Initial value of the checksum of a binary file
+ */
+#define GENSVM_BINARY_CHECKSUM_INIT 14695981039346656037ULL
+
+// type declarations
+
+/**
+ * @brief Header of a binary model file
+ *
+ * @details
+ * The header is followed by the arrays of the model, at the given offsets
+ * from the start of the file. All offsets are multiples of
+ * GENSVM_BINARY_ALIGN, and all numbers are stored in the byte order of the
+ * machine that wrote the file. The checksum is computed with
+ * gensvm_binary_checksum() over the whole file, with the checksum field set
+ * to zero. See the @ref spec_model_file for the arrays in the file.
+ */
+struct GenModelHeader {
+	char magic[8];
+	///< GENSVM_BINARY_MODEL_MAGIC, without the terminating zero
+	uint32_t version;
+	///< version of the file format
+	uint32_t byte_order;
+	///< GENSVM_BINARY_BYTE_ORDER
+	uint64_t header_size;
+	///< size of this structure in bytes
+	uint64_t file_size;
+	///< size of the file in bytes
+	uint64_t checksum;
+	///< checksum of the file
+	int64_t n;
+	///< GenModel::n
+	int64_t m;
+	///< GenModel::m
+	int64_t K;
+	///< GenModel::K
+	int32_t kerneltype;
+	///< GenModel::kerneltype
+	int32_t weight_idx;
+	///< GenModel::weight_idx
+	double p;
+	///< GenModel::p
+	double lambda;
+	///< GenModel::lambda
+	double kappa;
+	///< GenModel::kappa
+	double epsilon;
+	///< GenModel::epsilon
+	double gamma;
+	///< GenModel::gamma
+	double coef;
+	///< GenModel::coef
+	double degree;
+	///< GenModel::degree
+	double kernel_eigen_cutoff;
+	///< GenModel::kernel_eigen_cutoff
+	int64_t basis_n;
+	///< number of basis instances (0 if the model has no basis)
+	int64_t basis_m;
+	///< number of features of the basis instances
+	int64_t basis_nnz;
+	///< number of nonzeros of a sparse basis
+	int32_t basis_format;
+	///< 0 = no instances, 1 = dense instances, 2 = sparse instances
+	int16_t hash_bits;
+	///< GenModel::hash_bits, zero in files without feature hashing
+	int16_t hash_signed;
+	///< GenModel::hash_signed
+	uint64_t data_file_offset;
+	///< offset of GenModel::data_file
+	uint64_t data_file_length;
+	///< length of GenModel::data_file, without the terminating zero
+	uint64_t V_offset;
+	///< offset of GenModel::V, (m+1) x (K-1)
+	uint64_t W_offset;
+	///< offset of GenModel::W, basis_n x (K-1)
+	uint64_t RAW_offset;
+	///< offset of the dense basis, basis_n x (basis_m+1)
+	uint64_t values_offset;
+	///< offset of the nonzero values of a sparse basis
+	uint64_t ia_offset;
+	///< offset of the row indices of a sparse basis, as int64
+	uint64_t ja_offset;
+	///< offset of the column indices of a sparse basis, as int64
+	int64_t col_map_size;
+	///< GenModel::col_map_size, zero in files without a column map
+	uint64_t col_map_offset;
+	///< offset of GenModel::col_map, as int64
+};
+
+/**
+ * @brief Header of a binary data file
+ *
+ * @details
+ * The header starts with the same fields as the GenModelHeader, and is
+ * followed by the labels and the instances at the given offsets from the
+ * start of the file, with the same alignment and checksum as in a binary
+ * model file. Dense instances are stored as GenData::RAW, including the
+ * column of ones, and sparse instances in the CSR format of GenSparse.
+ */
+struct GenDataHeader {
+	char magic[8];
+	///< GENSVM_BINARY_DATA_MAGIC, without the terminating zero
+	uint32_t version;
+	///< version of the file format
+	uint32_t byte_order;
+	///< GENSVM_BINARY_BYTE_ORDER
+	uint64_t header_size;
+	///< size of this structure in bytes
+	uint64_t file_size;
+	///< size of the file in bytes
+	uint64_t checksum;
+	///< checksum of the file
+	int64_t n;
+	///< GenData::n
+	int64_t m;
+	///< GenData::m
+	int64_t K;
+	///< GenData::K
+	int64_t nnz;
+	///< number of nonzeros of sparse instances
+	int32_t format;
+	///< 1 = dense instances, 2 = sparse instances
+	int32_t dtype;
+	///< type of the values, GENSVM_BINARY_FLOAT64
+	int32_t has_labels;
+	///< whether the file contains labels
+	int32_t reserved;
+	///< unused, zero
+	uint64_t y_offset;
+	///< offset of GenData::y, as int64
+	uint64_t RAW_offset;
+	///< offset of the dense instances, n x (m+1)
+	uint64_t values_offset;
+	///< offset of the nonzero values of sparse instances
+	uint64_t ia_offset;
+	///< offset of the row indices of sparse instances, as int64
+	uint64_t ja_offset;
+	///< offset of the column indices of sparse instances, as int64
+};
+
+// function declarations
+bool gensvm_is_binary_model(char *model_filename);
+bool gensvm_read_model_binary(struct GenModel *model, char *model_filename);
+void gensvm_write_model_binary(struct GenModel *model, char *output_filename);
+bool gensvm_check_model_header(struct GenModelHeader *header,
+		uint64_t file_size);
+bool gensvm_is_binary_data(char *data_file);
+void gensvm_read_data_binary(struct GenData *data, char *data_file);
+void gensvm_write_data_binary(struct GenData *data, char *output_filename);
+bool gensvm_check_data_header(struct GenDataHeader *header,
+		uint64_t file_size);
+uint64_t gensvm_binary_checksum(uint64_t hash, const void *buffer,
+		uint64_t size);
+uint64_t gensvm_binary_align(uint64_t offset);
+FILE *gensvm_binary_open_temp(char *filename, char **temp_filename);
+void gensvm_binary_close_temp(FILE *fid, char *temp_filename,
+		char *filename, bool written);
+bool gensvm_binary_has_magic(char *filename, const char *magic);
+bool gensvm_binary_map(char *filename, char **map, uint64_t *size);
+bool gensvm_binary_verify(char *map, uint64_t size, uint64_t checksum_offset);
+uint64_t gensvm_binary_offsets(uint64_t header_size, uint64_t *sizes,
+		long n_arrays, uint64_t *offsets);
+bool gensvm_binary_write_arrays(FILE *fid, uint64_t *hash,
+		uint64_t header_size, const void **arrays, uint64_t *sizes,
+		long n_arrays, uint64_t file_size);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file gensvm_codegen.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_codegen.c
+ *
+ * @details
+ * Contains the function declarations for writing a trained model as a
+ * standalone C source file.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_CODEGEN_H
+#define GENSVM_CODEGEN_H
+
+// includes
+#include "gensvm_base.h"
+
+/**
+ * Maximum number of elements of V for which the simplex space vector of a
+ * linear model is computed with unrolled code instead of loops.
+ */
+#ifndef GENSVM_CODEGEN_UNROLL_MAX
+  #define GENSVM_CODEGEN_UNROLL_MAX 1024
+#endif
+
+// function declarations
+void gensvm_write_model_source(struct GenModel *model, char *output_filename,
+		char *name);
+void gensvm_write_source(FILE *fid, struct GenModel *model, char *name);
+void gensvm_write_source_matrix(FILE *fid, char *name, char *suffix,
+		double *A, long rows, long cols);
+void gensvm_write_source_linear(FILE *fid, struct GenModel *model,
+		char *name);
+void gensvm_write_source_kernel(FILE *fid, struct GenModel *model,
+		char *name);
+void gensvm_write_source_column(FILE *fid, struct GenModel *model,
+		char *name);
+bool gensvm_is_identifier(char *name);
+
+#endif
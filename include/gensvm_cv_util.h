@@ -33,6 +33,35 @@
 
 #include "gensvm_base.h"
 
+/**
+ * @brief The instances of a dataset grouped by cross validation fold
+ *
+ * @details
+ * The augmented rows of the dataset are stored once grouped by fold, in the
+ * order of GenFolds::rows, followed by the rows of all folds but the last
+ * a second time. Both the test set and the training set of every fold are
+ * therefore a contiguous range of rows, of which gensvm_get_fold_views()
+ * makes train and test datasets without copying the instances. This needs
+ * about twice the memory of the dataset, regardless of the number of folds.
+ */
+struct GenFolds {
+	long folds;
+	///< number of folds
+	long n;
+	///< number of instances
+	long m;
+	///< number of features
+	long *start;
+	///< index in GenFolds::rows of the first instance of each fold, of
+	///< length folds+1 with start[folds] = n
+	long *rows;
+	///< indices of the instances in the full dataset, grouped by fold
+	double *RAW;
+	///< augmented rows of the instances if the data is dense
+	struct GenSparse *spZ;
+	///< augmented rows of the instances if the data is sparse
+};
+
 void gensvm_make_cv_split(long N, long folds, long *cv_idx);
 void gensvm_get_tt_split(struct GenData *full_data, struct GenData *train_data,
 		struct GenData *test_data, long *cv_idx, long fold_idx);
@@ -42,5 +71,20 @@ void gensvm_get_tt_split_dense(struct GenData *full_data,
 void gensvm_get_tt_split_sparse(struct GenData *full_data,
 		struct GenData *train_data, struct GenData *test_data,
 		long *cv_idx, long fold_idx);
+void gensvm_get_tt_split_kernel(struct GenData *full_data,
+		struct GenData *train_data, struct GenData *test_data,
+		long *cv_idx, long fold_idx);
+
+struct GenFolds *gensvm_init_folds(struct GenData *full_data, long *cv_idx,
+		long folds);
+void gensvm_free_folds(struct GenFolds *cv);
+void gensvm_get_fold_views(struct GenData *full_data, struct GenFolds *cv,
+		long fold_idx, struct GenData *train_data,
+		struct GenData *test_data);
+void gensvm_get_fold_view(struct GenData *full_data, struct GenFolds *cv,
+		long pos, long n, struct GenData *view);
+void gensvm_get_fold_kernel(struct GenData *full_data, struct GenFolds *cv,
+		long fold_idx, struct GenData *train_data,
+		struct GenData *test_data);
 
 #endif
@@ -42,10 +42,12 @@
 #include <cblas.h>
 #include <ctype.h>
 #include <errno.h>
+#include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,8 +71,19 @@ typedef enum {
 	K_POLY=1, 	/**< Polynomial kernel */
 	K_RBF=2, 	/**< RBF kernel */
 	K_SIGMOID=3,  	/**< Sigmoid kernel */
+	K_PRECOMPUTED=4,/**< Precomputed kernel matrix */
 } KernelType;
 
+/**
+ * @brief format of the predictions written to file
+ */
+typedef enum {
+	P_DATA=0, 	/**< Instances with the predicted label */
+	P_LABELS=1, 	/**< Predicted labels, one per line */
+	P_SCORES=2, 	/**< Predicted labels followed by the class scores */
+	P_BINARY=3 	/**< Predicted labels as an array of int32 */
+} PredictionFormat;
+
 // ########################### Global constants ########################### //
 
 /**
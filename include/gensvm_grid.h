@@ -62,6 +62,8 @@
  * @param *degrees 		array of degree values
  * @param *train_data_file 	filename of train data file
  * @param *test_data_file 	filename of test data file
+ * @param *train_kernel_file 	filename of precomputed train kernel file
+ * @param *test_kernel_file 	filename of precomputed test kernel file
  *
  */
 struct GenGrid {
@@ -112,6 +114,10 @@ struct GenGrid {
 	///< filename of train data file
 	char *test_data_file;
 	///< filename of test data file
+	char *train_kernel_file;
+	///< filename of precomputed train kernel file
+	char *test_kernel_file;
+	///< filename of precomputed test kernel file
 };
 
 // function declarations
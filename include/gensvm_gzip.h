@@ -0,0 +1,153 @@
+/**
+ * @file gensvm_gzip.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_gzip.c
+ *
+ * @details
+ * Contains the structures for a gzip compressed data file that is
+ * decompressed in blocks, and the function declarations for reading
+ * compressed data files.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_GZIP_H
+#define GENSVM_GZIP_H
+
+// includes
+#include <zlib.h>
+
+#include "gensvm_io.h"
+
+/**
+ * Size in bytes of the buffer for the compressed data
+ */
+#define GENSVM_GZIP_INPUT_SIZE (1 << 18)
+
+/**
+ * Number of decompressed blocks that may wait to be parsed before the
+ * thread that decompresses parses a block itself
+ */
+#define GENSVM_GZIP_MAX_QUEUED 4
+
+/**
+ * Time in nanoseconds that a thread waits for the next block
+ */
+#define GENSVM_GZIP_WAIT 50000
+
+// type declarations
+
+/**
+ * @brief A decompressed block of a gzip compressed data file
+ *
+ * @details
+ * A block holds complete lines of the data file, of about
+ * GENSVM_PARSE_CHUNK_SIZE bytes. The decompressed data is freed once the
+ * block is parsed, only the results of the parser remain.
+ */
+struct GenGzipBlock {
+	char *data;
+	///< decompressed lines, NULL after the block is parsed
+	size_t size;
+	///< number of bytes in GenGzipBlock::data
+	size_t skip;
+	///< number of bytes at the start of the data that are not parsed
+	struct GenParseChunk chunk;
+	///< the rows of the block, set when the block is taken
+	struct GenSparse *fragment;
+	///< CSR fragment of the rows of the block
+	long *y;
+	///< labels of the rows of the block of a LibSVM file
+	long n_labels;
+	///< number of rows with a label in the block of a LibSVM file
+	long min_index;
+	///< smallest feature index in the block of a LibSVM file
+	long max_index;
+	///< largest feature index in the block of a LibSVM file
+	struct GenGzipBlock *next;
+	///< the next block of the file
+};
+
+/**
+ * @brief A gzip compressed data file that is decompressed in blocks
+ *
+ * @details
+ * One thread decompresses the file with gensvm_gzip_read_block(), while
+ * the other threads take the blocks with gensvm_gzip_take() and parse them,
+ * so that the decompression and the parsing overlap. The blocks are kept in
+ * a list in the order of the file. The list is only changed in the
+ * critical section gensvm_gzip.
+ */
+struct GenGzipStream {
+	FILE *fid;
+	///< the compressed file
+	char *filename;
+	///< filename of the compressed file
+	z_stream zs;
+	///< state of zlib
+	unsigned char *input;
+	///< buffer for the compressed data
+	bool in_member;
+	///< whether a gzip member is partially decompressed
+	bool end_of_input;
+	///< whether the whole file is decompressed
+	char *carry;
+	///< start of a line that didn't fit in the last block
+	size_t carry_size;
+	///< number of bytes in GenGzipStream::carry
+	struct GenGzipBlock *first;
+	///< first block of the file
+	struct GenGzipBlock *last;
+	///< last decompressed block
+	struct GenGzipBlock *next;
+	///< next block to be parsed, or NULL if there is none yet
+	long n_blocks;
+	///< number of decompressed blocks
+	long n_taken;
+	///< number of blocks that are taken
+	long n_rows;
+	///< number of rows in the blocks that are taken
+	bool done;
+	///< whether all blocks are decompressed
+};
+
+// function declarations
+bool gensvm_is_gzip_data(char *data_file);
+void gensvm_read_data_gzip(struct GenData *dataset, char *data_file);
+void gensvm_read_data_libsvm_gzip(struct GenData *data, char *data_file);
+void gensvm_gzip_parse_dense(struct GenGzipBlock *block, long n, long m,
+		bool has_labels, long *y);
+void gensvm_gzip_parse_libsvm(struct GenGzipBlock *block);
+
+struct GenGzipStream *gensvm_gzip_open(char *filename);
+void gensvm_gzip_close(struct GenGzipStream *stream);
+bool gensvm_gzip_read_block(struct GenGzipStream *stream, long min_lines);
+long gensvm_gzip_getline(struct GenGzipStream *stream, char **line,
+		size_t *line_size);
+size_t gensvm_gzip_inflate(struct GenGzipStream *stream, char *buffer,
+		size_t size);
+struct GenGzipBlock *gensvm_gzip_take(struct GenGzipStream *stream,
+		bool wait);
+long gensvm_gzip_queued(struct GenGzipStream *stream);
+void gensvm_gzip_finish(struct GenGzipStream *stream);
+struct GenParseChunk *gensvm_gzip_chunks(struct GenGzipStream *stream);
+
+#endif
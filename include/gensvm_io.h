@@ -32,18 +32,115 @@
 
 // includes
 #include "gensvm_base.h"
+#include "gensvm_kernel.h"
+#include "gensvm_parse.h"
 #include "gensvm_print.h"
+#include "gensvm_simplex.h"
 #include "gensvm_strutil.h"
+#include "gensvm_writer.h"
+
+// type declarations
+
+/**
+ * @brief A data file that is read in chunks
+ *
+ * @details
+ * This structure holds the state of a data file that is read with 
+ * gensvm_read_data_chunk(), so that datasets that don't fit in memory can be 
+ * processed.
+ *
+ * @param fid 		the open file
+ * @param libsvm 	whether the file is in LibSVM format
+ * @param n 		number of instances in the file
+ * @param m 		number of features
+ * @param n_read 	number of instances read so far
+ * @param has_labels 	whether the instances have labels
+ * @param line 		buffer for a line of the file
+ * @param line_size 	allocated size of the line buffer
+ * @param nnz_size 	allocated number of nonzero elements of a sparse
+ * 			chunk
+ */
+struct GenDataReader {
+	FILE *fid;
+	///< the open data file
+	bool libsvm;
+	///< whether the file is in LibSVM format
+	long n;
+	///< number of instances in the file
+	long m;
+	///< number of features
+	long n_read;
+	///< number of instances read so far
+	bool has_labels;
+	///< whether the instances have labels
+	char *line;
+	///< buffer for a line of the file
+	size_t line_size;
+	///< allocated size of the line buffer
+	long nnz_size;
+	///< allocated number of nonzero elements of a sparse chunk
+	struct GenData *data;
+	///< the data of a binary data file, or NULL
+	struct GenNpyFile *npy;
+	///< the mapped arrays of a NumPy data file, or NULL
+	struct GenGzipStream *gzip;
+	///< the stream of a gzip compressed data file, or NULL
+	long hash_bits;
+	///< number of bits of the hashed feature space of a LibSVM file
+	///< (0 = no hashing)
+	bool hash_signed;
+	///< whether the hashed features get a random sign
+	long *hash_marker;
+	///< work space for gensvm_parse_hash_row(), or NULL
+	long *col_map;
+	///< column map of GenDataReader::m columns of a LibSVM file, or NULL
+};
 
 // function declarations
 void gensvm_read_data(struct GenData *dataset, char *data_file);
 void gensvm_read_data_libsvm(struct GenData *dataset, char *data_file);
+void gensvm_read_data_libsvm_stitch(struct GenData *data,
+		struct GenSparse **fragments, struct GenParseChunk *chunks,
+		long n_chunks, long n_labels, long min_index, long max_index,
+		long nnz);
+struct GenDataReader *gensvm_open_data_reader(char *data_file,
+		bool libsvm_format, long m, long hash_bits, bool hash_signed,
+		long *col_map);
+long gensvm_read_data_chunk(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n);
+void gensvm_read_data_chunk_dense(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n);
+void gensvm_read_data_chunk_dense_gzip(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n);
+void gensvm_read_data_chunk_libsvm(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n);
+void gensvm_read_data_chunk_binary(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n);
+void gensvm_read_data_chunk_npy(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n);
+long gensvm_read_data_line(struct GenDataReader *reader);
+void gensvm_close_data_reader(struct GenDataReader *reader);
+void gensvm_read_kernel(struct GenData *dataset, char *kernel_file,
+		long n_cols);
 
 void gensvm_read_model(struct GenModel *model, char *model_filename);
+bool gensvm_try_read_model(struct GenModel *model, char *model_filename);
+bool gensvm_read_model_text(FILE *fid, struct GenModel *model,
+		char *model_filename);
+bool gensvm_read_model_basis(FILE *fid, struct GenModel *model,
+		char *model_filename, long size);
 void gensvm_write_model(struct GenModel *model, char *output_filename);
+void gensvm_write_model_basis(FILE *fid, struct GenModel *model);
 
 void gensvm_write_predictions(struct GenData *data, long *predy,
 		char *output_filename);
+void gensvm_write_predictions_rows(FILE *fid, struct GenData *data,
+		long *predy);
+void gensvm_write_predictions_header(struct GenWriter *writer, long n,
+		long m, PredictionFormat format);
+void gensvm_write_predictions_chunk(struct GenWriter *writer,
+		struct GenData *data, long *predy, double *scores, long K,
+		PredictionFormat format);
 void gensvm_time_string(char *buffer);
 
 #endif
@@ -41,16 +41,47 @@ void gensvm_kernel_copy_kernelparam_to_data(struct GenModel *model,
 void gensvm_kernel_preprocess(struct GenModel *model, struct GenData *data);
 void gensvm_kernel_postprocess(struct GenModel *model,
 	       	struct GenData *traindata, struct GenData *testdata);
+void gensvm_kernel_store_basis(struct GenModel *model, struct GenData *data);
+void gensvm_kernel_collapse(struct GenModel *model, struct GenData *data);
+void gensvm_kernel_prune_basis(struct GenModel *model, struct GenData *data);
+struct GenData *gensvm_kernel_select_basis(struct GenData *basis, long *idx,
+		long n_idx);
+void gensvm_kernel_calculate_ZV(struct GenModel *model,
+		struct GenData *testdata, double *ZV);
+void gensvm_kernel_calculate_ZV_block(struct GenModel *model,
+		struct GenData *testdata, long start, long rows, double *K2,
+		double *ZV);
 void gensvm_kernel_compute(struct GenModel *model, struct GenData *data,
 		double *K);
+void gensvm_kernel_compute_packed(struct GenModel *model,
+		struct GenData *data, double *K);
+void gensvm_kernel_compute_packed_sparse(struct GenModel *model,
+		struct GenData *data, double *K);
+void gensvm_kernel_sparse_norms(struct GenSparse *A, double *norms);
+double gensvm_kernel_sparse_gather(double *w, struct GenSparse *A, long i);
+double gensvm_kernel_dot_inner(struct GenModel *model, double dot,
+		double norm1, double norm2);
+void gensvm_kernel_check_precomputed(struct GenData *data);
+double gensvm_kernel_dot(struct GenModel *model, double *x1, double *x2,
+		long n);
 long gensvm_kernel_eigendecomp(double *K, long n, double cutoff, 
 		double **P_ret, double **Sigma_ret);
+long gensvm_kernel_eigendecomp_packed(double *K, long n, double cutoff,
+		double **P_ret, double **Sigma_ret);
 double *gensvm_kernel_cross(struct GenModel *model, struct GenData *data_train,
 		struct GenData *data_test);
+void gensvm_kernel_cross_block(struct GenModel *model,
+		struct GenData *data_train, struct GenData *data_test,
+		long start, long rows, double *K2);
+void gensvm_kernel_cross_block_sparse(struct GenModel *model,
+		struct GenData *data_train, struct GenData *data_test,
+		long start, long rows, double *K2);
 void gensvm_kernel_trainfactor(struct GenData *data, double *P, double *Sigma,
 		long r);
 void gensvm_kernel_testfactor(struct GenData *testdata,
 	       	struct GenData *traindata, double *K2);
+void gensvm_kernel_testfactor_block(struct GenData *testdata,
+		struct GenData *traindata, double *K2, long start, long rows);
 double gensvm_kernel_dot_rbf(double *x1, double *x2, long n, double gamma);
 double gensvm_kernel_dot_poly(double *x1, double *x2, long n, double gamma, 
 		double coef, double degree);
@@ -60,5 +91,18 @@ int dsyevx(char JOBZ, char RANGE, char UPLO, int N, double *A, int LDA,
 	       	double VL, double VU, int IL, int IU, double ABSTOL,
 		int *M, double *W, double *Z, int LDZ, double *WORK, int LWORK,
 		int *IWORK, int *IFAIL);
+int dsptrd(char UPLO, int N, double *AP, double *D, double *E, double *TAU);
+int dsterf(int N, double *D, double *E);
+int dstebz(char RANGE, char ORDER, int N, double VL, double VU, int IL,
+		int IU, double ABSTOL, double *D, double *E, int *M,
+		int *NSPLIT, double *W, int *IBLOCK, int *ISPLIT,
+		double *WORK, int *IWORK);
+int dstein(int N, double *D, double *E, int M, double *W, int *IBLOCK,
+		int *ISPLIT, double *Z, int LDZ, double *WORK, int *IWORK,
+		int *IFAIL);
+int dopmtr(char SIDE, char UPLO, char TRANS, int M, int N, double *AP,
+		double *TAU, double *C, int LDC, double *WORK);
+int dgelss(int M, int N, int NRHS, double *A, int LDA, double *B, int LDB,
+		double *S, double RCOND, int *RANK, double *WORK, int LWORK);
 double dlamch(char CMACH);
 #endif
@@ -0,0 +1,137 @@
+/**
+ * @file gensvm_npy.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_npy.c
+ *
+ * @details
+ * Contains the structure for an array in a NumPy .npy file and the function
+ * declarations for reading data from .npy and .npz files.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_NPY_H
+#define GENSVM_NPY_H
+
+// includes
+#include "gensvm_base.h"
+#include "gensvm_print.h"
+#include "gensvm_sparse.h"
+
+/**
+ * Magic bytes at the start of a .npy file
+ */
+#define GENSVM_NPY_MAGIC "\x93NUMPY"
+
+/**
+ * Magic bytes at the start of a .npz file, which is a zip archive
+ */
+#define GENSVM_NPZ_MAGIC "PK\x03\x04"
+
+// type declarations
+
+/**
+ * @brief An array in a memory mapped .npy file
+ *
+ * @details
+ * The array is described by the header of the .npy file, see
+ * gensvm_npy_parse(). Only numeric arrays with at most two dimensions and
+ * the byte order of this machine are supported.
+ */
+struct GenNpyArray {
+	const char *data;
+	///< start of the elements in the mapped file
+	char kind;
+	///< 'f' for floating point, 'i' for signed and 'u' for unsigned
+	///< integers
+	int itemsize;
+	///< size of an element in bytes
+	bool fortran_order;
+	///< whether a two dimensional array is stored column by column
+	int ndim;
+	///< number of dimensions
+	long shape[2];
+	///< size of the dimensions, 1 for missing dimensions
+	long size;
+	///< number of elements
+};
+
+/**
+ * @brief A memory mapped .npy or .npz data file
+ *
+ * @details
+ * The arrays of the file are found and checked by gensvm_npy_open(), and
+ * are read in place with gensvm_npy_get().
+ */
+struct GenNpyFile {
+	char *map;
+	///< the mapped file, or NULL if it is owned by a GenData
+	size_t size;
+	///< size of the mapped file in bytes
+	long n;
+	///< number of instances
+	long m;
+	///< number of features
+	bool sparse;
+	///< whether the instances are a CSR matrix instead of the array X
+	struct GenNpyArray X;
+	///< n x m array of dense instances
+	struct GenNpyArray values;
+	///< nonzero values of the CSR matrix
+	struct GenNpyArray indices;
+	///< 0-based column indices of the CSR matrix
+	struct GenNpyArray indptr;
+	///< start of every row of the CSR matrix in the values
+	bool has_labels;
+	///< whether the file has the labels y
+	struct GenNpyArray y;
+	///< the labels
+};
+
+// function declarations
+bool gensvm_is_npy_data(char *data_file);
+void gensvm_read_data_npy(struct GenData *data, char *data_file);
+struct GenNpyFile *gensvm_npy_open(char *data_file);
+void gensvm_npy_close(struct GenNpyFile *file);
+void gensvm_npy_check_dense(struct GenNpyFile *file, char *data_file);
+void gensvm_npy_check_csr(struct GenNpyFile *file, struct GenNpyArray *shape,
+		char *data_file);
+void gensvm_read_data_npy_dense(struct GenData *data, struct GenNpyArray *X);
+void gensvm_read_data_npy_csr(struct GenData *data, struct GenNpyFile *file);
+long *gensvm_read_data_npy_labels(struct GenNpyArray *y, long n);
+
+bool gensvm_npy_parse(const char *buffer, size_t size,
+		struct GenNpyArray *array);
+bool gensvm_npy_parse_descr(const char *descr, long length,
+		struct GenNpyArray *array);
+bool gensvm_npy_parse_shape(const char *str, const char *end,
+		struct GenNpyArray *array);
+const char *gensvm_npy_find_key(const char *header, const char *end,
+		const char *key);
+bool gensvm_npz_find(const char *map, size_t size, const char *name,
+		const char **member, size_t *member_size);
+const char *gensvm_npz_central_directory(const char *map, size_t size,
+		long *n_entries);
+double gensvm_npy_get(struct GenNpyArray *array, long i);
+long gensvm_npy_get_long(struct GenNpyArray *array, long i);
+uint64_t gensvm_npz_read(const char *buffer, int n_bytes);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file gensvm_parse.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_parse.c
+ *
+ * @details
+ * Contains the structure for a part of a data file that is parsed by a
+ * single thread, and the function declarations for parsing memory-mapped
+ * data files.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_PARSE_H
+#define GENSVM_PARSE_H
+
+// includes
+#include "gensvm_print.h"
+#include "gensvm_sparse.h"
+
+/**
+ * Approximate size in bytes of the part of a data file that is parsed by a
+ * single thread
+ */
+#define GENSVM_PARSE_CHUNK_SIZE (1 << 20)
+
+/**
+ * Maximum length of a number that is parsed with strtod()
+ */
+#define GENSVM_PARSE_MAX_TOKEN 512
+
+/**
+ * Maximum number of bits of the space that feature indices are hashed into
+ */
+#define GENSVM_PARSE_MAX_HASH_BITS 30
+
+// type declarations
+
+/**
+ * @brief A part of a data file that is parsed by a single thread
+ *
+ * @details
+ * A data file is split in chunks at line boundaries with
+ * gensvm_parse_chunks(). The rows of a chunk are the lines that are not
+ * blank, and the index of the first row of every chunk is known before the
+ * chunks are parsed, so that all chunks can be parsed in parallel.
+ */
+struct GenParseChunk {
+	const char *start;
+	///< start of the chunk
+	const char *end;
+	///< end of the chunk, the start of the next chunk
+	long row_start;
+	///< index of the first row of the chunk in the file
+	long n_rows;
+	///< number of rows in the chunk
+	long nnz;
+	///< number of nonzero values in the chunk, see gensvm_parse_chunks_nnz()
+	long error_row;
+	///< index of the first row with an error, -1 if there is none
+};
+
+// function declarations
+char *gensvm_map_file(char *filename, size_t *size);
+void gensvm_unmap_file(char *map, size_t size);
+
+long gensvm_parse_n_chunks(size_t size);
+struct GenParseChunk *gensvm_parse_chunks(const char *begin, const char *end,
+		long n_chunks);
+long gensvm_parse_count_rows(const char *start, const char *end);
+long gensvm_parse_chunks_nnz(struct GenParseChunk *chunks, long n_chunks,
+		long m, long max_nnz);
+long gensvm_parse_count_nnz(const char *start, const char *end,
+		long max_values);
+int gensvm_parse_dense_row(const char **str, const char *end,
+		double *values, long m, bool has_labels, long *label);
+long gensvm_parse_dense(struct GenParseChunk *chunks, long n_chunks,
+		const char *end, long n, long m, bool has_labels, double *RAW,
+		long *y);
+struct GenSparse *gensvm_parse_sparse(struct GenParseChunk *chunks,
+		long n_chunks, const char *end, long n, long m,
+		bool has_labels, long *y, long *n_read);
+struct GenSparse *gensvm_parse_dense_chunk(struct GenParseChunk *chunk,
+		const char *end, long n, long m, bool has_labels, long *y);
+long gensvm_parse_check_rows(struct GenParseChunk *chunks, long n_chunks,
+		long n);
+struct GenSparse **gensvm_parse_libsvm(struct GenParseChunk *chunks,
+		long n_chunks, const char *end, long *y, long *n_labels,
+		long *min_index, long *max_index, long *nnz);
+struct GenSparse *gensvm_parse_libsvm_chunk(struct GenParseChunk *chunk,
+		const char *end, long *y, long *n_labels, long *min_index,
+		long *max_index);
+struct GenSparse *gensvm_parse_stitch_sparse(struct GenSparse **fragments,
+		struct GenParseChunk *chunks, long n_chunks, long n, long m,
+		long shift);
+void gensvm_parse_stitch_dense(struct GenSparse **fragments,
+		struct GenParseChunk *chunks, long n_chunks, long m,
+		long shift, double *RAW);
+long gensvm_parse_hash(long index, long hash_bits, bool hash_signed,
+		double *sign);
+long gensvm_parse_hash_row(long *ja, double *values, long nnz,
+		long hash_bits, bool hash_signed, long *marker);
+void gensvm_parse_sort_row(long *ja, double *values, long nnz);
+void gensvm_parse_hash_fragments(struct GenSparse **fragments,
+		long n_chunks, long hash_bits, bool hash_signed);
+long gensvm_parse_unique(long *ja, long nnz);
+long *gensvm_parse_column_map(struct GenSparse **fragments, long n_chunks,
+		long shift, long *n_columns);
+long gensvm_parse_map_column(long col, long *col_map, long n_columns);
+long gensvm_parse_map_row(long *ja, double *values, long nnz, long shift,
+		long *col_map, long n_columns);
+void gensvm_parse_map_fragments(struct GenSparse **fragments, long n_chunks,
+		long shift, long *col_map, long n_columns);
+
+bool gensvm_parse_double(const char **str, const char *end, double *value);
+bool gensvm_parse_long(const char **str, const char *end, long *value);
+long gensvm_parse_values(const char **str, const char *end, double *values,
+		long max_values);
+bool gensvm_parse_line_end(const char *str, const char *end);
+const char *gensvm_parse_next_line(const char *str, const char *end);
+
+#endif
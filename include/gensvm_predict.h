@@ -38,6 +38,9 @@
 // function declarations
 void gensvm_predict_labels(struct GenData *testdata,
 	       	struct GenModel *model, long *predy);
+void gensvm_predict_scores(struct GenData *testdata, struct GenModel *model,
+		long *predy, double *scores);
+long gensvm_predict_argmax(double *x, long n);
 double gensvm_prediction_perf(struct GenData *data, long *perdy);
 
 #endif
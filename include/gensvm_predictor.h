@@ -0,0 +1,99 @@
+/**
+ * @file gensvm_predictor.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_predictor.c
+ *
+ * @details
+ * Contains the declaration of the GenPredictor structure and the functions 
+ * for predicting the class label of a single instance.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_PREDICTOR_H
+#define GENSVM_PREDICTOR_H
+
+// includes
+#include "gensvm_parse.h"
+#include "gensvm_predict.h"
+
+// type declarations
+
+/**
+ * @brief A structure for predicting the labels of single instances
+ *
+ * @details
+ * This structure holds everything that is needed to predict the class label 
+ * of a single instance with a trained GenModel, including the work space.  
+ * After initialization with gensvm_predictor_init(), prediction with 
+ * gensvm_predictor_predict_one() or gensvm_predictor_predict_one_sparse() 
+ * does not allocate any memory. Since the work space is shared between 
+ * calls, a GenPredictor should only be used by one thread at a time.
+ *
+ * @param model 	the GenModel used for prediction
+ * @param K 		number of classes
+ * @param m 		number of features of an instance
+ * @param n_basis 	number of instances in the basis of a kernel model
+ * @param norms 	squared norms of the basis instances
+ * @param w 		work vector for scattering an instance
+ * @param k 		work vector for a row of the cross kernel
+ * @param zv 		work vector for the simplex space vector
+ * @param scores 	scores of the classes of the last prediction
+ */
+struct GenPredictor {
+	struct GenModel *model;
+	///< the model used for prediction, which is not owned by the
+	///< predictor and should outlive it
+	long K;
+	///< number of classes
+	long m;
+	///< number of features of an instance (the number of basis
+	///< instances for a precomputed kernel)
+	long n_basis;
+	///< number of instances in GenModel::basis (0 for linear models)
+
+	double *norms;
+	///< squared norms of the basis instances, of length n_basis
+	double *w;
+	///< work vector of length m+1 for scattering an instance when the
+	///< basis is sparse, which is zero between predictions
+	double *k;
+	///< work vector of length n_basis for a row of the cross kernel
+	double *zv;
+	///< work vector of length K-1 for the simplex space vector
+	double *scores;
+	///< scores of the K classes of the last prediction
+};
+
+// function declarations
+struct GenPredictor *gensvm_predictor_init(struct GenModel *model);
+void gensvm_predictor_free(struct GenPredictor *pred);
+long gensvm_predictor_predict_one(struct GenPredictor *pred, const double *x,
+		long m);
+long gensvm_predictor_column(struct GenPredictor *pred, long index,
+		double *sign);
+long gensvm_predictor_predict_one_sparse(struct GenPredictor *pred,
+		const long *idx, const double *val, long nnz);
+double *gensvm_predictor_scores(struct GenPredictor *pred);
+long gensvm_predictor_kernel_label(struct GenPredictor *pred);
+long gensvm_predictor_label(struct GenPredictor *pred);
+
+#endif
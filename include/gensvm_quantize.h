@@ -0,0 +1,100 @@
+/**
+ * @file gensvm_quantize.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_quantize.c
+ *
+ * @details
+ * Contains the GenQuantModel structure and the function declarations for 
+ * quantized prediction with linear models.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_QUANTIZE_H
+#define GENSVM_QUANTIZE_H
+
+// includes
+#include "gensvm_predict.h"
+
+/**
+ * Number of features for which the integer inner product is accumulated in 
+ * 32 bits before it is added to a 64 bit total. With values in [-127, 127] 
+ * this can't overflow.
+ */
+#define GENSVM_QUANT_BLOCK_SIZE 65536
+
+// type declarations
+
+/**
+ * @brief A linear GenModel with quantized weights
+ *
+ * @details
+ * For a linear model the scores of the classes are 
+ * @f$\textbf{z}'\textbf{V}\textbf{U}'@f$ (see gensvm_predict_scores()). 
+ * The product @f$\textbf{W} = \textbf{V}\textbf{U}'@f$ is computed once, 
+ * and the rows of W for the features are quantized to int8 with a scale for 
+ * each class. The first row of W is the bias, which is kept in double 
+ * precision. The constants needed to bound the error of the quantized scores 
+ * are stored as well.
+ *
+ * @param model 	the GenModel that is quantized
+ * @param m 		number of features
+ * @param K 		number of classes
+ * @param Q 		quantized weights, K x m with the weights of a class
+ * 			contiguous
+ * @param scale 	scale of the quantized weights of each class
+ * @param bias 		bias of each class
+ * @param qnorm 	L1 norm of the dequantized weights of each class
+ * @param absbias 	bound of the bias of each class for the rounding error
+ * @param absmax 	bound of the weights of each class for the rounding
+ * 			error
+ */
+struct GenQuantModel {
+	struct GenModel *model;
+	///< the GenModel that is quantized, which should outlive it
+	long m;
+	///< number of features
+	long K;
+	///< number of classes
+	int8_t *Q;
+	///< quantized weights, K x m
+	double *scale;
+	///< scale of the quantized weights of each class
+	double *bias;
+	///< bias of each class
+	double *qnorm;
+	///< L1 norm of the dequantized weights of each class
+	double *absbias;
+	///< sum of |V_0l U_kl| over l for each class
+	double *absmax;
+	///< maximum over the features j of the sum of |V_jl U_kl| over l
+};
+
+// function declarations
+struct GenQuantModel *gensvm_quantize_model(struct GenModel *model);
+void gensvm_free_quant_model(struct GenQuantModel *qmodel);
+long gensvm_quant_predict_labels(struct GenData *data,
+		struct GenQuantModel *qmodel, long *predy);
+bool gensvm_quant_predict_row(struct GenQuantModel *qmodel, double *x,
+		int8_t *p, double *a, long *label);
+int64_t gensvm_quant_dot(const int8_t *a, const int8_t *b, long n);
+
+#endif
@@ -35,5 +35,6 @@
 
 // function declarations
 long gensvm_num_sv(struct GenModel *model);
+bool gensvm_is_sv(struct GenModel *model, long i);
 
 #endif
@@ -0,0 +1,85 @@
+/**
+ * @file gensvm_writer.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Header file for gensvm_writer.c
+ *
+ * @details
+ * Contains the GenWriter structure and the function declarations for 
+ * buffered output.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef GENSVM_WRITER_H
+#define GENSVM_WRITER_H
+
+// includes
+#include "gensvm_print.h"
+
+/**
+ * Size of the buffer of a GenWriter in bytes
+ */
+#ifndef GENSVM_WRITER_BUFFER_SIZE
+  #define GENSVM_WRITER_BUFFER_SIZE 1048576
+#endif
+
+/**
+ * Number of decimals written by gensvm_writer_double()
+ */
+#define GENSVM_WRITER_DECIMALS 8
+
+// type declarations
+
+/**
+ * @brief A buffered writer
+ *
+ * @details
+ * Output is collected in a large buffer which is written to the file when it 
+ * is full, so that many small writes result in few calls to fwrite().
+ *
+ * @param fid 		the output file
+ * @param buffer 	the buffer
+ * @param len 		number of bytes in the buffer
+ * @param close_file 	whether the file is closed by gensvm_writer_close()
+ */
+struct GenWriter {
+	FILE *fid;
+	///< the output file
+	char *buffer;
+	///< buffer of size GENSVM_WRITER_BUFFER_SIZE
+	long len;
+	///< number of bytes in the buffer
+	bool close_file;
+	///< whether the file is closed by gensvm_writer_close()
+};
+
+// function declarations
+struct GenWriter *gensvm_writer_open(char *filename);
+struct GenWriter *gensvm_writer_init(FILE *fid);
+void gensvm_writer_close(struct GenWriter *writer);
+void gensvm_writer_flush(struct GenWriter *writer);
+void gensvm_writer_write(struct GenWriter *writer, const void *data,
+		long len);
+void gensvm_writer_char(struct GenWriter *writer, char c);
+void gensvm_writer_long(struct GenWriter *writer, long value);
+void gensvm_writer_double(struct GenWriter *writer, double value);
+
+#endif
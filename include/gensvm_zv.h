@@ -32,3 +32,7 @@ void gensvm_calculate_ZV_sparse(struct GenModel *model,
 		struct GenData *data, double *ZV);
 void gensvm_calculate_ZV_dense(struct GenModel *model,
 		struct GenData *data, double *ZV);
+void gensvm_calculate_ZV_rows(struct GenModel *model, double *Z, long rows,
+		bool wrapped, double *ZV);
+void gensvm_calculate_ZV_block(struct GenModel *model, struct GenData *data,
+		long start, long rows, double *ZV);
@@ -0,0 +1,186 @@
+/**
+ * @file GenSVMcodegen.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Command line interface for writing a model as C source code
+ *
+ * @details
+ * This is a command line program that reads a model file and writes a
+ * standalone C source file that predicts class labels with the model, see
+ * gensvm_write_source(). The generated file only needs the C math library,
+ * so it can be compiled into applications that don't link libgensvm, BLAS
+ * or LAPACK.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_cmdarg.h"
+#include "gensvm_codegen.h"
+#include "gensvm_io.h"
+
+/**
+ * Minimal number of command line arguments
+ */
+#define MINARGS 3
+
+extern FILE *GENSVM_OUTPUT_FILE;
+extern FILE *GENSVM_ERROR_FILE;
+
+// function declarations
+void exit_with_help(char **argv);
+void parse_command_line(int argc, char **argv, char **model_file,
+		char **source_file, char **name);
+
+/**
+ * @brief Help function
+ *
+ * @details
+ * Print help for this program and exit. Note that the VERSION is defined in
+ * the Makefile.
+ *
+ * @param[in] 	argv 	command line arguments
+ *
+ */
+void exit_with_help(char **argv)
+{
+	printf("This is GenSVM, version %s.\n", VERSION_STRING);
+	printf("Copyright (C) 2016, G.J.J. van den Burg.\n");
+	printf("This program is free software, see the LICENSE file "
+			"for details.\n\n");
+	printf("Usage: %s [options] model_file source_file\n\n", argv[0]);
+	printf("Options:\n");
+	printf("--------\n");
+	printf("-h | -help           : print this help.\n");
+	printf("-n name              : prefix of the function names in the "
+			"source file\n"
+			"                       (default: gensvm_model)\n");
+	printf("-q                   : quiet mode (no output, not even "
+			"errors!)\n");
+	printf("\n");
+	printf("The source file defines name_predict(x) and "
+			"name_scores(x, scores).\n");
+	printf("\n");
+
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Main interface function for GenSVMcodegen
+ *
+ * @details
+ * Main interface for the GenSVMcodegen commandline program.
+ *
+ * @param[in] 	argc 	number of command line arguments
+ * @param[in] 	argv 	array of command line arguments
+ *
+ * @return 		exit status
+ */
+int main(int argc, char **argv)
+{
+	char *model_file = NULL,
+	     *source_file = NULL,
+	     *name = NULL;
+	struct GenModel *model = NULL;
+
+	if (argc < MINARGS || gensvm_check_argv(argc, argv, "-help")
+			|| gensvm_check_argv_eq(argc, argv, "-h"))
+		exit_with_help(argv);
+
+	parse_command_line(argc, argv, &model_file, &source_file, &name);
+
+	model = gensvm_init_model();
+	gensvm_read_model(model, model_file);
+	gensvm_write_model_source(model, source_file, name);
+	note("Source written to: %s\n", source_file);
+
+	gensvm_free_model(model);
+	free(model_file);
+	free(source_file);
+	free(name);
+
+	return 0;
+}
+
+/**
+ * @brief Parse the command line arguments
+ *
+ * @details
+ * The options are parsed and the filenames of the model and the source file
+ * are set. If the name is not given, gensvm_model is used. Invalid options
+ * and names that aren't C identifiers result in a call to exit_with_help().
+ *
+ * @param[in] 	argc 		number of command line arguments
+ * @param[in] 	argv 		array of command line arguments
+ * @param[out] 	model_file 	filename of the model
+ * @param[out] 	source_file 	filename of the C source file
+ * @param[out] 	name 		prefix of the names in the source file
+ */
+void parse_command_line(int argc, char **argv, char **model_file,
+		char **source_file, char **name)
+{
+	int i;
+
+	GENSVM_OUTPUT_FILE = stdout;
+	GENSVM_ERROR_FILE = stderr;
+
+	// parse options
+	// note: flags that don't have an argument should decrement i
+	for (i=1; i<argc; i++) {
+		if (argv[i][0] != '-') break;
+		if (++i>=argc) {
+			exit_with_help(argv);
+		}
+		switch (argv[i-1][1]) {
+			case 'n':
+				if (!gensvm_is_identifier(argv[i])) {
+					fprintf(stderr, "Invalid parameter "
+							"value for name.\n\n");
+					exit_with_help(argv);
+				}
+				free(*name);
+				(*name) = Malloc(char, strlen(argv[i])+1);
+				strcpy((*name), argv[i]);
+				break;
+			case 'q':
+				GENSVM_OUTPUT_FILE = NULL;
+				GENSVM_ERROR_FILE = NULL;
+				i--;
+				break;
+			default:
+				// this one should always print explicitly to
+				// stderr, even if '-q' is supplied, because
+				// otherwise you can't debug cmdline flags.
+				fprintf(stderr, "Unknown option: -%c\n",
+						argv[i-1][1]);
+				exit_with_help(argv);
+		}
+	}
+	if (i+2 != argc)
+		exit_with_help(argv);
+
+	(*model_file) = Malloc(char, strlen(argv[i])+1);
+	strcpy((*model_file), argv[i]);
+	(*source_file) = Malloc(char, strlen(argv[i+1])+1);
+	strcpy((*source_file), argv[i+1]);
+	if (*name == NULL) {
+		(*name) = Malloc(char, strlen("gensvm_model")+1);
+		strcpy((*name), "gensvm_model");
+	}
+}
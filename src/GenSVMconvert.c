@@ -0,0 +1,176 @@
+/**
+ * @file GenSVMconvert.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Command line interface for converting a data file to binary
+ *
+ * @details
+ * This is a command line program that reads a data file in the format of
+ * the @ref spec_data_file or the @ref spec_libsvm_data_file, and writes it
+ * as a binary data file with gensvm_write_data_binary(). The binary file
+ * can be given to the other executables instead of the text file, and is
+ * read without parsing any numbers.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_binary.h"
+#include "gensvm_cmdarg.h"
+#include "gensvm_io.h"
+
+/**
+ * Minimal number of command line arguments
+ */
+#define MINARGS 3
+
+extern FILE *GENSVM_OUTPUT_FILE;
+extern FILE *GENSVM_ERROR_FILE;
+
+// function declarations
+void exit_with_help(char **argv);
+void parse_command_line(int argc, char **argv, char **data_file,
+		char **binary_file, bool *libsvm_format);
+
+/**
+ * @brief Help function
+ *
+ * @details
+ * Print help for this program and exit. Note that the VERSION is defined in
+ * the Makefile.
+ *
+ * @param[in] 	argv 	command line arguments
+ *
+ */
+void exit_with_help(char **argv)
+{
+	printf("This is GenSVM, version %s.\n", VERSION_STRING);
+	printf("Copyright (C) 2016, G.J.J. van den Burg.\n");
+	printf("This program is free software, see the LICENSE file "
+			"for details.\n\n");
+	printf("Usage: %s [options] data_file binary_file\n\n", argv[0]);
+	printf("Options:\n");
+	printf("--------\n");
+	printf("-h | -help           : print this help.\n");
+	printf("-q                   : quiet mode (no output, not even "
+			"errors!)\n");
+	printf("-x                   : data file is in LibSVM/SVMlight "
+			"format\n");
+	printf("\n");
+
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Main interface function for GenSVMconvert
+ *
+ * @details
+ * Main interface for the GenSVMconvert commandline program.
+ *
+ * @param[in] 	argc 	number of command line arguments
+ * @param[in] 	argv 	array of command line arguments
+ *
+ * @return 		exit status
+ */
+int main(int argc, char **argv)
+{
+	bool libsvm_format = false;
+	char *data_file = NULL,
+	     *binary_file = NULL;
+	struct GenData *data = NULL;
+
+	if (argc < MINARGS || gensvm_check_argv(argc, argv, "-help")
+			|| gensvm_check_argv_eq(argc, argv, "-h"))
+		exit_with_help(argv);
+
+	parse_command_line(argc, argv, &data_file, &binary_file,
+			&libsvm_format);
+
+	data = gensvm_init_data();
+	if (libsvm_format)
+		gensvm_read_data_libsvm(data, data_file);
+	else
+		gensvm_read_data(data, data_file);
+	gensvm_write_data_binary(data, binary_file);
+	note("Binary data (%s) written to: %s\n",
+			(data->spZ == NULL) ? "dense" : "sparse",
+			binary_file);
+
+	gensvm_free_data(data);
+	free(data_file);
+	free(binary_file);
+
+	return 0;
+}
+
+/**
+ * @brief Parse the command line arguments
+ *
+ * @details
+ * The options are parsed and the filenames of the data file and the binary
+ * file are set. Invalid options result in a call to exit_with_help().
+ *
+ * @param[in] 	argc 		number of command line arguments
+ * @param[in] 	argv 		array of command line arguments
+ * @param[out] 	data_file 	filename of the data file
+ * @param[out] 	binary_file 	filename of the binary data file
+ * @param[out] 	libsvm_format 	whether the data file is in LibSVM format
+ */
+void parse_command_line(int argc, char **argv, char **data_file,
+		char **binary_file, bool *libsvm_format)
+{
+	int i;
+
+	GENSVM_OUTPUT_FILE = stdout;
+	GENSVM_ERROR_FILE = stderr;
+
+	// parse options
+	// note: flags that don't have an argument should decrement i
+	for (i=1; i<argc; i++) {
+		if (argv[i][0] != '-') break;
+		if (++i>=argc) {
+			exit_with_help(argv);
+		}
+		switch (argv[i-1][1]) {
+			case 'q':
+				GENSVM_OUTPUT_FILE = NULL;
+				GENSVM_ERROR_FILE = NULL;
+				i--;
+				break;
+			case 'x':
+				*libsvm_format = true;
+				i--;
+				break;
+			default:
+				// this one should always print explicitly to
+				// stderr, even if '-q' is supplied, because
+				// otherwise you can't debug cmdline flags.
+				fprintf(stderr, "Unknown option: -%c\n",
+						argv[i-1][1]);
+				exit_with_help(argv);
+		}
+	}
+	if (i+2 != argc)
+		exit_with_help(argv);
+
+	(*data_file) = Malloc(char, strlen(argv[i])+1);
+	strcpy((*data_file), argv[i]);
+	(*binary_file) = Malloc(char, strlen(argv[i+1])+1);
+	strcpy((*binary_file), argv[i+1]);
+}
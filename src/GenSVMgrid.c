@@ -153,14 +153,21 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
-	// check if we are sparse and want nonlinearity
-	if (train_data->Z == NULL && grid->kerneltype != K_LINEAR) {
-		err("[GenSVM Warning]: Sparse matrices with nonlinear kernels "
-				"are not yet supported. Dense matrices will "
-				"be used.\n");
-		train_data->RAW = gensvm_sparse_to_dense(train_data->spZ);
-		train_data->Z = train_data->RAW;
-		gensvm_free_sparse(train_data->spZ);
+	// read the precomputed kernel matrices if needed
+	if (grid->kerneltype == K_PRECOMPUTED) {
+		if (grid->train_kernel_file == NULL || (test_data != NULL &&
+					grid->test_kernel_file == NULL)) {
+			err("[GenSVM Error]: Precomputed kernel requires the "
+					"train_kernel and test_kernel fields "
+					"in the grid file.\n");
+			exit(EXIT_FAILURE);
+		}
+		note("Reading kernel from %s\n", grid->train_kernel_file);
+		gensvm_read_kernel(train_data, grid->train_kernel_file,
+				train_data->n);
+		if (test_data != NULL)
+			gensvm_read_kernel(test_data, grid->test_kernel_file,
+					train_data->n);
 	}
 
 	note("Creating queue\n");
@@ -202,17 +209,7 @@ int main(int argc, char **argv)
 
 		gensvm_train(best_model, train_data, NULL);
 
-		// check if we are sparse and want nonlinearity
-		if (test_data->Z == NULL &&
-				best_model->kerneltype != K_LINEAR) {
-			err("[GenSVM Warning]: Sparse matrices with nonlinear "
-					"kernels are not yet supported. Dense "
-					"matrices will be used.\n");
-			test_data->Z = gensvm_sparse_to_dense(test_data->spZ);
-			gensvm_free_sparse(test_data->spZ);
-		}
-
-		gensvm_kernel_postprocess(best_model, train_data, test_data);
+		gensvm_kernel_store_basis(best_model, train_data);
 
 		// predict labels
 		predy = Calloc(long, test_data->n);
@@ -331,6 +328,8 @@ KernelType parse_kernel_str(char *kernel_line)
 		return K_RBF;
 	} else if (str_endswith(kernel_line, "SIGMOID\n")) {
 		return K_SIGMOID;
+	} else if (str_endswith(kernel_line, "PRECOMPUTED\n")) {
+		return K_PRECOMPUTED;
 	} else {
 		fprintf(stderr, "Unknown kernel specified on line: %s\n",
 				kernel_line);
@@ -360,6 +359,7 @@ void read_grid_from_file(char *input_filename, struct GenGrid *grid)
 	char buffer[GENSVM_MAX_LINE_LENGTH];
 	char train_filename[GENSVM_MAX_LINE_LENGTH];
 	char test_filename[GENSVM_MAX_LINE_LENGTH];
+	char kernel_filename[GENSVM_MAX_LINE_LENGTH];
 	double *params = Calloc(double, GENSVM_MAX_LINE_LENGTH);
 	long *lparams = Calloc(long, GENSVM_MAX_LINE_LENGTH);
 
@@ -383,6 +383,16 @@ void read_grid_from_file(char *input_filename, struct GenGrid *grid)
 			grid->test_data_file = Calloc(char,
 					GENSVM_MAX_LINE_LENGTH);
 			strcpy(grid->test_data_file, test_filename);
+		} else if (str_startswith(buffer, "train_kernel:")) {
+			sscanf(buffer, "train_kernel: %s\n", kernel_filename);
+			grid->train_kernel_file = Calloc(char,
+					GENSVM_MAX_LINE_LENGTH);
+			strcpy(grid->train_kernel_file, kernel_filename);
+		} else if (str_startswith(buffer, "test_kernel:")) {
+			sscanf(buffer, "test_kernel: %s\n", kernel_filename);
+			grid->test_kernel_file = Calloc(char,
+					GENSVM_MAX_LINE_LENGTH);
+			strcpy(grid->test_kernel_file, kernel_filename);
 		} else if (str_startswith(buffer, "p:")) {
 			nr = all_doubles_str(buffer, 2, params);
 			grid->ps = Calloc(double, nr);
@@ -438,9 +448,10 @@ void read_grid_from_file(char *input_filename, struct GenGrid *grid)
 			grid->kerneltype = parse_kernel_str(buffer);
 		} else if (str_startswith(buffer, "gamma:")) {
 			nr = all_doubles_str(buffer, 6, params);
-			if (grid->kerneltype == K_LINEAR) {
-				fprintf(stderr, "Field \"gamma\" ignored, "
-						"linear kernel is used.\n");
+			if (grid->kerneltype == K_LINEAR ||
+				grid->kerneltype == K_PRECOMPUTED) {
+				fprintf(stderr, "Field \"gamma\" ignored with "
+						"specified kernel.\n");
 				grid->Ng = 0;
 				continue;
 			}
@@ -451,7 +462,8 @@ void read_grid_from_file(char *input_filename, struct GenGrid *grid)
 		} else if (str_startswith(buffer, "coef:")) {
 			nr = all_doubles_str(buffer, 5, params);
 			if (grid->kerneltype == K_LINEAR ||
-				grid->kerneltype == K_RBF) {
+				grid->kerneltype == K_RBF ||
+				grid->kerneltype == K_PRECOMPUTED) {
 				fprintf(stderr, "Field \"coef\" ignored with "
 						"specified kernel.\n");
 				grid->Nc = 0;
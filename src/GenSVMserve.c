@@ -0,0 +1,1117 @@
+/**
+ * @file GenSVMserve.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Command line interface for serving predictions with a GenSVM model
+ *
+ * @details
+ * This is a command line program that loads a trained GenSVM model once and
+ * predicts the class labels of instances that are sent to it, either over
+ * stdin/stdout or over a Unix domain socket. This avoids the cost of
+ * starting a process and reading the model for every prediction job.
+ *
+ * The protocol is line based. Every request is a single line with the
+ * features of an instance, separated by whitespace. With the -x flag the
+ * features are given in LibSVM format (index:value, with 1-based indices),
+ * and an optional leading class label is ignored. For a precomputed kernel
+ * the line holds the kernel row of the instance with the training
+ * instances. Every request is answered with a single line containing the
+ * predicted label, followed by the scores of the classes if the -S flag is
+ * given (see gensvm_predict_scores()). A request that can't be parsed, or
+ * that is longer than GENSVM_SERVE_MAX_LINE bytes, is answered with a line
+ * starting with "error". Replies to a client are always in the order of
+ * its requests.
+ *
+ * Requests that arrive together, from one client or from several
+ * concurrent clients, are collected in a micro-batch which is predicted
+ * with a single call to gensvm_predict_scores(). A batch is predicted when
+ * it is full, or when its first request has waited for the waiting time,
+ * which is thus the maximum time that a request waits for others.
+ *
+ * On SIGHUP the model file is read again. The reload happens between
+ * batches, so every request is answered by either the old or the new
+ * model. If the new file can't be read, the old model is kept. SIGINT and
+ * SIGTERM stop the server after the pending batch is answered.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "gensvm_checks.h"
+#include "gensvm_cmdarg.h"
+#include "gensvm_io.h"
+#include "gensvm_predict.h"
+#include "gensvm_timer.h"
+
+/**
+ * Minimal number of command line arguments
+ */
+#define MINARGS 2
+
+/**
+ * Default maximum number of instances in a micro-batch
+ */
+#define GENSVM_SERVE_BATCH_SIZE 1024
+
+/**
+ * Number of bytes read from a client at a time
+ */
+#define GENSVM_SERVE_READ_SIZE 65536
+
+/**
+ * Maximum length in bytes of a request line
+ */
+#define GENSVM_SERVE_MAX_LINE 16777216
+
+/**
+ * Number of bytes of unsent replies to a client above which no more
+ * requests of the client are read
+ */
+#define GENSVM_SERVE_MAX_PENDING 1048576
+
+extern FILE *GENSVM_OUTPUT_FILE;
+extern FILE *GENSVM_ERROR_FILE;
+
+/**
+ * @brief A client of the server
+ *
+ * @details
+ * A client reads requests from in_fd and writes replies to out_fd. For the
+ * stdin/stdout mode these are different, for a socket client they are the
+ * same. Both are non-blocking, so a slow client can't stall the others.
+ * Incomplete request lines are kept in the input buffer, and replies that
+ * can't be written yet in the output buffer, which is written when the
+ * client is ready for it.
+ */
+struct ServeClient {
+	int in_fd;
+	///< file descriptor for the requests
+	int out_fd;
+	///< file descriptor for the replies
+	bool closed;
+	///< whether the end of the input has been reached
+	bool failed;
+	///< whether writing the replies failed
+	bool discard;
+	///< whether the rest of a request line that is too long is skipped
+	char *in;
+	///< buffer with unprocessed input
+	long in_len;
+	///< number of bytes in the input buffer
+	long in_size;
+	///< allocated size of the input buffer
+	char *out;
+	///< buffer with replies that are not yet written
+	long out_len;
+	///< number of bytes in the output buffer
+	long out_size;
+	///< allocated size of the output buffer
+};
+
+/**
+ * @brief A micro-batch of requests
+ *
+ * @details
+ * The instances of the requests are stored in a GenData structure with
+ * room for max_n instances, which is passed to gensvm_predict_scores() with
+ * the number of instances set to the size of the batch. The client and
+ * validity of every request are stored so that the replies can be sent.
+ */
+struct ServeBatch {
+	long n;
+	///< number of requests in the batch
+	long max_n;
+	///< maximum number of requests in the batch
+	long m;
+	///< number of values in a request
+	long K;
+	///< number of classes of the model
+	double *X;
+	///< instances of the batch
+	long *client;
+	///< index of the client of each request
+	bool *valid;
+	///< whether each request could be parsed
+	long *predy;
+	///< predicted labels
+	double *scores;
+	///< scores of the classes
+	struct GenData *data;
+	///< GenData wrapper around the instances
+	struct timespec first;
+	///< arrival time of the first request in the batch
+};
+
+// flags set by the signal handler
+static volatile sig_atomic_t reload_requested = 0;
+static volatile sig_atomic_t stop_requested = 0;
+
+// pipe to wake up the event loop from the signal handler
+static int signal_pipe[2] = {-1, -1};
+
+// function declarations
+void exit_with_help(char **argv);
+void parse_command_line(int argc, char **argv, char **model_file,
+		char **socket_path, long *batch_size, long *wait_ms,
+		bool *libsvm_format, bool *with_scores);
+void handle_signal(int signum);
+void install_signal_handlers(void);
+int open_socket(char *socket_path);
+long serve_num_values(struct GenModel *model);
+struct ServeBatch *serve_batch_init(struct GenModel *model, long max_n);
+void serve_batch_free(struct ServeBatch *batch);
+bool serve_parse_dense(char *line, double *x, long m);
+bool serve_parse_libsvm(char *line, double *x, long m,
+		struct GenModel *model);
+void serve_add_request(struct ServeBatch *batch, long client, char *line,
+		struct GenModel *model, bool libsvm_format);
+void serve_process_input(struct ServeClient *clients, long c,
+		struct ServeBatch *batch, struct GenModel *model,
+		bool libsvm_format, bool with_scores);
+void serve_flush(struct ServeClient *clients, struct ServeBatch *batch,
+		struct GenModel *model, bool with_scores);
+void serve_append(struct ServeClient *client, const char *str, long len);
+void serve_write_pending(struct ServeClient *client);
+void serve_set_nonblocking(int fd);
+struct GenModel *serve_read_model(char *model_file);
+
+/**
+ * @brief Help function
+ *
+ * @details
+ * Print help for this program and exit. Note that the VERSION is defined in
+ * the Makefile.
+ *
+ * @param[in] 	argv 	command line arguments
+ *
+ */
+void exit_with_help(char **argv)
+{
+	printf("This is GenSVM, version %s.\n", VERSION_STRING);
+	printf("Copyright (C) 2016, G.J.J. van den Burg.\n");
+	printf("This program is free software, see the LICENSE file "
+			"for details.\n\n");
+	printf("Usage: %s [options] model_file\n\n", argv[0]);
+	printf("Options:\n");
+	printf("--------\n");
+	printf("-b batch_size        : maximum number of instances in a "
+			"batch (default: %i)\n", GENSVM_SERVE_BATCH_SIZE);
+	printf("-h | -help           : print this help.\n");
+	printf("-q                   : quiet mode (no output, not even "
+			"errors!)\n");
+	printf("-S                   : reply with the class scores after "
+			"the label\n");
+	printf("-s socket_path       : listen on a Unix domain socket "
+			"(uses stdin/stdout if\n"
+			"                       not provided)\n");
+	printf("-w wait              : maximum time in milliseconds that a "
+			"request waits for\n"
+			"                       more requests before its batch is "
+			"predicted\n"
+			"                       (default: 0)\n");
+	printf("-x                   : requests are in LibSVM/SVMlight "
+			"format\n");
+	printf("\n");
+	printf("Send SIGHUP to reload the model file.\n");
+	printf("\n");
+
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Main interface function for GenSVMserve
+ *
+ * @details
+ * Main interface for the GenSVMserve commandline program. This runs an
+ * event loop with poll() over the input of the clients (and the listening
+ * socket). All input that is available is parsed into the current batch,
+ * and the batch is predicted when it is full or when its first request has
+ * waited for the waiting time.
+ *
+ * @param[in] 	argc 	number of command line arguments
+ * @param[in] 	argv 	array of command line arguments
+ *
+ * @return 		exit status
+ */
+int main(int argc, char **argv)
+{
+	bool done, libsvm_format = false,
+	     with_scores = false;
+	int fd, ret, timeout, listen_fd = -1,
+	    stdin_flags = 0,
+	    stdout_flags = 0;
+	long c, j, offset, n_polled, n_clients = 0,
+	     batch_size = GENSVM_SERVE_BATCH_SIZE,
+	     wait_ms = 0;
+	double elapsed;
+	char buf[64],
+	     *model_file = NULL,
+	     *socket_path = NULL;
+	struct timespec now;
+	struct pollfd *fds = NULL;
+	struct ServeClient *clients = NULL;
+	struct ServeBatch *batch = NULL;
+	struct GenModel *model = NULL,
+			*new_model = NULL;
+
+	if (argc < MINARGS || gensvm_check_argv(argc, argv, "-help")
+			|| gensvm_check_argv_eq(argc, argv, "-h"))
+		exit_with_help(argv);
+
+	parse_command_line(argc, argv, &model_file, &socket_path,
+			&batch_size, &wait_ms, &libsvm_format, &with_scores);
+
+	model = serve_read_model(model_file);
+	if (model == NULL) {
+		err("[GenSVM Error]: Couldn't read model file: %s\n",
+				model_file);
+		exit(EXIT_FAILURE);
+	}
+	batch = serve_batch_init(model, batch_size);
+	install_signal_handlers();
+
+	if (socket_path != NULL) {
+		listen_fd = open_socket(socket_path);
+		note("Listening on: %s\n", socket_path);
+	} else {
+		clients = Calloc(struct ServeClient, 1);
+		clients[0].in_fd = STDIN_FILENO;
+		clients[0].out_fd = STDOUT_FILENO;
+		n_clients = 1;
+		stdin_flags = fcntl(STDIN_FILENO, F_GETFL);
+		stdout_flags = fcntl(STDOUT_FILENO, F_GETFL);
+		serve_set_nonblocking(STDIN_FILENO);
+		serve_set_nonblocking(STDOUT_FILENO);
+	}
+
+	while (true) {
+		// answer pending requests before a reload, a stop, or the
+		// removal of a client
+		done = false;
+		for (c=0; c<n_clients; c++)
+			done = done || clients[c].failed ||
+				(clients[c].closed && clients[c].out_len == 0);
+		if (batch->n > 0 && (reload_requested || stop_requested ||
+					done))
+			serve_flush(clients, batch, model, with_scores);
+
+		if (reload_requested) {
+			reload_requested = 0;
+			new_model = serve_read_model(model_file);
+			if (new_model == NULL) {
+				err("[GenSVM Warning]: Couldn't read model "
+						"file %s, keeping the current "
+						"model.\n", model_file);
+			} else {
+				gensvm_free_model(model);
+				serve_batch_free(batch);
+				model = new_model;
+				batch = serve_batch_init(model, batch_size);
+				note("Model reloaded from: %s\n", model_file);
+			}
+		}
+		if (stop_requested)
+			break;
+
+		// remove clients that are done and have received all their
+		// replies, and stop if stdin is done
+		for (c=0, j=0; c<n_clients; c++) {
+			if (clients[c].failed || (clients[c].closed &&
+						clients[c].out_len == 0)) {
+				if (clients[c].in_fd != STDIN_FILENO)
+					close(clients[c].in_fd);
+				free(clients[c].in);
+				free(clients[c].out);
+				continue;
+			}
+			clients[j++] = clients[c];
+		}
+		n_clients = j;
+		if (listen_fd < 0 && n_clients == 0)
+			break;
+
+		// predict the batch when its first request has waited long
+		// enough, also when new requests keep arriving
+		timeout = -1;
+		if (batch->n > 0) {
+			Timer(now);
+			elapsed = 1000.0 * gensvm_elapsed_time(&batch->first,
+					&now);
+			if (elapsed >= wait_ms)
+				serve_flush(clients, batch, model, with_scores);
+			else
+				timeout = (int) (wait_ms - elapsed);
+		}
+
+		// poll the signal pipe, the listening socket, the input of
+		// the clients that don't have too many unsent replies, and the
+		// output of the clients with unsent replies (poll() skips
+		// negative fds)
+		fds = Realloc(fds, struct pollfd, 2*n_clients + 2);
+		fds[0].fd = signal_pipe[0];
+		fds[0].events = POLLIN;
+		fds[1].fd = listen_fd;
+		fds[1].events = POLLIN;
+		offset = 2;
+		n_polled = n_clients;
+		for (c=0; c<n_polled; c++) {
+			fds[2*c + offset].fd = (clients[c].closed ||
+					clients[c].out_len >=
+					GENSVM_SERVE_MAX_PENDING) ? -1 :
+				clients[c].in_fd;
+			fds[2*c + offset].events = POLLIN;
+			fds[2*c + 1 + offset].fd = (clients[c].out_len > 0) ?
+				clients[c].out_fd : -1;
+			fds[2*c + 1 + offset].events = POLLOUT;
+		}
+
+		ret = poll(fds, 2*n_polled + offset, timeout);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			// LCOV_EXCL_START
+			err("[GenSVM Error]: poll() failed: %s\n",
+					strerror(errno));
+			break;
+			// LCOV_EXCL_STOP
+		}
+		if (ret == 0) {
+			// the waiting time of the batch has passed
+			continue;
+		}
+		if (fds[0].revents & POLLIN) {
+			// the signal is handled at the start of the loop
+			while (read(signal_pipe[0], buf, sizeof(buf)) > 0)
+				;
+			continue;
+		}
+
+		for (c=0; c<n_polled; c++) {
+			if (fds[2*c + 1 + offset].revents != 0)
+				serve_write_pending(&clients[c]);
+			if (fds[2*c + offset].revents != 0)
+				serve_process_input(clients, c, batch, model,
+						libsvm_format, with_scores);
+		}
+
+		if (listen_fd >= 0 && (fds[1].revents & POLLIN)) {
+			fd = accept(listen_fd, NULL, NULL);
+			if (fd >= 0) {
+				serve_set_nonblocking(fd);
+				clients = Realloc(clients, struct ServeClient,
+						n_clients + 1);
+				memset(&clients[n_clients], 0,
+						sizeof(struct ServeClient));
+				clients[n_clients].in_fd = fd;
+				clients[n_clients].out_fd = fd;
+				n_clients++;
+			}
+		}
+	}
+
+	// answer the remaining requests and clean up, stdin and stdout are
+	// made blocking again so that all replies are written to stdout
+	if (listen_fd < 0) {
+		fcntl(STDIN_FILENO, F_SETFL, stdin_flags);
+		fcntl(STDOUT_FILENO, F_SETFL, stdout_flags);
+	}
+	serve_flush(clients, batch, model, with_scores);
+	for (c=0; c<n_clients; c++) {
+		serve_write_pending(&clients[c]);
+		if (clients[c].in_fd != STDIN_FILENO)
+			close(clients[c].in_fd);
+		free(clients[c].in);
+		free(clients[c].out);
+	}
+	if (listen_fd >= 0) {
+		close(listen_fd);
+		unlink(socket_path);
+	}
+	close(signal_pipe[0]);
+	close(signal_pipe[1]);
+
+	free(clients);
+	free(fds);
+	serve_batch_free(batch);
+	gensvm_free_model(model);
+	free(model_file);
+	free(socket_path);
+
+	return 0;
+}
+
+/**
+ * @brief Signal handler of the server
+ *
+ * @details
+ * SIGHUP requests a reload of the model, SIGINT and SIGTERM request the
+ * server to stop. The requests are handled in the event loop, which is
+ * woken up by writing to the signal pipe.
+ *
+ * @param[in] 	signum 	the signal number
+ */
+void handle_signal(int signum)
+{
+	int saved_errno = errno;
+
+	if (signum == SIGHUP)
+		reload_requested = 1;
+	else
+		stop_requested = 1;
+	// if the pipe is full the event loop wakes up anyway
+	write(signal_pipe[1], "", 1);
+	errno = saved_errno;
+}
+
+/**
+ * @brief Install the signal handlers of the server
+ *
+ * @details
+ * The signal may be delivered to one of the threads of OpenMP or BLAS
+ * instead of to the thread that waits in poll(), so the handler wakes up
+ * the event loop by writing to a pipe that is polled with the clients.
+ * SIGPIPE is ignored, so a client that disconnects before it has read its
+ * replies does not stop the server.
+ */
+void install_signal_handlers(void)
+{
+	struct sigaction act;
+
+	if (pipe(signal_pipe) != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Couldn't create a pipe: %s\n",
+				strerror(errno));
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	serve_set_nonblocking(signal_pipe[0]);
+	serve_set_nonblocking(signal_pipe[1]);
+
+	memset(&act, 0, sizeof(act));
+	act.sa_handler = handle_signal;
+	sigemptyset(&act.sa_mask);
+	sigaction(SIGHUP, &act, NULL);
+	sigaction(SIGINT, &act, NULL);
+	sigaction(SIGTERM, &act, NULL);
+
+	act.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &act, NULL);
+}
+
+/**
+ * @brief Open a listening Unix domain socket
+ *
+ * @details
+ * A stale socket file at the given path, for instance of a previous server
+ * that didn't stop cleanly, is removed. Any other existing file is left
+ * alone, and the server exits with an error.
+ *
+ * @param[in] 	socket_path 	path of the socket
+ * @returns 			file descriptor of the listening socket
+ */
+int open_socket(char *socket_path)
+{
+	int fd;
+	struct stat st;
+	struct sockaddr_un addr;
+
+	if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Socket path too long: %s\n",
+				socket_path);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	if (stat(socket_path, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(socket_path);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, socket_path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0
+			|| listen(fd, SOMAXCONN) < 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Couldn't listen on socket %s: %s\n",
+				socket_path, strerror(errno));
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	return fd;
+}
+
+/**
+ * @brief Read a model file for serving
+ *
+ * @details
+ * Since this is also used to reload the model while serving, a model file
+ * that can't be used must give NULL instead of stopping the server. A model
+ * file that is reloaded may be incomplete because it is still being
+ * written. The model is therefore read with gensvm_try_read_model(), which
+ * gives an error instead of exiting on a malformed file, and it is checked
+ * that a nonlinear model has the basis for prediction.
+ *
+ * @param[in] 	model_file 	filename of the model
+ * @returns 			the model, or NULL if it can't be used
+ */
+struct GenModel *serve_read_model(char *model_file)
+{
+	struct GenModel *model = gensvm_init_model();
+
+	if (!gensvm_try_read_model(model, model_file)) {
+		gensvm_free_model(model);
+		return NULL;
+	}
+	if (model->kerneltype != K_LINEAR && model->W == NULL) {
+		err("[GenSVM Warning]: Model in %s has no basis for "
+				"prediction.\n", model_file);
+		gensvm_free_model(model);
+		return NULL;
+	}
+
+	return model;
+}
+
+/**
+ * @brief Number of values in a request for a model
+ *
+ * @details
+ * This is the number of features for a linear model or a kernel model, and
+ * the number of training instances for a precomputed kernel.
+ *
+ * @param[in] 	model 	a GenModel read with serve_read_model()
+ * @returns 		the number of values in a request
+ */
+long serve_num_values(struct GenModel *model)
+{
+	if (model->kerneltype == K_LINEAR)
+		return model->m;
+	if (model->kerneltype == K_PRECOMPUTED)
+		return model->basis->n;
+	return model->basis->m;
+}
+
+/**
+ * @brief Initialize a micro-batch for a model
+ *
+ * @details
+ * The instances are stored in GenData::RAW (and GenData::Z) with a leading
+ * column of ones, or in GenData::kernel for a precomputed kernel.
+ *
+ * @param[in] 	model 	the GenModel used for prediction
+ * @param[in] 	max_n 	maximum number of requests in the batch
+ * @returns 		an empty batch
+ */
+struct ServeBatch *serve_batch_init(struct GenModel *model, long max_n)
+{
+	long m = serve_num_values(model);
+	struct ServeBatch *batch = Malloc(struct ServeBatch, 1);
+
+	batch->n = 0;
+	batch->max_n = max_n;
+	batch->m = m;
+	batch->K = model->K;
+	batch->client = Calloc(long, max_n);
+	batch->valid = Calloc(bool, max_n);
+	batch->predy = Calloc(long, max_n);
+	batch->scores = Calloc(double, max_n*model->K);
+
+	batch->data = gensvm_init_data();
+	batch->data->m = m;
+	batch->data->r = m;
+	batch->data->K = model->K;
+	if (model->kerneltype == K_PRECOMPUTED) {
+		batch->X = Calloc(double, max_n*m);
+		batch->data->kernel = batch->X;
+	} else {
+		batch->X = Calloc(double, max_n*(m+1));
+		batch->data->RAW = batch->X;
+		batch->data->Z = batch->X;
+	}
+
+	return batch;
+}
+
+/**
+ * @brief Free a micro-batch
+ *
+ * @param[in] 	batch 	the batch to free
+ */
+void serve_batch_free(struct ServeBatch *batch)
+{
+	if (batch == NULL)
+		return;
+
+	// the instances are owned by the batch, not by the GenData
+	batch->data->RAW = NULL;
+	batch->data->Z = NULL;
+	batch->data->kernel = NULL;
+	gensvm_free_data(batch->data);
+
+	free(batch->X);
+	free(batch->client);
+	free(batch->valid);
+	free(batch->predy);
+	free(batch->scores);
+	free(batch);
+}
+
+/**
+ * @brief Parse a request with dense features
+ *
+ * @param[in] 	line 	the request
+ * @param[out] 	x 	vector of length m for the values
+ * @param[in] 	m 	the number of values
+ * @returns 		whether exactly m numbers were found
+ */
+bool serve_parse_dense(char *line, double *x, long m)
+{
+	long j;
+	char *start = line,
+	     *end = NULL;
+
+	for (j=0; j<m; j++) {
+		x[j] = strtod(start, &end);
+		if (end == start)
+			return false;
+		start = end;
+	}
+	while (isspace(*start))
+		start++;
+
+	return *start == '\0';
+}
+
+/**
+ * @brief Parse a request with features in LibSVM format
+ *
+ * @details
+ * The request consists of index:value pairs with 1-based indices, which
+ * may be preceded by a class label. Features that are not given are zero.
+ * If the model was trained on hashed features (see GenModel::hash_bits),
+ * the indices are hashed in the same way with gensvm_parse_hash().
+ * If the model has a column map (see GenModel::col_map), the columns are
+ * renumbered with gensvm_parse_map_column(), and features in columns that
+ * are not in the map are ignored.
+ *
+ * @param[in] 	line 	the request
+ * @param[out] 	x 	vector of length m for the values
+ * @param[in] 	m 	the number of values
+ * @param[in] 	model 	the GenModel used for prediction
+ * @returns 		whether the request is valid
+ */
+bool serve_parse_libsvm(char *line, double *x, long m,
+		struct GenModel *model)
+{
+	long index;
+	double sign, value;
+	bool first = true;
+	char *start = line,
+	     *end = NULL;
+
+	memset(x, 0, m*sizeof(double));
+	while (true) {
+		while (isspace(*start))
+			start++;
+		if (*start == '\0')
+			return true;
+
+		index = strtol(start, &end, 10);
+		if (end == start)
+			return false;
+		if (*end != ':') {
+			// skip the class label
+			if (!first || !(isspace(*end) || *end == '\0'))
+				return false;
+			first = false;
+			start = end;
+			continue;
+		}
+		first = false;
+		if (index < 0 || (model->hash_bits == 0 &&
+					model->col_map == NULL &&
+					(index < 1 || index > m)))
+			return false;
+
+		start = end + 1;
+		value = strtod(start, &end);
+		if (end == start)
+			return false;
+		start = end;
+
+		sign = 1.0;
+		if (model->hash_bits > 0)
+			index = gensvm_parse_hash(index, model->hash_bits,
+					model->hash_signed, &sign);
+		if (model->col_map != NULL)
+			index = gensvm_parse_map_column(index, model->col_map,
+					model->col_map_size);
+		if (index == 0)
+			continue;
+		if (model->hash_bits > 0)
+			x[index-1] += sign * value;
+		else
+			x[index-1] = value;
+	}
+}
+
+/**
+ * @brief Add a request to the micro-batch
+ *
+ * @details
+ * The request is parsed into the next row of the batch. A request that
+ * can't be parsed is kept in the batch as well, so that its error reply is
+ * sent in order.
+ *
+ * @param[in] 	batch 		the batch, which should not be full
+ * @param[in] 	client 		index of the client of the request
+ * @param[in] 	line 		the request, or NULL for a request that is
+ * 				rejected without parsing it
+ * @param[in] 	model 		the GenModel used for prediction
+ * @param[in] 	libsvm_format 	whether the request is in LibSVM format
+ */
+void serve_add_request(struct ServeBatch *batch, long client, char *line,
+		struct GenModel *model, bool libsvm_format)
+{
+	long m = batch->m;
+	double *x = NULL;
+	bool valid;
+
+	if (batch->n == 0)
+		Timer(batch->first);
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		x = &batch->X[batch->n*m];
+	} else {
+		x = &batch->X[batch->n*(m+1)];
+		*x++ = 1.0;
+	}
+
+	if (line == NULL)
+		valid = false;
+	else if (libsvm_format)
+		valid = serve_parse_libsvm(line, x, m, model);
+	else
+		valid = serve_parse_dense(line, x, m);
+	if (!valid)
+		memset(x, 0, m*sizeof(double));
+
+	batch->client[batch->n] = client;
+	batch->valid[batch->n] = valid;
+	batch->n++;
+}
+
+/**
+ * @brief Read the available input of a client
+ *
+ * @details
+ * All complete lines that are read are added to the batch as requests, and
+ * the batch is predicted whenever it is full. At the end of the input an
+ * unterminated last line is also added as a request, and the client is
+ * marked as closed. A line that is longer than GENSVM_SERVE_MAX_LINE is
+ * rejected as soon as the limit is exceeded, and the rest of it is
+ * skipped, so the input buffer doesn't grow without bound.
+ *
+ * @param[in] 	clients 	the clients of the server
+ * @param[in] 	c 		index of the client with input
+ * @param[in] 	batch 		the current batch
+ * @param[in] 	model 		the GenModel used for prediction
+ * @param[in] 	libsvm_format 	whether requests are in LibSVM format
+ * @param[in] 	with_scores 	whether replies include the class scores
+ */
+void serve_process_input(struct ServeClient *clients, long c,
+		struct ServeBatch *batch, struct GenModel *model,
+		bool libsvm_format, bool with_scores)
+{
+	long start, end;
+	ssize_t n_read;
+	struct ServeClient *client = &clients[c];
+
+	if (client->in_size - client->in_len < GENSVM_SERVE_READ_SIZE + 1) {
+		client->in_size = client->in_len + 2*GENSVM_SERVE_READ_SIZE;
+		client->in = Realloc(client->in, char, client->in_size);
+	}
+
+	n_read = read(client->in_fd, client->in + client->in_len,
+			GENSVM_SERVE_READ_SIZE);
+	if (n_read < 0 && (errno == EINTR || errno == EAGAIN))
+		return;
+	if (n_read <= 0) {
+		client->closed = true;
+		if (client->in_len > 0)
+			client->in[client->in_len++] = '\n';
+	} else {
+		client->in_len += n_read;
+	}
+
+	start = 0;
+	for (end=0; end<client->in_len; end++) {
+		if (client->in[end] != '\n')
+			continue;
+		if (client->discard) {
+			// end of a line that is too long
+			client->discard = false;
+			start = end + 1;
+			continue;
+		}
+		client->in[end] = '\0';
+		if (end > start && client->in[end-1] == '\r')
+			client->in[end-1] = '\0';
+		serve_add_request(batch, c, client->in + start, model,
+				libsvm_format);
+		if (batch->n == batch->max_n)
+			serve_flush(clients, batch, model, with_scores);
+		start = end + 1;
+	}
+
+	client->in_len -= start;
+	memmove(client->in, client->in + start, client->in_len);
+
+	if (client->discard || client->in_len > GENSVM_SERVE_MAX_LINE) {
+		if (!client->discard) {
+			serve_add_request(batch, c, NULL, model,
+					libsvm_format);
+			if (batch->n == batch->max_n)
+				serve_flush(clients, batch, model,
+						with_scores);
+		}
+		client->discard = true;
+		client->in_len = 0;
+	}
+}
+
+/**
+ * @brief Append to the output buffer of a client
+ *
+ * @param[in] 	client 	the client
+ * @param[in] 	str 	the string to append
+ * @param[in] 	len 	length of the string
+ */
+void serve_append(struct ServeClient *client, const char *str, long len)
+{
+	if (client->out_len + len > client->out_size) {
+		client->out_size = 2*(client->out_len + len);
+		client->out = Realloc(client->out, char, client->out_size);
+	}
+	memcpy(client->out + client->out_len, str, len);
+	client->out_len += len;
+}
+
+/**
+ * @brief Write the unsent replies of a client
+ *
+ * @details
+ * As much of the output buffer is written as the client accepts without
+ * blocking, and the rest is kept for when poll() reports that the client
+ * is ready for more. A client to which the replies can't be written is
+ * marked as failed and its replies are dropped.
+ *
+ * @param[in] 	client 	the client
+ */
+void serve_write_pending(struct ServeClient *client)
+{
+	long start = 0;
+	ssize_t n_written;
+
+	while (start < client->out_len) {
+		n_written = write(client->out_fd, client->out + start,
+				client->out_len - start);
+		if (n_written < 0 && errno == EINTR)
+			continue;
+		if (n_written < 0 && (errno == EAGAIN ||
+					errno == EWOULDBLOCK))
+			break;
+		if (n_written <= 0) {
+			client->failed = true;
+			client->out_len = 0;
+			return;
+		}
+		start += n_written;
+	}
+
+	client->out_len -= start;
+	memmove(client->out, client->out + start, client->out_len);
+}
+
+/**
+ * @brief Make reading and writing of a file descriptor non-blocking
+ *
+ * @param[in] 	fd 	the file descriptor
+ */
+void serve_set_nonblocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL);
+
+	if (flags >= 0)
+		fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/**
+ * @brief Predict the micro-batch and send the replies
+ *
+ * @details
+ * The labels and scores of all requests in the batch are computed with a
+ * single call to gensvm_predict_scores(). The replies are collected per
+ * client and written with serve_write_pending(), which keeps what the
+ * client doesn't accept yet.
+ *
+ * @param[in] 	clients 	the clients of the server
+ * @param[in] 	batch 		the batch to predict, which is empty
+ * 				afterwards
+ * @param[in] 	model 		the GenModel used for prediction
+ * @param[in] 	with_scores 	whether replies include the class scores
+ */
+void serve_flush(struct ServeClient *clients, struct ServeBatch *batch,
+		struct GenModel *model, bool with_scores)
+{
+	long i, k, c, len, K = batch->K;
+	char *buf = NULL;
+	struct ServeClient *client = NULL;
+
+	if (batch->n == 0)
+		return;
+
+	// room for the label and the scores of a reply
+	buf = Malloc(char, 32*(K+1));
+
+	batch->data->n = batch->n;
+	gensvm_predict_scores(batch->data, model, batch->predy,
+			batch->scores);
+
+	for (i=0; i<batch->n; i++) {
+		client = &clients[batch->client[i]];
+		if (!batch->valid[i]) {
+			len = sprintf(buf, "error invalid instance\n");
+			serve_append(client, buf, len);
+			continue;
+		}
+		len = sprintf(buf, "%li", batch->predy[i]);
+		if (with_scores) {
+			for (k=0; k<K; k++)
+				len += sprintf(buf + len, " %.16g",
+					matrix_get(batch->scores, K, i, k));
+		}
+		buf[len++] = '\n';
+		serve_append(client, buf, len);
+	}
+
+	for (i=0; i<batch->n; i++) {
+		c = batch->client[i];
+		if (i == 0 || c != batch->client[i-1])
+			serve_write_pending(&clients[c]);
+	}
+	batch->n = 0;
+
+	free(buf);
+}
+
+/**
+ * @brief Parse the command line arguments
+ *
+ * @details
+ * For a full overview of the command line arguments and their meaning see
+ * exit_with_help(). Since stdout may be used for the replies, the output
+ * stream for notes is set to stderr.
+ *
+ * @param[in] 	argc 		number of command line arguments
+ * @param[in] 	argv 		array of command line arguments
+ * @param[out] 	model_file 	filename of the model
+ * @param[out] 	socket_path 	path of the socket, or NULL for stdin/stdout
+ * @param[out] 	batch_size 	maximum number of requests in a batch
+ * @param[out] 	wait_ms 	maximum time that a request waits for others
+ * @param[out] 	libsvm_format 	whether requests are in LibSVM format
+ * @param[out] 	with_scores 	whether replies include the class scores
+ */
+void parse_command_line(int argc, char **argv, char **model_file,
+		char **socket_path, long *batch_size, long *wait_ms,
+		bool *libsvm_format, bool *with_scores)
+{
+	int i;
+
+	GENSVM_OUTPUT_FILE = stderr;
+	GENSVM_ERROR_FILE = stderr;
+
+	// parse options
+	// note: flags that don't have an argument should decrement i
+	for (i=1; i<argc; i++) {
+		if (argv[i][0] != '-') break;
+		if (++i>=argc) {
+			exit_with_help(argv);
+		}
+		switch (argv[i-1][1]) {
+			case 'b':
+				*batch_size = atol(argv[i]);
+				if (*batch_size < 1) {
+					fprintf(stderr, "Invalid parameter "
+							"value for batch "
+							"size.\n\n");
+					exit_with_help(argv);
+				}
+				break;
+			case 'q':
+				GENSVM_OUTPUT_FILE = NULL;
+				GENSVM_ERROR_FILE = NULL;
+				i--;
+				break;
+			case 'S':
+				*with_scores = true;
+				i--;
+				break;
+			case 's':
+				(*socket_path) = Malloc(char,
+						strlen(argv[i])+1);
+				strcpy((*socket_path), argv[i]);
+				break;
+			case 'w':
+				*wait_ms = atol(argv[i]);
+				if (*wait_ms < 0) {
+					fprintf(stderr, "Invalid parameter "
+							"value for wait.\n\n");
+					exit_with_help(argv);
+				}
+				break;
+			case 'x':
+				*libsvm_format = true;
+				i--;
+				break;
+			default:
+				// this one should always print explicitly to 
+				// stderr, even if '-q' is supplied, because 
+				// otherwise you can't debug cmdline flags.
+				fprintf(stderr, "Unknown option: -%c\n",
+						argv[i-1][1]);
+				exit_with_help(argv);
+		}
+	}
+	if (i >= argc)
+		exit_with_help(argv);
+
+	(*model_file) = Malloc(char, strlen(argv[i])+1);
+	strcpy((*model_file), argv[i]);
+}
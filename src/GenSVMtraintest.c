@@ -28,17 +28,27 @@
 
  */
 
+#include "gensvm_binary.h"
 #include "gensvm_checks.h"
 #include "gensvm_cmdarg.h"
 #include "gensvm_io.h"
 #include "gensvm_train.h"
 #include "gensvm_predict.h"
+#include "gensvm_quantize.h"
 
 /**
  * Minimal number of command line arguments
  */
 #define MINARGS 2
 
+/**
+ * Number of instances that are read and predicted at a time in predict-only 
+ * mode
+ */
+#ifndef GENSVM_PREDICT_CHUNK_SIZE
+  #define GENSVM_PREDICT_CHUNK_SIZE 16384
+#endif
+
 extern FILE *GENSVM_OUTPUT_FILE;
 extern FILE *GENSVM_ERROR_FILE;
 
@@ -47,7 +57,11 @@ void exit_with_help(char **argv);
 void parse_command_line(int argc, char **argv, struct GenModel *model,
 		char **model_inputfile, char **training_inputfile,
 		char **testing_inputfile, char **model_outputfile,
-		char **prediction_outputfile);
+		char **prediction_outputfile, char **train_kernelfile,
+		char **test_kernelfile, PredictionFormat *format);
+void predict_only(char *model_inputfile, char *data_file,
+		char *prediction_outputfile, bool libsvm_format,
+		PredictionFormat format, bool quantized);
 
 /**
  * @brief Help function
@@ -65,18 +79,35 @@ void exit_with_help(char **argv)
 	printf("Copyright (C) 2016, G.J.J. van den Burg.\n");
 	printf("This program is free software, see the LICENSE file "
 			"for details.\n\n");
-	printf("Usage: %s [options] training_data [test_data]\n\n", argv[0]);
+	printf("Usage: %s [options] training_data [test_data]\n", argv[0]);
+	printf("       %s -P -s model_file [options] test_data\n\n",
+			argv[0]);
 	printf("Options:\n");
 	printf("--------\n");
+	printf("-B                   : write the model of -m in the binary "
+			"model format\n");
+	printf("-C                   : keep only the features that are used "
+			"in the LibSVM\n"
+			"                       training data (with -x)\n");
 	printf("-c coef              : coefficient for the polynomial and "
 			"sigmoid kernel\n");
 	printf("-d degree            : degree for the polynomial kernel\n");
 	printf("-e epsilon           : set the value of the stopping "
 			"criterion (epsilon > 0)\n");
+	printf("-f format            : format of the predictions written "
+			"with -o (0 = data\n"
+			"                       with labels, 1 = labels, 2 = labels "
+			"and class scores,\n"
+			"                       3 = binary int32 labels)\n");
 	printf("-g gamma             : parameter for the rbf, polynomial or "
 			"sigmoid kernel\n");
+	printf("-H bits              : hash the feature indices of LibSVM "
+			"data into 2^bits\n"
+			"                       columns (with -x)\n");
 	printf("-h | -help           : print this help.\n");
 	printf("-i max_iter          : maximum number of iterations to do.\n");
+	printf("-K train_kernel_file : precomputed kernel matrix of the "
+			"training data (with -t 4)\n");
 	printf("-k kappa             : set the value of kappa used in the "
 			"Huber hinge (kappa > -1.0)\n");
 	printf("-l lambda            : set the value of lambda "
@@ -85,15 +116,31 @@ void exit_with_help(char **argv)
 			"(not saved if no file provided)\n");
 	printf("-o prediction_output : write predictions of test data to "
 			"file (uses stdout if not provided)\n");
+	printf("-P                   : predict the test data with the model "
+			"of -s in chunks,\n"
+			"                       without training\n");
 	printf("-p p-value           : set the value of p in the lp norm "
 			"(1.0 <= p <= 2.0)\n");
+	printf("-Q                   : predict with quantized weights in "
+			"predict-only mode\n"
+			"                       (linear models, labels are exact)\n");
 	printf("-q                   : quiet mode (no output, not even "
 			"errors!)\n");
+	printf("-R tolerance         : prune the training instances of a "
+			"kernel model whose\n"
+			"                       coefficients have a norm below "
+			"tolerance times the\n"
+			"                       largest norm (0 = off, 1 = keep "
+			"only support vectors)\n");
 	printf("-r rho               : choose the weigth specification "
 			"(1 = unit, 2 = group)\n");
+	printf("-S                   : give the hashed features of -H a "
+			"random sign\n");
 	printf("-s seed_model_file   : use previous model as seed for V\n");
+	printf("-T test_kernel_file  : precomputed cross kernel matrix of the "
+			"test data (with -t 4)\n");
 	printf("-t type              : kerneltype (0=LINEAR, 1=POLY, 2=RBF, "
-			"3=SIGMOID)\n");
+			"3=SIGMOID, 4=PRECOMPUTED)\n");
 	printf("-x                   : data files are in LibSVM/SVMlight "
 			"format\n");
 	printf("-z seed              : seed for the random number generator\n");
@@ -117,13 +164,18 @@ int main(int argc, char **argv)
 {
 	bool libsvm_format = false;
 	long i, *predy = NULL;
-	double performance;
+	double performance,
+	       *scores = NULL;
+	PredictionFormat format = P_DATA;
+	struct GenWriter *writer = NULL;
 
 	char *training_inputfile = NULL,
 	     *testing_inputfile = NULL,
 	     *model_inputfile = NULL,
 	     *model_outputfile = NULL,
-	     *prediction_outputfile = NULL;
+	     *prediction_outputfile = NULL,
+	     *train_kernelfile = NULL,
+	     *test_kernelfile = NULL;
 
 	struct GenModel *model = gensvm_init_model();
 	struct GenModel *seed_model = NULL;
@@ -137,14 +189,60 @@ int main(int argc, char **argv)
 	// parse command line arguments
 	parse_command_line(argc, argv, model, &model_inputfile,
 		       	&training_inputfile, &testing_inputfile,
-		       	&model_outputfile, &prediction_outputfile);
+		       	&model_outputfile, &prediction_outputfile,
+			&train_kernelfile, &test_kernelfile, &format);
 	libsvm_format = gensvm_check_argv(argc, argv, "-x");
 
-	// read data from file
+	// predict with a saved model without training
+	if (gensvm_check_argv_eq(argc, argv, "-P")) {
+		if (model_inputfile == NULL) {
+			err("[GenSVM Error]: Predict-only mode requires a "
+					"model file (-s).\n");
+			exit(EXIT_FAILURE);
+		}
+		predict_only(model_inputfile, training_inputfile,
+				prediction_outputfile, libsvm_format, format,
+				gensvm_check_argv_eq(argc, argv, "-Q"));
+
+		gensvm_free_model(model);
+		gensvm_free_data(traindata);
+		gensvm_free_data(testdata);
+		free(training_inputfile);
+		free(testing_inputfile);
+		free(model_inputfile);
+		free(model_outputfile);
+		free(prediction_outputfile);
+		free(train_kernelfile);
+		free(test_kernelfile);
+		return 0;
+	}
+
+	// read data from file, hashing the features of a LibSVM file or 
+	// keeping only the features that are used if requested
+	traindata->hash_bits = libsvm_format ? model->hash_bits : 0;
+	traindata->hash_signed = model->hash_signed;
+	model->hash_bits = traindata->hash_bits;
+	traindata->compact = libsvm_format &&
+		gensvm_check_argv_eq(argc, argv, "-C");
+	if (traindata->compact && model->kerneltype == K_RBF) {
+		err("[GenSVM Error]: Column compaction (-C) is not "
+				"supported for the RBF kernel, since the "
+				"removed features of the test data change "
+				"the distances.\n");
+		exit(EXIT_FAILURE);
+	}
 	if (libsvm_format)
 		gensvm_read_data_libsvm(traindata, training_inputfile);
 	else
 		gensvm_read_data(traindata, training_inputfile);
+	if (traindata->col_map != NULL) {
+		model->col_map_size = traindata->col_map_size;
+		model->col_map = Malloc(long, model->col_map_size);
+		memcpy(model->col_map, traindata->col_map,
+				model->col_map_size*sizeof(long));
+		note("Kept %li columns of the training data.\n",
+				model->col_map_size);
+	}
 
 	// check labels for consistency
 	if (!gensvm_check_outcome_contiguous(traindata)) {
@@ -157,14 +255,16 @@ int main(int argc, char **argv)
 	model->data_file = Calloc(char, GENSVM_MAX_LINE_LENGTH);
 	strcpy(model->data_file, training_inputfile);
 
-	// check if we are sparse and want nonlinearity
-	if (traindata->Z == NULL && model->kerneltype != K_LINEAR) {
-		err("[GenSVM Warning]: Sparse matrices with nonlinear kernels "
-				"are not yet supported. Dense matrices will "
-				"be used.\n");
-		traindata->RAW = gensvm_sparse_to_dense(traindata->spZ);
-		traindata->Z = traindata->RAW;
-		gensvm_free_sparse(traindata->spZ);
+	// read the precomputed kernel matrix if needed
+	if (model->kerneltype == K_PRECOMPUTED) {
+		if (train_kernelfile == NULL || (testing_inputfile != NULL &&
+					test_kernelfile == NULL)) {
+			err("[GenSVM Error]: Precomputed kernel requires "
+					"kernel files for the train and test "
+					"data (-K and -T).\n");
+			exit(EXIT_FAILURE);
+		}
+		gensvm_read_kernel(traindata, train_kernelfile, traindata->n);
 	}
 
 	// load a seed model from file if it is specified
@@ -176,29 +276,38 @@ int main(int argc, char **argv)
 	// train the GenSVM model
 	gensvm_train(model, traindata, seed_model);
 
+	// store the training data and collapsed coefficients needed for 
+	// prediction with a nonlinear kernel
+	gensvm_kernel_store_basis(model, traindata);
+
 	// if we also have a test set, predict labels and write to predictions
 	// to an output file if specified
 	if (testing_inputfile != NULL) {
-		// read the test data
+		// read the test data, with the same hashing and columns as 
+		// the training data
+		testdata->hash_bits = model->hash_bits;
+		testdata->hash_signed = model->hash_signed;
+		if (model->col_map != NULL) {
+			testdata->col_map_size = model->col_map_size;
+			testdata->col_map = Malloc(long,
+					model->col_map_size);
+			memcpy(testdata->col_map, model->col_map,
+					model->col_map_size*sizeof(long));
+		}
 		if (libsvm_format)
 			gensvm_read_data_libsvm(testdata, testing_inputfile);
 		else
 			gensvm_read_data(testdata, testing_inputfile);
 
-		// check if we are sparse and want nonlinearity
-		if (testdata->Z == NULL && model->kerneltype != K_LINEAR) {
-			err("[GenSVM Warning]: Sparse matrices with nonlinear "
-					"kernels are not yet supported. Dense "
-					"matrices will be used.\n");
-			testdata->Z = gensvm_sparse_to_dense(testdata->spZ);
-			gensvm_free_sparse(testdata->spZ);
-		}
-
-		gensvm_kernel_postprocess(model, traindata, testdata);
+		if (model->kerneltype == K_PRECOMPUTED)
+			gensvm_read_kernel(testdata, test_kernelfile,
+					traindata->n);
 
-		// predict labels
+		// predict labels, and class scores if they're written
 		predy = Calloc(long, testdata->n);
-		gensvm_predict_labels(testdata, model, predy);
+		if (format == P_SCORES)
+			scores = Calloc(double, testdata->n*model->K);
+		gensvm_predict_scores(testdata, model, predy, scores);
 
 		if (testdata->y != NULL) {
 			performance = gensvm_prediction_perf(testdata, predy);
@@ -207,8 +316,12 @@ int main(int argc, char **argv)
 
 		// if output file is specified, write predictions to it
 		if (gensvm_check_argv_eq(argc, argv, "-o")) {
-			gensvm_write_predictions(testdata, predy,
-				       	prediction_outputfile);
+			writer = gensvm_writer_open(prediction_outputfile);
+			gensvm_write_predictions_header(writer, testdata->n,
+					testdata->m, format);
+			gensvm_write_predictions_chunk(writer, testdata,
+					predy, scores, model->K, format);
+			gensvm_writer_close(writer);
 			note("Prediction written to: %s\n",
 				       	prediction_outputfile);
 		} else {
@@ -220,7 +333,10 @@ int main(int argc, char **argv)
 
 	// write model to output file if necessary
 	if (gensvm_check_argv_eq(argc, argv, "-m")) {
-		gensvm_write_model(model, model_outputfile);
+		if (gensvm_check_argv_eq(argc, argv, "-B"))
+			gensvm_write_model_binary(model, model_outputfile);
+		else
+			gensvm_write_model(model, model_outputfile);
 		note("Model written to: %s\n", model_outputfile);
 	}
 
@@ -234,12 +350,132 @@ int main(int argc, char **argv)
 	free(model_inputfile);
 	free(model_outputfile);
 	free(prediction_outputfile);
+	free(train_kernelfile);
+	free(test_kernelfile);
 
 	free(predy);
+	free(scores);
 
 	return 0;
 }
 
+/**
+ * @brief Predict the labels of a data file with a saved model
+ *
+ * @details
+ * The model is read from file, and the data file is read and predicted in 
+ * chunks of GENSVM_PREDICT_CHUNK_SIZE instances with 
+ * gensvm_read_data_chunk(), so the memory needed doesn't depend on the size 
+ * of the data file. The predictions are written after every chunk, either 
+ * to the output file in the given format (see 
+ * gensvm_write_predictions_chunk()), or to stdout. If the data file has 
+ * labels the predictive performance is reported.
+ *
+ * If quantized is true and the model is linear, the labels are predicted 
+ * with gensvm_quant_predict_labels(), which gives the same labels. This is 
+ * not used when the class scores are written.
+ *
+ * @param[in] 	model_inputfile 	filename of the model
+ * @param[in] 	data_file 		filename of the data to predict
+ * @param[in] 	prediction_outputfile 	filename for the predictions, or
+ * 					NULL to write them to stdout
+ * @param[in] 	libsvm_format 		whether the data file is in LibSVM
+ * 					format
+ * @param[in] 	format 			format of the prediction file
+ * @param[in] 	quantized 		whether to predict with quantized
+ * 					weights
+ */
+void predict_only(char *model_inputfile, char *data_file,
+		char *prediction_outputfile, bool libsvm_format,
+		PredictionFormat format, bool quantized)
+{
+	long i, n, m, n_total = 0,
+	     correct = 0,
+	     *predy = NULL;
+	double *scores = NULL;
+	bool has_labels = false;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+	struct GenWriter *writer = NULL;
+	struct GenQuantModel *qmodel = NULL;
+
+	gensvm_read_model(model, model_inputfile);
+	if (model->kerneltype == K_PRECOMPUTED) {
+		err("[GenSVM Error]: Predict-only mode is not supported for "
+				"a precomputed kernel.\n");
+		exit(EXIT_FAILURE);
+	}
+	if (model->kerneltype != K_LINEAR && model->W == NULL) {
+		err("[GenSVM Error]: Model file %s has no basis for "
+				"prediction.\n", model_inputfile);
+		exit(EXIT_FAILURE);
+	}
+	m = (model->kerneltype == K_LINEAR) ? model->m : model->basis->m;
+
+	reader = gensvm_open_data_reader(data_file, libsvm_format, m,
+			model->hash_bits, model->hash_signed, model->col_map);
+
+	if (prediction_outputfile != NULL) {
+		writer = gensvm_writer_open(prediction_outputfile);
+		gensvm_write_predictions_header(writer, reader->n, m, format);
+	} else {
+		writer = gensvm_writer_init(stdout);
+	}
+
+	predy = Malloc(long, GENSVM_PREDICT_CHUNK_SIZE);
+	if (prediction_outputfile != NULL && format == P_SCORES)
+		scores = Malloc(double, GENSVM_PREDICT_CHUNK_SIZE*model->K);
+	if (quantized && scores == NULL) {
+		qmodel = gensvm_quantize_model(model);
+		if (qmodel == NULL)
+			note("Quantized prediction is only available for "
+					"linear models.\n");
+	}
+
+	while ((n = gensvm_read_data_chunk(reader, chunk,
+					GENSVM_PREDICT_CHUNK_SIZE)) > 0) {
+		if (qmodel != NULL)
+			gensvm_quant_predict_labels(chunk, qmodel, predy);
+		else
+			gensvm_predict_scores(chunk, model, predy, scores);
+
+		if (chunk->y != NULL) {
+			has_labels = true;
+			for (i=0; i<n; i++)
+				correct += (chunk->y[i] == predy[i]);
+		}
+		n_total += n;
+
+		if (prediction_outputfile != NULL) {
+			gensvm_write_predictions_chunk(writer, chunk, predy,
+					scores, model->K, format);
+		} else {
+			for (i=0; i<n; i++) {
+				gensvm_writer_long(writer, predy[i]);
+				gensvm_writer_char(writer, ' ');
+			}
+		}
+	}
+
+	if (prediction_outputfile == NULL)
+		gensvm_writer_char(writer, '\n');
+	gensvm_writer_close(writer);
+
+	if (has_labels && n_total > 0)
+		note("Predictive performance: %3.2f%%\n",
+				((double) correct)/((double) n_total) * 100.0);
+	if (prediction_outputfile != NULL)
+		note("Prediction written to: %s\n", prediction_outputfile);
+
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+	gensvm_free_quant_model(qmodel);
+	gensvm_free_model(model);
+	free(predy);
+	free(scores);
+}
+
 /**
  * @brief Exit with warning about invalid parameter value.
  *
@@ -269,12 +505,18 @@ void exit_invalid_param(const char *label, char **argv)
  * @param[out] 	 testing_inputfile 	filename for the test data
  * @param[out] 	 model_outputfile 	filename for the output model
  * @param[out] 	 prediction_outputfile 	filename for the predictions
+ * @param[out] 	 train_kernelfile 	filename for the precomputed train
+ * 					kernel
+ * @param[out] 	 test_kernelfile 	filename for the precomputed test
+ * 					kernel
+ * @param[out] 	 format 		format of the prediction file
  *
  */
 void parse_command_line(int argc, char **argv, struct GenModel *model,
 		char **model_inputfile, char **training_inputfile,
 	       	char **testing_inputfile, char **model_outputfile,
-	       	char **prediction_outputfile)
+	       	char **prediction_outputfile, char **train_kernelfile,
+		char **test_kernelfile, PredictionFormat *format)
 {
 	int i;
 
@@ -289,6 +531,12 @@ void parse_command_line(int argc, char **argv, struct GenModel *model,
 			exit_with_help(argv);
 		}
 		switch (argv[i-1][1]) {
+			case 'B':
+				i--;
+				break;
+			case 'C':
+				i--;
+				break;
 			case 'c':
 				model->coef = atof(argv[i]);
 				break;
@@ -300,12 +548,28 @@ void parse_command_line(int argc, char **argv, struct GenModel *model,
 				if (model->epsilon <= 0)
 					exit_invalid_param("epsilon", argv);
 				break;
+			case 'f':
+				*format = atoi(argv[i]);
+				if (*format < P_DATA || *format > P_BINARY)
+					exit_invalid_param("format", argv);
+				break;
 			case 'g':
 				model->gamma = atof(argv[i]);
 				break;
+			case 'H':
+				model->hash_bits = atoi(argv[i]);
+				if (model->hash_bits < 1 || model->hash_bits >
+						GENSVM_PARSE_MAX_HASH_BITS)
+					exit_invalid_param("bits", argv);
+				break;
 			case 'i':
 				model->max_iter = atoi(argv[i]);
 				break;
+			case 'K':
+				(*train_kernelfile) = Malloc(char,
+						strlen(argv[i])+1);
+				strcpy((*train_kernelfile), argv[i]);
+				break;
 			case 'k':
 				model->kappa = atof(argv[i]);
 				if (model->kappa <= -1.0)
@@ -331,17 +595,38 @@ void parse_command_line(int argc, char **argv, struct GenModel *model,
 						strlen(argv[i])+1);
 				strcpy((*prediction_outputfile), argv[i]);
 				break;
+			case 'P':
+				i--;
+				break;
 			case 'p':
 				model->p = atof(argv[i]);
 				if (model->p < 1.0 || model->p > 2.0)
 					exit_invalid_param("p", argv);
 				break;
+			case 'R':
+				model->basis_tol = atof(argv[i]);
+				if (model->basis_tol < 0 ||
+						model->basis_tol > 1)
+					exit_invalid_param("tolerance", argv);
+				break;
 			case 'r':
 				model->weight_idx = atoi(argv[i]);
 				break;
+			case 'S':
+				model->hash_signed = true;
+				i--;
+				break;
+			case 'T':
+				(*test_kernelfile) = Malloc(char,
+						strlen(argv[i])+1);
+				strcpy((*test_kernelfile), argv[i]);
+				break;
 			case 't':
 				model->kerneltype = atoi(argv[i]);
 				break;
+			case 'Q':
+				i--;
+				break;
 			case 'q':
 				GENSVM_OUTPUT_FILE = NULL;
 				GENSVM_ERROR_FILE = NULL;
@@ -30,6 +30,8 @@
 
  */
 
+#include <sys/mman.h>
+
 #include "gensvm_base.h"
 
 /**
@@ -50,12 +52,22 @@ struct GenData *gensvm_init_data(void)
 	data->Z = NULL;
 	data->spZ = NULL;
 	data->RAW = NULL;
+	data->kernel = NULL;
+	data->map = NULL;
+	data->map_size = 0;
 
 	// set default values
 	data->kerneltype = K_LINEAR;
 	data->gamma = -1;
 	data->coef = -1;
 	data->degree = -1;
+	data->hash_bits = 0;
+	data->hash_signed = false;
+	data->compact = false;
+	data->col_map = NULL;
+	data->col_map_size = 0;
+	data->wrapped = false;
+	data->view = false;
 
 	return data;
 }
@@ -75,6 +87,29 @@ void gensvm_free_data(struct GenData *data)
 	if (data == NULL)
 		return;
 
+	gensvm_unmap_data(data);
+
+	// the instances of wrapped data belong to the caller
+	if (data->wrapped) {
+		free(data->spZ);
+		data->spZ = NULL;
+		if (data->Z == data->RAW)
+			data->Z = NULL;
+		data->RAW = NULL;
+	}
+
+	// the instances of a view belong to a GenFolds, only the row
+	// pointers of a sparse view are its own
+	if (data->view) {
+		if (data->spZ != NULL)
+			free(data->spZ->ia);
+		free(data->spZ);
+		data->spZ = NULL;
+		if (data->Z == data->RAW)
+			data->Z = NULL;
+		data->RAW = NULL;
+	}
+
 	if (data->spZ != NULL)
 		gensvm_free_sparse(data->spZ);
 
@@ -86,10 +121,204 @@ void gensvm_free_data(struct GenData *data)
 	}
 	free(data->y);
 	free(data->Sigma);
+	free(data->kernel);
+	free(data->col_map);
 	free(data);
 	data = NULL;
 }
 
+/**
+ * @brief Unmap the data file of a GenData
+ *
+ * @details
+ * Data that is read from a binary data file uses the arrays in the memory 
+ * mapped file directly (see gensvm_read_data_binary()). This function 
+ * unmaps the file, and sets the pointers to arrays in the file to NULL, such 
+ * that the remaining arrays can be freed with gensvm_free_data(). Nothing is 
+ * done if the data isn't memory mapped.
+ *
+ * @param[in] 	data 	GenData to unmap
+ */
+void gensvm_unmap_data(struct GenData *data)
+{
+	char *start = data->map,
+	     *end = start + data->map_size;
+
+	if (data->map == NULL)
+		return;
+
+	if ((char *) data->y >= start && (char *) data->y < end)
+		data->y = NULL;
+	if ((char *) data->RAW >= start && (char *) data->RAW < end) {
+		if (data->Z == data->RAW)
+			data->Z = NULL;
+		data->RAW = NULL;
+	}
+	if (data->spZ != NULL && (char *) data->spZ->values >= start &&
+			(char *) data->spZ->values < end) {
+		data->spZ->values = NULL;
+		data->spZ->ia = NULL;
+		data->spZ->ja = NULL;
+	}
+
+	munmap(data->map, data->map_size);
+	data->map = NULL;
+	data->map_size = 0;
+}
+
+/**
+ * @brief Wrap a dense matrix of the caller in a GenData without copying
+ *
+ * @details
+ * This is used to train or predict on data that is already in memory, 
+ * without building the augmented data matrix. The instances are the rows of 
+ * the row-major n x m matrix X, without the column of ones. GenData::Z and 
+ * GenData::RAW point to X, and GenData::wrapped is set, such that the column 
+ * of ones is implied by gensvm_calculate_ZV() and gensvm_get_ZAZ_ZB(), and X 
+ * isn't freed by gensvm_free_data(). The nonlinear kernels need the 
+ * augmented matrix, and copy the data with gensvm_unwrap_data() first. The 
+ * labels are copied, X should be kept until the GenData is freed.
+ *
+ * @param[in] 	n 	number of instances
+ * @param[in] 	m 	number of features
+ * @param[in] 	X 	row-major n x m matrix of the instances
+ * @param[in] 	y 	labels of the instances (1..K), or NULL
+ * @returns 		a GenData with the instances of X
+ */
+struct GenData *gensvm_wrap_dense(long n, long m, double *X, long *y)
+{
+	struct GenData *data = gensvm_init_data();
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+	data->RAW = X;
+	data->Z = X;
+	data->wrapped = true;
+	gensvm_wrap_labels(data, y);
+
+	return data;
+}
+
+/**
+ * @brief Wrap a CSR matrix of the caller in a GenData without copying
+ *
+ * @details
+ * As gensvm_wrap_dense(), but for an n x m sparse matrix in compressed row 
+ * format with 0-based column indices, which is used as GenData::spZ. The 
+ * column of ones is implied, so it takes no nonzeros. The columns of every 
+ * row should be increasing, as gensvm_get_ZAZ_ZB_sparse() expects.
+ *
+ * @param[in] 	n 	number of instances
+ * @param[in] 	m 	number of features
+ * @param[in] 	values 	nonzero values, ia[n] elements
+ * @param[in] 	ia 	row pointers, n+1 elements with ia[0] = 0
+ * @param[in] 	ja 	0-based column indices, ia[n] elements
+ * @param[in] 	y 	labels of the instances (1..K), or NULL
+ * @returns 		a GenData with the instances of the CSR matrix
+ */
+struct GenData *gensvm_wrap_csr(long n, long m, double *values, long *ia,
+		long *ja, long *y)
+{
+	struct GenData *data = gensvm_init_data();
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+	data->spZ = gensvm_init_sparse();
+	data->spZ->nnz = ia[n];
+	data->spZ->n_row = n;
+	data->spZ->n_col = m;
+	data->spZ->values = values;
+	data->spZ->ia = ia;
+	data->spZ->ja = ja;
+	data->wrapped = true;
+	gensvm_wrap_labels(data, y);
+
+	return data;
+}
+
+/**
+ * @brief Copy the labels of the caller to a wrapped GenData
+ *
+ * @details
+ * The labels are copied to GenData::y, and the number of classes is set to 
+ * the largest label. Nothing is done if y is NULL.
+ *
+ * @param[in,out] 	data 	a GenData with GenData::n set
+ * @param[in] 		y 	labels of the instances, or NULL
+ */
+void gensvm_wrap_labels(struct GenData *data, long *y)
+{
+	long i;
+
+	if (y == NULL)
+		return;
+
+	data->y = Malloc(long, data->n);
+	data->K = 0;
+	for (i=0; i<data->n; i++) {
+		data->y[i] = y[i];
+		data->K = maximum(data->K, y[i]);
+	}
+}
+
+/**
+ * @brief Copy wrapped instances to an augmented data matrix
+ *
+ * @details
+ * The instances of a GenData of gensvm_wrap_dense() or gensvm_wrap_csr() are 
+ * copied to arrays that are owned by the GenData, with the explicit column 
+ * of ones in the first column, as if the data was read from a file. This is 
+ * used by the routines that don't handle the implicit column of ones, such 
+ * as the nonlinear kernels. Nothing is done if the data isn't wrapped.
+ *
+ * @param[in,out] 	data 	a GenData
+ */
+void gensvm_unwrap_data(struct GenData *data)
+{
+	long i, jj, nnz,
+	     n = data->n,
+	     m = data->m;
+	struct GenSparse *spZ = data->spZ;
+	double *values = NULL;
+	long *ia = NULL,
+	     *ja = NULL;
+
+	if (!data->wrapped)
+		return;
+
+	if (spZ == NULL) {
+		data->RAW = Malloc(double, n*(m+1));
+		for (i=0; i<n; i++) {
+			data->RAW[i*(m+1)] = 1.0;
+			memcpy(&data->RAW[i*(m+1)+1], &data->Z[i*m],
+					m*sizeof(double));
+		}
+		data->Z = data->RAW;
+	} else {
+		values = Malloc(double, spZ->nnz + n);
+		ja = Malloc(long, spZ->nnz + n);
+		ia = Malloc(long, n+1);
+		ia[0] = nnz = 0;
+		for (i=0; i<n; i++) {
+			values[nnz] = 1.0;
+			ja[nnz++] = 0;
+			for (jj=spZ->ia[i]; jj<spZ->ia[i+1]; jj++) {
+				values[nnz] = spZ->values[jj];
+				ja[nnz++] = spZ->ja[jj] + 1;
+			}
+			ia[i+1] = nnz;
+		}
+		spZ->values = values;
+		spZ->ia = ia;
+		spZ->ja = ja;
+		spZ->nnz = nnz;
+		spZ->n_col = m+1;
+	}
+	data->wrapped = false;
+}
+
 /**
  * @brief Initialize a GenModel structure
  *
@@ -118,11 +347,16 @@ struct GenModel *gensvm_init_model(void)
 	model->degree = 2.0;
 	model->kerneltype = K_LINEAR;
 	model->kernel_eigen_cutoff = 1e-8;
+	model->basis_tol = 0.0;
 	model->max_iter = 1000000000;
 	model->training_error = -1;
 	model->elapsed_iter = -1;
 	model->status = -1;
 	model->seed = -1;
+	model->hash_bits = 0;
+	model->hash_signed = false;
+	model->col_map = NULL;
+	model->col_map_size = 0;
 
 	model->V = NULL;
 	model->Vbar = NULL;
@@ -132,6 +366,10 @@ struct GenModel *gensvm_init_model(void)
 	model->H = NULL;
 	model->rho = NULL;
 	model->data_file = NULL;
+	model->basis = NULL;
+	model->W = NULL;
+	model->map = NULL;
+	model->map_size = 0;
 
 	return model;
 }
@@ -218,6 +456,8 @@ void gensvm_free_model(struct GenModel *model)
 	if (model == NULL)
 		return;
 
+	gensvm_unmap_model(model);
+
 	free(model->V);
 	free(model->Vbar);
 	free(model->U);
@@ -226,11 +466,58 @@ void gensvm_free_model(struct GenModel *model)
 	free(model->H);
 	free(model->rho);
 	free(model->data_file);
+	gensvm_free_data(model->basis);
+	free(model->W);
+	free(model->col_map);
 
 	free(model);
 	model = NULL;
 }
 
+/**
+ * @brief Unmap the model file of a GenModel
+ *
+ * @details
+ * A model that is read from a binary model file uses the arrays in the 
+ * memory mapped file directly (see gensvm_read_model_binary()). This 
+ * function unmaps the file, and sets the pointers to arrays in the file to 
+ * NULL, such that the remaining arrays can be freed with 
+ * gensvm_free_model(). Nothing is done if the model isn't memory mapped.
+ *
+ * @param[in] 	model 	GenModel to unmap
+ */
+void gensvm_unmap_model(struct GenModel *model)
+{
+	char *start = model->map,
+	     *end = start + model->map_size;
+	struct GenData *basis = model->basis;
+
+	if (model->map == NULL)
+		return;
+
+	if ((char *) model->V >= start && (char *) model->V < end)
+		model->V = NULL;
+	if ((char *) model->W >= start && (char *) model->W < end)
+		model->W = NULL;
+	if (basis != NULL) {
+		if ((char *) basis->RAW >= start && (char *) basis->RAW < end) {
+			if (basis->Z == basis->RAW)
+				basis->Z = NULL;
+			basis->RAW = NULL;
+		}
+		if (basis->spZ != NULL && (char *) basis->spZ->values >= start
+				&& (char *) basis->spZ->values < end) {
+			basis->spZ->values = NULL;
+			basis->spZ->ia = NULL;
+			basis->spZ->ja = NULL;
+		}
+	}
+
+	munmap(model->map, model->map_size);
+	model->map = NULL;
+	model->map_size = 0;
+}
+
 /**
  * @brief Initialize the workspace structure
  *
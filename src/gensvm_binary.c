@@ -0,0 +1,891 @@
+/**
+ * @file gensvm_binary.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for reading and writing binary model and data files
+ *
+ * @details
+ * The binary model file holds a GenModelHeader followed by the arrays of
+ * the model in their in-memory representation. Writing a model is therefore
+ * a few calls to fwrite(), and reading a model maps the file into memory and
+ * uses the arrays directly, so no numbers have to be parsed. The text format
+ * of gensvm_write_model() remains available, and gensvm_read_model() reads
+ * both formats. Binary data files work in the same way, with a
+ * GenDataHeader followed by the labels and the instances, and are read by
+ * gensvm_read_data() and gensvm_read_data_libsvm() as well.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "gensvm_binary.h"
+
+/**
+ * @brief Check if a file is a binary model file
+ *
+ * @param[in] 	model_filename 	filename of the model file
+ * @returns 			whether the file starts with
+ * 				GENSVM_BINARY_MODEL_MAGIC
+ */
+bool gensvm_is_binary_model(char *model_filename)
+{
+	return gensvm_binary_has_magic(model_filename,
+			GENSVM_BINARY_MODEL_MAGIC);
+}
+
+/**
+ * @brief Read a model from a binary model file
+ *
+ * @details
+ * The file is mapped into memory with mmap() and the header is checked with
+ * gensvm_check_model_header() and the checksum. GenModel::V, GenModel::W
+ * and the basis instances then point into the mapped file, which is
+ * recorded in GenModel::map and unmapped by gensvm_free_model(). The file is
+ * mapped privately, so the arrays can be changed without changing the file.
+ * The column map of the model, if any, is copied to GenModel::col_map.
+ * A dense basis is used as GenData::RAW and a sparse basis as GenData::spZ,
+ * as in gensvm_read_model_basis(). The simplex matrix is generated, such
+ * that the model can be used for prediction directly.
+ *
+ * A file that can't be mapped or that is truncated, invalid or corrupted
+ * gives an error message and false, and leaves the model unchanged.
+ *
+ * @param[in,out] 	model 		initialized GenModel
+ * @param[in] 		model_filename 	filename of the binary model file
+ * @returns 				whether the model was read
+ */
+bool gensvm_read_model_binary(struct GenModel *model, char *model_filename)
+{
+	long K;
+	uint64_t size;
+	char *map = NULL;
+	struct GenModelHeader header;
+	struct GenData *basis = NULL;
+	struct GenSparse *spZ = NULL;
+
+	if (!gensvm_binary_map(model_filename, &map, &size))
+		return false;
+	if (size < sizeof(struct GenModelHeader)) {
+		err("[GenSVM Error]: Model file %s is truncated.\n",
+				model_filename);
+		if (map != NULL)
+			munmap(map, size);
+		return false;
+	}
+	memcpy(&header, map, sizeof(struct GenModelHeader));
+	if (!gensvm_check_model_header(&header, size) ||
+			!gensvm_binary_verify(map, size, offsetof(
+					struct GenModelHeader, checksum))) {
+		err("[GenSVM Error]: Model file %s is invalid or "
+				"corrupted.\n", model_filename);
+		munmap(map, size);
+		return false;
+	}
+
+	model->map = map;
+	model->map_size = size;
+
+	model->n = header.n;
+	model->m = header.m;
+	model->K = K = header.K;
+	model->kerneltype = header.kerneltype;
+	model->weight_idx = header.weight_idx;
+	model->p = header.p;
+	model->lambda = header.lambda;
+	model->kappa = header.kappa;
+	model->epsilon = header.epsilon;
+	model->gamma = header.gamma;
+	model->coef = header.coef;
+	model->degree = header.degree;
+	model->kernel_eigen_cutoff = header.kernel_eigen_cutoff;
+	model->hash_bits = header.hash_bits;
+	model->hash_signed = header.hash_signed != 0;
+	if (header.col_map_size > 0) {
+		model->col_map_size = header.col_map_size;
+		model->col_map = Malloc(long, header.col_map_size);
+		memcpy(model->col_map, map + header.col_map_offset,
+				header.col_map_size*sizeof(long));
+	}
+
+	model->data_file = Calloc(char, GENSVM_MAX_LINE_LENGTH);
+	memcpy(model->data_file, map + header.data_file_offset,
+			minimum(header.data_file_length,
+				GENSVM_MAX_LINE_LENGTH - 1));
+
+	model->V = (double *) (map + header.V_offset);
+
+	if (header.basis_n > 0) {
+		basis = gensvm_init_data();
+		basis->n = header.basis_n;
+		basis->m = header.basis_m;
+		basis->r = model->m;
+		basis->K = K;
+		gensvm_kernel_copy_kernelparam_to_data(model, basis);
+		model->basis = basis;
+		model->W = (double *) (map + header.W_offset);
+
+		if (header.basis_format == 1) {
+			basis->RAW = (double *) (map + header.RAW_offset);
+		} else if (header.basis_format == 2) {
+			spZ = gensvm_init_sparse();
+			spZ->nnz = header.basis_nnz;
+			spZ->n_row = header.basis_n;
+			spZ->n_col = header.basis_m + 1;
+			spZ->values = (double *) (map + header.values_offset);
+			spZ->ia = (long *) (map + header.ia_offset);
+			spZ->ja = (long *) (map + header.ja_offset);
+			basis->spZ = spZ;
+		}
+	}
+
+	model->U = Calloc(double, K*(K-1));
+	gensvm_simplex(model);
+
+	return true;
+}
+
+/**
+ * @brief Write a model to a binary model file
+ *
+ * @details
+ * The model is written as a GenModelHeader followed by the data filename,
+ * GenModel::V and, for a model with a basis (see gensvm_write_model()),
+ * GenModel::W and the basis instances, and GenModel::col_map for a model
+ * with a column map. Every array starts at a multiple of
+ * GENSVM_BINARY_ALIGN bytes. The checksum is computed while the file is
+ * written, and written to the header at the end. The file is written to
+ * a temporary file that replaces the output file when it is complete (see
+ * gensvm_binary_open_temp()), such that a reader that maps the old file
+ * is not affected.
+ *
+ * @param[in] 	model 		GenModel which contains an estimate for
+ * 				GenModel::V
+ * @param[in] 	output_filename the output file to write the model to
+ */
+void gensvm_write_model_binary(struct GenModel *model, char *output_filename)
+{
+	long i, K = model->K;
+	bool written;
+	uint64_t hash,
+		 sizes[8],
+		 offsets[8];
+	const void *arrays[8];
+	char *data_file = NULL,
+	     *temp_filename = NULL;
+	struct GenData *basis = NULL;
+	struct GenModelHeader header;
+	FILE *fid = NULL;
+
+	memset(&header, 0, sizeof(struct GenModelHeader));
+	memcpy(header.magic, GENSVM_BINARY_MODEL_MAGIC, 8);
+	header.version = GENSVM_BINARY_MODEL_VERSION;
+	header.byte_order = GENSVM_BINARY_BYTE_ORDER;
+	header.header_size = sizeof(struct GenModelHeader);
+	header.n = model->n;
+	header.m = model->m;
+	header.K = K;
+	header.kerneltype = model->kerneltype;
+	header.weight_idx = model->weight_idx;
+	header.p = model->p;
+	header.lambda = model->lambda;
+	header.kappa = model->kappa;
+	header.epsilon = model->epsilon;
+	header.gamma = model->gamma;
+	header.coef = model->coef;
+	header.degree = model->degree;
+	header.kernel_eigen_cutoff = model->kernel_eigen_cutoff;
+	header.hash_bits = model->hash_bits;
+	header.hash_signed = model->hash_signed;
+
+	// the arrays in the order in which they are written
+	for (i=0; i<8; i++) {
+		arrays[i] = NULL;
+		sizes[i] = 0;
+	}
+	// the data filename is padded with zeros to a multiple of 8 bytes, 
+	// such that all parts of the file have a multiple of 8 bytes
+	header.data_file_length = (model->data_file != NULL) ?
+		strlen(model->data_file) : 0;
+	sizes[0] = (header.data_file_length + 7) / 8 * 8;
+	data_file = Calloc(char, sizes[0] + 1);
+	if (model->data_file != NULL)
+		strcpy(data_file, model->data_file);
+	arrays[0] = data_file;
+	arrays[1] = model->V;
+	sizes[1] = (model->m+1)*(K-1)*sizeof(double);
+	if (model->basis != NULL && model->W != NULL) {
+		basis = model->basis;
+		header.basis_n = basis->n;
+		header.basis_m = basis->m;
+		arrays[2] = model->W;
+		sizes[2] = basis->n*(K-1)*sizeof(double);
+		if (basis->RAW != NULL) {
+			header.basis_format = 1;
+			arrays[3] = basis->RAW;
+			sizes[3] = basis->n*(basis->m+1)*sizeof(double);
+		} else if (basis->spZ != NULL) {
+			header.basis_format = 2;
+			header.basis_nnz = basis->spZ->nnz;
+			arrays[4] = basis->spZ->values;
+			sizes[4] = basis->spZ->nnz*sizeof(double);
+			arrays[5] = basis->spZ->ia;
+			sizes[5] = (basis->n+1)*sizeof(long);
+			arrays[6] = basis->spZ->ja;
+			sizes[6] = basis->spZ->nnz*sizeof(long);
+		}
+	}
+	if (model->col_map != NULL) {
+		header.col_map_size = model->col_map_size;
+		arrays[7] = model->col_map;
+		sizes[7] = model->col_map_size*sizeof(long);
+	}
+
+	header.file_size = gensvm_binary_offsets(sizeof(struct GenModelHeader),
+			sizes, 8, offsets);
+	header.data_file_offset = offsets[0];
+	header.V_offset = offsets[1];
+	header.W_offset = offsets[2];
+	header.RAW_offset = offsets[3];
+	header.values_offset = offsets[4];
+	header.ia_offset = offsets[5];
+	header.ja_offset = offsets[6];
+	header.col_map_offset = offsets[7];
+
+	fid = gensvm_binary_open_temp(output_filename, &temp_filename);
+
+	// write the header, followed by the padded arrays
+	hash = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, &header,
+			sizeof(struct GenModelHeader));
+	written = (fwrite(&header, sizeof(struct GenModelHeader), 1, fid) == 1)
+		&& gensvm_binary_write_arrays(fid, &hash,
+				sizeof(struct GenModelHeader), arrays, sizes, 8,
+				header.file_size);
+
+	// write the checksum
+	written = written && fseek(fid, offsetof(struct GenModelHeader,
+				checksum), SEEK_SET) == 0 &&
+		fwrite(&hash, sizeof(uint64_t), 1, fid) == 1;
+	free(data_file);
+
+	gensvm_binary_close_temp(fid, temp_filename, output_filename,
+			written);
+}
+
+/**
+ * @brief Check the header of a binary model file
+ *
+ * @details
+ * The magic bytes, the version, the byte order and the sizes in the header
+ * are checked, and it is checked that all arrays fit in the file and are
+ * aligned. Files of a different version or written on a machine with a
+ * different byte order or size of long are rejected.
+ *
+ * @param[in] 	header 		header of the model file
+ * @param[in] 	file_size 	size of the model file in bytes
+ * @returns 			whether the header is valid
+ */
+bool gensvm_check_model_header(struct GenModelHeader *header,
+		uint64_t file_size)
+{
+	long i;
+	uint64_t K, n_b, m_b, nnz,
+		 offsets[8],
+		 sizes[8];
+
+	if (memcmp(header->magic, GENSVM_BINARY_MODEL_MAGIC, 8) != 0 ||
+			header->version != GENSVM_BINARY_MODEL_VERSION ||
+			header->byte_order != GENSVM_BINARY_BYTE_ORDER ||
+			header->header_size != sizeof(struct GenModelHeader) ||
+			header->file_size != file_size)
+		return false;
+	if (header->n < 0 || header->m < 0 || header->K < 2 ||
+			header->basis_n < 0 || header->basis_m < 0 ||
+			header->basis_nnz < 0 || header->basis_format < 0 ||
+			header->basis_format > 2 || header->col_map_size < 0)
+		return false;
+	if ((header->basis_format == 2 || header->col_map_size > 0) &&
+			sizeof(long) != sizeof(int64_t))
+		return false;
+
+	K = header->K;
+	n_b = header->basis_n;
+	m_b = header->basis_m;
+	nnz = header->basis_nnz;
+
+	offsets[0] = header->data_file_offset;
+	sizes[0] = header->data_file_length;
+	offsets[1] = header->V_offset;
+	sizes[1] = (header->m+1)*(K-1)*sizeof(double);
+	offsets[2] = header->W_offset;
+	sizes[2] = n_b*(K-1)*sizeof(double);
+	offsets[3] = header->RAW_offset;
+	sizes[3] = (header->basis_format == 1) ? n_b*(m_b+1)*sizeof(double)
+		: 0;
+	offsets[4] = header->values_offset;
+	sizes[4] = (header->basis_format == 2) ? nnz*sizeof(double) : 0;
+	offsets[5] = header->ia_offset;
+	sizes[5] = (header->basis_format == 2) ? (n_b+1)*sizeof(int64_t) : 0;
+	offsets[6] = header->ja_offset;
+	sizes[6] = (header->basis_format == 2) ? nnz*sizeof(int64_t) : 0;
+	offsets[7] = header->col_map_offset;
+	sizes[7] = header->col_map_size*sizeof(int64_t);
+
+	for (i=0; i<8; i++) {
+		if (offsets[i] % GENSVM_BINARY_ALIGN != 0 ||
+				offsets[i] < header->header_size ||
+				offsets[i] > file_size ||
+				sizes[i] > file_size - offsets[i])
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Check if a file is a binary data file
+ *
+ * @param[in] 	data_file 	filename of the data file
+ * @returns 			whether the file starts with
+ * 				GENSVM_BINARY_DATA_MAGIC
+ */
+bool gensvm_is_binary_data(char *data_file)
+{
+	return gensvm_binary_has_magic(data_file, GENSVM_BINARY_DATA_MAGIC);
+}
+
+/**
+ * @brief Read data from a binary data file
+ *
+ * @details
+ * The file is mapped into memory with gensvm_binary_map(), and the header
+ * is checked with gensvm_check_data_header() and the checksum. The labels
+ * and the instances then point into the mapped file, which is recorded in
+ * GenData::map and unmapped by gensvm_free_data(), so the data is not
+ * copied. Dense instances are used as GenData::RAW and GenData::Z, sparse
+ * instances as GenData::spZ, as with gensvm_read_data().
+ *
+ * @param[in,out] 	data 		initialized GenData
+ * @param[in] 		data_file 	filename of the binary data file
+ */
+void gensvm_read_data_binary(struct GenData *data, char *data_file)
+{
+	uint64_t size;
+	char *map = NULL;
+	struct GenDataHeader header;
+	struct GenSparse *spZ = NULL;
+
+	if (!gensvm_binary_map(data_file, &map, &size))
+		exit(EXIT_FAILURE);
+	if (size < sizeof(struct GenDataHeader)) {
+		err("[GenSVM Error]: Data file %s is truncated.\n",
+				data_file);
+		exit(EXIT_FAILURE);
+	}
+	memcpy(&header, map, sizeof(struct GenDataHeader));
+	if (!gensvm_check_data_header(&header, size) ||
+			!gensvm_binary_verify(map, size, offsetof(
+					struct GenDataHeader, checksum))) {
+		err("[GenSVM Error]: Data file %s is invalid or "
+				"corrupted.\n", data_file);
+		exit(EXIT_FAILURE);
+	}
+
+	data->map = map;
+	data->map_size = size;
+
+	data->n = header.n;
+	data->m = header.m;
+	data->r = header.m;
+	data->K = header.K;
+
+	free(data->y);
+	data->y = (header.has_labels) ? (long *) (map + header.y_offset) :
+		NULL;
+
+	if (header.format == 1) {
+		data->RAW = (double *) (map + header.RAW_offset);
+		data->Z = data->RAW;
+	} else {
+		spZ = gensvm_init_sparse();
+		spZ->nnz = header.nnz;
+		spZ->n_row = header.n;
+		spZ->n_col = header.m + 1;
+		spZ->values = (double *) (map + header.values_offset);
+		spZ->ia = (long *) (map + header.ia_offset);
+		spZ->ja = (long *) (map + header.ja_offset);
+		data->spZ = spZ;
+	}
+}
+
+/**
+ * @brief Write data to a binary data file
+ *
+ * @details
+ * The data is written as a GenDataHeader followed by the labels and the
+ * instances, either as the dense matrix GenData::RAW, or in CSR format from
+ * GenData::spZ if there is no dense matrix. Every array starts at a
+ * multiple of GENSVM_BINARY_ALIGN bytes, and the checksum is computed while
+ * the file is written. Only the raw data is written, not the result of
+ * a kernel transformation in GenData::Z. Wrapped data (see
+ * gensvm_wrap_dense()) is copied with gensvm_unwrap_data() first. As for
+ * the model file, the output file is replaced when the temporary file is
+ * complete.
+ *
+ * @param[in] 	data 		GenData with the dense or sparse instances
+ * @param[in] 	output_filename the output file to write the data to
+ */
+void gensvm_write_data_binary(struct GenData *data, char *output_filename)
+{
+	long i, n = data->n;
+	bool written;
+	uint64_t hash,
+		 sizes[5],
+		 offsets[5];
+	const void *arrays[5];
+	char *temp_filename = NULL;
+	struct GenDataHeader header;
+	FILE *fid = NULL;
+
+	gensvm_unwrap_data(data);
+
+	memset(&header, 0, sizeof(struct GenDataHeader));
+	memcpy(header.magic, GENSVM_BINARY_DATA_MAGIC, 8);
+	header.version = GENSVM_BINARY_DATA_VERSION;
+	header.byte_order = GENSVM_BINARY_BYTE_ORDER;
+	header.header_size = sizeof(struct GenDataHeader);
+	header.n = n;
+	header.m = data->m;
+	header.K = data->K;
+	header.dtype = GENSVM_BINARY_FLOAT64;
+	header.has_labels = (data->y != NULL);
+
+	// the arrays in the order in which they are written
+	for (i=0; i<5; i++) {
+		arrays[i] = NULL;
+		sizes[i] = 0;
+	}
+	if (data->y != NULL) {
+		arrays[0] = data->y;
+		sizes[0] = n*sizeof(long);
+	}
+	if (data->RAW != NULL) {
+		header.format = 1;
+		arrays[1] = data->RAW;
+		sizes[1] = n*(data->m+1)*sizeof(double);
+	} else if (data->spZ != NULL) {
+		header.format = 2;
+		header.nnz = data->spZ->nnz;
+		arrays[2] = data->spZ->values;
+		sizes[2] = data->spZ->nnz*sizeof(double);
+		arrays[3] = data->spZ->ia;
+		sizes[3] = (n+1)*sizeof(long);
+		arrays[4] = data->spZ->ja;
+		sizes[4] = data->spZ->nnz*sizeof(long);
+	} else {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: No instances to write to %s\n",
+				output_filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	header.file_size = gensvm_binary_offsets(sizeof(struct GenDataHeader),
+			sizes, 5, offsets);
+	header.y_offset = offsets[0];
+	header.RAW_offset = offsets[1];
+	header.values_offset = offsets[2];
+	header.ia_offset = offsets[3];
+	header.ja_offset = offsets[4];
+
+	fid = gensvm_binary_open_temp(output_filename, &temp_filename);
+
+	// write the header, followed by the padded arrays
+	hash = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, &header,
+			sizeof(struct GenDataHeader));
+	written = (fwrite(&header, sizeof(struct GenDataHeader), 1, fid) == 1)
+		&& gensvm_binary_write_arrays(fid, &hash,
+				sizeof(struct GenDataHeader), arrays, sizes, 5,
+				header.file_size);
+
+	// write the checksum
+	written = written && fseek(fid, offsetof(struct GenDataHeader,
+				checksum), SEEK_SET) == 0 &&
+		fwrite(&hash, sizeof(uint64_t), 1, fid) == 1;
+
+	gensvm_binary_close_temp(fid, temp_filename, output_filename,
+			written);
+}
+
+/**
+ * @brief Check the header of a binary data file
+ *
+ * @details
+ * The magic bytes, the version, the byte order, the type of the values and
+ * the sizes in the header are checked, and it is checked that all arrays
+ * fit in the file and are aligned.
+ *
+ * @param[in] 	header 		header of the data file
+ * @param[in] 	file_size 	size of the data file in bytes
+ * @returns 			whether the header is valid
+ */
+bool gensvm_check_data_header(struct GenDataHeader *header,
+		uint64_t file_size)
+{
+	long i;
+	uint64_t n, m, nnz,
+		 offsets[5],
+		 sizes[5];
+
+	if (memcmp(header->magic, GENSVM_BINARY_DATA_MAGIC, 8) != 0 ||
+			header->version != GENSVM_BINARY_DATA_VERSION ||
+			header->byte_order != GENSVM_BINARY_BYTE_ORDER ||
+			header->header_size != sizeof(struct GenDataHeader) ||
+			header->file_size != file_size ||
+			header->dtype != GENSVM_BINARY_FLOAT64 ||
+			sizeof(long) != sizeof(int64_t))
+		return false;
+	if (header->n < 1 || header->m < 1 || header->K < 0 ||
+			header->nnz < 0 || header->format < 1 ||
+			header->format > 2)
+		return false;
+
+	n = header->n;
+	m = header->m;
+	nnz = header->nnz;
+
+	offsets[0] = header->y_offset;
+	sizes[0] = (header->has_labels) ? n*sizeof(int64_t) : 0;
+	offsets[1] = header->RAW_offset;
+	sizes[1] = (header->format == 1) ? n*(m+1)*sizeof(double) : 0;
+	offsets[2] = header->values_offset;
+	sizes[2] = (header->format == 2) ? nnz*sizeof(double) : 0;
+	offsets[3] = header->ia_offset;
+	sizes[3] = (header->format == 2) ? (n+1)*sizeof(int64_t) : 0;
+	offsets[4] = header->ja_offset;
+	sizes[4] = (header->format == 2) ? nnz*sizeof(int64_t) : 0;
+
+	for (i=0; i<5; i++) {
+		if (offsets[i] % GENSVM_BINARY_ALIGN != 0 ||
+				offsets[i] < header->header_size ||
+				offsets[i] > file_size ||
+				sizes[i] > file_size - offsets[i])
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Update a checksum with a buffer
+ *
+ * @details
+ * This is the FNV-1a hash, applied to the 64-bit words of the buffer 
+ * instead of to its bytes, which is considerably faster for large files. 
+ * The size of the buffer should therefore be a multiple of 8. The hash of a 
+ * file can be computed in parts by passing the hash of the previous part, 
+ * starting with GENSVM_BINARY_CHECKSUM_INIT.
+ *
+ * @param[in] 	hash 	hash of the previous parts
+ * @param[in] 	buffer 	the buffer
+ * @param[in] 	size 	size of the buffer in bytes
+ * @returns 		the updated hash
+ */
+uint64_t gensvm_binary_checksum(uint64_t hash, const void *buffer,
+		uint64_t size)
+{
+	uint64_t i, word;
+	const char *bytes = buffer;
+
+	for (i=0; i+8<=size; i+=8) {
+		memcpy(&word, bytes + i, 8);
+		hash ^= word;
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Round an offset up to a multiple of GENSVM_BINARY_ALIGN
+ *
+ * @param[in] 	offset 	offset in bytes
+ * @returns 		smallest multiple of GENSVM_BINARY_ALIGN that is at
+ * 			least offset
+ */
+uint64_t gensvm_binary_align(uint64_t offset)
+{
+	return (offset + GENSVM_BINARY_ALIGN - 1) / GENSVM_BINARY_ALIGN *
+		GENSVM_BINARY_ALIGN;
+}
+
+/**
+ * @brief Open a temporary file next to an output file
+ *
+ * @details
+ * Binary files are mapped by the readers, and the arrays of a model or 
+ * dataset that is read stay in the mapped file (see gensvm_binary_map()). 
+ * Truncating and rewriting a file that is mapped by another process, such 
+ * as gensvm_serve, causes a bus error in that process. The binary files are 
+ * therefore written to a temporary file in the same directory as the output 
+ * file, which replaces the output file with rename() in 
+ * gensvm_binary_close_temp(). A reader keeps the old file until it is 
+ * unmapped.
+ *
+ * @param[in] 	filename 	the output file
+ * @param[out] 	temp_filename 	filename of the temporary file, to be 
+ * 				freed by gensvm_binary_close_temp()
+ * @returns 			the temporary file, opened for writing
+ */
+FILE *gensvm_binary_open_temp(char *filename, char **temp_filename)
+{
+	int fd;
+	mode_t mask;
+	FILE *fid = NULL;
+
+	*temp_filename = Calloc(char, strlen(filename) + 8);
+	sprintf(*temp_filename, "%s.XXXXXX", filename);
+	fd = mkstemp(*temp_filename);
+	if (fd >= 0) {
+		// mkstemp() creates the file with mode 0600, use the mode
+		// that fopen() would give
+		mask = umask(0);
+		umask(mask);
+		fchmod(fd, 0666 & ~mask);
+		fid = fdopen(fd, "wb");
+	}
+	if (fid == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Error opening output file %s\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	return fid;
+}
+
+/**
+ * @brief Close a temporary file and move it over the output file
+ *
+ * @details
+ * The output file is only replaced if the temporary file is complete: all
+ * writes succeeded, the stream has no error, and it is closed without an
+ * error. Otherwise the temporary file is removed and the output file is
+ * left as it was.
+ *
+ * @param[in] 	fid 		temporary file from gensvm_binary_open_temp()
+ * @param[in] 	temp_filename 	filename of the temporary file, which is
+ * 				freed
+ * @param[in] 	filename 	the output file
+ * @param[in] 	written 	whether all writes to the file succeeded
+ */
+void gensvm_binary_close_temp(FILE *fid, char *temp_filename,
+		char *filename, bool written)
+{
+	written = written && !ferror(fid);
+	if (fclose(fid) != 0 || !written ||
+			rename(temp_filename, filename) != 0) {
+		// LCOV_EXCL_START
+		remove(temp_filename);
+		err("[GenSVM Error]: Error writing output file %s\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	free(temp_filename);
+}
+
+/**
+ * @brief Check if a file starts with the given magic bytes
+ *
+ * @param[in] 	filename 	filename of the file
+ * @param[in] 	magic 		8 magic bytes
+ * @returns 			whether the file starts with magic
+ */
+bool gensvm_binary_has_magic(char *filename, const char *magic)
+{
+	char buffer[8];
+	bool binary = false;
+	FILE *fid = fopen(filename, "rb");
+
+	if (fid == NULL)
+		return false;
+	if (fread(buffer, 1, 8, fid) == 8)
+		binary = (memcmp(buffer, magic, 8) == 0);
+	fclose(fid);
+
+	return binary;
+}
+
+/**
+ * @brief Map a binary file into memory
+ *
+ * @details
+ * The file is mapped privately with read and write access, so that the
+ * arrays in the file can be changed in memory without changing the file.
+ * An empty file gives a NULL pointer and a size of zero. If the file can't
+ * be opened or mapped an error is printed, and the caller decides whether
+ * this is fatal.
+ *
+ * @param[in] 	filename 	filename of the binary file
+ * @param[out] 	map 		the mapped file
+ * @param[out] 	size 		size of the file in bytes
+ * @returns 			whether the file was mapped
+ */
+bool gensvm_binary_map(char *filename, char **map, uint64_t *size)
+{
+	int fd;
+	struct stat st;
+
+	*map = NULL;
+	*size = 0;
+	fd = open(filename, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		err("[GenSVM Error]: Couldn't open file %s\n", filename);
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+	*size = st.st_size;
+	if (*size == 0) {
+		close(fd);
+		return true;
+	}
+
+	*map = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (*map == MAP_FAILED) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Couldn't map file %s\n", filename);
+		*map = NULL;
+		*size = 0;
+		return false;
+		// LCOV_EXCL_STOP
+	}
+
+	return true;
+}
+
+/**
+ * @brief Verify the checksum of a mapped binary file
+ *
+ * @details
+ * The checksum is computed with gensvm_binary_checksum() over the whole
+ * file with the checksum field set to zero, without changing the mapped
+ * file.
+ *
+ * @param[in] 	map 		the mapped file
+ * @param[in] 	size 		size of the file in bytes
+ * @param[in] 	checksum_offset offset of the checksum in the header
+ * @returns 			whether the checksum matches
+ */
+bool gensvm_binary_verify(char *map, uint64_t size, uint64_t checksum_offset)
+{
+	uint64_t checksum, hash,
+		 zero = 0;
+
+	memcpy(&checksum, map + checksum_offset, sizeof(uint64_t));
+	hash = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, map,
+			checksum_offset);
+	hash = gensvm_binary_checksum(hash, &zero, sizeof(uint64_t));
+	hash = gensvm_binary_checksum(hash, map + checksum_offset + 8,
+			size - checksum_offset - 8);
+
+	return hash == checksum;
+}
+
+/**
+ * @brief Compute the offsets of the arrays in a binary file
+ *
+ * @details
+ * The arrays are placed after the header in the given order, each at the
+ * next multiple of GENSVM_BINARY_ALIGN bytes.
+ *
+ * @param[in] 	header_size 	size of the header in bytes
+ * @param[in] 	sizes 		sizes of the arrays in bytes
+ * @param[in] 	n_arrays 	number of arrays
+ * @param[out] 	offsets 	offsets of the arrays
+ * @returns 			the size of the file in bytes
+ */
+uint64_t gensvm_binary_offsets(uint64_t header_size, uint64_t *sizes,
+		long n_arrays, uint64_t *offsets)
+{
+	long i;
+	uint64_t offset = header_size;
+
+	for (i=0; i<n_arrays; i++) {
+		offsets[i] = gensvm_binary_align(offset);
+		offset = offsets[i] + sizes[i];
+	}
+	return gensvm_binary_align(offset);
+}
+
+/**
+ * @brief Write the arrays of a binary file
+ *
+ * @details
+ * The arrays are written after the header, each padded with zeros to the
+ * offset of gensvm_binary_offsets(), and the file is padded to file_size.
+ * The checksum is updated with everything that is written. Writing stops
+ * at the first write that is incomplete, for instance because the disk is
+ * full.
+ *
+ * @param[in] 	fid 		file, positioned after the header
+ * @param[in,out] hash 		checksum of the header, replaced by the
+ * 				checksum of the file
+ * @param[in] 	header_size 	size of the header in bytes
+ * @param[in] 	arrays 		the arrays to write
+ * @param[in] 	sizes 		sizes of the arrays in bytes
+ * @param[in] 	n_arrays 	number of arrays
+ * @param[in] 	file_size 	size of the file in bytes
+ * @returns 			whether everything was written
+ */
+bool gensvm_binary_write_arrays(FILE *fid, uint64_t *hash,
+		uint64_t header_size, const void **arrays, uint64_t *sizes,
+		long n_arrays, uint64_t file_size)
+{
+	long i;
+	uint64_t size,
+		 offset = header_size;
+	char zeros[GENSVM_BINARY_ALIGN] = {0};
+
+	for (i=0; i<n_arrays; i++) {
+		size = gensvm_binary_align(offset) - offset;
+		*hash = gensvm_binary_checksum(*hash, zeros, size);
+		if (fwrite(zeros, 1, size, fid) != size)
+			return false;
+		offset += size;
+		if (sizes[i] > 0) {
+			*hash = gensvm_binary_checksum(*hash, arrays[i],
+					sizes[i]);
+			if (fwrite(arrays[i], 1, sizes[i], fid) != sizes[i])
+				return false;
+			offset += sizes[i];
+		}
+	}
+	size = file_size - offset;
+	*hash = gensvm_binary_checksum(*hash, zeros, size);
+
+	return fwrite(zeros, 1, size, fid) == size;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file gensvm_codegen.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for writing a model as a standalone C source file
+ *
+ * @details
+ * A trained model can be written as a C source file that predicts class
+ * labels without libgensvm, BLAS or LAPACK. The dimensions and the model
+ * coefficients are compile-time constants, such that the compiler can unroll
+ * and fold the prediction for small models. See gensvm_write_source() for
+ * the functions in the generated file.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_codegen.h"
+#include "gensvm_io.h"
+#include "gensvm_simplex.h"
+
+/**
+ * @brief Write a model to a C source file
+ *
+ * @details
+ * The model is written with gensvm_write_source(), see there for the
+ * supported models. All functions and constants in the file are prefixed
+ * with the given name.
+ *
+ * @param[in] 	model 		a trained GenModel
+ * @param[in] 	output_filename filename of the C source file
+ * @param[in] 	name 		prefix of the names in the source file, which
+ * 				should be a valid C identifier
+ */
+void gensvm_write_model_source(struct GenModel *model, char *output_filename,
+		char *name)
+{
+	FILE *fid = fopen(output_filename, "w");
+	if (fid == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Error opening output file %s\n",
+				output_filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	gensvm_write_source(fid, model, name);
+	fclose(fid);
+}
+
+/**
+ * @brief Write a model as C source code
+ *
+ * @details
+ * The generated code defines the functions
+ *
+ * @code
+ * void name_scores(const double *x, double *scores);
+ * long name_predict(const double *x);
+ * @endcode
+ *
+ * where x contains the m features of an instance (without the column of
+ * ones) and scores has room for K values. The scores are computed as in
+ * gensvm_predict_scores(), and name_predict() returns the label of the
+ * class with the first largest score, or 0 if the scores are NaN.
+ *
+ * Linear models and models with a nonlinear kernel and the collapsed
+ * coefficients in GenModel::W are supported. A model with a precomputed
+ * kernel can't be written, since the kernel can't be evaluated for new
+ * instances.
+ *
+ * For a model trained on hashed or compacted LibSVM features (see
+ * GenModel::hash_bits and GenModel::col_map) the features in x are the
+ * columns of the model. The code then also defines
+ *
+ * @code
+ * long name_column(long index, double *sign);
+ * @endcode
+ *
+ * which gives the column of a feature index of the data file, see
+ * gensvm_write_source_column().
+ *
+ * @param[in] 	fid 	file opened for writing
+ * @param[in] 	model 	a trained GenModel
+ * @param[in] 	name 	prefix of the names in the source code
+ */
+void gensvm_write_source(FILE *fid, struct GenModel *model, char *name)
+{
+	long K = model->K;
+	char timestr[GENSVM_MAX_LINE_LENGTH];
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		err("[GenSVM Error]: A model with a precomputed kernel can't "
+				"be written as C source.\n");
+		exit(EXIT_FAILURE);
+	}
+	if (model->kerneltype != K_LINEAR && (model->W == NULL ||
+				model->basis == NULL)) {
+		err("[GenSVM Error]: A kernel model needs a basis to be "
+				"written as C source.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (model->U == NULL)
+		model->U = Calloc(double, K*(K-1));
+	gensvm_simplex(model);
+
+	gensvm_time_string(timestr);
+	fprintf(fid, "/*\n");
+	fprintf(fid, " * Prediction with a GenSVM model, generated by GenSVM "
+			"(version %s)\n", VERSION_STRING);
+	fprintf(fid, " * Generated on: %s\n", timestr);
+	fprintf(fid, " */\n\n");
+	fprintf(fid, "#include <math.h>\n");
+	if (model->hash_bits > 0)
+		fprintf(fid, "#include <stdint.h>\n");
+	fprintf(fid, "\n");
+	fprintf(fid, "#define %s_M %li\n", name, (model->kerneltype ==
+				K_LINEAR) ? model->m : model->basis->m);
+	fprintf(fid, "#define %s_K %li\n\n", name, K);
+	fprintf(fid, "void %s_scores(const double *x, double *scores);\n",
+			name);
+	fprintf(fid, "long %s_predict(const double *x);\n", name);
+	if (model->hash_bits > 0 || model->col_map != NULL)
+		fprintf(fid, "long %s_column(long index, double *sign);\n",
+				name);
+	fprintf(fid, "\n");
+
+	if (model->hash_bits > 0 || model->col_map != NULL)
+		gensvm_write_source_column(fid, model, name);
+
+	gensvm_write_source_matrix(fid, name, "U", model->U, K, K-1);
+
+	if (model->kerneltype == K_LINEAR)
+		gensvm_write_source_linear(fid, model, name);
+	else
+		gensvm_write_source_kernel(fid, model, name);
+
+	// simplex scores, shared by all models
+	fprintf(fid, "\tfor (k=0; k<%s_K; k++) {\n", name);
+	fprintf(fid, "\t\tscores[k] = 0.0;\n");
+	fprintf(fid, "\t\tfor (l=0; l<%s_K-1; l++)\n", name);
+	fprintf(fid, "\t\t\tscores[k] += zv[l] * %s_U[k][l];\n", name);
+	fprintf(fid, "\t}\n");
+	fprintf(fid, "}\n\n");
+
+	fprintf(fid, "long %s_predict(const double *x)\n", name);
+	fprintf(fid, "{\n");
+	fprintf(fid, "\tlong k, best = -1;\n");
+	fprintf(fid, "\tdouble max_value = -INFINITY, scores[%s_K];\n\n",
+			name);
+	fprintf(fid, "\t%s_scores(x, scores);\n", name);
+	fprintf(fid, "\tfor (k=0; k<%s_K; k++) {\n", name);
+	fprintf(fid, "\t\tif (scores[k] > max_value || (best < 0 && "
+			"scores[k] == max_value)) {\n");
+	fprintf(fid, "\t\t\tmax_value = scores[k];\n");
+	fprintf(fid, "\t\t\tbest = k;\n");
+	fprintf(fid, "\t\t}\n");
+	fprintf(fid, "\t}\n");
+	fprintf(fid, "\treturn best + 1;\n");
+	fprintf(fid, "}\n");
+}
+
+/**
+ * @brief Write a matrix as a constant array in C source code
+ *
+ * @details
+ * The matrix is written as a two-dimensional static array with the name
+ * name_suffix. The values are written with 17 significant digits, so they
+ * are read back exactly by the compiler.
+ *
+ * @param[in] 	fid 	file opened for writing
+ * @param[in] 	name 	prefix of the array name
+ * @param[in] 	suffix 	suffix of the array name
+ * @param[in] 	A 	matrix in RowMajor order
+ * @param[in] 	rows 	number of rows of A
+ * @param[in] 	cols 	number of columns of A
+ */
+void gensvm_write_source_matrix(FILE *fid, char *name, char *suffix,
+		double *A, long rows, long cols)
+{
+	long i, j;
+
+	fprintf(fid, "static const double %s_%s[%li][%li] = {\n", name, suffix,
+			rows, cols);
+	for (i=0; i<rows; i++) {
+		fprintf(fid, "\t{");
+		for (j=0; j<cols; j++)
+			fprintf(fid, (j > 0) ? ", %.17g" : "%.17g",
+					matrix_get(A, cols, i, j));
+		fprintf(fid, (i < rows - 1) ? "},\n" : "}\n");
+	}
+	fprintf(fid, "};\n\n");
+}
+
+/**
+ * @brief Write the simplex space vector of a linear model as C source code
+ *
+ * @details
+ * This writes the start of the scores function of a linear model, which
+ * computes the simplex space vector @f$\textbf{z}'\textbf{V}@f$. If V has at
+ * most GENSVM_CODEGEN_UNROLL_MAX elements the product is written out term
+ * by term with the elements of V as literals, skipping the zeros. Otherwise
+ * V is written as an array and the product is computed with loops of
+ * constant length.
+ *
+ * @param[in] 	fid 	file opened for writing
+ * @param[in] 	model 	a linear GenModel
+ * @param[in] 	name 	prefix of the names in the source code
+ */
+void gensvm_write_source_linear(FILE *fid, struct GenModel *model, char *name)
+{
+	long j, l,
+	     m = model->m,
+	     K = model->K;
+	bool unroll = ((m+1)*(K-1) <= GENSVM_CODEGEN_UNROLL_MAX);
+	double value;
+
+	if (!unroll)
+		gensvm_write_source_matrix(fid, name, "V", model->V, m+1,
+				K-1);
+
+	fprintf(fid, "void %s_scores(const double *x, double *scores)\n",
+			name);
+	fprintf(fid, "{\n");
+	fprintf(fid, unroll ? "\tlong k, l;\n" : "\tlong j, k, l;\n");
+	fprintf(fid, "\tdouble zv[%s_K-1];\n\n", name);
+
+	if (unroll) {
+		for (l=0; l<K-1; l++) {
+			fprintf(fid, "\tzv[%li] = %.17g;\n", l,
+					matrix_get(model->V, K-1, 0, l));
+			for (j=1; j<m+1; j++) {
+				value = matrix_get(model->V, K-1, j, l);
+				if (value != 0)
+					fprintf(fid, "\tzv[%li] += x[%li] * "
+							"%.17g;\n", l, j-1,
+							value);
+			}
+		}
+	} else {
+		fprintf(fid, "\tfor (l=0; l<%s_K-1; l++)\n", name);
+		fprintf(fid, "\t\tzv[l] = %s_V[0][l];\n", name);
+		fprintf(fid, "\tfor (j=0; j<%s_M; j++)\n", name);
+		fprintf(fid, "\t\tfor (l=0; l<%s_K-1; l++)\n", name);
+		fprintf(fid, "\t\t\tzv[l] += x[j] * %s_V[j+1][l];\n", name);
+	}
+	fprintf(fid, "\n");
+}
+
+/**
+ * @brief Write the simplex space vector of a kernel model as C source code
+ *
+ * @details
+ * This writes the start of the scores function of a model with a nonlinear
+ * kernel. The training instances in GenModel::basis, the collapsed
+ * coefficients in GenModel::W and the bias in the first row of GenModel::V
+ * are written as arrays, and the kernel with the parameters of the model is
+ * written inline, as in gensvm_kernel_dot(). A sparse basis is written as a
+ * dense array.
+ *
+ * @param[in] 	fid 	file opened for writing
+ * @param[in] 	model 	a GenModel with a nonlinear kernel, and with
+ * 			GenModel::basis and GenModel::W set
+ * @param[in] 	name 	prefix of the names in the source code
+ */
+void gensvm_write_source_kernel(FILE *fid, struct GenModel *model, char *name)
+{
+	long i,
+	     K = model->K,
+	     n_basis = model->basis->n,
+	     m = model->basis->m;
+	double *X = NULL,
+	       *RAW = model->basis->RAW;
+
+	if (RAW == NULL)
+		RAW = gensvm_sparse_to_dense(model->basis->spZ);
+
+	// the basis without the column of ones
+	X = Malloc(double, n_basis*m);
+	for (i=0; i<n_basis; i++)
+		memcpy(&X[i*m], &RAW[i*(m+1)+1], m*sizeof(double));
+	if (RAW != model->basis->RAW)
+		free(RAW);
+
+	fprintf(fid, "#define %s_N_BASIS %li\n\n", name, n_basis);
+	gensvm_write_source_matrix(fid, name, "basis", X, n_basis, m);
+	gensvm_write_source_matrix(fid, name, "W", model->W, n_basis, K-1);
+	gensvm_write_source_matrix(fid, name, "bias", model->V, 1, K-1);
+	free(X);
+
+	fprintf(fid, "void %s_scores(const double *x, double *scores)\n",
+			name);
+	fprintf(fid, "{\n");
+	fprintf(fid, "\tlong i, j, k, l;\n");
+	fprintf(fid, "\tdouble value, zv[%s_K-1];\n\n", name);
+	fprintf(fid, "\tfor (l=0; l<%s_K-1; l++)\n", name);
+	fprintf(fid, "\t\tzv[l] = %s_bias[0][l];\n", name);
+	fprintf(fid, "\tfor (i=0; i<%s_N_BASIS; i++) {\n", name);
+	fprintf(fid, "\t\tvalue = 0.0;\n");
+	fprintf(fid, "\t\tfor (j=0; j<%s_M; j++)\n", name);
+	if (model->kerneltype == K_RBF) {
+		fprintf(fid, "\t\t\tvalue += (x[j] - %s_basis[i][j]) * "
+				"(x[j] - %s_basis[i][j]);\n", name, name);
+		fprintf(fid, "\t\tvalue = exp(%.17g * value);\n",
+				-model->gamma);
+	} else if (model->kerneltype == K_POLY) {
+		fprintf(fid, "\t\t\tvalue += x[j] * %s_basis[i][j];\n", name);
+		fprintf(fid, "\t\tvalue = pow(%.17g * value + %.17g, %.17g);\n",
+				model->gamma, model->coef, model->degree);
+	} else {
+		fprintf(fid, "\t\t\tvalue += x[j] * %s_basis[i][j];\n", name);
+		fprintf(fid, "\t\tvalue = tanh(%.17g * value + %.17g);\n",
+				model->gamma, model->coef);
+	}
+	fprintf(fid, "\t\tfor (l=0; l<%s_K-1; l++)\n", name);
+	fprintf(fid, "\t\t\tzv[l] += value * %s_W[i][l];\n", name);
+	fprintf(fid, "\t}\n\n");
+}
+
+/**
+ * @brief Write the column map of a hashed or compacted model as C source code
+ *
+ * @details
+ * This writes the function name_column(), which maps the 1-based feature 
+ * index of a LibSVM file to the 1-based column of the model in the same way 
+ * as the training data was read: the index is hashed as in 
+ * gensvm_parse_hash() if GenModel::hash_bits is positive, and the column is 
+ * looked up in GenModel::col_map with a binary search as in 
+ * gensvm_parse_map_column() if the model has a column map. The function 
+ * returns 0 for features that the model doesn't use, and sets sign to the 
+ * sign of a hashed feature. A feature is then added to the instance with
+ *
+ * @code
+ * col = name_column(index, &sign);
+ * if (col > 0)
+ * 	x[col-1] += sign * value;
+ * @endcode
+ *
+ * @param[in] 	fid 	file opened for writing
+ * @param[in] 	model 	a GenModel with GenModel::hash_bits or
+ * 			GenModel::col_map set
+ * @param[in] 	name 	prefix of the names in the source code
+ */
+void gensvm_write_source_column(FILE *fid, struct GenModel *model, char *name)
+{
+	long j,
+	     n_columns = model->col_map_size;
+
+	if (model->col_map != NULL) {
+		fprintf(fid, "static const long %s_columns[%li] = {", name,
+				n_columns);
+		for (j=0; j<n_columns; j++)
+			fprintf(fid, "%s%li%s", (j % 8 == 0) ? "\n\t" : " ",
+					model->col_map[j],
+					(j < n_columns - 1) ? "," : "\n");
+		fprintf(fid, "};\n\n");
+	}
+
+	fprintf(fid, "long %s_column(long index, double *sign)\n", name);
+	fprintf(fid, "{\n");
+	if (model->hash_bits > 0)
+		fprintf(fid, "\tuint64_t h = (uint64_t) index;\n");
+	if (model->col_map != NULL)
+		fprintf(fid, "\tlong mid, low = 0, high = %li;\n", n_columns);
+	fprintf(fid, "\n");
+	fprintf(fid, "\t*sign = 1.0;\n");
+	fprintf(fid, "\tif (index < 1)\n");
+	fprintf(fid, "\t\treturn 0;\n");
+	if (model->hash_bits > 0) {
+		fprintf(fid, "\th ^= h >> 33;\n");
+		fprintf(fid, "\th *= 0xff51afd7ed558ccdULL;\n");
+		fprintf(fid, "\th ^= h >> 33;\n");
+		fprintf(fid, "\th *= 0xc4ceb9fe1a85ec53ULL;\n");
+		fprintf(fid, "\th ^= h >> 33;\n");
+		if (model->hash_signed)
+			fprintf(fid, "\tif (h >> 63)\n\t\t*sign = -1.0;\n");
+		fprintf(fid, "\tindex = (long) (h & ((1ULL << %li) - 1)) + 1;\n",
+				model->hash_bits);
+	}
+	if (model->col_map == NULL) {
+		fprintf(fid, "\treturn index;\n");
+		fprintf(fid, "}\n\n");
+		return;
+	}
+	fprintf(fid, "\twhile (low < high) {\n");
+	fprintf(fid, "\t\tmid = low + (high - low)/2;\n");
+	fprintf(fid, "\t\tif (%s_columns[mid] < index)\n", name);
+	fprintf(fid, "\t\t\tlow = mid + 1;\n");
+	fprintf(fid, "\t\telse\n");
+	fprintf(fid, "\t\t\thigh = mid;\n");
+	fprintf(fid, "\t}\n");
+	fprintf(fid, "\treturn (low < %li && %s_columns[low] == index) ? "
+			"low + 1 : 0;\n", n_columns, name);
+	fprintf(fid, "}\n\n");
+}
+
+/**
+ * @brief Check if a string is a valid C identifier
+ *
+ * @param[in] 	name 	string to check
+ * @returns 		whether name is non-empty, starts with a letter or an
+ * 			underscore, and contains only letters, digits and
+ * 			underscores
+ */
+bool gensvm_is_identifier(char *name)
+{
+	long i;
+
+	if (name[0] == '\0' || isdigit((unsigned char) name[0]))
+		return false;
+	for (i=0; name[i] != '\0'; i++)
+		if (!isalnum((unsigned char) name[i]) && name[i] != '_')
+			return false;
+	return true;
+}
@@ -141,6 +141,7 @@ int gensvm_consistency_repeats(struct GenQueue *q, long repeats,
 	struct GenQueue *nq = NULL;
 	struct GenData **train_folds = NULL,
 		       **test_folds = NULL;
+	struct GenFolds *cv = NULL;
 	struct GenModel *model = gensvm_init_model();
 	struct GenTask *task = NULL;
 	struct timespec loop_s, loop_e;
@@ -164,9 +165,6 @@ int gensvm_consistency_repeats(struct GenQueue *q, long repeats,
 
 	cv_idx = Calloc(long, task->train_data->n);
 
-	train_folds = Malloc(struct GenData *, task->folds);
-	test_folds = Malloc(struct GenData *, task->folds);
-
 	i = 0;
 	while (task) {
 		gensvm_task_to_model(task, model);
@@ -176,13 +174,15 @@ int gensvm_consistency_repeats(struct GenQueue *q, long repeats,
 		for (r=0; r<repeats; r++) {
 			Memset(cv_idx, long, task->train_data->n);
 			gensvm_make_cv_split(task->train_data->n, task->folds, cv_idx);
+			cv = gensvm_init_folds(task->train_data, cv_idx,
+					task->folds);
 			train_folds = Malloc(struct GenData *, task->folds);
 			test_folds = Malloc(struct GenData *, task->folds);
 			for (f=0; f<task->folds; f++) {
 				train_folds[f] = gensvm_init_data();
 				test_folds[f] = gensvm_init_data();
-				gensvm_get_tt_split(task->train_data, train_folds[f],
-						test_folds[f], cv_idx, f);
+				gensvm_get_fold_views(task->train_data, cv, f,
+						train_folds[f], test_folds[f]);
 				gensvm_kernel_preprocess(model, train_folds[f]);
 				gensvm_kernel_postprocess(model, train_folds[f],
 						test_folds[f]);
@@ -197,7 +197,11 @@ int gensvm_consistency_repeats(struct GenQueue *q, long repeats,
 			mean[i] += p/((double) repeats);
 			note("%3.3f\t", p);
 			// this is done because if we reuse the V it's not a
-			// consistency check
+			// consistency check. The dimensions of the model are
+			// those of the last fold (the kernel rank), so they
+			// are reset to those of the full dataset first.
+			gensvm_reallocate_model(model, task->train_data->n,
+					task->train_data->m);
 			gensvm_init_V(NULL, model, task->train_data);
 			for (f=0; f<task->folds; f++) {
 				gensvm_free_data(train_folds[f]);
@@ -208,6 +212,9 @@ int gensvm_consistency_repeats(struct GenQueue *q, long repeats,
 
 			free(test_folds);
 			test_folds = NULL;
+
+			gensvm_free_folds(cv);
+			cv = NULL;
 		}
 		for (r=0; r<repeats; r++) {
 			std[i] += pow(matrix_get(perf, repeats, i, r) - mean[i],
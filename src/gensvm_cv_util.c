@@ -88,10 +88,15 @@ void gensvm_make_cv_split(long N, long folds, long *cv_idx)
  * @details
  * This function tests if the data in the full_data structure is stored in a
  * dense matrix format or not, and calls gensvm_get_tt_split_dense() or
- * gensvm_get_tt_split_sparse() accordingly.
+ * gensvm_get_tt_split_sparse() accordingly. If a precomputed kernel matrix 
+ * is available in GenData::kernel, it is split using 
+ * gensvm_get_tt_split_kernel(). Wrapped data (see gensvm_wrap_dense()) is 
+ * copied with gensvm_unwrap_data() first.
  *
  * @sa
- * gensvm_get_tt_split_dense(), gensvm_get_tt_split_sparse()
+ * gensvm_get_tt_split_dense(), gensvm_get_tt_split_sparse(), 
+ * gensvm_get_tt_split_kernel(), and gensvm_get_fold_views() for train and 
+ * test datasets that don't copy the instances
  *
  * @param[in] 		full_data 	a GenData structure for the entire
  * 					dataset
@@ -108,12 +113,19 @@ void gensvm_get_tt_split(struct GenData *full_data,
 		struct GenData *train_data, struct GenData *test_data,
 		long *cv_idx, long fold_idx)
 {
+	// the folds are augmented data matrices
+	gensvm_unwrap_data(full_data);
+
 	if (full_data->Z == NULL)
 		gensvm_get_tt_split_sparse(full_data, train_data, test_data,
 				cv_idx, fold_idx);
 	else
 		gensvm_get_tt_split_dense(full_data, train_data, test_data,
 				cv_idx, fold_idx);
+
+	if (full_data->kernel != NULL)
+		gensvm_get_tt_split_kernel(full_data, train_data, test_data,
+				cv_idx, fold_idx);
 }
 
 /**
@@ -321,3 +333,340 @@ void gensvm_get_tt_split_sparse(struct GenData *full_data,
 		}
 	}
 }
+
+/**
+ * @brief Split a precomputed kernel matrix for a CV split
+ *
+ * @details
+ * When a precomputed kernel is used, the kernel matrix of the full dataset 
+ * is stored in GenData::kernel. For a cross validation split the training 
+ * dataset needs the kernel matrix between the training instances, and the 
+ * test dataset needs the cross kernel matrix between the test instances and 
+ * the training instances. These matrices are extracted here from the full 
+ * kernel matrix, in the same order as the instances are assigned by 
+ * gensvm_get_tt_split_dense() and gensvm_get_tt_split_sparse(). This 
+ * function assumes that GenData::n of the train and test dataset is already 
+ * set.
+ *
+ * @sa
+ * gensvm_get_tt_split()
+ *
+ * @param[in] 		full_data 	a GenData structure for the entire
+ * 					dataset, with the full kernel matrix
+ * @param[in,out] 	train_data 	a GenData structure for the training
+ * 					dataset, on exit contains the train 
+ * 					kernel matrix
+ * @param[in,out] 	test_data 	a GenData structure for the test
+ * 					dataset, on exit contains the cross 
+ * 					kernel matrix
+ * @param[in] 		cv_idx 		a vector of cv partitions created by
+ * 					gensvm_make_cv_split()
+ * @param[in] 		fold_idx 	index of the fold which becomes the
+ * 					test dataset
+ */
+void gensvm_get_tt_split_kernel(struct GenData *full_data,
+		struct GenData *train_data, struct GenData *test_data,
+		long *cv_idx, long fold_idx)
+{
+	long i, j, k, l, train_n = train_data->n;
+	long n = full_data->n;
+	double value;
+
+	free(train_data->kernel);
+	free(test_data->kernel);
+	train_data->kernel = Calloc(double, train_n*train_n);
+	test_data->kernel = Calloc(double, test_data->n*train_n);
+
+	k = 0;
+	for (i=0; i<n; i++) {
+		l = 0;
+		for (j=0; j<n; j++) {
+			if (cv_idx[j] == fold_idx)
+				continue;
+			value = matrix_get(full_data->kernel, n, i, j);
+			if (cv_idx[i] == fold_idx)
+				matrix_set(test_data->kernel, train_n, k, l,
+						value);
+			else
+				matrix_set(train_data->kernel, train_n,
+						i - k, l, value);
+			l++;
+		}
+		if (cv_idx[i] == fold_idx)
+			k++;
+	}
+}
+
+/**
+ * @brief Group the instances of a dataset by cross validation fold
+ *
+ * @details
+ * The functions gensvm_get_tt_split_dense() and gensvm_get_tt_split_sparse()
+ * copy the instances to the train and test dataset of a fold, such that the
+ * train and test datasets of all folds together hold as many copies of the
+ * data as there are folds. This function instead stores the augmented rows
+ * once grouped by fold, and the rows of all folds but the last a second
+ * time, in a GenFolds structure. The test set of fold @f$f@f$ is then the
+ * range of rows of the fold, and the training set is the range of rows of
+ * the folds @f$f+1, \ldots, f-1@f$ that directly follows it. Within a fold
+ * the instances keep the order of the full dataset. Wrapped data (see
+ * gensvm_wrap_dense()) is augmented with the column of ones while it is
+ * copied.
+ *
+ * @sa
+ * gensvm_get_fold_views(), gensvm_free_folds()
+ *
+ * @param[in] 	full_data 	a GenData structure for the entire dataset
+ * @param[in] 	cv_idx 		a vector of cv partitions created by
+ * 				gensvm_make_cv_split()
+ * @param[in] 	folds 		number of folds
+ *
+ * @returns 			the instances grouped by fold
+ */
+struct GenFolds *gensvm_init_folds(struct GenData *full_data, long *cv_idx,
+		long folds)
+{
+	long f, i, p, jj, nnz, n_pos,
+	     n = full_data->n,
+	     m = full_data->m,
+	     shift = full_data->wrapped ? 1 : 0;
+	long *next = Malloc(long, folds);
+	double *x = NULL;
+	struct GenSparse *spZ = full_data->spZ;
+	struct GenFolds *cv = Malloc(struct GenFolds, 1);
+
+	cv->folds = folds;
+	cv->n = n;
+	cv->m = m;
+	cv->start = Calloc(long, folds+1);
+	cv->rows = Malloc(long, n);
+	cv->RAW = NULL;
+	cv->spZ = NULL;
+
+	// group the instances by fold, in the order of the full dataset
+	for (i=0; i<n; i++)
+		cv->start[cv_idx[i]+1]++;
+	for (f=0; f<folds; f++) {
+		cv->start[f+1] += cv->start[f];
+		next[f] = cv->start[f];
+	}
+	for (i=0; i<n; i++)
+		cv->rows[next[cv_idx[i]]++] = i;
+	free(next);
+
+	// the rows of all folds, followed by those of all folds but the last
+	n_pos = n + cv->start[folds-1];
+
+	if (spZ == NULL) {
+		cv->RAW = Malloc(double, n_pos*(m+1));
+		for (p=0; p<n_pos; p++) {
+			i = cv->rows[p % n];
+			x = &cv->RAW[p*(m+1)];
+			if (full_data->wrapped) {
+				x[0] = 1.0;
+				memcpy(x + 1, &full_data->Z[i*m],
+						m*sizeof(double));
+			} else {
+				memcpy(x, &full_data->RAW[i*(m+1)],
+						(m+1)*sizeof(double));
+			}
+		}
+		return cv;
+	}
+
+	nnz = 0;
+	for (p=0; p<n_pos; p++) {
+		i = cv->rows[p % n];
+		nnz += spZ->ia[i+1] - spZ->ia[i] + shift;
+	}
+
+	cv->spZ = gensvm_init_sparse();
+	cv->spZ->nnz = nnz;
+	cv->spZ->n_row = n_pos;
+	cv->spZ->n_col = m+1;
+	cv->spZ->values = Malloc(double, nnz);
+	cv->spZ->ia = Malloc(long, n_pos+1);
+	cv->spZ->ja = Malloc(long, nnz);
+
+	nnz = 0;
+	cv->spZ->ia[0] = 0;
+	for (p=0; p<n_pos; p++) {
+		i = cv->rows[p % n];
+		if (shift) {
+			cv->spZ->values[nnz] = 1.0;
+			cv->spZ->ja[nnz++] = 0;
+		}
+		for (jj=spZ->ia[i]; jj<spZ->ia[i+1]; jj++) {
+			cv->spZ->values[nnz] = spZ->values[jj];
+			cv->spZ->ja[nnz++] = spZ->ja[jj] + shift;
+		}
+		cv->spZ->ia[p+1] = nnz;
+	}
+
+	return cv;
+}
+
+/**
+ * @brief Free the instances grouped by fold
+ *
+ * @details
+ * The views made by gensvm_get_fold_views() point to the instances in the
+ * GenFolds structure, so they must be freed first.
+ *
+ * @param[in] 	cv 	a GenFolds structure created by gensvm_init_folds()
+ */
+void gensvm_free_folds(struct GenFolds *cv)
+{
+	if (cv == NULL)
+		return;
+
+	if (cv->spZ != NULL)
+		gensvm_free_sparse(cv->spZ);
+	free(cv->RAW);
+	free(cv->rows);
+	free(cv->start);
+	free(cv);
+}
+
+/**
+ * @brief Create train and test datasets for a CV split without copies
+ *
+ * @details
+ * This function has the same role as gensvm_get_tt_split(), but the train
+ * and test datasets are views of the instances in a GenFolds structure (see
+ * gensvm_get_fold_view()). The instances of the training set are in the
+ * order of the folds that follow the test fold, rather than in the order of
+ * the full dataset. If a precomputed kernel matrix is available in
+ * GenData::kernel, it is split in the same order with
+ * gensvm_get_fold_kernel().
+ *
+ * @param[in] 		full_data 	a GenData structure for the entire
+ * 					dataset
+ * @param[in] 		cv 		the instances grouped by fold, created
+ * 					by gensvm_init_folds()
+ * @param[in] 		fold_idx 	index of the fold which becomes the
+ * 					test dataset
+ * @param[in,out] 	train_data 	an initialized GenData structure which
+ * 					on exit is a view of the training
+ * 					dataset
+ * @param[in,out] 	test_data 	an initialized GenData structure which
+ * 					on exit is a view of the test dataset
+ */
+void gensvm_get_fold_views(struct GenData *full_data, struct GenFolds *cv,
+		long fold_idx, struct GenData *train_data,
+		struct GenData *test_data)
+{
+	long test_n = cv->start[fold_idx+1] - cv->start[fold_idx];
+
+	gensvm_get_fold_view(full_data, cv, cv->start[fold_idx], test_n,
+			test_data);
+	gensvm_get_fold_view(full_data, cv, cv->start[fold_idx+1],
+			cv->n - test_n, train_data);
+
+	if (full_data->kernel != NULL)
+		gensvm_get_fold_kernel(full_data, cv, fold_idx, train_data,
+				test_data);
+}
+
+/**
+ * @brief Make a dataset of a range of rows of a GenFolds
+ *
+ * @details
+ * The instances of the view point to the rows @f$\text{pos}, \ldots,
+ * \text{pos} + n - 1@f$ of the GenFolds structure, and GenData::view is set
+ * such that gensvm_free_data() doesn't free them. Dense views therefore take
+ * no memory for the instances, and sparse views only need their own row
+ * pointers. The labels are copied, since they are small compared to the
+ * instances.
+ *
+ * @param[in] 		full_data 	a GenData structure for the entire
+ * 					dataset
+ * @param[in] 		cv 		the instances grouped by fold
+ * @param[in] 		pos 		index of the first row of the view
+ * @param[in] 		n 		number of rows of the view
+ * @param[in,out] 	view 		an initialized GenData structure which
+ * 					is the view on exit
+ */
+void gensvm_get_fold_view(struct GenData *full_data, struct GenFolds *cv,
+		long pos, long n, struct GenData *view)
+{
+	long i, offset,
+	     m = cv->m;
+
+	view->n = n;
+	view->m = m;
+	view->K = full_data->K;
+	view->view = true;
+
+	view->y = Malloc(long, n);
+	for (i=0; i<n; i++)
+		view->y[i] = full_data->y[cv->rows[(pos + i) % cv->n]];
+
+	if (cv->RAW != NULL) {
+		view->RAW = cv->RAW + pos*(m+1);
+		view->Z = view->RAW;
+		return;
+	}
+
+	offset = cv->spZ->ia[pos];
+	view->spZ = gensvm_init_sparse();
+	view->spZ->nnz = cv->spZ->ia[pos+n] - offset;
+	view->spZ->n_row = n;
+	view->spZ->n_col = m+1;
+	view->spZ->values = cv->spZ->values + offset;
+	view->spZ->ja = cv->spZ->ja + offset;
+	view->spZ->ia = Malloc(long, n+1);
+	for (i=0; i<n+1; i++)
+		view->spZ->ia[i] = cv->spZ->ia[pos+i] - offset;
+}
+
+/**
+ * @brief Split a precomputed kernel matrix for the views of a CV split
+ *
+ * @details
+ * This function has the same role as gensvm_get_tt_split_kernel(), for the
+ * train and test datasets made by gensvm_get_fold_views(). The training
+ * instances are in the order of the folds that follow the test fold, so the
+ * kernel matrices are extracted in that order.
+ *
+ * @param[in] 		full_data 	a GenData structure for the entire
+ * 					dataset, with the full kernel matrix
+ * @param[in] 		cv 		the instances grouped by fold
+ * @param[in] 		fold_idx 	index of the fold which is the test
+ * 					dataset
+ * @param[in,out] 	train_data 	the view of the training dataset, on
+ * 					exit contains the train kernel matrix
+ * @param[in,out] 	test_data 	the view of the test dataset, on exit
+ * 					contains the cross kernel matrix
+ */
+void gensvm_get_fold_kernel(struct GenData *full_data, struct GenFolds *cv,
+		long fold_idx, struct GenData *train_data,
+		struct GenData *test_data)
+{
+	long i, j, k, l,
+	     n = cv->n,
+	     train_n = train_data->n,
+	     test_n = test_data->n,
+	     train_pos = cv->start[fold_idx+1],
+	     test_pos = cv->start[fold_idx];
+	double value;
+
+	free(train_data->kernel);
+	free(test_data->kernel);
+	train_data->kernel = Malloc(double, train_n*train_n);
+	test_data->kernel = Malloc(double, test_n*train_n);
+
+	for (l=0; l<train_n; l++) {
+		j = cv->rows[(train_pos + l) % n];
+		for (k=0; k<test_n; k++) {
+			i = cv->rows[test_pos + k];
+			value = matrix_get(full_data->kernel, n, i, j);
+			matrix_set(test_data->kernel, train_n, k, l, value);
+		}
+		for (k=0; k<train_n; k++) {
+			i = cv->rows[(train_pos + k) % n];
+			value = matrix_get(full_data->kernel, n, i, j);
+			matrix_set(train_data->kernel, train_n, k, l, value);
+		}
+	}
+}
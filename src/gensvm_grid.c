@@ -71,6 +71,8 @@ struct GenGrid *gensvm_init_grid(void)
 	grid->degrees = NULL;
 	grid->train_data_file = NULL;
 	grid->test_data_file = NULL;
+	grid->train_kernel_file = NULL;
+	grid->test_kernel_file = NULL;
 
 	return grid;
 }
@@ -97,6 +99,8 @@ void gensvm_free_grid(struct GenGrid *grid)
 	free(grid->degrees);
 	free(grid->train_data_file);
 	free(grid->test_data_file);
+	free(grid->train_kernel_file);
+	free(grid->test_kernel_file);
 	free(grid);
 	grid = NULL;
 }
@@ -291,13 +291,16 @@ void gensvm_train_queue(struct GenQueue *q)
 	long *cv_idx = Calloc(long, task->train_data->n);
 	gensvm_make_cv_split(task->train_data->n, task->folds, cv_idx);
 
+	// the folds are views of the instances grouped by fold
+	struct GenFolds *cv = gensvm_init_folds(task->train_data, cv_idx,
+			folds);
 	struct GenData **train_folds = Malloc(struct GenData *, task->folds);
 	struct GenData **test_folds = Malloc(struct GenData *, task->folds);
 	for (f=0; f<folds; f++) {
 		train_folds[f] = gensvm_init_data();
 		test_folds[f] = gensvm_init_data();
-		gensvm_get_tt_split(task->train_data, train_folds[f],
-				test_folds[f], cv_idx, f);
+		gensvm_get_fold_views(task->train_data, cv, f, train_folds[f],
+				test_folds[f]);
 	}
 
 	Timer(main_s);
@@ -335,6 +338,7 @@ void gensvm_train_queue(struct GenQueue *q)
 	}
 	free(train_folds);
 	free(test_folds);
+	gensvm_free_folds(cv);
 	free(cv_idx);
 }
 
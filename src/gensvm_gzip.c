@@ -0,0 +1,687 @@
+/**
+ * @file gensvm_gzip.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for reading gzip compressed data files
+ *
+ * @details
+ * A gzip compressed data file is decompressed with zlib in blocks of
+ * complete lines, without writing the decompressed file to disk. One thread
+ * decompresses the blocks, while the other threads parse the blocks that
+ * are ready with the functions of gensvm_parse.c. When the parsing threads
+ * fall behind, the decompressing thread parses a block itself, so that the
+ * number of decompressed blocks in memory stays small.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include <time.h>
+
+#include "gensvm_gzip.h"
+
+/**
+ * @brief Check if a file is gzip compressed
+ *
+ * @param[in] 	data_file 	filename of the data file
+ * @returns 			whether the file starts with the gzip magic
+ * 				bytes
+ */
+bool gensvm_is_gzip_data(char *data_file)
+{
+	unsigned char magic[2];
+	bool gzip = false;
+	FILE *fid = fopen(data_file, "rb");
+
+	if (fid == NULL)
+		return false;
+	if (fread(magic, 1, 2, fid) == 2)
+		gzip = (magic[0] == 0x1f && magic[1] == 0x8b);
+	fclose(fid);
+
+	return gzip;
+}
+
+/**
+ * @brief Read a gzip compressed data file in the default format
+ *
+ * @details
+ * This reads a compressed file in the format of the @ref spec_data_file,
+ * in the same way as gensvm_read_data(). The first block is decompressed
+ * first, to read the dimensions and to find out if the instances have
+ * labels. The blocks are then parsed into CSR fragments while the rest of
+ * the file is decompressed, as for a compressed LibSVM file. Since the
+ * number of nonzeros is known once all blocks are parsed, the fragments
+ * are combined directly into GenData::RAW or GenData::spZ, and the dense
+ * matrix isn't allocated for sparse data.
+ *
+ * @param[in,out] 	dataset 	initialized GenData struct
+ * @param[in] 		data_file 	filename of the compressed data file
+ */
+void gensvm_read_data_gzip(struct GenData *dataset, char *data_file)
+{
+	long c, i, n, m, n_first, n_read,
+	     nnz = 0,
+	     K = 0;
+	bool has_labels;
+	double *first = NULL;
+	const char *str = NULL,
+	      *end = NULL,
+	      *probe = NULL;
+	struct GenGzipStream *stream = gensvm_gzip_open(data_file);
+	struct GenGzipBlock *block = NULL;
+	struct GenParseChunk *chunks = NULL;
+	struct GenSparse **fragments = NULL;
+
+	// the first block holds at least the dimensions and the first line
+	gensvm_gzip_read_block(stream, 3);
+	str = (stream->first == NULL) ? NULL : stream->first->data;
+	end = (stream->first == NULL) ? NULL : str + stream->first->size;
+
+	// Read data dimensions
+	if (str == NULL || !gensvm_parse_long(&str, end, &n) ||
+			!gensvm_parse_long(&str, end, &m) || n < 1 || m < 1) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Invalid dimensions in %s\n", data_file);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	str = gensvm_parse_next_line(str, end);
+
+	// Check if there is a label at the end of the first instance
+	while (str < end && gensvm_parse_line_end(str, end))
+		str = gensvm_parse_next_line(str, end);
+	first = Malloc(double, m+2);
+	probe = str;
+	n_first = gensvm_parse_values(&probe, end, first, m+2);
+	free(first);
+	if (n_first != m && n_first != m+1) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: No label found on first line.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	has_labels = (n_first == m+1);
+	stream->first->skip = str - stream->first->data;
+
+	free(dataset->y);
+	dataset->y = has_labels ? Malloc(long, n) : NULL;
+
+	// decompress the rest of the file while the blocks are parsed
+	#pragma omp parallel private(block)
+	{
+		#pragma omp single nowait
+		{
+			while (gensvm_gzip_read_block(stream, 1)) {
+				while (gensvm_gzip_queued(stream) >
+						GENSVM_GZIP_MAX_QUEUED &&
+						(block = gensvm_gzip_take(
+							stream, false)) != NULL)
+					gensvm_gzip_parse_dense(block, n, m,
+							has_labels,
+							dataset->y);
+			}
+			gensvm_gzip_finish(stream);
+		}
+		while ((block = gensvm_gzip_take(stream, true)) != NULL)
+			gensvm_gzip_parse_dense(block, n, m, has_labels,
+					dataset->y);
+	}
+
+	chunks = gensvm_gzip_chunks(stream);
+	n_read = gensvm_parse_check_rows(chunks, stream->n_blocks, n);
+	if (n_read < n) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: not enough data found in %s\n",
+				data_file);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	// collect the fragments of the blocks
+	fragments = Malloc(struct GenSparse *, stream->n_blocks);
+	for (c=0, block=stream->first; block != NULL; c++,
+			block=block->next) {
+		fragments[c] = block->fragment;
+		block->fragment = NULL;
+		nnz += fragments[c]->nnz;
+	}
+
+	// check if sparsity is worth it, don't forget the column of ones
+	if (gensvm_nnz_comparison(nnz + n, n, m+1)) {
+		dataset->spZ = gensvm_parse_stitch_sparse(fragments, chunks,
+				stream->n_blocks, n, m, 0);
+	} else {
+		dataset->RAW = Calloc(double, n*(m+1));
+		gensvm_parse_stitch_dense(fragments, chunks,
+				stream->n_blocks, m, 0, dataset->RAW);
+	}
+	free(chunks);
+	gensvm_gzip_close(stream);
+
+	if (dataset->y != NULL)
+		for (i=0; i<n; i++)
+			K = maximum(K, dataset->y[i]);
+
+	dataset->n = n;
+	dataset->m = m;
+	dataset->r = m;
+	dataset->K = K;
+	dataset->Z = dataset->RAW;
+}
+
+/**
+ * @brief Read a gzip compressed data file in LibSVM format
+ *
+ * @details
+ * This reads a compressed file in the format of the @ref
+ * spec_libsvm_data_file, in the same way as gensvm_read_data_libsvm(). The
+ * blocks are parsed into CSR fragments while the file is decompressed, and
+ * the fragments are combined with gensvm_read_data_libsvm_stitch().
+ *
+ * @param[in,out] 	data 		initialized GenData struct
+ * @param[in] 		data_file 	filename of the compressed data file
+ */
+void gensvm_read_data_libsvm_gzip(struct GenData *data, char *data_file)
+{
+	long c, n,
+	     n_labels = 0,
+	     nnz = 0,
+	     min_index = LONG_MAX,
+	     max_index = -1;
+	struct GenGzipStream *stream = gensvm_gzip_open(data_file);
+	struct GenGzipBlock *block = NULL;
+	struct GenParseChunk *chunks = NULL;
+	struct GenSparse **fragments = NULL;
+
+	#pragma omp parallel private(block)
+	{
+		#pragma omp single nowait
+		{
+			while (gensvm_gzip_read_block(stream, 1)) {
+				while (gensvm_gzip_queued(stream) >
+						GENSVM_GZIP_MAX_QUEUED &&
+						(block = gensvm_gzip_take(
+							stream, false)) != NULL)
+					gensvm_gzip_parse_libsvm(block);
+			}
+			gensvm_gzip_finish(stream);
+		}
+		while ((block = gensvm_gzip_take(stream, true)) != NULL)
+			gensvm_gzip_parse_libsvm(block);
+	}
+
+	n = stream->n_rows;
+	if (n == 0) {
+		err("[GenSVM Error]: No instances found in %s\n", data_file);
+		exit(EXIT_FAILURE);
+	}
+
+	// collect the fragments and the labels of the blocks
+	chunks = gensvm_gzip_chunks(stream);
+	fragments = Malloc(struct GenSparse *, stream->n_blocks);
+	free(data->y);
+	data->y = Malloc(long, n);
+	for (c=0, block=stream->first; block != NULL; c++,
+			block=block->next) {
+		if (block->chunk.error_row >= 0) {
+			err("[GenSVM Error]: Wrong input format on line: "
+					"%li\n", block->chunk.error_row + 1);
+			exit(EXIT_FAILURE);
+		}
+		memcpy(data->y + block->chunk.row_start, block->y,
+				block->chunk.n_rows*sizeof(long));
+		fragments[c] = block->fragment;
+		block->fragment = NULL;
+		n_labels += block->n_labels;
+		nnz += fragments[c]->nnz;
+		min_index = minimum(min_index, block->min_index);
+		max_index = maximum(max_index, block->max_index);
+	}
+
+	gensvm_read_data_libsvm_stitch(data, fragments, chunks,
+			stream->n_blocks, n_labels, min_index, max_index, nnz);
+	free(chunks);
+	gensvm_gzip_close(stream);
+}
+
+/**
+ * @brief Parse a block of a compressed data file in the default format
+ *
+ * @details
+ * The rows of the block are parsed with gensvm_parse_dense_chunk() into a
+ * CSR fragment, and the decompressed data is freed. The labels are stored
+ * in the rows of y that start at GenParseChunk::row_start.
+ *
+ * @param[in,out] 	block 		a block of gensvm_gzip_take()
+ * @param[in] 		n 		number of rows of the file
+ * @param[in] 		m 		number of features
+ * @param[in] 		has_labels 	whether the rows end with a label
+ * @param[out] 		y 		allocated array of n labels, or NULL if
+ * 					has_labels is false
+ */
+void gensvm_gzip_parse_dense(struct GenGzipBlock *block, long n, long m,
+		bool has_labels, long *y)
+{
+	block->fragment = gensvm_parse_dense_chunk(&block->chunk,
+			block->data + block->size, n, m, has_labels, y);
+	free(block->data);
+	block->data = NULL;
+}
+
+/**
+ * @brief Parse a block of a compressed data file in LibSVM format
+ *
+ * @details
+ * The rows of the block are parsed with gensvm_parse_libsvm_chunk() into a
+ * CSR fragment and an array of labels of the block, and the decompressed
+ * data is freed. The number of the first row with an invalid format is
+ * stored in GenParseChunk::error_row of the block.
+ *
+ * @param[in,out] 	block 	a block of gensvm_gzip_take()
+ */
+void gensvm_gzip_parse_libsvm(struct GenGzipBlock *block)
+{
+	struct GenParseChunk chunk = block->chunk;
+
+	// the labels are stored per block, starting at zero
+	chunk.row_start = 0;
+	block->y = Malloc(long, maximum(chunk.n_rows, 1));
+	block->fragment = gensvm_parse_libsvm_chunk(&chunk,
+			block->data + block->size, block->y,
+			&block->n_labels, &block->min_index,
+			&block->max_index);
+	if (chunk.error_row >= 0)
+		block->chunk.error_row = block->chunk.row_start +
+			chunk.error_row;
+	free(block->data);
+	block->data = NULL;
+}
+
+/**
+ * @brief Open a gzip compressed file for decompression in blocks
+ *
+ * @details
+ * Both gzip and zlib streams are recognized, and files with multiple gzip
+ * members are decompressed as a single file, as with gunzip.
+ *
+ * @param[in] 	filename 	filename of the compressed file
+ * @returns 			a GenGzipStream for the file
+ */
+struct GenGzipStream *gensvm_gzip_open(char *filename)
+{
+	struct GenGzipStream *stream = Malloc(struct GenGzipStream, 1);
+
+	stream->fid = fopen(filename, "rb");
+	if (stream->fid == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Datafile %s could not be opened.\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	stream->filename = filename;
+	stream->input = Malloc(unsigned char, GENSVM_GZIP_INPUT_SIZE);
+	stream->in_member = false;
+	stream->end_of_input = false;
+	stream->carry = NULL;
+	stream->carry_size = 0;
+	stream->first = NULL;
+	stream->last = NULL;
+	stream->next = NULL;
+	stream->n_blocks = 0;
+	stream->n_taken = 0;
+	stream->n_rows = 0;
+	stream->done = false;
+
+	memset(&stream->zs, 0, sizeof(z_stream));
+	if (inflateInit2(&stream->zs, 15 + 32) != Z_OK) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Couldn't initialize zlib.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	return stream;
+}
+
+/**
+ * @brief Close a compressed file and free the blocks
+ *
+ * @param[in] 	stream 	a GenGzipStream of gensvm_gzip_open()
+ */
+void gensvm_gzip_close(struct GenGzipStream *stream)
+{
+	struct GenGzipBlock *block = NULL;
+
+	if (stream == NULL)
+		return;
+
+	while (stream->first != NULL) {
+		block = stream->first;
+		stream->first = block->next;
+		free(block->data);
+		free(block->y);
+		if (block->fragment != NULL)
+			gensvm_free_sparse(block->fragment);
+		free(block);
+	}
+	inflateEnd(&stream->zs);
+	fclose(stream->fid);
+	free(stream->input);
+	free(stream->carry);
+	free(stream);
+}
+
+/**
+ * @brief Decompress the next block of a compressed file
+ *
+ * @details
+ * Data is decompressed until the block holds at least
+ * GENSVM_PARSE_CHUNK_SIZE bytes and min_lines complete lines, or until the
+ * end of the file. The block is then cut after the last newline, and the
+ * rest is kept for the next block. The block is added to the list of
+ * blocks, where it can be taken with gensvm_gzip_take().
+ *
+ * @param[in,out] 	stream 		a GenGzipStream
+ * @param[in] 		min_lines 	minimal number of lines in the block
+ * @returns 				whether a block was added, false at the
+ * 					end of the file
+ */
+bool gensvm_gzip_read_block(struct GenGzipStream *stream, long min_lines)
+{
+	long lines = 0;
+	size_t scanned = 0,
+	       capacity = 2*GENSVM_PARSE_CHUNK_SIZE + stream->carry_size;
+	const char *newline = NULL;
+	struct GenGzipBlock *block = Malloc(struct GenGzipBlock, 1);
+
+	block->data = Malloc(char, capacity);
+	block->size = stream->carry_size;
+	block->skip = 0;
+	block->fragment = NULL;
+	block->y = NULL;
+	block->next = NULL;
+	if (stream->carry_size > 0)
+		memcpy(block->data, stream->carry, stream->carry_size);
+	free(stream->carry);
+	stream->carry = NULL;
+	stream->carry_size = 0;
+
+	while (true) {
+		// count the newlines in the new data
+		while ((newline = memchr(block->data + scanned, '\n',
+						block->size - scanned)) !=
+				NULL) {
+			lines++;
+			scanned = newline - block->data + 1;
+		}
+		scanned = block->size;
+
+		if (stream->end_of_input || (lines >= min_lines &&
+					block->size >= GENSVM_PARSE_CHUNK_SIZE))
+			break;
+		if (block->size == capacity) {
+			capacity *= 2;
+			block->data = Realloc(block->data, char, capacity);
+		}
+		block->size += gensvm_gzip_inflate(stream,
+				block->data + block->size,
+				capacity - block->size);
+	}
+
+	if (block->size == 0) {
+		free(block->data);
+		free(block);
+		return false;
+	}
+
+	// keep the part of the last line for the next block
+	if (!stream->end_of_input) {
+		for (scanned=block->size; block->data[scanned-1] != '\n';
+				scanned--);
+		stream->carry_size = block->size - scanned;
+		stream->carry = Malloc(char, maximum(stream->carry_size, 1));
+		memcpy(stream->carry, block->data + scanned,
+				stream->carry_size);
+		block->size = scanned;
+	}
+
+	#pragma omp critical (gensvm_gzip)
+	{
+		if (stream->last == NULL)
+			stream->first = block;
+		else
+			stream->last->next = block;
+		stream->last = block;
+		if (stream->next == NULL)
+			stream->next = block;
+		stream->n_blocks++;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read the next line of a compressed file
+ *
+ * @details
+ * This reads a compressed file line by line in the same way as getline(),
+ * for reading a file in chunks with a GenDataReader. Only the current
+ * block is kept: the next block is decompressed with
+ * gensvm_gzip_read_block() when all lines of the current block are read,
+ * and the current block is then freed. GenGzipBlock::skip holds the number
+ * of bytes of the block that are read. The stream shouldn't be used with
+ * gensvm_gzip_take() as well.
+ *
+ * @param[in,out] 	stream 		a GenGzipStream
+ * @param[in,out] 	line 		buffer for the line, which grows when
+ * 					needed
+ * @param[in,out] 	line_size 	allocated size of the buffer
+ * @returns 				number of characters of the line
+ * 					including the newline, or -1 at the end
+ * 					of the file
+ */
+long gensvm_gzip_getline(struct GenGzipStream *stream, char **line,
+		size_t *line_size)
+{
+	size_t len;
+	const char *start = NULL,
+	      *newline = NULL;
+	struct GenGzipBlock *block = stream->first;
+
+	while (block == NULL || block->skip == block->size) {
+		if (block != NULL) {
+			free(block->data);
+			free(block);
+			stream->first = NULL;
+			stream->last = NULL;
+			stream->next = NULL;
+		}
+		if (!gensvm_gzip_read_block(stream, 1))
+			return -1;
+		block = stream->first;
+	}
+
+	// a block ends with a complete line, except at the end of the file
+	start = block->data + block->skip;
+	newline = memchr(start, '\n', block->size - block->skip);
+	len = (newline == NULL) ? block->size - block->skip :
+		(size_t) (newline - start) + 1;
+	if (*line_size < len + 1) {
+		*line_size = len + 1;
+		*line = Realloc(*line, char, *line_size);
+	}
+	memcpy(*line, start, len);
+	(*line)[len] = '\0';
+	block->skip += len;
+
+	return len;
+}
+
+/**
+ * @brief Decompress data from a compressed file
+ *
+ * @details
+ * Data is decompressed into the buffer until it is full or until the end
+ * of the file. A file that ends in the middle of a gzip member or that
+ * isn't valid gzip data results in an error.
+ *
+ * @param[in,out] 	stream 	a GenGzipStream
+ * @param[out] 		buffer 	buffer for the decompressed data
+ * @param[in] 		size 	size of the buffer
+ * @returns 			number of bytes decompressed
+ */
+size_t gensvm_gzip_inflate(struct GenGzipStream *stream, char *buffer,
+		size_t size)
+{
+	int status;
+	size_t n_read;
+	z_stream *zs = &stream->zs;
+
+	zs->next_out = (unsigned char *) buffer;
+	zs->avail_out = size;
+	while (zs->avail_out > 0 && !stream->end_of_input) {
+		if (zs->avail_in == 0) {
+			n_read = fread(stream->input, 1,
+					GENSVM_GZIP_INPUT_SIZE, stream->fid);
+			if (n_read == 0) {
+				if (stream->in_member) {
+					err("[GenSVM Error]: Compressed file "
+							"%s is truncated.\n",
+							stream->filename);
+					exit(EXIT_FAILURE);
+				}
+				stream->end_of_input = true;
+				break;
+			}
+			zs->next_in = stream->input;
+			zs->avail_in = n_read;
+		}
+
+		stream->in_member = true;
+		status = inflate(zs, Z_NO_FLUSH);
+		if (status == Z_STREAM_END) {
+			// another gzip member may follow
+			stream->in_member = false;
+			inflateReset(zs);
+		} else if (status != Z_OK) {
+			err("[GenSVM Error]: Compressed file %s is "
+					"corrupted.\n", stream->filename);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	return size - zs->avail_out;
+}
+
+/**
+ * @brief Take the next block of a compressed file for parsing
+ *
+ * @details
+ * The blocks are taken in the order of the file, and the rows of a block
+ * are counted when it is taken, which gives the index of its first row. If
+ * wait is true and the next block isn't decompressed yet, this waits until
+ * it is, or until gensvm_gzip_finish() is called.
+ *
+ * @param[in,out] 	stream 	a GenGzipStream
+ * @param[in] 		wait 	whether to wait for the next block
+ * @returns 		 	the next block, or NULL if there is none
+ */
+struct GenGzipBlock *gensvm_gzip_take(struct GenGzipStream *stream,
+		bool wait)
+{
+	bool done = false;
+	struct GenGzipBlock *block = NULL;
+	struct timespec pause = {0, GENSVM_GZIP_WAIT};
+
+	while (true) {
+		#pragma omp critical (gensvm_gzip)
+		{
+			block = stream->next;
+			if (block != NULL) {
+				stream->next = block->next;
+				block->chunk.start = block->data + block->skip;
+				block->chunk.end = block->data + block->size;
+				block->chunk.n_rows = gensvm_parse_count_rows(
+						block->chunk.start,
+						block->chunk.end);
+				block->chunk.row_start = stream->n_rows;
+				block->chunk.nnz = 0;
+				block->chunk.error_row = -1;
+				stream->n_rows += block->chunk.n_rows;
+				stream->n_taken++;
+			}
+			done = stream->done;
+		}
+		if (block != NULL || done || !wait)
+			return block;
+		nanosleep(&pause, NULL);
+	}
+}
+
+/**
+ * @brief Number of decompressed blocks that aren't taken yet
+ *
+ * @param[in] 	stream 	a GenGzipStream
+ * @returns 		number of blocks waiting to be parsed
+ */
+long gensvm_gzip_queued(struct GenGzipStream *stream)
+{
+	long queued;
+
+	#pragma omp critical (gensvm_gzip)
+	queued = stream->n_blocks - stream->n_taken;
+
+	return queued;
+}
+
+/**
+ * @brief Mark that all blocks of a compressed file are decompressed
+ *
+ * @details
+ * After this, gensvm_gzip_take() returns NULL instead of waiting when there
+ * are no more blocks.
+ *
+ * @param[in,out] 	stream 	a GenGzipStream
+ */
+void gensvm_gzip_finish(struct GenGzipStream *stream)
+{
+	#pragma omp critical (gensvm_gzip)
+	stream->done = true;
+}
+
+/**
+ * @brief Collect the chunks of the blocks of a compressed file
+ *
+ * @param[in] 	stream 	a GenGzipStream of which all blocks are parsed
+ * @returns 		array of the GenGzipBlock::chunk of all blocks
+ */
+struct GenParseChunk *gensvm_gzip_chunks(struct GenGzipStream *stream)
+{
+	long c = 0;
+	struct GenGzipBlock *block = NULL;
+	struct GenParseChunk *chunks = Malloc(struct GenParseChunk,
+			maximum(stream->n_blocks, 1));
+
+	for (block=stream->first; block != NULL; block=block->next)
+		chunks[c++] = block->chunk;
+
+	return chunks;
+}
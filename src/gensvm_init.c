@@ -49,6 +49,7 @@
  * numbers between the inverse of the minimum and the inverse of the maximum 
  * of the corresponding column of Z. This is done to center the product of the 
  * two in the simplex space.
+ * The column of ones of wrapped data (see gensvm_wrap_dense()) is implied.
  *
  * @param[in] 		from_model 	GenModel from which to copy V
  * @param[in,out] 	to_model 	GenModel to which V will be copied
@@ -57,7 +58,8 @@
 void gensvm_init_V(struct GenModel *from_model,
 	       	struct GenModel *to_model, struct GenData *data)
 {
-	long i, j, k, jj_start, jj_end, jj;
+	long i, j, k, jj_start, jj_end, jj,
+	     shift = data->wrapped ? 1 : 0;
 	double cmin, cmax, value, rnd;
 	double *col_min = NULL,
 	       *col_max = NULL;
@@ -76,11 +78,16 @@ void gensvm_init_V(struct GenModel *from_model,
 		if (data->Z == NULL) {
 			// sparse matrix
 			long *visit_count = Calloc(long, to_model->m+1);
+			if (shift) {
+				// the implied column of ones of wrapped data
+				col_min[0] = col_max[0] = 1.0;
+				visit_count[0] = data->spZ->n_row;
+			}
 			for (i=0; i<data->spZ->n_row; i++) {
 				jj_start = data->spZ->ia[i];
 				jj_end = data->spZ->ia[i+1];
 				for (jj=jj_start; jj<jj_end; jj++) {
-					j = data->spZ->ja[jj];
+					j = data->spZ->ja[jj] + shift;
 					value = data->spZ->values[jj];
 
 					col_min[j] = minimum(col_min[j], value);
@@ -98,10 +105,13 @@ void gensvm_init_V(struct GenModel *from_model,
 			free(visit_count);
 		} else {
 			// dense matrix
+			if (shift)
+				col_min[0] = col_max[0] = 1.0;
 			for (i=0; i<to_model->n; i++) {
-				for (j=0; j<to_model->m+1; j++) {
-					value = matrix_get(data->Z, 
-							to_model->m+1, i, j);
+				for (j=shift; j<to_model->m+1; j++) {
+					value = matrix_get(data->Z,
+							to_model->m+1-shift,
+							i, j-shift);
 					col_min[j] = minimum(col_min[j], value);
 					col_max[j] = maximum(col_max[j], value);
 				}
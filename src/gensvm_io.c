@@ -30,6 +30,10 @@
  */
 
 #include "gensvm_io.h"
+#include "gensvm_binary.h"
+#include "gensvm_gzip.h"
+#include "gensvm_npy.h"
+#include "gensvm_parse.h"
 
 /**
  * @brief Read data from file
@@ -41,71 +45,97 @@
  * The class labels are assumed to be in the interval [1 .. K], which can be
  * checked using the function gensvm_check_outcome_contiguous().
  *
+ * The file is mapped into memory and split in chunks that are parsed in
+ * parallel. The nonzero values are counted first with
+ * gensvm_parse_chunks_nnz(), which stops early for dense data. If a sparse
+ * matrix is worth it (see gensvm_nnz_comparison()), the instances are
+ * parsed directly into GenData::spZ with gensvm_parse_sparse(), so that the
+ * dense matrix is never allocated. Otherwise, they are parsed into
+ * GenData::RAW with gensvm_parse_dense(). Whether the instances have labels
+ * is determined from the number of values on the first line with an
+ * instance. Binary data files and NumPy .npy and .npz files are recognized
+ * by their magic bytes and read with gensvm_read_data_binary() and
+ * gensvm_read_data_npy() instead. Gzip compressed files are decompressed
+ * while they are parsed with gensvm_read_data_gzip().
+ *
  * @param[in,out] 	dataset 	initialized GenData struct
  * @param[in] 		data_file 	filename of the data file.
  */
 void gensvm_read_data(struct GenData *dataset, char *data_file)
 {
-	FILE *fid = NULL;
-	long i, j, n, m,
-	     nr = 0,
+	long i, n, m, nnz, n_chunks, n_first,
+	     n_read = 0,
 	     K = 0;
-	double value;
-	char buf[GENSVM_MAX_LINE_LENGTH];
+	size_t size;
+	char *map = NULL;
+	double *first = NULL;
+	const char *str = NULL,
+	      *end = NULL,
+	      *probe = NULL;
+	struct GenParseChunk *chunks = NULL;
+
+	if (gensvm_is_binary_data(data_file)) {
+		gensvm_read_data_binary(dataset, data_file);
+		return;
+	}
+	if (gensvm_is_npy_data(data_file)) {
+		gensvm_read_data_npy(dataset, data_file);
+		return;
+	}
+	if (gensvm_is_gzip_data(data_file)) {
+		gensvm_read_data_gzip(dataset, data_file);
+		return;
+	}
+
+	map = gensvm_map_file(data_file, &size);
+	str = map;
+	end = map + size;
 
-	if ((fid = fopen(data_file, "r")) == NULL) {
+	// Read data dimensions
+	if (!gensvm_parse_long(&str, end, &n) ||
+			!gensvm_parse_long(&str, end, &m) || n < 1 || m < 1) {
 		// LCOV_EXCL_START
-		err("[GenSVM Error]: Datafile %s could not be opened.\n",
-				data_file);
+		err("[GenSVM Error]: Invalid dimensions in %s\n", data_file);
 		exit(EXIT_FAILURE);
 		// LCOV_EXCL_STOP
 	}
-
-	// Read data dimensions
-	nr += fscanf(fid, "%ld", &n);
-	nr += fscanf(fid, "%ld", &m);
-
-	// Allocate memory
-	dataset->RAW = Malloc(double, n*(m+1));
-
-	// Read first line of data
-	for (j=1; j<m+1; j++) {
-		nr += fscanf(fid, "%lf", &value);
-		matrix_set(dataset->RAW, m+1, 0, j, value);
-	}
-
-	if (fgets(buf, GENSVM_MAX_LINE_LENGTH, fid) == NULL) {
+	str = gensvm_parse_next_line(str, end);
+
+	// Check if there is a label at the end of the first instance
+	while (str < end && gensvm_parse_line_end(str, end))
+		str = gensvm_parse_next_line(str, end);
+	first = Malloc(double, m+2);
+	probe = str;
+	n_first = gensvm_parse_values(&probe, end, first, m+2);
+	free(first);
+	if (n_first != m && n_first != m+1) {
 		// LCOV_EXCL_START
 		err("[GenSVM Error]: No label found on first line.\n");
 		exit(EXIT_FAILURE);
 		// LCOV_EXCL_STOP
 	}
-
-	// Check if there is a label at the end of the line
-	if (sscanf(buf, "%lf", &value) > 0) {
-		dataset->y = Malloc(long, n);
-		dataset->y[0] = value;
-		K = 1;
+	free(dataset->y);
+	dataset->y = (n_first == m+1) ? Malloc(long, n) : NULL;
+
+	// Count the nonzeros to choose between dense and sparse
+	n_chunks = gensvm_parse_n_chunks(end - str);
+	chunks = gensvm_parse_chunks(str, end, n_chunks);
+	nnz = gensvm_parse_chunks_nnz(chunks, n_chunks, m, n*m/2) + n;
+
+	if (gensvm_nnz_comparison(nnz, n, m+1)) {
+		note("Reading data in sparse format ... ");
+		dataset->spZ = gensvm_parse_sparse(chunks, n_chunks, end, n, m,
+				dataset->y != NULL, dataset->y, &n_read);
+		note("done.\n");
 	} else {
-		free(dataset->y);
-		dataset->y = NULL;
+		dataset->RAW = Malloc(double, n*(m+1));
+		n_read = gensvm_parse_dense(chunks, n_chunks, end, n, m,
+				dataset->y != NULL, dataset->RAW, dataset->y);
 	}
+	free(chunks);
+	gensvm_unmap_file(map, size);
 
-	// Read the rest of the file
-	for (i=1; i<n; i++) {
-		for (j=1; j<m+1; j++) {
-			nr += fscanf(fid, "%lf", &value);
-			matrix_set(dataset->RAW, m+1, i, j, value);
-		}
-		if (dataset->y != NULL) {
-			nr += fscanf(fid, "%lf", &value);
-			dataset->y[i] = (long) value;
-			K = maximum(K, dataset->y[i]);
-		}
-	}
-	fclose(fid);
-
-	if (nr < n * m) {
+	if (n_read < n) {
 		// LCOV_EXCL_START
 		err("[GenSVM Error]: not enough data found in %s\n",
 				data_file);
@@ -113,24 +143,15 @@ void gensvm_read_data(struct GenData *dataset, char *data_file)
 		// LCOV_EXCL_STOP
 	}
 
-	// Set the column of ones
-	for (i=0; i<n; i++)
-		matrix_set(dataset->RAW, m+1, i, 0, 1.0);
+	if (dataset->y != NULL)
+		for (i=0; i<n; i++)
+			K = maximum(K, dataset->y[i]);
 
 	dataset->n = n;
 	dataset->m = m;
 	dataset->r = m;
 	dataset->K = K;
 	dataset->Z = dataset->RAW;
-
-	if (gensvm_could_sparse(dataset->Z, n, m+1)) {
-		note("Converting to sparse ... ");
-		dataset->spZ = gensvm_dense_to_sparse(dataset->Z, n, m+1);
-		note("done.\n");
-		free(dataset->RAW);
-		dataset->RAW = NULL;
-		dataset->Z = NULL;
-	}
 }
 
 /**
@@ -158,16 +179,29 @@ void exit_input_error(int line_num)
  * which are too large for memory when kept in dense format can be loaded
  * efficiently into GenSVM.
  *
- * @note
- * This code is based on the read_problem() function in the svm-train.c
- * file of LibSVM. It has however been expanded to be able to handle data 
- * files without labels.
+ * The file is mapped into memory and split in chunks, which are tokenized
+ * in place and parsed in parallel into CSR fragments with
+ * gensvm_parse_libsvm(). The fragments are then combined into a dense or a
+ * sparse matrix, depending on the number of nonzeros. There is no limit on
+ * the length of a line. Binary data files and NumPy files are read with
+ * gensvm_read_data_binary() and gensvm_read_data_npy() instead, and gzip
+ * compressed files with gensvm_read_data_libsvm_gzip().
  *
  * @note
  * This file tries to detect whether 1-based or 0-based indexing is used in 
  * the data file. By default 1-based indexing is used, but if an index is 
  * found with value 0, 0-based indexing is assumed.
  *
+ * If GenData::hash_bits is set before reading, the feature indices are
+ * hashed into 2^hash_bits columns instead (see gensvm_parse_hash()), which
+ * bounds the number of features for files with a huge index space.
+ * Alternatively, if GenData::compact is set before reading, only the
+ * columns that are used in the file are kept, and their columns are stored
+ * in GenData::col_map. Test data is read with the map of the training data
+ * by setting GenData::col_map before reading, then features in columns
+ * that are not in the map are removed. The map is applied after hashing.
+ * Column compaction is only available for LibSVM text files.
+ *
  * @sa
  * gensvm_read_problem()
  *
@@ -177,221 +211,892 @@ void exit_input_error(int line_num)
  */
 void gensvm_read_data_libsvm(struct GenData *data, char *data_file)
 {
-	bool do_sparse, zero_based = false;
-	long i, j, n, m, K, nnz, cnt, tmp, index, row_cnt, num_labels, 
-	     min_index = 1;
-	int n_big, n_small, big_start;
-	double value;
-	FILE *fid = NULL;
-	char *label = NULL,
-	     *endptr = NULL,
-	     **big_parts = NULL,
-	     **small_parts = NULL;
-	char buf[GENSVM_MAX_LINE_LENGTH];
+	long n, nnz, n_chunks, n_labels, min_index, max_index;
+	size_t size;
+	char *map = NULL;
+	const char *end = NULL;
+	struct GenParseChunk *chunks = NULL;
+	struct GenSparse **fragments = NULL;
+
+	if (gensvm_is_binary_data(data_file) || gensvm_is_npy_data(data_file)) {
+		if (data->compact || data->col_map != NULL) {
+			err("[GenSVM Error]: Column compaction is only "
+					"available for LibSVM files, not for "
+					"%s\n", data_file);
+			exit(EXIT_FAILURE);
+		}
+		if (gensvm_is_binary_data(data_file))
+			gensvm_read_data_binary(data, data_file);
+		else
+			gensvm_read_data_npy(data, data_file);
+		return;
+	}
+	if (gensvm_is_gzip_data(data_file)) {
+		gensvm_read_data_libsvm_gzip(data, data_file);
+		return;
+	}
 
-	fid = fopen(data_file, "r");
-	if (fid == NULL) {
-		// LCOV_EXCL_START
-		err("[GenSVM Error]: Datafile %s could not be opened.\n",
-				data_file);
+	map = gensvm_map_file(data_file, &size);
+	end = map + size;
+
+	// split the file and count the instances
+	n_chunks = gensvm_parse_n_chunks(size);
+	chunks = gensvm_parse_chunks(map, end, n_chunks);
+	n = chunks[n_chunks-1].row_start + chunks[n_chunks-1].n_rows;
+	if (n == 0) {
+		err("[GenSVM Error]: No instances found in %s\n", data_file);
 		exit(EXIT_FAILURE);
-		// LCOV_EXCL_STOP
 	}
 
-	// first count the number of elements
-	n = 0;
-	m = -1;
+	// parse the chunks in parallel
+	free(data->y);
+	data->y = Malloc(long, n);
+	fragments = gensvm_parse_libsvm(chunks, n_chunks, end, data->y,
+			&n_labels, &min_index, &max_index, &nnz);
+	gensvm_unmap_file(map, size);
 
-	num_labels = 0;
-	nnz = 0;
+	gensvm_read_data_libsvm_stitch(data, fragments, chunks, n_chunks,
+			n_labels, min_index, max_index, nnz);
+	free(chunks);
+}
 
-	while (fgets(buf, GENSVM_MAX_LINE_LENGTH, fid) != NULL) {
-		// split the string in labels and/or index:value pairs
-		big_parts = str_split(buf, " \t", &n_big);
+/**
+ * @brief Combine the parsed fragments of a LibSVM file into a GenData
+ *
+ * @details
+ * This is the last step of gensvm_read_data_libsvm(), after the chunks of
+ * the file are parsed into CSR fragments. It is checked that either all or
+ * none of the rows have a label, the indexing is determined from the
+ * smallest feature index, and the fragments are combined into a dense or a
+ * sparse matrix, depending on the number of nonzeros. The fragments are
+ * freed. If GenData::hash_bits is set, the feature indices are hashed into
+ * 2^hash_bits columns with gensvm_parse_hash_fragments() first, so that
+ * the number of features doesn't depend on the largest index in the file.
+ * If GenData::compact is set, GenData::col_map is built from the columns
+ * that are used with gensvm_parse_column_map(), and if GenData::col_map is
+ * set the columns are renumbered with gensvm_parse_map_fragments().
+ *
+ * @param[in,out] 	data 		GenData with the labels of all rows
+ * 					in GenData::y
+ * @param[in] 		fragments 	CSR fragments of the chunks
+ * @param[in] 		chunks 		the parsed chunks
+ * @param[in] 		n_chunks 	number of chunks
+ * @param[in] 		n_labels 	number of rows with a label
+ * @param[in] 		min_index 	smallest feature index
+ * @param[in] 		max_index 	largest feature index
+ * @param[in] 		nnz 		number of index:value pairs
+ */
+void gensvm_read_data_libsvm_stitch(struct GenData *data,
+		struct GenSparse **fragments, struct GenParseChunk *chunks,
+		long n_chunks, long n_labels, long min_index, long max_index,
+		long nnz)
+{
+	long i, m,
+	     shift = 0,
+	     K = 0,
+	     n = chunks[n_chunks-1].row_start + chunks[n_chunks-1].n_rows;
 
-		// record if this line has a label (first part has no colon)
-		num_labels += (!str_contains_char(big_parts[0], ':'));
+	// check if we have enough labels
+	if (n_labels > 0 && n_labels != n) {
+		err("[GenSVM Error]: There are some lines with missing "
+				"labels. Please fix this before "
+				"continuing.\n");
+		exit(EXIT_FAILURE);
+	}
+	if (n_labels == 0) {
+		free(data->y);
+		data->y = NULL;
+	}
 
-		// check for each part if it is a index:value pair
-		for (i=0; i<n_big; i++) {
-			if (!str_contains_char(big_parts[i], ':'))
-				continue;
+	// deal with 0-based or 1-based indexing in the LibSVM file, or hash
+	// the indices into a fixed number of columns
+	m = max_index;
+	if (data->hash_bits > 0) {
+		gensvm_parse_hash_fragments(fragments, n_chunks,
+				data->hash_bits, data->hash_signed);
+		m = 1L << data->hash_bits;
+		for (i=0, nnz=0; i<n_chunks; i++)
+			nnz += fragments[i]->nnz;
+	} else if (min_index == 0) {
+		m++;
+		shift = 1;
+	}
 
-			// split the index:value pair
-			small_parts = str_split(big_parts[i], ":", &n_small);
+	// renumber the columns to the columns that are used in the file, or
+	// to the columns of a given map
+	if (data->compact && data->col_map == NULL)
+		data->col_map = gensvm_parse_column_map(fragments, n_chunks,
+				shift, &data->col_map_size);
+	if (data->col_map != NULL) {
+		gensvm_parse_map_fragments(fragments, n_chunks, shift,
+				data->col_map, data->col_map_size);
+		m = data->col_map_size;
+		shift = 0;
+		for (i=0, nnz=0; i<n_chunks; i++)
+			nnz += fragments[i]->nnz;
+	}
 
-			// convert the index to a number
-			index = strtol(small_parts[0], &endptr, 10);
+	// check if sparsity is worth it, don't forget the column of ones
+	if (gensvm_nnz_comparison(nnz + n, n, m+1)) {
+		data->spZ = gensvm_parse_stitch_sparse(fragments, chunks,
+				n_chunks, n, m, shift);
+	} else {
+		data->RAW = Calloc(double, n*(m+1));
+		data->Z = data->RAW;
+		gensvm_parse_stitch_dense(fragments, chunks, n_chunks, m,
+				shift, data->RAW);
+	}
 
-			// catch conversion errors
-			if (endptr == small_parts[0] || errno != 0 ||
-					*endptr != '\0')
-				exit_input_error(n+1);
+	if (data->y != NULL)
+		for (i=0; i<n; i++)
+			K = maximum(K, data->y[i]);
 
-			// update the maximum index
-			m = maximum(m, index);
+	data->n = n;
+	data->m = m;
+	data->r = m;
+	data->K = K;
+}
 
-			// update the minimum index
-			min_index = minimum(min_index, index);
+/**
+ * @brief Open a data file for reading in chunks
+ *
+ * @details
+ * Open a data file in the format of the @ref spec_data_file or the @ref 
+ * spec_libsvm_data_file, such that the instances can be read in chunks with 
+ * gensvm_read_data_chunk(). This is useful for predicting the labels of a 
+ * dataset that is too large to keep in memory. The number of instances is 
+ * read from the header of a dense data file, and is counted for a LibSVM 
+ * file.
+ *
+ * Since the number of features is not known in advance for a LibSVM file, it 
+ * must be given (usually the number of features of the model). The feature 
+ * indices in a LibSVM file are assumed to be 1-based. For a dense file the 
+ * number of features in the header should equal m.
+ *
+ * A binary data file (see gensvm_write_data_binary()) is recognized
+ * regardless of libsvm_format, and is mapped into memory with
+ * gensvm_read_data_binary(). Its chunks are then copied from the mapped
+ * file. NumPy files are mapped with gensvm_npy_open(), and their chunks are
+ * copied from the arrays in the file with gensvm_npy_get(), without
+ * converting the whole array. Sparse instances in these files may have
+ * fewer than m features, dense instances should have m features. A
+ * gzip compressed file is decompressed while it is read, with
+ * gensvm_gzip_getline(), so that only the current block of the file is
+ * kept in memory. The lines of a compressed LibSVM file are therefore
+ * counted by decompressing the file twice.
+ *
+ * If hash_bits is positive, the feature indices of a LibSVM file are hashed
+ * into 2^hash_bits columns as in gensvm_read_data_libsvm(), so m should
+ * then equal 2^hash_bits. This is used to read test data in the same way as
+ * the training data of a model (see GenModel::hash_bits). Likewise, if
+ * col_map is given, the columns of a LibSVM file are renumbered with this
+ * map of m columns after hashing (see GenModel::col_map), and features in
+ * columns that are not in the map are removed. The map isn't copied, and
+ * should be kept until the reader is closed.
+ *
+ * @param[in] 	data_file 	filename of the data file
+ * @param[in] 	libsvm_format 	whether the file is in LibSVM format
+ * @param[in] 	m 		number of features
+ * @param[in] 	hash_bits 	number of bits of the hashed feature space
+ * 				of a LibSVM file (0 = no hashing)
+ * @param[in] 	hash_signed 	whether the hashed features get a random
+ * 				sign
+ * @param[in] 	col_map 	column map of m columns for a LibSVM file,
+ * 				or NULL
+ * @returns 			a GenDataReader for the file
+ */
+struct GenDataReader *gensvm_open_data_reader(char *data_file,
+		bool libsvm_format, long m, long hash_bits, bool hash_signed,
+		long *col_map)
+{
+	bool blank = true;
+	int n_dims;
+	long m_file, len,
+	     dims[2] = {0, 0};
+	size_t i, n_read;
+	const char *str = NULL;
+	char buf[BUFSIZ];
+	struct GenDataReader *reader = Malloc(struct GenDataReader, 1);
+
+	reader->libsvm = libsvm_format;
+	reader->n = 0;
+	reader->m = m;
+	reader->n_read = 0;
+	reader->has_labels = false;
+	reader->line = NULL;
+	reader->line_size = 0;
+	reader->nnz_size = 0;
+	reader->data = NULL;
+	reader->npy = NULL;
+	reader->gzip = NULL;
+	reader->fid = NULL;
+	reader->hash_bits = libsvm_format ? hash_bits : 0;
+	reader->hash_signed = hash_signed;
+	reader->hash_marker = NULL;
+	reader->col_map = libsvm_format ? col_map : NULL;
+
+	if (gensvm_is_binary_data(data_file) ||
+			gensvm_is_npy_data(data_file)) {
+		if (reader->col_map != NULL) {
+			err("[GenSVM Error]: Column compaction is only "
+					"available for LibSVM files, not for "
+					"%s\n", data_file);
+			exit(EXIT_FAILURE);
+		}
+	}
 
-			// free the small parts
-			for (j=0; j<n_small; j++) free(small_parts[j]);
-			free(small_parts);
+	if (gensvm_is_npy_data(data_file)) {
+		reader->npy = gensvm_npy_open(data_file);
+		if (reader->npy->m > m || (!reader->npy->sparse &&
+					reader->npy->m != m)) {
+			err("[GenSVM Error]: Number of features in %s (%li) "
+					"doesn't match the expected number "
+					"(%li)\n", data_file,
+					reader->npy->m, m);
+			exit(EXIT_FAILURE);
+		}
+		reader->n = reader->npy->n;
+		reader->has_labels = reader->npy->has_labels;
+		return reader;
+	}
 
-			// increment the nonzero counter
-			nnz++;
+	if (gensvm_is_binary_data(data_file)) {
+		reader->data = gensvm_init_data();
+		reader->data->hash_bits = reader->hash_bits;
+		reader->data->hash_signed = hash_signed;
+		gensvm_read_data_binary(reader->data, data_file);
+		if (reader->data->m > m || (reader->data->spZ == NULL &&
+					reader->data->m != m)) {
+			err("[GenSVM Error]: Number of features in %s (%li) "
+					"doesn't match the expected number "
+					"(%li)\n", data_file,
+					reader->data->m, m);
+			exit(EXIT_FAILURE);
 		}
+		reader->n = reader->data->n;
+		reader->has_labels = (reader->data->y != NULL);
+		return reader;
+	}
+
+	if (gensvm_is_gzip_data(data_file)) {
+		reader->gzip = gensvm_gzip_open(data_file);
+	} else if ((reader->fid = fopen(data_file, "r")) == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Datafile %s could not be opened.\n",
+				data_file);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
 
-		// free the big parts
-		for (i=0; i<n_big; i++) {
-			free(big_parts[i]);
+	if (!libsvm_format) {
+		if (reader->gzip != NULL) {
+			// the dimensions may be on separate lines
+			n_dims = 0;
+			while (n_dims < 2 && (len = gensvm_read_data_line(
+							reader)) >= 0) {
+				str = reader->line;
+				while (n_dims < 2 && gensvm_parse_long(&str,
+							reader->line + len,
+							&dims[n_dims]))
+					n_dims++;
+			}
+		} else {
+			n_dims = fscanf(reader->fid, "%ld %ld", &dims[0],
+					&dims[1]);
+		}
+		reader->n = dims[0];
+		m_file = dims[1];
+		if (n_dims != 2) {
+			// LCOV_EXCL_START
+			err("[GenSVM Error]: No data dimensions found in "
+					"%s\n", data_file);
+			exit(EXIT_FAILURE);
+			// LCOV_EXCL_STOP
+		}
+		if (m_file != m) {
+			err("[GenSVM Error]: Number of features in %s (%li) "
+					"doesn't match the expected number "
+					"(%li)\n", data_file, m_file, m);
+			exit(EXIT_FAILURE);
 		}
-		free(big_parts);
+		return reader;
+	}
 
-		// increment the number of observations
-		n++;
+	if (reader->hash_bits > 0) {
+		reader->hash_marker = Malloc(long, (1L << hash_bits) + 1);
+		for (i=0; i<(size_t) (1L << hash_bits) + 1; i++)
+			reader->hash_marker[i] = -1;
 	}
 
-	// rewind the file pointer
-	rewind(fid);
+	// count the lines of a compressed LibSVM file that aren't blank, and 
+	// start again at the beginning of the file
+	if (reader->gzip != NULL) {
+		while (gensvm_read_data_line(reader) >= 0) {
+			for (i=0; isspace(reader->line[i]); i++);
+			reader->n += (reader->line[i] != '\0');
+		}
+		gensvm_gzip_close(reader->gzip);
+		reader->gzip = gensvm_gzip_open(data_file);
+		return reader;
+	}
 
-	// check if we have enough labels
-	if (num_labels > 0 && num_labels != n) {
-		err("[GenSVM Error]: There are some lines with missing "
-				"labels. Please fix this before "
-				"continuing.\n");
-		exit(EXIT_FAILURE);
+	// count the lines of the LibSVM file that aren't blank, without 
+	// keeping them
+	while ((n_read = fread(buf, 1, BUFSIZ, reader->fid)) > 0) {
+		for (i=0; i<n_read; i++) {
+			if (buf[i] == '\n') {
+				reader->n += blank ? 0 : 1;
+				blank = true;
+			} else if (!isspace(buf[i])) {
+				blank = false;
+			}
+		}
 	}
+	if (!blank)
+		reader->n++;
+	rewind(reader->fid);
 
-	// don't forget the column of ones
-	nnz += n;
+	return reader;
+}
 
-	// deal with 0-based or 1-based indexing in the LibSVM file
-	if (min_index == 0) {
-		m++;
-		zero_based = true;
-	}
-
-	// check if sparsity is worth it
-	do_sparse = gensvm_nnz_comparison(nnz, n, m+1);
-	if (do_sparse) {
-		data->spZ = gensvm_init_sparse();
-		data->spZ->nnz = nnz;
-		data->spZ->n_row = n;
-		data->spZ->n_col = m+1;
-		data->spZ->values = Calloc(double, nnz);
-		data->spZ->ia = Calloc(long, n+1);
-		data->spZ->ja = Calloc(long, nnz);
-		data->spZ->ia[0] = 0;
-	} else {
-		data->RAW = Calloc(double, n*(m+1));
-		data->Z = data->RAW;
+/**
+ * @brief Read the next chunk of instances from a data file
+ *
+ * @details
+ * Read at most max_n instances from a data file opened with 
+ * gensvm_open_data_reader() into the given GenData. The first time, the 
+ * memory for a chunk of max_n instances is allocated in the GenData, which is 
+ * reused for the next chunks, so the same GenData should be passed on every 
+ * call (and not be used with another reader). Instances from a dense file 
+ * are stored in GenData::RAW (and GenData::Z), instances from a LibSVM file 
+ * in GenData::spZ. Both include the column of ones. If the file has labels, 
+ * they are stored in GenData::y.
+ *
+ * @param[in] 		reader 	an open GenDataReader
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @returns 			number of instances read, which is 0 at the
+ * 				end of the file
+ */
+long gensvm_read_data_chunk(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n)
+{
+	long n;
+
+	n = minimum(max_n, reader->n - reader->n_read);
+	if (n <= 0)
+		return 0;
+
+	if (reader->data != NULL)
+		gensvm_read_data_chunk_binary(reader, chunk, max_n, n);
+	else if (reader->npy != NULL)
+		gensvm_read_data_chunk_npy(reader, chunk, max_n, n);
+	else if (reader->libsvm)
+		gensvm_read_data_chunk_libsvm(reader, chunk, max_n, n);
+	else if (reader->gzip != NULL)
+		gensvm_read_data_chunk_dense_gzip(reader, chunk, max_n, n);
+	else
+		gensvm_read_data_chunk_dense(reader, chunk, max_n, n);
+
+	chunk->n = n;
+	chunk->m = reader->m;
+	chunk->r = reader->m;
+
+	return n;
+}
+
+/**
+ * @brief Read a chunk of instances from a dense data file
+ *
+ * @details
+ * Whether the file has labels is determined from the first instance, in the 
+ * same way as in gensvm_read_data().
+ *
+ * @param[in] 		reader 	an open GenDataReader for a dense file
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @param[in] 		n 	number of instances to read
+ */
+void gensvm_read_data_chunk_dense(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n)
+{
+	long i, j, m = reader->m;
+	double value;
+
+	if (chunk->RAW == NULL) {
+		chunk->RAW = Malloc(double, max_n*(m+1));
+		chunk->Z = chunk->RAW;
 	}
-	if (num_labels > 0)
-		data->y = Calloc(long, n);
 
-	K = 0;
-	cnt = 0;
 	for (i=0; i<n; i++) {
-		fgets(buf, GENSVM_MAX_LINE_LENGTH, fid);
+		matrix_set(chunk->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++) {
+			if (fscanf(reader->fid, "%lf", &value) != 1) {
+				err("[GenSVM Error]: Not enough data found "
+						"for instance %li\n",
+						reader->n_read+1);
+				exit(EXIT_FAILURE);
+			}
+			matrix_set(chunk->RAW, m+1, i, j, value);
+		}
 
-		// split the string in labels and/or index:value pairs
-		big_parts = str_split(buf, " \t", &n_big);
+		// check if there is a label at the end of the first line
+		if (reader->n_read == 0) {
+			if (getline(&reader->line, &reader->line_size,
+						reader->fid) > 0 &&
+					sscanf(reader->line, "%lf", &value) > 0)
+				reader->has_labels = true;
+		} else if (reader->has_labels) {
+			if (fscanf(reader->fid, "%lf", &value) != 1) {
+				err("[GenSVM Error]: No label found for "
+						"instance %li\n",
+						reader->n_read+1);
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (reader->has_labels) {
+			if (chunk->y == NULL)
+				chunk->y = Malloc(long, max_n);
+			chunk->y[i] = (long) value;
+		}
+		reader->n_read++;
+	}
+}
 
-		big_start = 0;
-		// get the label from the first part if it exists
-		if (!str_contains_char(big_parts[0], ':')) {
-			label = strtok(big_parts[0], " \t\n");
-			if (label == NULL) // empty line
-				exit_input_error(i+1);
+/**
+ * @brief Read a chunk of instances from a compressed dense data file
+ *
+ * @details
+ * The lines are decompressed one at a time with gensvm_read_data_line(), 
+ * and parsed with gensvm_parse_dense_row(). Blank lines are skipped. 
+ * Whether the file has labels is determined from the number of values on 
+ * the first instance, as in gensvm_read_data_gzip().
+ *
+ * @param[in] 		reader 	an open GenDataReader for a compressed dense
+ * 				file
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @param[in] 		n 	number of instances to read
+ */
+void gensvm_read_data_chunk_dense_gzip(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n)
+{
+	int status;
+	long i, len, label, n_values,
+	     m = reader->m;
+	const char *str = NULL,
+	      *probe = NULL;
+	double *values = NULL;
+
+	if (chunk->RAW == NULL) {
+		chunk->RAW = Malloc(double, max_n*(m+1));
+		chunk->Z = chunk->RAW;
+	}
 
-			// convert the label part to a number exit if there
-			// are errors
-			tmp = strtol(label, &endptr, 10);
-			if (endptr == label || *endptr != '\0')
-				exit_input_error(i+1);
+	for (i=0; i<n; i++) {
+		do {
+			if ((len = gensvm_read_data_line(reader)) < 0) {
+				err("[GenSVM Error]: Not enough data found "
+						"for instance %li\n",
+						reader->n_read+1);
+				exit(EXIT_FAILURE);
+			}
+			str = reader->line;
+		} while (gensvm_parse_line_end(str, str + len));
+
+		// check if there is a label at the end of the first line
+		if (reader->n_read == 0) {
+			values = Malloc(double, m+2);
+			probe = str;
+			n_values = gensvm_parse_values(&probe, str + len,
+					values, m+2);
+			free(values);
+			reader->has_labels = (n_values == m+1);
+		}
 
-			// assign label to y
-			data->y[i] = tmp;
+		matrix_set(chunk->RAW, m+1, i, 0, 1.0);
+		status = gensvm_parse_dense_row(&str, str + len,
+				&chunk->RAW[i*(m+1) + 1], m,
+				reader->has_labels, &label);
+		if (status != 1) {
+			err("[GenSVM Error]: Wrong input format for instance "
+					"%li\n", reader->n_read+1);
+			exit(EXIT_FAILURE);
+		}
+		if (reader->has_labels) {
+			if (chunk->y == NULL)
+				chunk->y = Malloc(long, max_n);
+			chunk->y[i] = label;
+		}
+		reader->n_read++;
+	}
+}
 
-			// keep track of maximum K
-			K = maximum(K, data->y[i]);
+/**
+ * @brief Read a chunk of instances from a LibSVM data file
+ *
+ * @details
+ * The lines are parsed in place, and the instances are stored in compressed 
+ * row format in GenData::spZ. The memory for the nonzero elements grows when 
+ * needed, and is reused for the next chunks. Whether the file has labels is 
+ * determined from the first line, and all lines should agree. If
+ * GenDataReader::hash_bits is set, the feature indices of every line are
+ * hashed with gensvm_parse_hash_row(), and if GenDataReader::col_map is set
+ * the columns are renumbered with gensvm_parse_map_row().
+ *
+ * @param[in] 		reader 	an open GenDataReader for a LibSVM file
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @param[in] 		n 	number of instances to read
+ */
+void gensvm_read_data_chunk_libsvm(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n)
+{
+	bool has_label;
+	long i, index, label, row_start,
+	     cnt = 0,
+	     m = reader->m;
+	double value;
+	char *start = NULL,
+	     *end = NULL;
+	struct GenSparse *spZ = chunk->spZ;
+
+	if (spZ == NULL) {
+		spZ = gensvm_init_sparse();
+		spZ->ia = Calloc(long, max_n+1);
+		reader->nnz_size = max_n;
+		spZ->values = Malloc(double, reader->nnz_size);
+		spZ->ja = Malloc(long, reader->nnz_size);
+		chunk->spZ = spZ;
+	}
 
-			// increment big part index
-			big_start++;
+	for (i=0; i<n; i++) {
+		// skip blank lines, which aren't counted as instances
+		do {
+			if (gensvm_read_data_line(reader) < 0)
+				exit_input_error(reader->n_read+1);
+			start = reader->line;
+			while (isspace(*start))
+				start++;
+		} while (*start == '\0');
+
+		// determine if there is a label (the first part has no colon)
+		label = strtol(start, &end, 10);
+		has_label = (end != start && *end != ':');
+		if (reader->n_read == 0)
+			reader->has_labels = has_label;
+		if (has_label != reader->has_labels) {
+			err("[GenSVM Error]: There are some lines with "
+					"missing labels. Please fix this "
+					"before continuing.\n");
+			exit(EXIT_FAILURE);
 		}
-
-		row_cnt = 0;
-		// set the first element in the row to 1
-		if (do_sparse) {
-			data->spZ->values[cnt] = 1.0;
-			data->spZ->ja[cnt] = 0;
-			cnt++;
-			row_cnt++;
-		} else {
-			matrix_set(data->RAW, m+1, i, 0, 1.0);
+		if (has_label) {
+			if (!(isspace(*end) || *end == '\0'))
+				exit_input_error(reader->n_read+1);
+			if (chunk->y == NULL)
+				chunk->y = Malloc(long, max_n);
+			chunk->y[i] = label;
+			start = end;
 		}
 
-		// read the rest of the line
-		for (j=big_start; j<n_big; j++) {
-			if (!str_contains_char(big_parts[j], ':'))
-				continue;
+		// the column of ones and the index:value pairs
+		value = 1.0;
+		index = 0;
+		row_start = cnt + 1;
+		while (true) {
+			if (cnt == reader->nnz_size) {
+				reader->nnz_size *= 2;
+				spZ->values = Realloc(spZ->values, double,
+						reader->nnz_size);
+				spZ->ja = Realloc(spZ->ja, long,
+						reader->nnz_size);
+			}
+			spZ->values[cnt] = value;
+			spZ->ja[cnt] = index;
+			cnt++;
 
-			// split the index:value pair
-			small_parts = str_split(big_parts[j], ":", &n_small);
-			if (n_small != 2)
-				exit_input_error(n+1);
+			while (isspace(*start))
+				start++;
+			if (*start == '\0')
+				break;
 
-			// convert the index to a long
 			errno = 0;
-			index = strtol(small_parts[0], &endptr, 10);
+			index = strtol(start, &end, 10);
+			if (end == start || *end != ':' || errno != 0 ||
+					index < 0 || (reader->hash_bits == 0
+						&& reader->col_map == NULL
+						&& (index < 1 || index > m)))
+				exit_input_error(reader->n_read+1);
+			start = end + 1;
+			value = strtod(start, &end);
+			if (end == start || errno != 0 ||
+					!(isspace(*end) || *end == '\0'))
+				exit_input_error(reader->n_read+1);
+			start = end;
+		}
+		if (reader->hash_bits > 0)
+			cnt = row_start + gensvm_parse_hash_row(
+					spZ->ja + row_start,
+					spZ->values + row_start,
+					cnt - row_start, reader->hash_bits,
+					reader->hash_signed,
+					reader->hash_marker);
+		if (reader->col_map != NULL)
+			cnt = row_start + gensvm_parse_map_row(
+					spZ->ja + row_start,
+					spZ->values + row_start,
+					cnt - row_start, 0, reader->col_map,
+					m);
+		spZ->ia[i+1] = cnt;
+		reader->n_read++;
+	}
 
-			// catch conversion errors
-			if (endptr == small_parts[0] || errno != 0 ||
-					*endptr != '\0')
-				exit_input_error(n+1);
+	spZ->nnz = cnt;
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+}
 
-			// convert the value to a double
-			errno = 0;
-			value = strtod(small_parts[1], &endptr);
-			if (endptr == small_parts[1] || errno != 0 ||
-					(*endptr != '\0' && !isspace(*endptr)))
-				exit_input_error(n+1);
-
-			if (do_sparse) {
-				data->spZ->values[cnt] = value;
-				data->spZ->ja[cnt] = index + zero_based;
-				cnt++;
-				row_cnt++;
-			} else {
-				matrix_set(data->RAW, m+1, i, 
-						index + zero_based, value);
-			}
+/**
+ * @brief Read a chunk of instances from a binary data file
+ *
+ * @details
+ * The instances are copied from the data of the file in GenDataReader::data,
+ * to GenData::RAW for dense instances and to GenData::spZ for sparse
+ * instances, such that the chunk can be used in the same way as a chunk from
+ * a text file.
+ *
+ * @param[in] 		reader 	an open GenDataReader for a binary file
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @param[in] 		n 	number of instances to read
+ */
+void gensvm_read_data_chunk_binary(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n)
+{
+	long i, start, nnz,
+	     m = reader->m,
+	     first = reader->n_read;
+	struct GenData *data = reader->data;
+	struct GenSparse *spZ = chunk->spZ;
+
+	if (data->y != NULL) {
+		if (chunk->y == NULL)
+			chunk->y = Malloc(long, max_n);
+		memcpy(chunk->y, data->y + first, n*sizeof(long));
+	}
 
-			// free the small parts
-			free(small_parts[0]);
-			free(small_parts[1]);
-			free(small_parts);
+	if (data->spZ == NULL) {
+		if (chunk->RAW == NULL) {
+			chunk->RAW = Malloc(double, max_n*(m+1));
+			chunk->Z = chunk->RAW;
 		}
+		memcpy(chunk->RAW, data->RAW + first*(m+1),
+				n*(m+1)*sizeof(double));
+		reader->n_read += n;
+		return;
+	}
 
-		if (do_sparse) {
-			data->spZ->ia[i+1] = data->spZ->ia[i] + row_cnt;
+	start = data->spZ->ia[first];
+	nnz = data->spZ->ia[first+n] - start;
+	if (spZ == NULL) {
+		spZ = gensvm_init_sparse();
+		spZ->ia = Calloc(long, max_n+1);
+		chunk->spZ = spZ;
+	}
+	if (nnz > reader->nnz_size) {
+		reader->nnz_size = nnz;
+		spZ->values = Realloc(spZ->values, double, nnz);
+		spZ->ja = Realloc(spZ->ja, long, nnz);
+	}
+	memcpy(spZ->values, data->spZ->values + start, nnz*sizeof(double));
+	memcpy(spZ->ja, data->spZ->ja + start, nnz*sizeof(long));
+	for (i=0; i<n+1; i++)
+		spZ->ia[i] = data->spZ->ia[first+i] - start;
+
+	spZ->nnz = nnz;
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	reader->n_read += n;
+}
+
+/**
+ * @brief Read a chunk of instances from a NumPy data file
+ *
+ * @details
+ * The instances are copied from the arrays in the mapped file with 
+ * gensvm_npy_get(), to GenData::RAW for the dense array X and to 
+ * GenData::spZ for a CSR matrix, with the column of ones. The memory of the 
+ * chunk is reused for the next chunks, as for a text file.
+ *
+ * @param[in] 		reader 	an open GenDataReader for a NumPy file
+ * @param[in,out] 	chunk 	GenData for the instances of the chunk
+ * @param[in] 		max_n 	maximum number of instances in a chunk
+ * @param[in] 		n 	number of instances to read
+ */
+void gensvm_read_data_chunk_npy(struct GenDataReader *reader,
+		struct GenData *chunk, long max_n, long n)
+{
+	long i, j, k, pos, start, stop, nnz,
+	     m = reader->m,
+	     first = reader->n_read;
+	struct GenNpyFile *file = reader->npy;
+	struct GenNpyArray *X = &file->X;
+	struct GenSparse *spZ = chunk->spZ;
+
+	if (file->has_labels) {
+		if (chunk->y == NULL)
+			chunk->y = Malloc(long, max_n);
+		for (i=0; i<n; i++)
+			chunk->y[i] = gensvm_npy_get_long(&file->y, first+i);
+	}
+
+	if (!file->sparse) {
+		if (chunk->RAW == NULL) {
+			chunk->RAW = Malloc(double, max_n*(m+1));
+			chunk->Z = chunk->RAW;
+		}
+		#pragma omp parallel for private(j)
+		for (i=0; i<n; i++) {
+			matrix_set(chunk->RAW, m+1, i, 0, 1.0);
+			for (j=0; j<m; j++)
+				matrix_set(chunk->RAW, m+1, i, j+1,
+						gensvm_npy_get(X,
+							X->fortran_order ?
+							j*file->n + first+i :
+							(first+i)*m + j));
 		}
+		reader->n_read += n;
+		return;
+	}
 
-		// free the big parts
-		for (j=0; j<n_big; j++) {
-			free(big_parts[j]);
+	// every row gets one extra element for the column of ones
+	start = gensvm_npy_get_long(&file->indptr, first);
+	nnz = gensvm_npy_get_long(&file->indptr, first+n) - start + n;
+	if (spZ == NULL) {
+		spZ = gensvm_init_sparse();
+		spZ->ia = Calloc(long, max_n+1);
+		chunk->spZ = spZ;
+	}
+	if (nnz > reader->nnz_size) {
+		reader->nnz_size = nnz;
+		spZ->values = Realloc(spZ->values, double, nnz);
+		spZ->ja = Realloc(spZ->ja, long, nnz);
+	}
+	pos = 0;
+	for (i=0; i<n; i++) {
+		spZ->ia[i] = pos;
+		spZ->values[pos] = 1.0;
+		spZ->ja[pos++] = 0;
+		stop = gensvm_npy_get_long(&file->indptr, first+i+1);
+		for (k=gensvm_npy_get_long(&file->indptr, first+i); k<stop;
+				k++) {
+			spZ->values[pos] = gensvm_npy_get(&file->values, k);
+			spZ->ja[pos++] = gensvm_npy_get_long(&file->indices,
+					k) + 1;
 		}
-		free(big_parts);
 	}
+	spZ->ia[n] = pos;
 
-	fclose(fid);
+	spZ->nnz = nnz;
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	reader->n_read += n;
+}
 
-	data->n = n;
-	data->m = m;
-	data->r = m;
-	data->K = K;
+/**
+ * @brief Read the next line of a data file that is read in chunks
+ *
+ * @details
+ * The line is read into GenDataReader::line, with getline() from a text 
+ * file and with gensvm_gzip_getline() from a compressed file.
+ *
+ * @param[in] 	reader 	an open GenDataReader for a text or compressed file
+ * @returns 		number of characters of the line, or -1 at the end of
+ * 			the file
+ */
+long gensvm_read_data_line(struct GenDataReader *reader)
+{
+	if (reader->gzip != NULL)
+		return gensvm_gzip_getline(reader->gzip, &reader->line,
+				&reader->line_size);
+	return getline(&reader->line, &reader->line_size, reader->fid);
+}
+
+/**
+ * @brief Close a data file opened for reading in chunks
+ *
+ * @param[in] 	reader 	the GenDataReader to close
+ */
+void gensvm_close_data_reader(struct GenDataReader *reader)
+{
+	if (reader == NULL)
+		return;
 
+	if (reader->fid != NULL)
+		fclose(reader->fid);
+	gensvm_gzip_close(reader->gzip);
+	gensvm_npy_close(reader->npy);
+	gensvm_free_data(reader->data);
+	free(reader->line);
+	free(reader->hash_marker);
+	free(reader);
+}
+
+/**
+ * @brief Read a precomputed kernel matrix from a binary file
+ *
+ * @details
+ * Read a precomputed kernel matrix for use with the K_PRECOMPUTED kernel 
+ * type. The file format is described in @ref spec_kernel_file. The number of 
+ * rows of the matrix must equal the number of instances in the dataset, and 
+ * the number of columns must equal the number of training instances (thus, 
+ * for the training data the kernel matrix is square, and for test data it is 
+ * the cross kernel between the test and training instances). The matrix is 
+ * stored in GenData::kernel.
+ *
+ * @param[in,out] 	dataset 	a GenData struct with GenData::n set
+ * @param[in] 		kernel_file 	filename of the kernel file
+ * @param[in] 		n_cols 		expected number of columns
+ */
+void gensvm_read_kernel(struct GenData *dataset, char *kernel_file,
+		long n_cols)
+{
+	FILE *fid = NULL;
+	int64_t rows, cols;
+	size_t nr = 0;
+
+	if ((fid = fopen(kernel_file, "rb")) == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Kernel file %s could not be opened.\n",
+				kernel_file);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	nr += fread(&rows, sizeof(int64_t), 1, fid);
+	nr += fread(&cols, sizeof(int64_t), 1, fid);
+	if (nr != 2 || rows != dataset->n || cols != n_cols) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Kernel matrix in %s has wrong dimensions. "
+				"Expected %li x %li.\n", kernel_file,
+				dataset->n, n_cols);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	free(dataset->kernel);
+	dataset->kernel = Malloc(double, rows*cols);
+	nr = fread(dataset->kernel, sizeof(double), rows*cols, fid);
+	fclose(fid);
+
+	if (nr != (size_t) (rows*cols)) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: not enough data found in %s\n",
+				kernel_file);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
 }
 
 /**
@@ -402,6 +1107,10 @@ void gensvm_read_data_libsvm(struct GenData *data, char *data_file)
  * initalized elswhere. The model file is expected to follow the @ref
  * spec_model_file. The easiest way to generate a model file is through
  * gensvm_write_model(), which can for instance be used in trainGenSVM.c.
+ * Binary model files written by gensvm_write_model_binary() are recognized 
+ * and read with gensvm_read_model_binary(). The program exits if the model 
+ * file can't be read, see gensvm_try_read_model() for a reader that 
+ * returns instead.
  *
  * @param[in,out] 	model 		initialized GenModel
  * @param[in] 		model_filename 	filename of the model file
@@ -409,20 +1118,79 @@ void gensvm_read_data_libsvm(struct GenData *data, char *data_file)
  */
 void gensvm_read_model(struct GenModel *model, char *model_filename)
 {
-	long i, j, nr = 0;
+	if (!gensvm_try_read_model(model, model_filename))
+		exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Read model from file without exiting on an error
+ *
+ * @details
+ * This reads a model file as gensvm_read_model(), but a model file that
+ * can't be opened, is incomplete, or is malformed gives an error message
+ * and false instead of stopping the program. This is used by programs that
+ * keep running when a model file is invalid, such as gensvm_serve when it
+ * reloads a model file that is being written. After a failure the model
+ * may be partially read, and should be freed with gensvm_free_model().
+ *
+ * @param[in,out] 	model 		initialized GenModel
+ * @param[in] 		model_filename 	filename of the model file
+ * @returns 				whether the model was read
+ */
+bool gensvm_try_read_model(struct GenModel *model, char *model_filename)
+{
+	bool ok;
 	FILE *fid = NULL;
-	char buffer[GENSVM_MAX_LINE_LENGTH];
-	char data_filename[GENSVM_MAX_LINE_LENGTH];
-	double value = 0;
+
+	if (gensvm_is_binary_model(model_filename))
+		return gensvm_read_model_binary(model, model_filename);
 
 	fid = fopen(model_filename, "r");
 	if (fid == NULL) {
-		// LCOV_EXCL_START
 		err("[GenSVM Error]: Couldn't open model file %s\n",
 				model_filename);
-		exit(EXIT_FAILURE);
-		// LCOV_EXCL_STOP
+		return false;
 	}
+	ok = gensvm_read_model_text(fid, model, model_filename);
+	fclose(fid);
+	if (!ok)
+		return false;
+
+	// generate the simplex matrix, such that the model can be used for 
+	// prediction directly
+	model->U = Calloc(double, model->K*(model->K-1));
+	gensvm_simplex(model);
+
+	return true;
+}
+
+/**
+ * @brief Read the sections of a text model file
+ *
+ * @details
+ * This reads the model, data, output and basis sections of a model file in
+ * the @ref spec_model_file for gensvm_try_read_model(). All sizes in the
+ * file are checked before memory is allocated for them: the numbers of
+ * values can't exceed the size of the file.
+ *
+ * @param[in] 		fid 		model file opened for reading
+ * @param[in,out] 	model 		initialized GenModel
+ * @param[in] 		model_filename 	filename of the model file
+ * @returns 				whether the sections were read
+ */
+bool gensvm_read_model_text(FILE *fid, struct GenModel *model,
+		char *model_filename)
+{
+	int kerneltype;
+	long i, j, size, nr = 0;
+	char buffer[GENSVM_MAX_LINE_LENGTH];
+	char data_filename[GENSVM_MAX_LINE_LENGTH];
+	double value = 0;
+
+	fseek(fid, 0, SEEK_END);
+	size = ftell(fid);
+	rewind(fid);
+
 	// skip the first four lines
 	for (i=0; i<4; i++)
 		next_line(fid, model_filename);
@@ -434,19 +1202,47 @@ void gensvm_read_model(struct GenModel *model, char *model_filename)
 	model->epsilon = get_fmt_double(fid, model_filename, "epsilon = %lf");
 	model->weight_idx = (int) get_fmt_long(fid, model_filename,
 			"weight_idx = %li");
+	if (isnan(model->p) || isnan(model->lambda) || isnan(model->kappa) ||
+			isnan(model->epsilon)) {
+		err("[GenSVM Error]: Error reading the parameters from model "
+				"file %s\n", model_filename);
+		return false;
+	}
 
-	// skip to data section
-	for (i=0; i<2; i++)
+	// read the kernel specification (absent in older model files)
+	if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL) {
+		err("[GenSVM Error]: Error reading from model file %s\n",
+				model_filename);
+		return false;
+	}
+	if (sscanf(buffer, "kerneltype = %i", &kerneltype) == 1) {
+		if (kerneltype < K_LINEAR || kerneltype > K_PRECOMPUTED) {
+			err("[GenSVM Error]: Invalid kernel type in model "
+					"file %s\n", model_filename);
+			return false;
+		}
+		model->kerneltype = kerneltype;
+		model->gamma = get_fmt_double(fid, model_filename,
+				"gamma = %lf");
+		model->coef = get_fmt_double(fid, model_filename,
+				"coef = %lf");
+		model->degree = get_fmt_double(fid, model_filename,
+				"degree = %lf");
+		model->kernel_eigen_cutoff = get_fmt_double(fid,
+				model_filename, "kernel_eigen_cutoff = %lf");
 		next_line(fid, model_filename);
+	}
+
+	// skip to data section
+	next_line(fid, model_filename);
 
 	// read filename of data file
 	if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL) {
-		// LCOV_EXCL_START
 		err("[GenSVM Error]: Error reading from model file %s\n",
 				model_filename);
-		exit(EXIT_FAILURE);
-		// LCOV_EXCL_STOP
+		return false;
 	}
+	data_filename[0] = '\0';
 	sscanf(buffer, "filename = %s\n", data_filename);
 	model->data_file = Calloc(char, GENSVM_MAX_LINE_LENGTH);
 	strcpy(model->data_file, data_filename);
@@ -455,10 +1251,52 @@ void gensvm_read_model(struct GenModel *model, char *model_filename)
 	model->n = get_fmt_long(fid, model_filename, "n = %li\n");
 	model->m = get_fmt_long(fid, model_filename, "m = %li\n");
 	model->K = get_fmt_long(fid, model_filename, "K = %li\n");
+	if (model->n < 1 || model->m < 1 || model->K < 2 ||
+			model->m > size || model->K > size ||
+			model->m + 1 > size / (model->K - 1)) {
+		err("[GenSVM Error]: Invalid dimensions in model file %s\n",
+				model_filename);
+		return false;
+	}
+
+	// read the feature hashing and the column map of the data (absent if
+	// not used), up to the empty line
+	while (true) {
+		if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL) {
+			err("[GenSVM Error]: Error reading from model file "
+					"%s\n", model_filename);
+			return false;
+		}
+		if (sscanf(buffer, "hash_bits = %li", &model->hash_bits) == 1) {
+			model->hash_signed = get_fmt_long(fid, model_filename,
+					"hash_signed = %li\n") != 0;
+		} else if (sscanf(buffer, "columns = %li",
+					&model->col_map_size) == 1) {
+			if (model->col_map_size < 1 ||
+					model->col_map_size > size) {
+				err("[GenSVM Error]: Invalid number of columns "
+						"in model file %s\n",
+						model_filename);
+				return false;
+			}
+			model->col_map = Malloc(long, model->col_map_size);
+			for (i=0; i<model->col_map_size; i++)
+				nr += fscanf(fid, "%li", &model->col_map[i]);
+			if (nr != model->col_map_size) {
+				err("[GenSVM Error]: Error reading from model "
+						"file %s. Not enough columns "
+						"found.\n", model_filename);
+				return false;
+			}
+			nr = 0;
+			next_line(fid, model_filename);
+		} else {
+			break;
+		}
+	}
 
 	// skip to output
-	for (i=0; i<2; i++)
-		next_line(fid, model_filename);
+	next_line(fid, model_filename);
 
 	// read the matrix V and check for consistency
 	model->V = Malloc(double, (model->m+1)*(model->K-1));
@@ -469,13 +1307,184 @@ void gensvm_read_model(struct GenModel *model, char *model_filename)
 		}
 	}
 	if (nr != (model->m+1)*(model->K-1)) {
-		// LCOV_EXCL_START
 		err("[GenSVM Error] Error reading from model file %s. "
 				"Not enough elements of V found.\n",
 				model_filename);
-		exit(EXIT_FAILURE);
-		// LCOV_EXCL_STOP
+		return false;
+	}
+
+	// read the training basis of a nonlinear model
+	if (model->kerneltype != K_LINEAR)
+		return gensvm_read_model_basis(fid, model, model_filename,
+				size);
+
+	return true;
+}
+
+/**
+ * @brief Read the basis section of a model file
+ *
+ * @details
+ * Models with a nonlinear kernel store the training data needed for 
+ * prediction in GenModel::basis and the collapsed coefficients in 
+ * GenModel::W (see gensvm_kernel_store_basis()). This function reads these 
+ * from the basis section of the model file, as specified in @ref 
+ * spec_model_file. The training instances are read directly into a sparse 
+ * matrix, which is converted to a dense matrix if this is more efficient. If 
+ * the model file has no basis section, GenModel::basis is left unset.
+ *
+ * Model files written by earlier versions contain the eigenvalues and the 
+ * training factor instead of the collapsed coefficients. For these files 
+ * GenModel::W is computed with gensvm_kernel_collapse().
+ *
+ * @param[in] 		fid 		model file opened for reading, positioned 
+ * 					after the output section
+ * @param[in,out] 	model 		GenModel with the kernel type, 
+ * 					parameters and GenModel::V set. On 
+ * 					exit, GenModel::basis and GenModel::W 
+ * 					are set.
+ * @param[in] 		model_filename 	filename of the model file
+ * @param[in] 		size 		size of the model file in bytes, which
+ * 					bounds the sizes in the basis section
+ * @returns 				whether the basis section was read
+ */
+bool gensvm_read_model_basis(FILE *fid, struct GenModel *model,
+		char *model_filename, long size)
+{
+	long i, j, n, m, r, col, row_nnz,
+	     K = model->K,
+	     nr = 0,
+	     nnz = 0,
+	     max_nnz = 0;
+	double value;
+	char buffer[GENSVM_MAX_LINE_LENGTH];
+	struct GenData *basis = NULL;
+	struct GenSparse *spZ = NULL;
+
+	if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL ||
+			!str_startswith(buffer, "Basis:"))
+		return true;
+
+	n = get_fmt_long(fid, model_filename, "n = %li\n");
+	m = get_fmt_long(fid, model_filename, "m = %li\n");
+	if (n < 1 || m < 1 || n > size / (K - 1) || m > size) {
+		err("[GenSVM Error]: Invalid basis dimensions in model file "
+				"%s\n", model_filename);
+		return false;
+	}
+
+	basis = gensvm_init_data();
+	basis->n = n;
+	basis->m = m;
+	basis->K = K;
+	gensvm_kernel_copy_kernelparam_to_data(model, basis);
+	model->basis = basis;
+
+	if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL) {
+		err("[GenSVM Error]: Error reading from model file %s\n",
+				model_filename);
+		return false;
 	}
+
+	if (sscanf(buffer, "r = %li", &r) == 1) {
+		// older format: read Sigma and the training factor
+		if (r < 1 || r > size / (n + 1)) {
+			err("[GenSVM Error]: Invalid basis rank in model file "
+					"%s\n", model_filename);
+			return false;
+		}
+		basis->r = r;
+		next_line(fid, model_filename);
+		basis->Sigma = Malloc(double, r);
+		for (j=0; j<r; j++)
+			nr += fscanf(fid, "%lf ", &basis->Sigma[j]);
+
+		next_line(fid, model_filename);
+		basis->Z = Malloc(double, n*(r+1));
+		for (i=0; i<n; i++) {
+			matrix_set(basis->Z, r+1, i, 0, 1.0);
+			for (j=0; j<r; j++) {
+				nr += fscanf(fid, "%lf ", &value);
+				matrix_set(basis->Z, r+1, i, j+1, value);
+			}
+		}
+		if (nr != r + n*r) {
+			err("[GenSVM Error] Error reading from model file %s. "
+					"Not enough elements of the basis "
+					"found.\n", model_filename);
+			return false;
+		}
+
+		gensvm_kernel_collapse(model, basis);
+		free(basis->Z);
+		free(basis->Sigma);
+		basis->Z = NULL;
+		basis->Sigma = NULL;
+	} else {
+		// read the collapsed coefficients
+		basis->r = model->m;
+		model->W = Malloc(double, n*(K-1));
+		for (i=0; i<n*(K-1); i++)
+			nr += fscanf(fid, "%lf ", &model->W[i]);
+		if (nr != n*(K-1)) {
+			err("[GenSVM Error] Error reading from model file %s. "
+					"Not enough coefficients found.\n",
+					model_filename);
+			return false;
+		}
+	}
+
+	// read the training instances if present
+	if (fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL ||
+			!str_startswith(buffer, "Instances:"))
+		return true;
+
+	spZ = gensvm_init_sparse();
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	spZ->ia = Malloc(long, n+1);
+	spZ->ia[0] = 0;
+	for (i=0; i<n; i++) {
+		if (fscanf(fid, "%li", &row_nnz) != 1 || row_nnz < 0 ||
+				row_nnz > m) {
+			err("[GenSVM Error] Error reading from model file %s. "
+					"Not enough instances found.\n",
+					model_filename);
+			gensvm_free_sparse(spZ);
+			return false;
+		}
+		// grow the arrays if needed, including the column of ones
+		if (nnz + row_nnz + 1 > max_nnz) {
+			max_nnz = maximum(2*max_nnz, nnz + row_nnz + 1);
+			spZ->values = Realloc(spZ->values, double, max_nnz);
+			spZ->ja = Realloc(spZ->ja, long, max_nnz);
+		}
+		spZ->values[nnz] = 1.0;
+		spZ->ja[nnz++] = 0;
+		for (j=0; j<row_nnz; j++) {
+			if (fscanf(fid, " %li:%lf", &col, &value) != 2 ||
+					col < 1 || col > m) {
+				err("[GenSVM Error] Error reading from model "
+						"file %s. Invalid instance "
+						"found.\n", model_filename);
+				gensvm_free_sparse(spZ);
+				return false;
+			}
+			spZ->values[nnz] = value;
+			spZ->ja[nnz++] = col;
+		}
+		spZ->ia[i+1] = nnz;
+	}
+	spZ->nnz = nnz;
+
+	if (gensvm_nnz_comparison(nnz, n, m+1)) {
+		basis->spZ = spZ;
+	} else {
+		basis->RAW = gensvm_sparse_to_dense(spZ);
+		gensvm_free_sparse(spZ);
+	}
+
+	return true;
 }
 
 /**
@@ -517,12 +1526,28 @@ void gensvm_write_model(struct GenModel *model, char *output_filename)
 	fprintf(fid, "kappa = %15.16f\n", model->kappa);
 	fprintf(fid, "epsilon = %g\n", model->epsilon);
 	fprintf(fid, "weight_idx = %i\n", model->weight_idx);
+	fprintf(fid, "kerneltype = %i\n", model->kerneltype);
+	fprintf(fid, "gamma = %15.16f\n", model->gamma);
+	fprintf(fid, "coef = %15.16f\n", model->coef);
+	fprintf(fid, "degree = %15.16f\n", model->degree);
+	fprintf(fid, "kernel_eigen_cutoff = %g\n", model->kernel_eigen_cutoff);
 	fprintf(fid, "\n");
 	fprintf(fid, "Data:\n");
 	fprintf(fid, "filename = %s\n", model->data_file);
 	fprintf(fid, "n = %li\n", model->n);
 	fprintf(fid, "m = %li\n", model->m);
 	fprintf(fid, "K = %li\n", model->K);
+	if (model->hash_bits > 0) {
+		fprintf(fid, "hash_bits = %li\n", model->hash_bits);
+		fprintf(fid, "hash_signed = %i\n", model->hash_signed);
+	}
+	if (model->col_map != NULL) {
+		fprintf(fid, "columns = %li\n", model->col_map_size);
+		for (i=0; i<model->col_map_size; i++)
+			fprintf(fid, (i > 0) ? " %li" : "%li",
+					model->col_map[i]);
+		fprintf(fid, "\n");
+	}
 	fprintf(fid, "\n");
 	fprintf(fid, "Output:\n");
 	for (i=0; i<model->m+1; i++) {
@@ -535,9 +1560,79 @@ void gensvm_write_model(struct GenModel *model, char *output_filename)
 		fprintf(fid, "\n");
 	}
 
+	if (model->basis != NULL && model->W != NULL)
+		gensvm_write_model_basis(fid, model);
+
 	fclose(fid);
 }
 
+/**
+ * @brief Write the basis section of a model file
+ *
+ * @details
+ * Write the training data needed for prediction with a nonlinear kernel 
+ * (GenModel::basis) and the collapsed coefficients (GenModel::W) to the 
+ * model file, following the @ref spec_model_file. The coefficients are 
+ * written with full precision, and the training instances are written in a 
+ * sparse index:value format, such that sparse training data remains small in 
+ * the model file.
+ *
+ * @param[in] 	fid 	model file opened for writing
+ * @param[in] 	model 	GenModel with GenModel::basis and GenModel::W set
+ */
+void gensvm_write_model_basis(FILE *fid, struct GenModel *model)
+{
+	struct GenData *basis = model->basis;
+	long i, j, jj, row_nnz,
+	     n = basis->n,
+	     m = basis->m,
+	     K = model->K;
+	double value;
+
+	fprintf(fid, "\n");
+	fprintf(fid, "Basis:\n");
+	fprintf(fid, "n = %li\n", n);
+	fprintf(fid, "m = %li\n", m);
+	fprintf(fid, "Coefficients:\n");
+	for (i=0; i<n; i++) {
+		for (j=0; j<K-1; j++)
+			fprintf(fid, (j > 0) ? " %.17g" : "%.17g",
+					matrix_get(model->W, K-1, i, j));
+		fprintf(fid, "\n");
+	}
+
+	if (basis->RAW == NULL && basis->spZ == NULL)
+		return;
+
+	fprintf(fid, "Instances:\n");
+	for (i=0; i<n; i++) {
+		if (basis->RAW != NULL) {
+			row_nnz = 0;
+			for (j=1; j<m+1; j++)
+				if (matrix_get(basis->RAW, m+1, i, j) != 0)
+					row_nnz++;
+			fprintf(fid, "%li", row_nnz);
+			for (j=1; j<m+1; j++) {
+				value = matrix_get(basis->RAW, m+1, i, j);
+				if (value != 0)
+					fprintf(fid, " %li:%.17g", j, value);
+			}
+		} else {
+			row_nnz = 0;
+			for (jj=basis->spZ->ia[i]; jj<basis->spZ->ia[i+1]; jj++)
+				if (basis->spZ->ja[jj] != 0)
+					row_nnz++;
+			fprintf(fid, "%li", row_nnz);
+			for (jj=basis->spZ->ia[i]; jj<basis->spZ->ia[i+1]; jj++)
+				if (basis->spZ->ja[jj] != 0)
+					fprintf(fid, " %li:%.17g",
+							basis->spZ->ja[jj],
+							basis->spZ->values[jj]);
+		}
+		fprintf(fid, "\n");
+	}
+}
+
 /**
  * @brief Write predictions to file
  *
@@ -556,7 +1651,6 @@ void gensvm_write_model(struct GenModel *model, char *output_filename)
 void gensvm_write_predictions(struct GenData *data, long *predy,
 		char *output_filename)
 {
-	long i, j;
 	FILE *fid = NULL;
 
 	fid = fopen(output_filename, "w");
@@ -570,15 +1664,149 @@ void gensvm_write_predictions(struct GenData *data, long *predy,
 
 	fprintf(fid, "%li\n", data->n);
 	fprintf(fid, "%li\n", data->m);
+	gensvm_write_predictions_rows(fid, data, predy);
+
+	fclose(fid);
+}
+
+/**
+ * @brief Write the instances and predictions to an open prediction file
+ *
+ * @details
+ * Write a line with the features and the predicted label for every instance 
+ * in data. This is used by gensvm_write_predictions(), and can be used to 
+ * write the predictions of a dataset in chunks (see gensvm_read_data_chunk()) 
+ * after the header of the @ref spec_data_file is written.
+ *
+ * @param[in] 	fid 		open output file
+ * @param[in] 	data 		GenData with the original instances
+ * @param[in] 	predy 		predictions of the class labels of the
+ * 				instances in data
+ */
+void gensvm_write_predictions_rows(FILE *fid, struct GenData *data,
+		long *predy)
+{
+	long i, j, jj,
+	     shift = data->wrapped ? 1 : 0;
+	double *X = NULL,
+	       *row = NULL;
+
+	// use the original instances, which are scattered to a dense row for 
+	// sparse data. The rows of wrapped data have no column of ones.
+	X = (data->RAW != NULL) ? data->RAW : data->Z;
+	if (X == NULL)
+		row = Calloc(double, data->m+1);
 
 	for (i=0; i<data->n; i++) {
+		if (X == NULL) {
+			for (jj=data->spZ->ia[i]; jj<data->spZ->ia[i+1]; jj++)
+				row[data->spZ->ja[jj]+shift] =
+					data->spZ->values[jj];
+		} else {
+			row = &X[i*(data->m+1-shift)];
+		}
 		for (j=0; j<data->m; j++)
-			fprintf(fid, "%.16f ", matrix_get(data->Z, data->m+1, i,
-						j+1));
+			fprintf(fid, "%.16f ", (X == NULL) ? row[j+1] :
+					row[j+1-shift]);
 		fprintf(fid, "%li\n", predy[i]);
+		if (X == NULL)
+			for (jj=data->spZ->ia[i]; jj<data->spZ->ia[i+1]; jj++)
+				row[data->spZ->ja[jj]+shift] = 0.0;
 	}
 
-	fclose(fid);
+	if (X == NULL)
+		free(row);
+}
+
+/**
+ * @brief Write the header of a prediction file
+ *
+ * @details
+ * Only the format with the instances (P_DATA) has a header, which contains 
+ * the number of instances and features as in the @ref spec_data_file. The 
+ * other formats have no header, so they can be concatenated.
+ *
+ * @param[in] 	writer 	GenWriter for the prediction file
+ * @param[in] 	n 	number of instances
+ * @param[in] 	m 	number of features
+ * @param[in] 	format 	format of the prediction file
+ */
+void gensvm_write_predictions_header(struct GenWriter *writer, long n,
+		long m, PredictionFormat format)
+{
+	if (format != P_DATA)
+		return;
+
+	gensvm_writer_long(writer, n);
+	gensvm_writer_char(writer, '\n');
+	gensvm_writer_long(writer, m);
+	gensvm_writer_char(writer, '\n');
+}
+
+/**
+ * @brief Write predictions to a prediction file in the given format
+ *
+ * @details
+ * Write the predictions of the instances in data, which can be all 
+ * instances or a chunk (see gensvm_read_data_chunk()). The formats are:
+ *
+ * - P_DATA: the instances followed by the predicted label, as written by 
+ *   gensvm_write_predictions_rows()
+ * - P_LABELS: one predicted label per line
+ * - P_SCORES: one line per instance with the predicted label followed by the 
+ *   scores of the K classes (see gensvm_predict_scores())
+ * - P_BINARY: the predicted labels as int32 values in the byte order of the 
+ *   machine, without a header
+ *
+ * The output is formatted with the GenWriter functions, which avoid 
+ * printf(), except for the P_DATA format which keeps its full precision.
+ *
+ * @param[in] 	writer 	GenWriter for the prediction file
+ * @param[in] 	data 	GenData with the instances (only used for P_DATA)
+ * @param[in] 	predy 	predicted labels of the instances in data
+ * @param[in] 	scores 	matrix of size n x K with the class scores (only
+ * 			used for P_SCORES)
+ * @param[in] 	K 	number of classes
+ * @param[in] 	format 	format of the prediction file
+ */
+void gensvm_write_predictions_chunk(struct GenWriter *writer,
+		struct GenData *data, long *predy, double *scores, long K,
+		PredictionFormat format)
+{
+	long i, k, n = data->n;
+	int32_t label;
+
+	switch (format) {
+		case P_DATA:
+			gensvm_writer_flush(writer);
+			gensvm_write_predictions_rows(writer->fid, data,
+					predy);
+			break;
+		case P_LABELS:
+			for (i=0; i<n; i++) {
+				gensvm_writer_long(writer, predy[i]);
+				gensvm_writer_char(writer, '\n');
+			}
+			break;
+		case P_SCORES:
+			for (i=0; i<n; i++) {
+				gensvm_writer_long(writer, predy[i]);
+				for (k=0; k<K; k++) {
+					gensvm_writer_char(writer, ' ');
+					gensvm_writer_double(writer,
+						matrix_get(scores, K, i, k));
+				}
+				gensvm_writer_char(writer, '\n');
+			}
+			break;
+		case P_BINARY:
+			for (i=0; i<n; i++) {
+				label = (int32_t) predy[i];
+				gensvm_writer_write(writer, &label,
+						sizeof(int32_t));
+			}
+			break;
+	}
 }
 
 /**
@@ -31,6 +31,15 @@
 
 #include "gensvm_kernel.h"
 #include "gensvm_print.h"
+#include "gensvm_sv.h"
+
+/**
+ * Number of test instances in a single block of the cross kernel matrix in 
+ * gensvm_kernel_postprocess().
+ */
+#ifndef GENSVM_KERNEL_BLOCK_SIZE
+  #define GENSVM_KERNEL_BLOCK_SIZE 256
+#endif
 
 /**
  * @brief Copy the kernelparameters from GenModel to GenData
@@ -62,9 +71,21 @@ void gensvm_kernel_copy_kernelparam_to_data(struct GenModel *model,
  * = \textbf{P}\boldsymbol{\Sigma}@f$ which takes the role as data matrix in
  * the optimization algorithm.
  *
+ * To keep the memory footprint small, the kernel matrix is only computed in 
+ * packed storage (the upper triangle, see gensvm_kernel_compute_packed()) 
+ * and the eigendecomposition overwrites this matrix in place (see 
+ * gensvm_kernel_eigendecomp_packed()). Only the eigenvectors that are 
+ * retained are ever computed. The peak memory usage is therefore about 
+ * @f$n^2/2 + nr@f$ doubles while decomposing and @f$2nr@f$ doubles while 
+ * constructing @f$\textbf{M}@f$, compared to @f$3n^2@f$ doubles for a full 
+ * eigendecomposition.
+ *
  * @sa
- * gensvm_kernel_compute(), gensvm_kernel_eigendecomp(), 
- * gensvm_kernel_trainfactor(), gensvm_kernel_postprocess()
+ * gensvm_kernel_compute_packed(), gensvm_kernel_eigendecomp_packed(), 
+ * gensvm_kernel_postprocess()
+ *
+ * Wrapped data (see gensvm_wrap_dense()) is copied to an augmented data 
+ * matrix with gensvm_unwrap_data() first.
  *
  * @param[in] 		model 	input GenSVM model
  * @param[in,out] 	data 	input structure with the data. On exit,
@@ -79,21 +100,35 @@ void gensvm_kernel_preprocess(struct GenModel *model, struct GenData *data)
 		return;
 	}
 
-	long r, n = data->n;
-	double *P = NULL,
+	// the kernels need the augmented data matrix
+	gensvm_unwrap_data(data);
+
+	long i, j, r, n = data->n;
+	double value, *P = NULL,
 	       *Sigma = NULL,
 	       *K = NULL;
 
-	// build the kernel matrix
-	K = Calloc(double, n*n);
-	gensvm_kernel_compute(model, data, K);
+	// build the upper triangle of the kernel matrix in packed storage
+	K = Malloc(double, n*(n+1)/2);
+	gensvm_kernel_compute_packed(model, data, K);
 
-	// generate the eigen decomposition
-	r = gensvm_kernel_eigendecomp(K, n, model->kernel_eigen_cutoff, &P, 
-			&Sigma);
+	// generate the eigen decomposition, this overwrites K
+	r = gensvm_kernel_eigendecomp_packed(K, n, model->kernel_eigen_cutoff,
+			&P, &Sigma);
+	free(K);
 
-	// build M and set to data (leave RAW intact)
-	gensvm_kernel_trainfactor(data, P, Sigma, r);
+	// build M and set to data (leave RAW intact). Note that P is stored 
+	// in column-major order here.
+	data->Z = Calloc(double, n*(r+1));
+	for (i=0; i<n; i++) {
+		for (j=0; j<r; j++) {
+			value = P[i + j*n] * Sigma[j];
+			matrix_set(data->Z, r+1, i, j+1, value);
+		}
+		matrix_set(data->Z, r+1, i, 0, 1.0);
+	}
+	data->r = r;
+	free(P);
 
 	// Set Sigma to data->Sigma (need it again for prediction)
 	if (data->Sigma != NULL) {
@@ -104,9 +139,6 @@ void gensvm_kernel_preprocess(struct GenModel *model, struct GenData *data)
 
 	// write kernel params to data
 	gensvm_kernel_copy_kernelparam_to_data(model, data);
-
-	free(K);
-	free(P);
 }
 
 /**
@@ -114,9 +146,21 @@ void gensvm_kernel_preprocess(struct GenModel *model, struct GenData *data)
  *
  * @details
  * This function computes the postprocessing factor needed to do predictions 
- * with kernels in GenSVM. This is a wrapper around gensvm_kernel_cross() and 
+ * with kernels in GenSVM. For a precomputed kernel the cross kernel matrix is 
+ * taken from GenData::kernel of the test dataset and passed to 
  * gensvm_kernel_testfactor().
  *
+ * Otherwise, the full cross kernel matrix is never formed. The test 
+ * instances are processed in blocks of GENSVM_KERNEL_BLOCK_SIZE rows. For 
+ * each block the rows of the cross kernel matrix are computed with 
+ * gensvm_kernel_cross_block() and multiplied with the training factor by 
+ * gensvm_kernel_testfactor_block(), which writes the result directly to 
+ * GenData::Z of the test data. The blocks are divided over threads with 
+ * OpenMP, and each thread uses a single buffer for its blocks. The memory 
+ * needed besides the test factor itself is therefore 
+ * GENSVM_KERNEL_BLOCK_SIZE rows of the cross kernel per thread, regardless 
+ * of the size of the test set.
+ *
  * @param[in] 		model 		a GenSVM model
  * @param[in] 		traindata 	the training dataset
  * @param[in,out] 	testdata 	the test dataset. On exit, GenData::Z
@@ -130,13 +174,482 @@ void gensvm_kernel_postprocess(struct GenModel *model,
 		return;
 	}
 
-	// build the cross kernel matrix between train and test
-	double *K2 = gensvm_kernel_cross(model, traindata, testdata);
+	// the kernels need the augmented data matrix
+	gensvm_unwrap_data(testdata);
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		gensvm_kernel_check_precomputed(testdata);
+		gensvm_kernel_testfactor(testdata, traindata,
+				testdata->kernel);
+		return;
+	}
+
+	long b, start, rows,
+	     n_train = traindata->n,
+	     n_test = testdata->n,
+	     r = traindata->r,
+	     n_blocks = (n_test + GENSVM_KERNEL_BLOCK_SIZE - 1) /
+		     GENSVM_KERNEL_BLOCK_SIZE;
+	double *K2 = NULL;
+
+	testdata->Z = Calloc(double, n_test*(r+1));
+
+	#pragma omp parallel private(b, start, rows, K2)
+	{
+		K2 = Malloc(double, GENSVM_KERNEL_BLOCK_SIZE*n_train);
+
+		#pragma omp for schedule(dynamic)
+		for (b=0; b<n_blocks; b++) {
+			start = b * GENSVM_KERNEL_BLOCK_SIZE;
+			rows = minimum(GENSVM_KERNEL_BLOCK_SIZE,
+					n_test - start);
+
+			// rows of the cross kernel for this block
+			gensvm_kernel_cross_block(model, traindata, testdata,
+					start, rows, K2);
+
+			// rows of N = K2 * M * Sigma^{-2} for this block
+			gensvm_kernel_testfactor_block(testdata, traindata,
+					K2, start, rows);
+		}
+
+		free(K2);
+	}
+
+	testdata->r = r;
+}
+
+/**
+ * @brief Store the training data needed for prediction in the model
+ *
+ * @details
+ * To predict the class labels of new instances with a nonlinear kernel, the 
+ * cross kernel between the test instances and the training instances is 
+ * needed. This function copies the training instances from the preprocessed 
+ * training data to a new GenData instance in GenModel::basis, and computes 
+ * the collapsed coefficient matrix GenModel::W with gensvm_kernel_collapse().  
+ * The model can then be used for prediction (and written to a file with 
+ * gensvm_write_model()) independently of the training data, see 
+ * gensvm_kernel_calculate_ZV(). For a precomputed kernel the training 
+ * instances are not stored, since the cross kernel is given. If 
+ * GenModel::basis_tol is positive, the basis is pruned afterwards with 
+ * gensvm_kernel_prune_basis(). Nothing is done for the linear kernel.
+ *
+ * @param[in,out] 	model 	a trained GenModel. On exit GenModel::basis
+ * 				and GenModel::W are set
+ * @param[in] 		data 	the preprocessed training data
+ */
+void gensvm_kernel_store_basis(struct GenModel *model, struct GenData *data)
+{
+	long i, n = data->n,
+	     m = data->m;
+	struct GenData *basis = NULL;
+
+	if (model->kerneltype == K_LINEAR)
+		return;
+
+	gensvm_free_data(model->basis);
+	basis = gensvm_init_data();
+	basis->n = n;
+	basis->m = m;
+	basis->r = data->r;
+	basis->K = data->K;
+
+	if (model->kerneltype != K_PRECOMPUTED && data->RAW != NULL) {
+		basis->RAW = Malloc(double, n*(m+1));
+		for (i=0; i<n*(m+1); i++)
+			basis->RAW[i] = data->RAW[i];
+	} else if (model->kerneltype != K_PRECOMPUTED) {
+		basis->spZ = gensvm_init_sparse();
+		basis->spZ->nnz = data->spZ->nnz;
+		basis->spZ->n_row = data->spZ->n_row;
+		basis->spZ->n_col = data->spZ->n_col;
+		basis->spZ->values = Malloc(double, data->spZ->nnz);
+		basis->spZ->ja = Malloc(long, data->spZ->nnz);
+		basis->spZ->ia = Malloc(long, n+1);
+		for (i=0; i<data->spZ->nnz; i++) {
+			basis->spZ->values[i] = data->spZ->values[i];
+			basis->spZ->ja[i] = data->spZ->ja[i];
+		}
+		for (i=0; i<n+1; i++)
+			basis->spZ->ia[i] = data->spZ->ia[i];
+	}
+
+	gensvm_kernel_copy_kernelparam_to_data(model, basis);
+	model->basis = basis;
+
+	gensvm_kernel_collapse(model, data);
+
+	if (model->basis_tol > 0)
+		gensvm_kernel_prune_basis(model, data);
+}
+
+/**
+ * @brief Remove training instances from the basis of a kernel model
+ *
+ * @details
+ * The cost of predicting with a nonlinear kernel is proportional to the 
+ * number of instances in GenModel::basis, since the kernel has to be 
+ * evaluated between each test instance and each basis instance. Many 
+ * training instances have a negligible contribution to the predictions. This 
+ * function keeps only the instances that are support vectors (see 
+ * gensvm_is_sv()) or for which the norm of the corresponding row of 
+ * GenModel::W is larger than GenModel::basis_tol times the largest row norm.  
+ * The tolerance is thus a threshold on the relative norm in [0, 1], and not 
+ * a bound on the error of the pruned model. Setting GenModel::basis_tol to 1 
+ * keeps only the support vectors, and smaller values keep more instances.  
+ * If no instance is selected, the instance with the largest row norm is 
+ * kept, such that the basis is never empty.
+ *
+ * The coefficients of the remaining instances are then fitted again, such 
+ * that the predictions on the training data change as little as possible.  
+ * With @f$\textbf{K}_S@f$ the kernel between all training instances and the 
+ * remaining instances, this is the least squares problem
+ * @f[
+ * 	\min_{\textbf{W}_S} \| \textbf{K}_S \textbf{W}_S - \textbf{M} 
+ * 	\textbf{W} \|_F,
+ * @f]
+ * where @f$\textbf{M}\textbf{W}@f$ are the training scores without the 
+ * bias. This is solved with dgelss(), using GenModel::kernel_eigen_cutoff as 
+ * the cutoff for small singular values. The relative error in the training 
+ * scores of the pruned model is printed. Pruning is not supported for a 
+ * precomputed kernel, since the cross kernel of the test data is given for 
+ * all training instances.
+ *
+ * @param[in,out] 	model 	a GenModel with GenModel::basis and 
+ * 				GenModel::W set by 
+ * 				gensvm_kernel_store_basis(), and 
+ * 				GenModel::Q up to date. On exit, the basis 
+ * 				and the coefficients are replaced by the 
+ * 				pruned basis and the refitted coefficients.
+ * @param[in] 		data 	the preprocessed training data
+ */
+void gensvm_kernel_prune_basis(struct GenModel *model, struct GenData *data)
+{
+	int rank, status, LWORK;
+	long i, j, s = 0,
+	     i_max = 0,
+	     n = data->n,
+	     r = data->r,
+	     K = model->K,
+	     *idx = NULL;
+	double value, max_norm = 0.0,
+	       diff = 0.0,
+	       total = 0.0,
+	       *norms = NULL,
+	       *A = NULL,
+	       *B = NULL,
+	       *T = NULL,
+	       *S = NULL,
+	       *W = NULL,
+	       *ZV = NULL,
+	       *WORK = NULL;
+	struct GenData *pruned = NULL;
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		err("[GenSVM Warning]: Pruning the basis is not supported "
+				"for a precomputed kernel.\n");
+		return;
+	}
+
+	// select the instances to keep
+	norms = Malloc(double, n);
+	for (i=0; i<n; i++) {
+		norms[i] = cblas_dnrm2(K-1, &model->W[i*(K-1)], 1);
+		if (norms[i] > max_norm) {
+			max_norm = norms[i];
+			i_max = i;
+		}
+	}
+	idx = Malloc(long, n);
+	for (i=0; i<n; i++)
+		if (gensvm_is_sv(model, i) ||
+				norms[i] > model->basis_tol * max_norm)
+			idx[s++] = i;
+	if (s == 0)
+		idx[s++] = i_max;
+	free(norms);
+
+	if (s == n) {
+		free(idx);
+		return;
+	}
+	pruned = gensvm_kernel_select_basis(model->basis, idx, s);
+	free(idx);
+
+	// The rows of the cross kernel of the kept instances with the 
+	// training data form K_S in column-major order.
+	A = Malloc(double, s*n);
+	gensvm_kernel_cross_block(model, data, pruned, 0, s, A);
+
+	// B = M * W, the training scores without the bias, in column-major 
+	// order. W is stored in V after the row with the bias.
+	B = Malloc(double, n*(K-1));
+	cblas_dgemm(CblasRowMajor, CblasTrans, CblasTrans, K-1, n, r, 1.0,
+			model->V + (K-1), K-1, data->Z + 1, r+1, 0.0, B, n);
+	T = Malloc(double, n*(K-1));
+	for (i=0; i<n*(K-1); i++)
+		T[i] = B[i];
+
+	// solve the least squares problem, starting with a workspace query
+	S = Malloc(double, s);
+	WORK = Malloc(double, 1);
+	status = dgelss(n, s, K-1, A, n, B, n, S, model->kernel_eigen_cutoff,
+			&rank, WORK, -1);
+	LWORK = WORK[0];
+	WORK = Realloc(WORK, double, LWORK);
+	status = dgelss(n, s, K-1, A, n, B, n, S, model->kernel_eigen_cutoff,
+			&rank, WORK, LWORK);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dgelss.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	free(A);
+	free(S);
+	free(WORK);
+
+	// replace the basis and the coefficients
+	W = Malloc(double, s*(K-1));
+	for (i=0; i<s; i++)
+		for (j=0; j<K-1; j++)
+			matrix_set(W, K-1, i, j, B[i + j*n]);
+	free(B);
+	free(model->W);
+	model->W = W;
+	gensvm_free_data(model->basis);
+	model->basis = pruned;
+
+	// compute the relative error of the training scores
+	ZV = Malloc(double, n*(K-1));
+	gensvm_kernel_calculate_ZV(model, data, ZV);
+	for (i=0; i<n; i++) {
+		for (j=0; j<K-1; j++) {
+			value = matrix_get(ZV, K-1, i, j) -
+				matrix_get(model->V, K-1, 0, j);
+			diff += pow(value - T[i + j*n], 2.0);
+			total += pow(T[i + j*n], 2.0);
+		}
+	}
+	free(ZV);
+	free(T);
+
+	note("Pruned kernel basis to %li of %li instances (rank = %i, "
+			"relative error = %g)\n", s, n, rank,
+			sqrt(diff/total));
+}
+
+/**
+ * @brief Select instances from the basis of a kernel model
+ *
+ * @details
+ * Create a new GenData instance with the instances of the given basis (see 
+ * gensvm_kernel_store_basis()) at the given indices, in the given order. The 
+ * instances are copied from GenData::RAW or from GenData::spZ, and the 
+ * kernel parameters are copied as well.
+ *
+ * @param[in] 	basis 	GenData with the basis
+ * @param[in] 	idx 	indices of the instances to select
+ * @param[in] 	n_idx 	number of indices
+ * @returns 		a new GenData instance with the selected instances
+ */
+struct GenData *gensvm_kernel_select_basis(struct GenData *basis, long *idx,
+		long n_idx)
+{
+	long i, j, jj, nnz = 0,
+	     m = basis->m;
+	struct GenData *sub = gensvm_init_data();
+	struct GenSparse *spZ = NULL;
+
+	sub->n = n_idx;
+	sub->m = m;
+	sub->r = basis->r;
+	sub->K = basis->K;
+	sub->kerneltype = basis->kerneltype;
+	sub->gamma = basis->gamma;
+	sub->coef = basis->coef;
+	sub->degree = basis->degree;
+
+	if (basis->RAW != NULL) {
+		sub->RAW = Malloc(double, n_idx*(m+1));
+		for (i=0; i<n_idx; i++)
+			for (j=0; j<m+1; j++)
+				matrix_set(sub->RAW, m+1, i, j,
+						matrix_get(basis->RAW, m+1,
+							idx[i], j));
+		return sub;
+	}
+
+	spZ = basis->spZ;
+	for (i=0; i<n_idx; i++)
+		nnz += spZ->ia[idx[i]+1] - spZ->ia[idx[i]];
+
+	sub->spZ = gensvm_init_sparse();
+	sub->spZ->nnz = nnz;
+	sub->spZ->n_row = n_idx;
+	sub->spZ->n_col = spZ->n_col;
+	sub->spZ->values = Malloc(double, nnz);
+	sub->spZ->ja = Malloc(long, nnz);
+	sub->spZ->ia = Malloc(long, n_idx+1);
+	sub->spZ->ia[0] = 0;
+	nnz = 0;
+	for (i=0; i<n_idx; i++) {
+		for (jj=spZ->ia[idx[i]]; jj<spZ->ia[idx[i]+1]; jj++) {
+			sub->spZ->values[nnz] = spZ->values[jj];
+			sub->spZ->ja[nnz++] = spZ->ja[jj];
+		}
+		sub->spZ->ia[i+1] = nnz;
+	}
 
-	// generate the data matrix N = K2 * M * Sigma^{-2}
-	gensvm_kernel_testfactor(testdata, traindata, K2);
+	return sub;
+}
 
-	free(K2);
+/**
+ * @brief Collapse the training factor and the weights of a kernel model
+ *
+ * @details
+ * With a nonlinear kernel, the simplex space vectors of test instances are 
+ * given by @f$\textbf{N}\textbf{V}@f$, with the test factor 
+ * @f$\textbf{N} = [\textbf{1} \,\, \textbf{K}_2 \textbf{M} 
+ * \boldsymbol{\Sigma}^{-2}]@f$ (see gensvm_kernel_testfactor()). Writing 
+ * @f$\textbf{V} = [\textbf{t} \,\, \textbf{W}']'@f$, this equals
+ * @f[
+ * 	\textbf{1}\textbf{t}' + \textbf{K}_2 \textbf{M} 
+ * 	\boldsymbol{\Sigma}^{-2} \textbf{W}.
+ * @f]
+ * This function computes the @f$n \times (K-1)@f$ matrix @f$\textbf{M} 
+ * \boldsymbol{\Sigma}^{-2} \textbf{W}@f$ once, and stores it in 
+ * GenModel::W. Prediction then only requires the product of the cross kernel 
+ * with this matrix, which costs @f$O(n(K-1))@f$ per test instance instead of 
+ * @f$O(nr + r(K-1))@f$, and the test factor is never formed.
+ *
+ * @param[in,out] 	model 	a trained GenModel. On exit GenModel::W
+ * 				contains the collapsed coefficients
+ * @param[in] 		data 	GenData with the training factor in
+ * 				GenData::Z and the eigenvalues in
+ * 				GenData::Sigma
+ */
+void gensvm_kernel_collapse(struct GenModel *model, struct GenData *data)
+{
+	long i, j, n = data->n,
+	     r = data->r,
+	     K = model->K;
+	double value, *SW = Malloc(double, r*(K-1));
+
+	// SW = Sigma^{-2} * W, skipping the bias row of V
+	for (i=0; i<r; i++) {
+		value = pow(matrix_get(data->Sigma, 1, i, 0), -2.0);
+		for (j=0; j<K-1; j++)
+			matrix_set(SW, K-1, i, j, value *
+					matrix_get(model->V, K-1, i+1, j));
+	}
+
+	free(model->W);
+	model->W = Malloc(double, n*(K-1));
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, K-1, r, 1.0,
+			data->Z + 1, r+1, SW, K-1, 0.0, model->W, K-1);
+
+	free(SW);
+}
+
+/**
+ * @brief Compute the simplex space vectors of test data with a kernel model
+ *
+ * @details
+ * This computes the matrix @f$\textbf{Z}\textbf{V}@f$ for test instances 
+ * using the collapsed coefficients in GenModel::W (see 
+ * gensvm_kernel_collapse()) and the training instances in GenModel::basis.  
+ * The test instances are taken from GenData::RAW or GenData::spZ, so any 
+ * test factor in GenData::Z is not used. As in gensvm_kernel_postprocess(), 
+ * the test instances are processed in blocks of GENSVM_KERNEL_BLOCK_SIZE 
+ * rows, which are divided over threads with OpenMP. For each block the rows 
+ * of the cross kernel are computed and multiplied with GenModel::W, and the 
+ * bias in the first row of GenModel::V is added. For a precomputed kernel 
+ * the rows of GenData::kernel are used directly.
+ *
+ * @param[in] 	model 		a GenModel with GenModel::basis and
+ * 				GenModel::W set
+ * @param[in] 	testdata 	the test dataset
+ * @param[out] 	ZV 		preallocated matrix of size n_test x (K-1)
+ */
+void gensvm_kernel_calculate_ZV(struct GenModel *model,
+		struct GenData *testdata, double *ZV)
+{
+	long b, start, rows,
+	     n_basis = model->basis->n,
+	     n_test = testdata->n,
+	     n_blocks = (n_test + GENSVM_KERNEL_BLOCK_SIZE - 1) /
+		     GENSVM_KERNEL_BLOCK_SIZE;
+	double *K2 = NULL;
+
+	#pragma omp parallel private(b, start, rows, K2)
+	{
+		K2 = NULL;
+		if (model->kerneltype != K_PRECOMPUTED)
+			K2 = Malloc(double, GENSVM_KERNEL_BLOCK_SIZE*n_basis);
+
+		#pragma omp for schedule(dynamic)
+		for (b=0; b<n_blocks; b++) {
+			start = b * GENSVM_KERNEL_BLOCK_SIZE;
+			rows = minimum(GENSVM_KERNEL_BLOCK_SIZE,
+					n_test - start);
+			gensvm_kernel_calculate_ZV_block(model, testdata,
+					start, rows, K2,
+					ZV + start*(model->K-1));
+		}
+
+		free(K2);
+	}
+}
+
+/**
+ * @brief Compute a block of rows of the simplex space vectors with a kernel
+ *
+ * @details
+ * This computes the rows @f$\text{start}, \ldots, \text{start} + 
+ * \text{rows} - 1@f$ of the simplex space vectors of the test data for a 
+ * kernel model, see gensvm_kernel_calculate_ZV(). The rows of the cross 
+ * kernel are computed in the given buffer and multiplied with GenModel::W, 
+ * and the bias in the first row of GenModel::V is added. For a precomputed 
+ * kernel the rows of GenData::kernel are used directly and the buffer is not 
+ * used.
+ *
+ * @param[in] 	model 		a GenModel with GenModel::basis and
+ * 				GenModel::W set
+ * @param[in] 	testdata 	the test dataset
+ * @param[in] 	start 		index of the first test instance in the block
+ * @param[in] 	rows 		number of test instances in the block
+ * @param[in] 	K2 		buffer of size rows x n_basis for the cross
+ * 				kernel (may be NULL for a precomputed kernel)
+ * @param[out] 	ZV 		preallocated matrix of size rows x (K-1)
+ */
+void gensvm_kernel_calculate_ZV_block(struct GenModel *model,
+		struct GenData *testdata, long start, long rows, double *K2,
+		double *ZV)
+{
+	long i, j,
+	     K = model->K,
+	     n_basis = model->basis->n;
+
+	// rows of the cross kernel for this block
+	if (model->kerneltype == K_PRECOMPUTED) {
+		gensvm_kernel_check_precomputed(testdata);
+		K2 = testdata->kernel + start*n_basis;
+	} else {
+		gensvm_kernel_cross_block(model, model->basis, testdata, start,
+				rows, K2);
+	}
+
+	// initialize the rows of ZV with the bias
+	for (i=0; i<rows; i++)
+		for (j=0; j<K-1; j++)
+			matrix_set(ZV, K-1, i, j,
+					matrix_get(model->V, K-1, 0, j));
+
+	// add K2 * W
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, K-1,
+			n_basis, 1.0, K2, n_basis, model->W, K-1, 1.0, ZV, K-1);
 }
 
 /**
@@ -147,7 +660,10 @@ void gensvm_kernel_postprocess(struct GenModel *model,
  * requested kernel type and the kernel parameters. The potential types of
  * kernel functions are document in KernelType. This function uses a naive
  * multiplication and computes the entire upper triangle of the kernel matrix,
- * then copies this over to the lower triangle.
+ * then copies this over to the lower triangle. For a precomputed kernel the 
+ * matrix is copied from GenData::kernel. If the data is stored as a sparse 
+ * matrix, the kernel matrix is computed with 
+ * gensvm_kernel_compute_packed_sparse() and copied to full storage.
  *
  * @param[in] 	model 	a GenModel structure with the model
  * @param[in] 	data 	a GenData structure with the data
@@ -163,6 +679,27 @@ void gensvm_kernel_compute(struct GenModel *model, struct GenData *data,
 	double *x1 = NULL,
 	       *x2 = NULL;
 
+	if (model->kerneltype == K_PRECOMPUTED) {
+		gensvm_kernel_check_precomputed(data);
+		for (i=0; i<n*n; i++)
+			K[i] = data->kernel[i];
+		return;
+	}
+
+	if (data->RAW == NULL) {
+		double *Kp = Malloc(double, n*(n+1)/2);
+		gensvm_kernel_compute_packed_sparse(model, data, Kp);
+		for (j=0; j<n; j++) {
+			for (i=0; i<=j; i++) {
+				value = Kp[i + j*(j+1)/2];
+				matrix_set(K, n, i, j, value);
+				matrix_set(K, n, j, i, value);
+			}
+		}
+		free(Kp);
+		return;
+	}
+
 	for (i=0; i<n; i++) {
 		for (j=i; j<n; j++) {
 			x1 = &data->RAW[i*(data->m+1)+1];
@@ -191,6 +728,246 @@ void gensvm_kernel_compute(struct GenModel *model, struct GenData *data,
 	}
 }
 
+/**
+ * @brief Compute the kernel matrix in packed storage
+ *
+ * @details
+ * This function computes the kernel matrix of a data matrix in the same way 
+ * as gensvm_kernel_compute(), but only stores the upper triangle of the 
+ * matrix in LAPACK packed storage. Element @f$(i, j)@f$ with @f$i \leq j@f$ 
+ * is stored at index @f$i + j(j+1)/2@f$. This halves the memory needed for 
+ * the kernel matrix. For a precomputed kernel the upper triangle is copied 
+ * from GenData::kernel, and for sparse data 
+ * gensvm_kernel_compute_packed_sparse() is used.
+ *
+ * @param[in] 	model 	a GenModel structure with the model
+ * @param[in] 	data 	a GenData structure with the data
+ * @param[out] 	K 	a preallocated array of length @f$n(n+1)/2@f$
+ *
+ */
+void gensvm_kernel_compute_packed(struct GenModel *model,
+		struct GenData *data, double *K)
+{
+	long i, j;
+	long n = data->n;
+	double *x1 = NULL,
+	       *x2 = NULL;
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		gensvm_kernel_check_precomputed(data);
+		for (j=0; j<n; j++)
+			for (i=0; i<=j; i++)
+				K[i + j*(j+1)/2] = matrix_get(data->kernel, n,
+						i, j);
+		return;
+	}
+
+	if (data->RAW == NULL) {
+		gensvm_kernel_compute_packed_sparse(model, data, K);
+		return;
+	}
+
+	for (j=0; j<n; j++) {
+		x2 = &data->RAW[j*(data->m+1)+1];
+		for (i=0; i<=j; i++) {
+			x1 = &data->RAW[i*(data->m+1)+1];
+			K[i + j*(j+1)/2] = gensvm_kernel_dot(model, x1, x2,
+					data->m);
+		}
+	}
+}
+
+/**
+ * @brief Compute the kernel matrix of sparse data in packed storage
+ *
+ * @details
+ * This function computes the kernel matrix in packed storage (see 
+ * gensvm_kernel_compute_packed()) directly from the sparse data matrix in 
+ * GenData::spZ, without converting the data to a dense matrix. The squared 
+ * norms of all instances are computed first. Next, each instance @f$j@f$ is 
+ * scattered to a dense work vector, such that the inner products with the 
+ * instances @f$i \leq j@f$ can be found by gathering over the nonzero 
+ * elements of these instances only. The kernel is then evaluated from the 
+ * inner products and the norms with gensvm_kernel_dot_inner().
+ *
+ * @param[in] 	model 	a GenModel structure with the model
+ * @param[in] 	data 	a GenData structure with the data in GenData::spZ
+ * @param[out] 	K 	a preallocated array of length @f$n(n+1)/2@f$
+ *
+ */
+void gensvm_kernel_compute_packed_sparse(struct GenModel *model,
+		struct GenData *data, double *K)
+{
+	long i, j, jj;
+	long n = data->n;
+	double dot;
+	struct GenSparse *A = data->spZ;
+	double *w = Calloc(double, A->n_col);
+	double *norms = Malloc(double, n);
+
+	gensvm_kernel_sparse_norms(A, norms);
+
+	for (j=0; j<n; j++) {
+		// scatter row j
+		for (jj=A->ia[j]; jj<A->ia[j+1]; jj++)
+			w[A->ja[jj]] = A->values[jj];
+		for (i=0; i<=j; i++) {
+			dot = gensvm_kernel_sparse_gather(w, A, i);
+			K[i + j*(j+1)/2] = gensvm_kernel_dot_inner(model, dot,
+					norms[i], norms[j]);
+		}
+		// reset the work vector
+		for (jj=A->ia[j]; jj<A->ia[j+1]; jj++)
+			w[A->ja[jj]] = 0.0;
+	}
+
+	free(w);
+	free(norms);
+}
+
+/**
+ * @brief Compute the squared norms of the rows of a sparse data matrix
+ *
+ * @details
+ * Compute the squared norm of each row of a sparse data matrix, excluding 
+ * the column of ones in the first column.
+ *
+ * @param[in] 	A 	a sparse data matrix
+ * @param[out] 	norms 	preallocated array of length GenSparse::n_row with
+ * 			the squared row norms on exit
+ */
+void gensvm_kernel_sparse_norms(struct GenSparse *A, double *norms)
+{
+	long i, jj;
+
+	for (i=0; i<A->n_row; i++) {
+		norms[i] = 0.0;
+		for (jj=A->ia[i]; jj<A->ia[i+1]; jj++) {
+			if (A->ja[jj] == 0)
+				continue;
+			norms[i] += A->values[jj] * A->values[jj];
+		}
+	}
+}
+
+/**
+ * @brief Compute the inner product of a dense vector and a sparse row
+ *
+ * @details
+ * Compute the inner product between a dense vector @f$w@f$, indexed by the 
+ * columns of the sparse data matrix, and a row of the sparse data matrix. 
+ * Only the nonzero elements of the row are visited. The column of ones in 
+ * the first column of the data matrix is excluded.
+ *
+ * @param[in] 	w 	dense vector of length GenSparse::n_col
+ * @param[in] 	A 	a sparse data matrix
+ * @param[in] 	i 	index of the row of A
+ * @returns 		the inner product
+ */
+double gensvm_kernel_sparse_gather(double *w, struct GenSparse *A, long i)
+{
+	long jj;
+	double dot = 0.0;
+
+	for (jj=A->ia[i]; jj<A->ia[i+1]; jj++) {
+		if (A->ja[jj] == 0)
+			continue;
+		dot += w[A->ja[jj]] * A->values[jj];
+	}
+	return dot;
+}
+
+/**
+ * @brief Compute the kernel function from an inner product
+ *
+ * @details
+ * All kernels available in GenSVM can be written in terms of the inner 
+ * product @f$\langle x_1, x_2 \rangle@f$ and the squared norms of the two 
+ * vectors. For the RBF kernel this uses that @f$\| x_1 - x_2 \|^2 = \| x_1 
+ * \|^2 + \| x_2 \|^2 - 2 \langle x_1, x_2 \rangle@f$. This is used with 
+ * sparse data, where the inner product can be computed efficiently, see 
+ * gensvm_kernel_dot_rbf(), gensvm_kernel_dot_poly(), and 
+ * gensvm_kernel_dot_sigmoid() for the kernel definitions.
+ *
+ * @param[in] 	model 	a GenModel with the kernel type and parameters
+ * @param[in] 	dot 	inner product of the two vectors
+ * @param[in] 	norm1 	squared norm of the first vector
+ * @param[in] 	norm2 	squared norm of the second vector
+ * @returns 		kernel evaluation
+ */
+double gensvm_kernel_dot_inner(struct GenModel *model, double dot,
+		double norm1, double norm2)
+{
+	double value;
+
+	if (model->kerneltype == K_POLY) {
+		return pow(model->gamma * dot + model->coef, model->degree);
+	} else if (model->kerneltype == K_RBF) {
+		// guard against rounding errors for nearly equal vectors
+		value = maximum(0.0, norm1 + norm2 - 2.0 * dot);
+		return exp(-model->gamma * value);
+	} else if (model->kerneltype == K_SIGMOID) {
+		return tanh(model->gamma * dot + model->coef);
+	}
+
+	// LCOV_EXCL_START
+	err("[GenSVM Error]: Unknown kernel type in gensvm_kernel_dot_inner\n");
+	exit(EXIT_FAILURE);
+	// LCOV_EXCL_STOP
+}
+
+/**
+ * @brief Check that a precomputed kernel matrix is available
+ *
+ * @details
+ * Small utility function that exits with an error if GenData::kernel has not 
+ * been set for a dataset that is used with a precomputed kernel.
+ *
+ * @param[in] 	data 	a GenData instance
+ */
+void gensvm_kernel_check_precomputed(struct GenData *data)
+{
+	if (data->kernel == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: No precomputed kernel matrix available "
+				"for the data.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+}
+
+/**
+ * @brief Compute the kernel function between two vectors
+ *
+ * @details
+ * This is a small utility function which calls the kernel function 
+ * corresponding to GenModel::kerneltype with the kernel parameters of the 
+ * model.
+ *
+ * @param[in] 	model 	a GenModel with the kernel type and parameters
+ * @param[in] 	x1 	first vector
+ * @param[in] 	x2 	second vector
+ * @param[in] 	n 	length of the vectors x1 and x2
+ * @returns 		kernel evaluation
+ */
+double gensvm_kernel_dot(struct GenModel *model, double *x1, double *x2,
+		long n)
+{
+	if (model->kerneltype == K_POLY)
+		return gensvm_kernel_dot_poly(x1, x2, n, model->gamma,
+				model->coef, model->degree);
+	else if (model->kerneltype == K_RBF)
+		return gensvm_kernel_dot_rbf(x1, x2, n, model->gamma);
+	else if (model->kerneltype == K_SIGMOID)
+		return gensvm_kernel_dot_sigmoid(x1, x2, n, model->gamma,
+				model->coef);
+
+	// LCOV_EXCL_START
+	err("[GenSVM Error]: Unknown kernel type in gensvm_kernel_dot\n");
+	exit(EXIT_FAILURE);
+	// LCOV_EXCL_STOP
+}
+
 /**
  * @brief Find the (reduced) eigendecomposition of a kernel matrix
  *
@@ -293,6 +1070,186 @@ long gensvm_kernel_eigendecomp(double *K, long n, double cutoff, double **P_ret,
 	return num_eigen;
 }
 
+/**
+ * @brief Find the reduced eigendecomposition of a packed kernel matrix
+ *
+ * @details
+ * This function computes the same reduced eigendecomposition as 
+ * gensvm_kernel_eigendecomp(), but works on a kernel matrix in packed 
+ * storage (see gensvm_kernel_compute_packed()) and avoids computing the 
+ * eigenvectors that are not retained. The matrix is first reduced to 
+ * tridiagonal form in place with dsptrd(). All eigenvalues of the 
+ * tridiagonal matrix are then computed with dsterf(), which determines how 
+ * many eigenvalues pass the cutoff. Only for these eigenvalues are the 
+ * eigenvectors computed, using dstebz() and dstein(), and transformed back 
+ * with dopmtr().
+ *
+ * @param[in,out] 	K 		the kernel matrix in packed storage. On
+ * 					exit, K is overwritten with the details
+ * 					of the tridiagonal reduction.
+ * @param[in] 		n 		the dimension of the kernel matrix
+ * @param[in] 		cutoff 		mimimum ratio of eigenvalue to largest
+ * 					eigenvalue for the eigenvector to be 
+ * 					included
+ * @param[out] 		P_ret 		on exit contains the eigenvectors, in
+ * 					column-major order (n x r)
+ * @param[out] 		Sigma_ret 	on exit contains the square roots of
+ * 					the eigenvalues, in descending order
+ *
+ * @return 			the number of eigenvalues kept
+ */
+long gensvm_kernel_eigendecomp_packed(double *K, long n, double cutoff,
+		double **P_ret, double **Sigma_ret)
+{
+	int M, nsplit, status, *iblock = NULL,
+	    *isplit = NULL,
+	    *IWORK = NULL,
+	    *IFAIL = NULL;
+	long i, j, k, num_eigen, cutoff_idx, *order = NULL;
+	double max_eigen, abstol, *D = NULL,
+	       *E = NULL,
+	       *tau = NULL,
+	       *W = NULL,
+	       *tmp = NULL,
+	       *WORK = NULL,
+	       *Sigma = NULL,
+	       *P = NULL;
+	bool *done = NULL;
+
+	D = Malloc(double, n);
+	E = Malloc(double, n);
+	W = Malloc(double, n);
+	tau = Malloc(double, n);
+	tmp = Malloc(double, n);
+
+	// reduce K to tridiagonal form T = Q' * K * Q
+	status = dsptrd('U', n, K, D, E, tau);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dsptrd.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	// compute all eigenvalues of T (in ascending order) to determine the 
+	// number of eigenvalues to keep
+	for (i=0; i<n; i++) {
+		W[i] = D[i];
+		tmp[i] = E[i];
+	}
+	status = dsterf(n, W, tmp);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dsterf.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	max_eigen = W[n-1];
+	cutoff_idx = 0;
+	for (i=0; i<n; i++) {
+		if (W[i]/max_eigen > cutoff) {
+			cutoff_idx = i;
+			break;
+		}
+	}
+
+	// compute the selected eigenvalues to high precision with bisection
+	abstol = 2.0*dlamch('S');
+	iblock = Malloc(int, n);
+	isplit = Malloc(int, n);
+	WORK = Malloc(double, 5*n);
+	IWORK = Malloc(int, 3*n);
+	IFAIL = Malloc(int, n);
+
+	status = dstebz('I', 'B', n, 0, 0, cutoff_idx+1, n, abstol, D, E, &M,
+			&nsplit, W, iblock, isplit, WORK, IWORK);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dstebz.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	num_eigen = M;
+
+	// compute the eigenvectors of T for the selected eigenvalues and 
+	// transform them back to eigenvectors of K
+	P = Malloc(double, n*num_eigen);
+	status = dstein(n, D, E, M, W, iblock, isplit, P, n, WORK, IWORK,
+			IFAIL);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dstein.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	WORK = Realloc(WORK, double, maximum(5*n, num_eigen));
+	status = dopmtr('L', 'U', 'N', n, num_eigen, K, tau, P, n, WORK);
+	if (status != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Nonzero exit status from dopmtr.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	// dstebz returns the eigenvalues ordered by block, so we sort them 
+	// in descending order here, and permute the eigenvectors accordingly.
+	order = Malloc(long, num_eigen);
+	for (i=0; i<num_eigen; i++) {
+		order[i] = i;
+		for (k=i; k>0 && W[order[k-1]] < W[order[k]]; k--) {
+			j = order[k];
+			order[k] = order[k-1];
+			order[k-1] = j;
+		}
+	}
+
+	// In the mathematical derivation (see paper), we state that the 
+	// diagonal matrix Sigma contains the square root of the eigenvalues 
+	// (i.e. the eigendecomposition is: K = P * Sigma^2 * P').
+	Sigma = Calloc(double, num_eigen);
+	for (i=0; i<num_eigen; i++)
+		Sigma[i] = sqrt(W[order[i]]);
+
+	// permute the columns of P in place by following the cycles of the 
+	// permutation, such that column i becomes column order[i].
+	done = Calloc(bool, num_eigen);
+	for (i=0; i<num_eigen; i++) {
+		if (done[i] || order[i] == i)
+			continue;
+		for (k=0; k<n; k++)
+			tmp[k] = P[k + i*n];
+		j = i;
+		while (order[j] != i) {
+			for (k=0; k<n; k++)
+				P[k + j*n] = P[k + order[j]*n];
+			done[j] = true;
+			j = order[j];
+		}
+		for (k=0; k<n; k++)
+			P[k + j*n] = tmp[k];
+		done[j] = true;
+	}
+
+	free(D);
+	free(E);
+	free(W);
+	free(tau);
+	free(tmp);
+	free(iblock);
+	free(isplit);
+	free(WORK);
+	free(IWORK);
+	free(IFAIL);
+	free(order);
+	free(done);
+
+	*Sigma_ret = Sigma;
+	*P_ret = P;
+
+	return num_eigen;
+}
+
 /**
  * @brief Compute the kernel crossproduct between two datasets
  *
@@ -303,7 +1260,8 @@ long gensvm_kernel_eigendecomp(double *K, long n, double cutoff, double **P_ret,
  * is given by @f$\textbf{K}_2 = \boldsymbol{\Phi}_2 \boldsymbol{\Phi}'@f$.  
  * Thus, an element in row @f$i@f$ and column @f$j@f$ in @f$\textbf{K}_2@f$ 
  * equals the kernel product between the @f$i@f$-th row of @f$\textbf{X}_2@f$ 
- * and the @f$j@f$-th row of @f$\textbf{X}@f$.
+ * and the @f$j@f$-th row of @f$\textbf{X}@f$. For a precomputed kernel this 
+ * returns a copy of GenData::kernel of the test dataset.
  *
  * @param[in] 	model 		the GenSVM model
  * @param[in] 	data_train 	the training dataset
@@ -313,40 +1271,170 @@ long gensvm_kernel_eigendecomp(double *K, long n, double cutoff, double **P_ret,
  */
 double *gensvm_kernel_cross(struct GenModel *model, struct GenData *data_train,
 		struct GenData *data_test)
+{
+	double *K2 = Calloc(double, data_test->n * data_train->n);
+
+	gensvm_kernel_cross_block(model, data_train, data_test, 0,
+			data_test->n, K2);
+
+	return K2;
+}
+
+/**
+ * @brief Compute a block of rows of the kernel crossproduct
+ *
+ * @details
+ * This computes the rows @f$\text{start}, \ldots, \text{start} + 
+ * \text{rows} - 1@f$ of the cross kernel matrix @f$\textbf{K}_2@f$ between 
+ * the test and training data (see gensvm_kernel_cross()). This function 
+ * writes to a preallocated buffer, and can therefore be used to process a 
+ * large test set in blocks without forming the full cross kernel matrix. For 
+ * a precomputed kernel the rows are copied from GenData::kernel of the test 
+ * dataset.
+ *
+ * If either dataset is stored as a sparse matrix in GenData::spZ, the inner 
+ * products are computed from the nonzero elements only, and the kernel is 
+ * evaluated with gensvm_kernel_dot_inner() using precomputed squared norms.  
+ * When only one of the datasets is sparse, its rows are gathered against the 
+ * dense rows of the other dataset. When both are sparse, each test instance 
+ * is scattered to a dense work vector and the training instances are 
+ * gathered against it. This is also done when the datasets have a different 
+ * number of features, as is common for LibSVM files, in which case the 
+ * missing features are zero.
+ *
+ * @param[in] 	model 		the GenSVM model
+ * @param[in] 	data_train 	the training dataset
+ * @param[in] 	data_test 	the test dataset
+ * @param[in] 	start 		index of the first test instance in the block
+ * @param[in] 	rows 		number of test instances in the block
+ * @param[out] 	K2 		preallocated array of size rows x n_train
+ * 				which contains the block of the cross kernel 
+ * 				on exit
+ */
+void gensvm_kernel_cross_block(struct GenModel *model,
+		struct GenData *data_train, struct GenData *data_test,
+		long start, long rows, double *K2)
 {
 	long i, j;
 	long n_train = data_train->n;
-	long n_test = data_test->n;
 	long m = data_test->m;
-	double value, *x1 = NULL,
-	       *x2 = NULL,
-	       *K2 = Calloc(double, n_test * n_train);
+	double *x1 = NULL,
+	       *x2 = NULL;
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		gensvm_kernel_check_precomputed(data_test);
+		for (i=0; i<rows*n_train; i++)
+			K2[i] = data_test->kernel[start*n_train + i];
+		return;
+	}
 
-	for (i=0; i<n_test; i++) {
+	if (data_train->RAW == NULL || data_test->RAW == NULL ||
+			data_train->m != data_test->m) {
+		gensvm_kernel_cross_block_sparse(model, data_train, data_test,
+				start, rows, K2);
+		return;
+	}
+
+	for (i=0; i<rows; i++) {
+		x1 = &data_test->RAW[(start+i)*(m+1)+1];
 		for (j=0; j<n_train; j++) {
-			x1 = &data_test->RAW[i*(m+1)+1];
 			x2 = &data_train->RAW[j*(m+1)+1];
-			if (model->kerneltype == K_POLY)
-				value = gensvm_kernel_dot_poly(x1, x2, m, 
-						model->gamma, model->coef, 
-						model->degree);
-			else if (model->kerneltype == K_RBF)
-				value = gensvm_kernel_dot_rbf(x1, x2, m, 
-						model->gamma);
-			else if (model->kerneltype == K_SIGMOID)
-				value = gensvm_kernel_dot_sigmoid(x1, x2, m,
-						model->gamma, model->coef);
-			else {
-				// LCOV_EXCL_START
-				err("[GenSVM Error]: Unknown kernel type in "
-						"gensvm_make_crosskernel\n");
-				exit(EXIT_FAILURE);
-				// LCOV_EXCL_STOP
+			matrix_set(K2, n_train, i, j,
+					gensvm_kernel_dot(model, x1, x2, m));
+		}
+	}
+}
+
+/**
+ * @brief Compute a block of the kernel crossproduct with sparse data
+ *
+ * @details
+ * This function is used by gensvm_kernel_cross_block() when the training 
+ * data, the test data, or both are stored as a sparse matrix, or when the 
+ * datasets have a different number of features. See that function for a 
+ * description. Features that are only present in one of the datasets are 
+ * zero in the other dataset.
+ *
+ * @param[in] 	model 		the GenSVM model
+ * @param[in] 	data_train 	the training dataset
+ * @param[in] 	data_test 	the test dataset
+ * @param[in] 	start 		index of the first test instance in the block
+ * @param[in] 	rows 		number of test instances in the block
+ * @param[out] 	K2 		preallocated array of size rows x n_train
+ * 				which contains the block of the cross kernel 
+ * 				on exit
+ */
+void gensvm_kernel_cross_block_sparse(struct GenModel *model,
+		struct GenData *data_train, struct GenData *data_test,
+		long start, long rows, double *K2)
+{
+	long i, j, jj, row;
+	long n_train = data_train->n,
+	     m_train = data_train->m,
+	     m_test = data_test->m,
+	     m_min = minimum(m_train, m_test),
+	     m_max = maximum(m_train, m_test);
+	double dot, norm_i, *w = NULL,
+	       *x1 = NULL,
+	       *x2 = NULL,
+	       *norms = Malloc(double, n_train);
+	struct GenSparse *A = data_train->spZ,
+			 *B = data_test->spZ;
+
+	// squared norms of the training instances
+	if (A == NULL) {
+		for (j=0; j<n_train; j++) {
+			x2 = &data_train->RAW[j*(m_train+1)+1];
+			norms[j] = cblas_ddot(m_train, x2, 1, x2, 1);
+		}
+	} else {
+		gensvm_kernel_sparse_norms(A, norms);
+	}
+
+	// work vector for a test instance, indexed by the columns of both 
+	// datasets
+	if (A != NULL || B != NULL)
+		w = Calloc(double, m_max+1);
+
+	for (i=0; i<rows; i++) {
+		row = start + i;
+		norm_i = 0.0;
+		if (B == NULL) {
+			x1 = &data_test->RAW[row*(m_test+1)];
+			norm_i = cblas_ddot(m_test, x1 + 1, 1, x1 + 1, 1);
+			if (A != NULL)
+				memcpy(w + 1, x1 + 1, m_test*sizeof(double));
+		} else {
+			for (jj=B->ia[row]; jj<B->ia[row+1]; jj++) {
+				if (B->ja[jj] == 0)
+					continue;
+				norm_i += B->values[jj] * B->values[jj];
+				w[B->ja[jj]] = B->values[jj];
 			}
-			matrix_set(K2, n_train, i, j, value);
 		}
+
+		for (j=0; j<n_train; j++) {
+			x2 = (A == NULL) ? &data_train->RAW[j*(m_train+1)] :
+				NULL;
+			if (A != NULL)
+				dot = gensvm_kernel_sparse_gather(w, A, j);
+			else if (B != NULL && m_test <= m_train)
+				dot = gensvm_kernel_sparse_gather(x2, B, row);
+			else
+				dot = cblas_ddot(m_min, (B == NULL) ? x1 + 1 :
+						w + 1, 1, x2 + 1, 1);
+			matrix_set(K2, n_train, i, j, gensvm_kernel_dot_inner(
+						model, dot, norm_i, norms[j]));
+		}
+
+		// reset the work vector
+		if (B != NULL)
+			for (jj=B->ia[row]; jj<B->ia[row+1]; jj++)
+				w[B->ja[jj]] = 0.0;
 	}
-	return K2;
+
+	free(w);
+	free(norms);
 }
 
 /**
@@ -409,51 +1497,62 @@ void gensvm_kernel_trainfactor(struct GenData *data, double *P, double *Sigma,
 void gensvm_kernel_testfactor(struct GenData *testdata,
 		struct GenData *traindata, double *K2)
 {
-	long n1, n2, r, i, j;
-	double value, *N = NULL,
-	       *M = NULL;
+	long r = traindata->r;
 
-	n1 = traindata->n;
-	n2 = testdata->n;
-	r = traindata->r;
+	testdata->Z = Calloc(double, testdata->n*(r+1));
+	gensvm_kernel_testfactor_block(testdata, traindata, K2, 0,
+			testdata->n);
 
-	N = Calloc(double, n2*r);
-	M = Calloc(double, n1*r);
+	// Set r to testdata
+	testdata->r = r;
+}
 
-	// copy M from traindata->Z because we need it in dgemm without column
-	// of 1's.
-	for (i=0; i<n1; i++) {
-		for (j=0; j<r; j++) {
-			value = matrix_get(traindata->Z, r+1, i, j+1);
-			matrix_set(M, r, i, j, value);
-		}
-	}
+/**
+ * @brief Calculate a block of rows of the testfactor
+ *
+ * @details
+ * This computes the rows @f$\text{start}, \ldots, \text{start} + 
+ * \text{rows} - 1@f$ of the testfactor (see gensvm_kernel_testfactor()) 
+ * given the corresponding rows of the cross kernel matrix. The matrix 
+ * @f$\textbf{M}@f$ is used directly from GenData::Z of the training data by 
+ * skipping the column of ones, and the result of the matrix product is 
+ * written directly to GenData::Z of the test data. No intermediate copies 
+ * are therefore made.
+ *
+ * @param[in,out] 	testdata 	a GenData struct with the testdata, with
+ * 					GenData::Z preallocated to size n x 
+ * 					(r+1). On exit contains the rows of 
+ * 					the testfactor in this block, preceded 
+ * 					by a column of ones.
+ * @param[in] 		traindata 	a GenData struct with the training data
+ * @param[in] 		K2 		rows x n_train block of the cross
+ * 					kernel matrix
+ * @param[in] 		start 		index of the first row of the block
+ * @param[in] 		rows 		number of rows in the block
+ */
+void gensvm_kernel_testfactor_block(struct GenData *testdata,
+		struct GenData *traindata, double *K2, long start, long rows)
+{
+	long i, j, n1 = traindata->n,
+	     r = traindata->r;
+	double value,
+	       *N = testdata->Z + start*(r+1);
 
-	// Multiply K2 with M and store in N
-	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n2, r, n1, 1.0,
-			K2, n1, M, r, 0.0, N, r);
+	// Multiply K2 with M and store in the block of Z after the column of 
+	// ones
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, r, n1,
+			1.0, K2, n1, traindata->Z + 1, r+1, 0.0, N + 1, r+1);
 
 	// Multiply N with Sigma^{-2}
 	for (j=0; j<r; j++) {
 		value = pow(matrix_get(traindata->Sigma, 1, j, 0), -2.0);
-		for (i=0; i<n2; i++)
-			matrix_mul(N, r, i, j, value);
-	}
-
-	// write N to Z with a column of ones
-	testdata->Z = Calloc(double, n2*(r+1));
-	for (i=0; i<n2; i++) {
-		for (j=0; j<r; j++) {
-			matrix_set(testdata->Z, r+1, i, j+1,
-					matrix_get(N, r, i, j));
-		}
-		matrix_set(testdata->Z, r+1, i, 0, 1.0);
+		for (i=0; i<rows; i++)
+			matrix_mul(N, r+1, i, j+1, value);
 	}
-	// Set r to testdata
-	testdata->r = r;
 
-	free(M);
-	free(N);
+	// Set the column of ones
+	for (i=0; i<rows; i++)
+		matrix_set(N, r+1, i, 0, 1.0);
 }
 
 /**
@@ -566,6 +1665,133 @@ int dsyevx(char JOBZ, char RANGE, char UPLO, int N, double *A, int LDA,
 	return INFO;
 }
 
+/**
+ * @brief Reduce a symmetric matrix in packed storage to tridiagonal form.
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/d6/d17/dsptrd_8f.html
+ */
+int dsptrd(char UPLO, int N, double *AP, double *D, double *E, double *TAU)
+{
+	extern void dsptrd_(char *UPLO, int *Np, double *AP, double *D,
+			double *E, double *TAU, int *INFOp);
+	int INFO;
+	dsptrd_(&UPLO, &N, AP, D, E, TAU, &INFO);
+	return INFO;
+}
+
+/**
+ * @brief Compute all eigenvalues of a symmetric tridiagonal matrix.
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/d1/d0e/dsterf_8f.html
+ */
+int dsterf(int N, double *D, double *E)
+{
+	extern void dsterf_(int *Np, double *D, double *E, int *INFOp);
+	int INFO;
+	dsterf_(&N, D, E, &INFO);
+	return INFO;
+}
+
+/**
+ * @brief Compute selected eigenvalues of a symmetric tridiagonal matrix by
+ * bisection.
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/d4/d48/dstebz_8f.html
+ */
+int dstebz(char RANGE, char ORDER, int N, double VL, double VU, int IL,
+		int IU, double ABSTOL, double *D, double *E, int *M,
+		int *NSPLIT, double *W, int *IBLOCK, int *ISPLIT,
+		double *WORK, int *IWORK)
+{
+	extern void dstebz_(char *RANGE, char *ORDER, int *Np, double *VLp,
+			double *VUp, int *ILp, int *IUp, double *ABSTOLp,
+			double *D, double *E, int *M, int *NSPLIT, double *W,
+			int *IBLOCK, int *ISPLIT, double *WORK, int *IWORK,
+			int *INFOp);
+	int INFO;
+	dstebz_(&RANGE, &ORDER, &N, &VL, &VU, &IL, &IU, &ABSTOL, D, E, M,
+			NSPLIT, W, IBLOCK, ISPLIT, WORK, IWORK, &INFO);
+	return INFO;
+}
+
+/**
+ * @brief Compute eigenvectors of a symmetric tridiagonal matrix by inverse
+ * iteration.
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/d4/d4d/dstein_8f.html
+ */
+int dstein(int N, double *D, double *E, int M, double *W, int *IBLOCK,
+		int *ISPLIT, double *Z, int LDZ, double *WORK, int *IWORK,
+		int *IFAIL)
+{
+	extern void dstein_(int *Np, double *D, double *E, int *Mp, double *W,
+			int *IBLOCK, int *ISPLIT, double *Z, int *LDZp,
+			double *WORK, int *IWORK, int *IFAIL, int *INFOp);
+	int INFO;
+	dstein_(&N, D, E, &M, W, IBLOCK, ISPLIT, Z, &LDZ, WORK, IWORK, IFAIL,
+			&INFO);
+	return INFO;
+}
+
+/**
+ * @brief Multiply a matrix with the orthogonal matrix from dsptrd().
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/d4/d1d/dopmtr_8f.html
+ */
+int dopmtr(char SIDE, char UPLO, char TRANS, int M, int N, double *AP,
+		double *TAU, double *C, int LDC, double *WORK)
+{
+	extern void dopmtr_(char *SIDE, char *UPLO, char *TRANS, int *Mp,
+			int *Np, double *AP, double *TAU, double *C, int *LDCp,
+			double *WORK, int *INFOp);
+	int INFO;
+	dopmtr_(&SIDE, &UPLO, &TRANS, &M, &N, AP, TAU, C, &LDC, WORK, &INFO);
+	return INFO;
+}
+
+/**
+ * @brief Compute the minimum norm solution of a linear least squares
+ * problem.
+ *
+ * @details
+ * This is a wrapper function around the external LAPACK function.
+ *
+ * See the LAPACK documentation at:
+ * http://www.netlib.org/lapack/explore-html/
+ */
+int dgelss(int M, int N, int NRHS, double *A, int LDA, double *B, int LDB,
+		double *S, double RCOND, int *RANK, double *WORK, int LWORK)
+{
+	extern void dgelss_(int *Mp, int *Np, int *NRHSp, double *A,
+			int *LDAp, double *B, int *LDBp, double *S,
+			double *RCONDp, int *RANK, double *WORK, int *LWORKp,
+			int *INFOp);
+	int INFO;
+	dgelss_(&M, &N, &NRHS, A, &LDA, B, &LDB, S, &RCOND, RANK, WORK,
+			&LWORK, &INFO);
+	return INFO;
+}
+
 /**
  * @brief Determine double precision machine parameters.
  *
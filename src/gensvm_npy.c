@@ -0,0 +1,849 @@
+/**
+ * @file gensvm_npy.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for reading data from NumPy .npy and .npz files
+ *
+ * @details
+ * A .npy file holds a single array, described by a short header in the
+ * form of a Python dictionary, followed by the elements. A .npz file is a
+ * zip archive of .npy files. Both are memory-mapped, and the arrays are
+ * read in place, without a Python or zip library. Only members that are
+ * stored without compression can be read from a .npz file, which is the
+ * default of numpy.savez().
+ *
+ * Since the instances in a GenData are augmented with a column of ones, the
+ * instances are converted in a single parallel pass to GenData::RAW or
+ * GenData::spZ. Labels that are stored as 64-bit integers are used in place
+ * from the mapped file.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_npy.h"
+#include "gensvm_parse.h"
+
+/**
+ * @brief Check if a file is a .npy or .npz file
+ *
+ * @param[in] 	data_file 	filename of the data file
+ * @returns 			whether the file starts with GENSVM_NPY_MAGIC
+ * 				or GENSVM_NPZ_MAGIC
+ */
+bool gensvm_is_npy_data(char *data_file)
+{
+	char magic[6];
+	bool npy = false;
+	FILE *fid = fopen(data_file, "rb");
+
+	if (fid == NULL)
+		return false;
+	if (fread(magic, 1, 6, fid) == 6)
+		npy = (memcmp(magic, GENSVM_NPY_MAGIC, 6) == 0 ||
+				memcmp(magic, GENSVM_NPZ_MAGIC, 4) == 0);
+	fclose(fid);
+
+	return npy;
+}
+
+/**
+ * @brief Read data from a .npy or .npz file
+ *
+ * @details
+ * The file is opened with gensvm_npy_open(), see there for the arrays that 
+ * are read. The instances are stored as 32 or 64 bit floating point 
+ * numbers, and are converted to a dense or a sparse matrix depending on the 
+ * number of nonzeros, as in gensvm_read_data(). If the labels are 64-bit 
+ * integers they are not copied, but used from the mapped file, which is 
+ * then unmapped by gensvm_free_data().
+ *
+ * @param[in,out] 	data 		initialized GenData
+ * @param[in] 		data_file 	filename of the .npy or .npz file
+ */
+void gensvm_read_data_npy(struct GenData *data, char *data_file)
+{
+	long i, K = 0;
+	struct GenNpyFile *file = gensvm_npy_open(data_file);
+
+	if (file->sparse)
+		gensvm_read_data_npy_csr(data, file);
+	else
+		gensvm_read_data_npy_dense(data, &file->X);
+
+	free(data->y);
+	data->y = NULL;
+	if (file->has_labels) {
+		data->y = gensvm_read_data_npy_labels(&file->y, data->n);
+		for (i=0; i<data->n; i++)
+			K = maximum(K, data->y[i]);
+	}
+	data->K = K;
+
+	if (data->y != NULL && (const char *) data->y == file->y.data) {
+		data->map = file->map;
+		data->map_size = file->size;
+		file->map = NULL;
+	}
+	gensvm_npy_close(file);
+}
+
+/**
+ * @brief Open a .npy or .npz data file
+ *
+ * @details
+ * A .npy file contains the n x m matrix of instances, without labels. A
+ * .npz file contains the instances either as the dense array @c X, or as a
+ * CSR matrix in the arrays @c data, @c indices, @c indptr and @c shape (as
+ * written by scipy.sparse.save_npz() with compressed=False). The labels
+ * are read from the array @c y if it is present. The labels and the CSR
+ * indices can be any integer type.
+ *
+ * The file is mapped into memory and the arrays are checked, but nothing 
+ * is copied. The instances can then be read in place with gensvm_npy_get(), 
+ * either all at once with gensvm_read_data_npy() or in chunks with 
+ * gensvm_read_data_chunk().
+ *
+ * @param[in] 	data_file 	filename of the .npy or .npz file
+ * @returns 			a GenNpyFile, to be closed with
+ * 				gensvm_npy_close()
+ */
+struct GenNpyFile *gensvm_npy_open(char *data_file)
+{
+	size_t length;
+	const char *member = NULL;
+	char *map = NULL;
+	struct GenNpyArray shape;
+	struct GenNpyFile *file = Malloc(struct GenNpyFile, 1);
+
+	file->map = map = gensvm_map_file(data_file, &file->size);
+	file->sparse = false;
+	file->has_labels = false;
+
+	if (file->size >= 6 && memcmp(map, GENSVM_NPY_MAGIC, 6) == 0) {
+		if (!gensvm_npy_parse(map, file->size, &file->X)) {
+			err("[GenSVM Error]: Invalid .npy file %s\n",
+					data_file);
+			exit(EXIT_FAILURE);
+		}
+		gensvm_npy_check_dense(file, data_file);
+		return file;
+	}
+
+	if (gensvm_npz_find(map, file->size, "X.npy", &member, &length)) {
+		if (!gensvm_npy_parse(member, length, &file->X)) {
+			err("[GenSVM Error]: Invalid array X in %s\n",
+					data_file);
+			exit(EXIT_FAILURE);
+		}
+		gensvm_npy_check_dense(file, data_file);
+	} else if (gensvm_npz_find(map, file->size, "data.npy", &member,
+				&length) &&
+			gensvm_npy_parse(member, length, &file->values) &&
+			gensvm_npz_find(map, file->size, "indices.npy",
+				&member, &length) &&
+			gensvm_npy_parse(member, length, &file->indices) &&
+			gensvm_npz_find(map, file->size, "indptr.npy", &member,
+				&length) &&
+			gensvm_npy_parse(member, length, &file->indptr) &&
+			gensvm_npz_find(map, file->size, "shape.npy", &member,
+				&length) &&
+			gensvm_npy_parse(member, length, &shape)) {
+		file->sparse = true;
+		gensvm_npy_check_csr(file, &shape, data_file);
+	} else {
+		err("[GenSVM Error]: No uncompressed array X or CSR matrix "
+				"found in %s\n", data_file);
+		exit(EXIT_FAILURE);
+	}
+
+	if (gensvm_npz_find(map, file->size, "y.npy", &member, &length)) {
+		if (!gensvm_npy_parse(member, length, &file->y)) {
+			err("[GenSVM Error]: Invalid array y in %s\n",
+					data_file);
+			exit(EXIT_FAILURE);
+		}
+		if (file->y.kind == 'f' || file->y.size != file->n ||
+				file->y.ndim > 2 || (file->y.ndim == 2 &&
+					file->y.shape[1] != 1)) {
+			err("[GenSVM Error]: The labels in %s should be an "
+					"array of %li integers\n", data_file,
+					file->n);
+			exit(EXIT_FAILURE);
+		}
+		file->has_labels = true;
+	}
+
+	return file;
+}
+
+/**
+ * @brief Close a .npy or .npz data file
+ *
+ * @param[in] 	file 	a GenNpyFile of gensvm_npy_open()
+ */
+void gensvm_npy_close(struct GenNpyFile *file)
+{
+	if (file == NULL)
+		return;
+
+	if (file->map != NULL)
+		gensvm_unmap_file(file->map, file->size);
+	free(file);
+}
+
+/**
+ * @brief Check the dense instances of a .npy or .npz file
+ *
+ * @details
+ * The instances should be a two dimensional array of floating point 
+ * numbers. This sets GenNpyFile::n and GenNpyFile::m.
+ *
+ * @param[in,out] 	file 		a GenNpyFile with GenNpyFile::X set
+ * @param[in] 		data_file 	filename of the data file
+ */
+void gensvm_npy_check_dense(struct GenNpyFile *file, char *data_file)
+{
+	struct GenNpyArray *X = &file->X;
+
+	file->n = X->shape[0];
+	file->m = X->shape[1];
+	if (X->ndim != 2 || X->kind != 'f' || file->n < 1 || file->m < 1) {
+		err("[GenSVM Error]: The instances in %s should be a two "
+				"dimensional array of floating point "
+				"numbers\n", data_file);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * @brief Check the CSR matrix of a .npz file
+ *
+ * @details
+ * The CSR matrix is given by the arrays of scipy.sparse.csr_matrix, with
+ * 0-based column indices. It is checked that the rows are consistent and
+ * that all column indices are within the shape of the matrix. This sets 
+ * GenNpyFile::n and GenNpyFile::m.
+ *
+ * @param[in,out] 	file 		a GenNpyFile with the arrays of the CSR
+ * 					matrix set
+ * @param[in] 		shape 		the number of rows and columns
+ * @param[in] 		data_file 	filename of the data file
+ */
+void gensvm_npy_check_csr(struct GenNpyFile *file, struct GenNpyArray *shape,
+		char *data_file)
+{
+	bool valid;
+	long i, k, n, m, nnz;
+	struct GenNpyArray *values = &file->values,
+			   *indices = &file->indices,
+			   *indptr = &file->indptr;
+
+	valid = (shape->kind != 'f' && shape->size == 2 &&
+			values->kind == 'f' && indices->kind != 'f' &&
+			indptr->kind != 'f' && values->ndim == 1 &&
+			indices->size == values->size);
+	n = valid ? gensvm_npy_get_long(shape, 0) : 0;
+	m = valid ? gensvm_npy_get_long(shape, 1) : 0;
+	nnz = values->size;
+	valid = valid && n > 0 && m > 0 && indptr->size == n+1 &&
+		gensvm_npy_get_long(indptr, 0) == 0 &&
+		gensvm_npy_get_long(indptr, n) == nnz;
+	for (i=0; valid && i<n; i++)
+		valid = (gensvm_npy_get_long(indptr, i) <=
+				gensvm_npy_get_long(indptr, i+1));
+	for (i=0; valid && i<nnz; i++) {
+		k = gensvm_npy_get_long(indices, i);
+		valid = (k >= 0 && k < m);
+	}
+	if (!valid) {
+		err("[GenSVM Error]: Invalid CSR matrix in %s\n", data_file);
+		exit(EXIT_FAILURE);
+	}
+
+	file->n = n;
+	file->m = m;
+}
+
+/**
+ * @brief Read dense instances from a .npy array
+ *
+ * @details
+ * The nonzeros are counted first, and the instances are copied directly to
+ * GenData::spZ if a sparse matrix is worth it (see gensvm_nnz_comparison()),
+ * and to GenData::RAW otherwise. Both are filled in parallel, and include
+ * the column of ones.
+ *
+ * @param[in,out] 	data 		initialized GenData
+ * @param[in] 		X 		n x m array of instances, checked with
+ * 					gensvm_npy_check_dense()
+ */
+void gensvm_read_data_npy_dense(struct GenData *data, struct GenNpyArray *X)
+{
+	long i, j, cnt,
+	     nnz = 0,
+	     n = X->shape[0],
+	     m = X->shape[1];
+	double value;
+	struct GenSparse *spZ = NULL;
+
+	#pragma omp parallel for reduction(+:nnz)
+	for (i=0; i<X->size; i++)
+		nnz += (gensvm_npy_get(X, i) != 0);
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+
+	if (!gensvm_nnz_comparison(nnz + n, n, m+1)) {
+		data->RAW = Malloc(double, n*(m+1));
+		data->Z = data->RAW;
+		#pragma omp parallel for private(j)
+		for (i=0; i<n; i++) {
+			matrix_set(data->RAW, m+1, i, 0, 1.0);
+			for (j=0; j<m; j++)
+				matrix_set(data->RAW, m+1, i, j+1,
+						gensvm_npy_get(X,
+							X->fortran_order ?
+							j*n+i : i*m+j));
+		}
+		return;
+	}
+
+	note("Reading data in sparse format ... ");
+	spZ = gensvm_init_sparse();
+	spZ->nnz = nnz + n;
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	spZ->values = Malloc(double, spZ->nnz);
+	spZ->ia = Malloc(long, n+1);
+	spZ->ja = Malloc(long, spZ->nnz);
+
+	// count the nonzeros per row, and fill the rows in parallel
+	spZ->ia[0] = 0;
+	#pragma omp parallel for private(j, cnt)
+	for (i=0; i<n; i++) {
+		cnt = 1;
+		for (j=0; j<m; j++)
+			cnt += (gensvm_npy_get(X, X->fortran_order ?
+						j*n+i : i*m+j) != 0);
+		spZ->ia[i+1] = cnt;
+	}
+	for (i=0; i<n; i++)
+		spZ->ia[i+1] += spZ->ia[i];
+
+	#pragma omp parallel for private(j, cnt, value)
+	for (i=0; i<n; i++) {
+		cnt = spZ->ia[i];
+		spZ->values[cnt] = 1.0;
+		spZ->ja[cnt++] = 0;
+		for (j=0; j<m; j++) {
+			value = gensvm_npy_get(X, X->fortran_order ?
+					j*n+i : i*m+j);
+			if (value != 0) {
+				spZ->values[cnt] = value;
+				spZ->ja[cnt++] = j+1;
+			}
+		}
+	}
+	data->spZ = spZ;
+	note("done.\n");
+}
+
+/**
+ * @brief Read instances from a CSR matrix in a .npz file
+ *
+ * @details
+ * The CSR matrix of the file is converted to GenData::spZ with the column of 
+ * ones, or to GenData::RAW if a sparse matrix isn't worth it.
+ *
+ * @param[in,out] 	data 	initialized GenData
+ * @param[in] 		file 	a GenNpyFile with a CSR matrix
+ */
+void gensvm_read_data_npy_csr(struct GenData *data, struct GenNpyFile *file)
+{
+	long i, j, k, start, stop,
+	     n = file->n,
+	     m = file->m,
+	     nnz = file->values.size;
+	struct GenNpyArray *values = &file->values,
+			   *indices = &file->indices,
+			   *indptr = &file->indptr;
+	struct GenSparse *spZ = NULL;
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+
+	if (!gensvm_nnz_comparison(nnz + n, n, m+1)) {
+		data->RAW = Calloc(double, n*(m+1));
+		data->Z = data->RAW;
+		#pragma omp parallel for private(k, stop)
+		for (i=0; i<n; i++) {
+			matrix_set(data->RAW, m+1, i, 0, 1.0);
+			stop = gensvm_npy_get_long(indptr, i+1);
+			for (k=gensvm_npy_get_long(indptr, i); k<stop; k++)
+				matrix_add(data->RAW, m+1, i,
+						gensvm_npy_get_long(indices,
+							k) + 1,
+						gensvm_npy_get(values, k));
+		}
+		return;
+	}
+
+	spZ = gensvm_init_sparse();
+	spZ->nnz = nnz + n;
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	spZ->values = Malloc(double, spZ->nnz);
+	spZ->ia = Malloc(long, n+1);
+	spZ->ja = Malloc(long, spZ->nnz);
+
+	// every row gets one extra element for the column of ones
+	#pragma omp parallel for private(j, k, start, stop)
+	for (i=0; i<n; i++) {
+		start = gensvm_npy_get_long(indptr, i);
+		stop = gensvm_npy_get_long(indptr, i+1);
+		j = start + i;
+		spZ->ia[i] = j;
+		spZ->values[j] = 1.0;
+		spZ->ja[j++] = 0;
+		for (k=start; k<stop; k++) {
+			spZ->values[j] = gensvm_npy_get(values, k);
+			spZ->ja[j++] = gensvm_npy_get_long(indices, k) + 1;
+		}
+	}
+	spZ->ia[n] = spZ->nnz;
+	data->spZ = spZ;
+}
+
+/**
+ * @brief Read the labels from a .npy array
+ *
+ * @details
+ * If the labels are 64-bit integers and suitably aligned, a pointer into
+ * the mapped file is returned. Otherwise they are converted to a newly
+ * allocated array.
+ *
+ * @param[in] 	y 		array of labels, checked by gensvm_npy_open()
+ * @param[in] 	n 		number of instances
+ * @returns 			the labels
+ */
+long *gensvm_read_data_npy_labels(struct GenNpyArray *y, long n)
+{
+	long i, *labels = NULL;
+
+	if (y->kind == 'i' && y->itemsize == sizeof(long) &&
+			((uintptr_t) y->data) % sizeof(long) == 0)
+		return (long *) y->data;
+
+	labels = Malloc(long, n);
+	for (i=0; i<n; i++)
+		labels[i] = gensvm_npy_get_long(y, i);
+	return labels;
+}
+
+/**
+ * @brief Parse the header of a .npy file
+ *
+ * @details
+ * The header of a .npy file is a Python dictionary with the keys @c descr,
+ * @c fortran_order and @c shape. Versions 1.0, 2.0 and 3.0 of the format are
+ * supported. It is checked that the elements fit in the buffer.
+ *
+ * @param[in] 	buffer 		start of the .npy file
+ * @param[in] 	size 		size of the .npy file in bytes
+ * @param[out] 	array 		the array in the file
+ * @returns 			whether the header is valid
+ */
+bool gensvm_npy_parse(const char *buffer, size_t size,
+		struct GenNpyArray *array)
+{
+	long header_size;
+	const char *str = NULL,
+	      *end = NULL,
+	      *header = NULL,
+	      *descr = NULL;
+
+	if (size < 10 || memcmp(buffer, GENSVM_NPY_MAGIC, 6) != 0)
+		return false;
+	if (buffer[6] == 1) {
+		header_size = gensvm_npz_read(buffer + 8, 2);
+		str = buffer + 10;
+	} else if ((buffer[6] == 2 || buffer[6] == 3) && size >= 12) {
+		header_size = gensvm_npz_read(buffer + 8, 4);
+		str = buffer + 12;
+	} else {
+		return false;
+	}
+	if ((size_t) (str - buffer) + header_size > size)
+		return false;
+	header = str;
+	end = str + header_size;
+
+	// the type of the elements
+	str = gensvm_npy_find_key(header, end, "descr");
+	if (str == NULL || (*str != '\'' && *str != '"'))
+		return false;
+	descr = ++str;
+	while (str < end && *str != descr[-1])
+		str++;
+	if (str == end || !gensvm_npy_parse_descr(descr, str - descr, array))
+		return false;
+
+	// the order of the elements
+	str = gensvm_npy_find_key(header, end, "fortran_order");
+	if (str == NULL)
+		return false;
+	if (end - str >= 4 && strncmp(str, "True", 4) == 0)
+		array->fortran_order = true;
+	else if (end - str >= 5 && strncmp(str, "False", 5) == 0)
+		array->fortran_order = false;
+	else
+		return false;
+
+	// the shape of the array
+	str = gensvm_npy_find_key(header, end, "shape");
+	if (str == NULL || !gensvm_npy_parse_shape(str, end, array))
+		return false;
+
+	array->data = end;
+	return (size_t) array->size <= (size - (end - buffer)) /
+		array->itemsize;
+}
+
+/**
+ * @brief Parse the type of the elements of a .npy array
+ *
+ * @details
+ * The type is given as a byte order ('<', '>', '=' or '|'), a kind and the
+ * number of bytes of an element. Floating point numbers of 4 and 8 bytes,
+ * and integers of 1, 2, 4 and 8 bytes are supported, in the byte order of
+ * this machine.
+ *
+ * @param[in] 	descr 		the type string, without quotes
+ * @param[in] 	length 		length of the type string
+ * @param[out] 	array 		array to set the kind and size of
+ * @returns 			whether the type is supported
+ */
+bool gensvm_npy_parse_descr(const char *descr, long length,
+		struct GenNpyArray *array)
+{
+	const uint16_t one = 1;
+	char native = (*((const char *) &one) == 1) ? '<' : '>';
+
+	if (length != 3 || (descr[0] != native && descr[0] != '=' &&
+				descr[0] != '|'))
+		return false;
+
+	array->kind = descr[1];
+	array->itemsize = descr[2] - '0';
+	if (array->kind == 'f')
+		return array->itemsize == 4 || array->itemsize == 8;
+	if (array->kind == 'i' || array->kind == 'u')
+		return array->itemsize == 1 || array->itemsize == 2 ||
+			array->itemsize == 4 || array->itemsize == 8;
+	return false;
+}
+
+/**
+ * @brief Parse the shape of a .npy array
+ *
+ * @details
+ * The shape is a Python tuple of at most two integers, such as @c (5,) or
+ * @c (5, 3).
+ *
+ * @param[in] 	str 		start of the tuple
+ * @param[in] 	end 		end of the header
+ * @param[out] 	array 		array to set the shape of
+ * @returns 			whether the shape is valid
+ */
+bool gensvm_npy_parse_shape(const char *str, const char *end,
+		struct GenNpyArray *array)
+{
+	long value;
+
+	if (str == end || *str++ != '(')
+		return false;
+
+	array->ndim = 0;
+	array->shape[0] = 1;
+	array->shape[1] = 1;
+	array->size = 1;
+	while (true) {
+		while (str < end && (*str == ' ' || *str == ','))
+			str++;
+		if (str == end)
+			return false;
+		if (*str == ')')
+			break;
+		if (!isdigit((unsigned char) *str) || array->ndim == 2)
+			return false;
+		for (value=0; str < end && isdigit((unsigned char) *str);
+				str++) {
+			if (value > LONG_MAX/10)
+				return false;
+			value = 10*value + (*str - '0');
+		}
+		if (value > 0 && array->size > LONG_MAX/value)
+			return false;
+		array->shape[array->ndim++] = value;
+		array->size *= value;
+	}
+	return true;
+}
+
+/**
+ * @brief Find the value of a key in the header of a .npy file
+ *
+ * @param[in] 	header 		start of the header
+ * @param[in] 	end 		end of the header
+ * @param[in] 	key 		the key, without quotes
+ * @returns 			the start of the value of the key, or NULL if
+ * 				the key isn't found
+ */
+const char *gensvm_npy_find_key(const char *header, const char *end,
+		const char *key)
+{
+	long length = strlen(key);
+	const char *str = NULL;
+
+	for (str=header; str + length + 2 <= end; str++) {
+		if ((*str != '\'' && *str != '"') || str[length+1] != *str ||
+				strncmp(str + 1, key, length) != 0)
+			continue;
+		str += length + 2;
+		while (str < end && (*str == ' ' || *str == ':'))
+			str++;
+		return str;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Find a member of a .npz file
+ *
+ * @details
+ * The member is looked up in the central directory of the zip archive,
+ * including the zip64 extensions that are used by numpy.savez(). Only
+ * members that are stored without compression are found.
+ *
+ * @param[in] 	map 		the mapped .npz file
+ * @param[in] 	size 		size of the file in bytes
+ * @param[in] 	name 		name of the member
+ * @param[out] 	member 		start of the member in the mapped file
+ * @param[out] 	member_size 	size of the member in bytes
+ * @returns 			whether the member is found
+ */
+bool gensvm_npz_find(const char *map, size_t size, const char *name,
+		const char **member, size_t *member_size)
+{
+	long e, n_entries,
+	     name_length = strlen(name);
+	uint64_t method, length, extra, comment, offset, compressed,
+		 uncompressed, id, field;
+	const char *entry = NULL,
+	      *str = NULL,
+	      *end = map + size;
+
+	entry = gensvm_npz_central_directory(map, size, &n_entries);
+	for (e=0; entry != NULL && e<n_entries; e++) {
+		if (entry + 46 > end || memcmp(entry, "PK\x01\x02", 4) != 0)
+			return false;
+		method = gensvm_npz_read(entry + 10, 2);
+		compressed = gensvm_npz_read(entry + 20, 4);
+		uncompressed = gensvm_npz_read(entry + 24, 4);
+		length = gensvm_npz_read(entry + 28, 2);
+		extra = gensvm_npz_read(entry + 30, 2);
+		comment = gensvm_npz_read(entry + 32, 2);
+		offset = gensvm_npz_read(entry + 42, 4);
+		if (entry + 46 + length + extra > end)
+			return false;
+
+		if ((long) length != name_length ||
+				memcmp(entry + 46, name, length) != 0) {
+			entry += 46 + length + extra + comment;
+			continue;
+		}
+		if (method != 0)
+			return false;
+
+		// the zip64 extra field holds the sizes that don't fit
+		for (str=entry + 46 + length; str + 4 <= entry + 46 + length +
+				extra; str += 4 + field) {
+			id = gensvm_npz_read(str, 2);
+			field = gensvm_npz_read(str + 2, 2);
+			if (id != 1)
+				continue;
+			id = 4;
+			if (uncompressed == 0xFFFFFFFF) {
+				uncompressed = gensvm_npz_read(str + id, 8);
+				id += 8;
+			}
+			if (compressed == 0xFFFFFFFF) {
+				compressed = gensvm_npz_read(str + id, 8);
+				id += 8;
+			}
+			if (offset == 0xFFFFFFFF)
+				offset = gensvm_npz_read(str + id, 8);
+		}
+
+		// the data starts after the local header
+		if (offset + 30 > size || memcmp(map + offset, "PK\x03\x04",
+					4) != 0)
+			return false;
+		offset += 30 + gensvm_npz_read(map + offset + 26, 2) +
+			gensvm_npz_read(map + offset + 28, 2);
+		if (offset > size || uncompressed > size - offset)
+			return false;
+		*member = map + offset;
+		*member_size = uncompressed;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Find the central directory of a zip archive
+ *
+ * @param[in] 	map 		the mapped zip archive
+ * @param[in] 	size 		size of the archive in bytes
+ * @param[out] 	n_entries 	number of entries in the central directory
+ * @returns 			start of the central directory, or NULL if it
+ * 				isn't found
+ */
+const char *gensvm_npz_central_directory(const char *map, size_t size,
+		long *n_entries)
+{
+	uint64_t offset;
+	const char *str = NULL,
+	      *zip64 = NULL;
+
+	// the end of central directory record is followed by a comment
+	if (size < 22)
+		return NULL;
+	for (str=map + size - 22; str >= map; str--) {
+		if (memcmp(str, "PK\x05\x06", 4) == 0)
+			break;
+		if (str == map || map + size - str > 65535 + 22)
+			return NULL;
+	}
+
+	*n_entries = gensvm_npz_read(str + 10, 2);
+	offset = gensvm_npz_read(str + 16, 4);
+	if (offset == 0xFFFFFFFF || *n_entries == 0xFFFF) {
+		if (str - map < 20 || memcmp(str - 20, "PK\x06\x07", 4) != 0)
+			return NULL;
+		offset = gensvm_npz_read(str - 12, 8);
+		if (offset + 56 > size)
+			return NULL;
+		zip64 = map + offset;
+		if (memcmp(zip64, "PK\x06\x06", 4) != 0)
+			return NULL;
+		*n_entries = gensvm_npz_read(zip64 + 32, 8);
+		offset = gensvm_npz_read(zip64 + 48, 8);
+	}
+	if (offset >= size)
+		return NULL;
+	return map + offset;
+}
+
+/**
+ * @brief Get an element of a .npy array as a double
+ *
+ * @param[in] 	array 	the array
+ * @param[in] 	i 	index of the element in the order of the file
+ * @returns 		the element
+ */
+double gensvm_npy_get(struct GenNpyArray *array, long i)
+{
+	float f;
+	double d;
+
+	if (array->kind == 'f' && array->itemsize == 8) {
+		memcpy(&d, array->data + i*8, 8);
+		return d;
+	}
+	if (array->kind == 'f') {
+		memcpy(&f, array->data + i*4, 4);
+		return f;
+	}
+	return gensvm_npy_get_long(array, i);
+}
+
+/**
+ * @brief Get an element of a .npy array as an integer
+ *
+ * @param[in] 	array 	the array
+ * @param[in] 	i 	index of the element in the order of the file
+ * @returns 		the element
+ */
+long gensvm_npy_get_long(struct GenNpyArray *array, long i)
+{
+	int8_t i8;
+	int16_t i16;
+	int32_t i32;
+	int64_t i64;
+	uint8_t u8;
+	uint16_t u16;
+	uint32_t u32;
+	const char *p = array->data + i*array->itemsize;
+
+	if (array->kind == 'f')
+		return (long) gensvm_npy_get(array, i);
+
+	switch (array->itemsize) {
+		case 1:
+			memcpy(&i8, p, 1);
+			memcpy(&u8, p, 1);
+			return (array->kind == 'u') ? u8 : i8;
+		case 2:
+			memcpy(&i16, p, 2);
+			memcpy(&u16, p, 2);
+			return (array->kind == 'u') ? u16 : i16;
+		case 4:
+			memcpy(&i32, p, 4);
+			memcpy(&u32, p, 4);
+			return (array->kind == 'u') ? (long) u32 : i32;
+		default:
+			memcpy(&i64, p, 8);
+			return i64;
+	}
+}
+
+/**
+ * @brief Read an unsigned little endian integer
+ *
+ * @details
+ * The numbers in a zip archive and the length of the header of a .npy file
+ * are little endian, regardless of the machine.
+ *
+ * @param[in] 	buffer 	start of the integer
+ * @param[in] 	n_bytes number of bytes of the integer
+ * @returns 		the integer
+ */
+uint64_t gensvm_npz_read(const char *buffer, int n_bytes)
+{
+	int i;
+	uint64_t value = 0;
+
+	for (i=n_bytes-1; i>=0; i--)
+		value = (value << 8) | (unsigned char) buffer[i];
+	return value;
+}
@@ -0,0 +1,1524 @@
+/**
+ * @file gensvm_parse.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for parsing memory-mapped data files
+ *
+ * @details
+ * This file contains functions for parsing data files that are mapped into
+ * memory. The file is split into chunks at line boundaries, which are parsed
+ * in parallel, and numbers are parsed in place without copying the lines
+ * of the file. The number parser gives the same result as strtod(), which is
+ * used for numbers that can't be parsed exactly with double precision
+ * arithmetic.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "gensvm_parse.h"
+
+/**
+ * Powers of ten that are exactly representable as a double
+ */
+const double GENSVM_PARSE_POW10[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+	1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Check if a character separates the numbers on a line
+ *
+ * @param[in] 	c 	character
+ *
+ * @return 		whether c is white space other than a newline
+ */
+#define gensvm_parse_is_blank(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' \
+		|| (c) == '\v' || (c) == '\f')
+
+/**
+ * @brief Check if a character is white space
+ *
+ * @details
+ * This is the same as isspace() in the C locale, but it avoids the lookup
+ * of the locale for every character of the file.
+ *
+ * @param[in] 	c 	character
+ *
+ * @return 		whether c is white space
+ */
+#define gensvm_parse_is_space(c) ((c) == ' ' || ((c) >= '\t' && (c) <= '\r'))
+
+/**
+ * @brief Map a file into memory
+ *
+ * @details
+ * The file is mapped read-only with mmap(), so that it can be parsed
+ * without reading it into a buffer first. The mapped file is not
+ * terminated by a zero, the functions in this file therefore take the end
+ * of the mapped file as argument. An empty file results in a NULL pointer
+ * and a size of zero.
+ *
+ * @param[in] 	filename 	name of the file
+ * @param[out] 	size 		size of the file in bytes
+ *
+ * @return 			the mapped file, to be unmapped with
+ * 				gensvm_unmap_file()
+ */
+char *gensvm_map_file(char *filename, size_t *size)
+{
+	int fd;
+	char *map = NULL;
+	struct stat st;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Datafile %s could not be opened.\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	*size = st.st_size;
+	if (*size == 0) {
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Datafile %s could not be mapped.\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	madvise(map, *size, MADV_WILLNEED);
+
+	return map;
+}
+
+/**
+ * @brief Unmap a file that was mapped with gensvm_map_file()
+ *
+ * @param[in] 	map 	the mapped file
+ * @param[in] 	size 	size of the file in bytes
+ */
+void gensvm_unmap_file(char *map, size_t size)
+{
+	if (map != NULL)
+		munmap(map, size);
+}
+
+/**
+ * @brief Number of chunks to split a data file in
+ *
+ * @param[in] 	size 	size of the data in bytes
+ *
+ * @return 		number of chunks of about GENSVM_PARSE_CHUNK_SIZE
+ * 			bytes
+ */
+long gensvm_parse_n_chunks(size_t size)
+{
+	return size / GENSVM_PARSE_CHUNK_SIZE + 1;
+}
+
+/**
+ * @brief Split data in chunks at line boundaries
+ *
+ * @details
+ * The data between begin and end is split in n_chunks chunks of roughly
+ * equal size, where every chunk starts at the start of a line. Chunks can be
+ * empty when lines are longer than the chunks. The rows of every chunk are
+ * counted in parallel with gensvm_parse_count_rows(), after which the index
+ * of the first row of every chunk is set.
+ *
+ * @param[in] 	begin 		start of the data
+ * @param[in] 	end 		end of the data
+ * @param[in] 	n_chunks 	number of chunks
+ *
+ * @return 			array of n_chunks chunks
+ */
+struct GenParseChunk *gensvm_parse_chunks(const char *begin, const char *end,
+		long n_chunks)
+{
+	long c, row = 0;
+	size_t step = (end - begin) / n_chunks;
+	struct GenParseChunk *chunks = Malloc(struct GenParseChunk, n_chunks);
+
+	chunks[0].start = begin;
+	for (c=1; c<n_chunks; c++)
+		chunks[c].start = (step == 0) ? begin :
+			gensvm_parse_next_line(begin + c*step - 1, end);
+	for (c=0; c<n_chunks; c++) {
+		chunks[c].end = (c < n_chunks - 1) ? chunks[c+1].start : end;
+		chunks[c].nnz = 0;
+		chunks[c].error_row = -1;
+	}
+
+	#pragma omp parallel for schedule(dynamic)
+	for (c=0; c<n_chunks; c++)
+		chunks[c].n_rows = gensvm_parse_count_rows(chunks[c].start,
+				chunks[c].end);
+
+	for (c=0; c<n_chunks; c++) {
+		chunks[c].row_start = row;
+		row += chunks[c].n_rows;
+	}
+
+	return chunks;
+}
+
+/**
+ * @brief Count the rows in a part of a data file
+ *
+ * @details
+ * A row is a line that contains a character that is not white space, blank
+ * lines are not counted.
+ *
+ * @param[in] 	start 	start of a line
+ * @param[in] 	end 	end of the data
+ *
+ * @return 		number of rows between start and end
+ */
+long gensvm_parse_count_rows(const char *start, const char *end)
+{
+	long n_rows = 0;
+	const char *str = start,
+	      *line_end = NULL;
+
+	while (str < end) {
+		line_end = memchr(str, '\n', end - str);
+		if (line_end == NULL)
+			line_end = end;
+		for (; str < line_end; str++) {
+			if (!gensvm_parse_is_space(*str)) {
+				n_rows++;
+				break;
+			}
+		}
+		str = line_end + 1;
+	}
+	return n_rows;
+}
+
+/**
+ * @brief Count the nonzero values of the rows of all chunks
+ *
+ * @details
+ * The nonzero values of every chunk are counted in parallel with
+ * gensvm_parse_count_nnz() and stored in GenParseChunk::nnz. This is used
+ * to decide whether a data file is read in dense or sparse format before
+ * the values are parsed. Since a dense matrix is used when there are many
+ * nonzeros, the counting stops when max_nnz nonzeros are found. The number
+ * of nonzeros in the chunks is then incomplete.
+ *
+ * @param[in,out] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 		n_chunks 	number of chunks
+ * @param[in] 		m 		number of features on every row
+ * @param[in] 		max_nnz 	number of nonzeros after which
+ * 					counting stops
+ *
+ * @return 				upper bound on the number of nonzero
+ * 					features in the data, or a number of
+ * 					at least max_nnz if counting stopped
+ */
+long gensvm_parse_chunks_nnz(struct GenParseChunk *chunks, long n_chunks,
+		long m, long max_nnz)
+{
+	long c, nnz = 0,
+	     total = 0;
+
+	#pragma omp parallel for schedule(dynamic) private(nnz)
+	for (c=0; c<n_chunks; c++) {
+		#pragma omp atomic read
+		nnz = total;
+		if (nnz >= max_nnz)
+			continue;
+		chunks[c].nnz = gensvm_parse_count_nnz(chunks[c].start,
+				chunks[c].end, m);
+		#pragma omp atomic
+		total += chunks[c].nnz;
+	}
+	return total;
+}
+
+/**
+ * @brief Count the nonzero values in a part of a data file
+ *
+ * @details
+ * The first max_values numbers on every line are checked without parsing
+ * them. A decimal number of which all digits are zero is zero, all other
+ * numbers are counted as nonzero. The result is therefore an upper bound on
+ * the number of nonzeros, which only differs from the exact number for
+ * numbers that underflow to zero or are written in hexadecimal.
+ *
+ * @param[in] 	start 		start of a line
+ * @param[in] 	end 		end of the data
+ * @param[in] 	max_values 	number of values to check on every line
+ *
+ * @return 			upper bound on the number of nonzeros
+ */
+long gensvm_parse_count_nnz(const char *start, const char *end,
+		long max_values)
+{
+	long j, nnz = 0;
+	bool zero, has_digits;
+	const char *str = start,
+	      *p = NULL;
+
+	while (str < end) {
+		for (j=0; j<max_values; j++) {
+			while (str < end && gensvm_parse_is_blank(*str))
+				str++;
+			if (str == end || *str == '\n')
+				break;
+
+			// a number is zero if it only has zeros before the exponent
+			has_digits = false;
+			p = str;
+			if (*p == '-' || *p == '+')
+				p++;
+			for (; p < end && (*p == '0' || *p == '.'); p++)
+				has_digits = has_digits || *p == '0';
+			if (has_digits && p < end && (*p == 'e' || *p == 'E')) {
+				p++;
+				if (p < end && (*p == '-' || *p == '+'))
+					p++;
+				while (p < end && isdigit((unsigned char) *p))
+					p++;
+			}
+			zero = has_digits && (p == end ||
+					gensvm_parse_is_space(*p));
+			nnz += zero ? 0 : 1;
+
+			while (p < end && !gensvm_parse_is_space(*p))
+				p++;
+			str = p;
+		}
+		str = gensvm_parse_next_line(str, end);
+	}
+	return nnz;
+}
+
+/**
+ * @brief Parse a row of a data file in the dense format
+ *
+ * @details
+ * The m features of the row are parsed into values, followed by the label
+ * if has_labels is true. The position is moved to the start of the next
+ * line, also for blank lines.
+ *
+ * @param[in,out] 	str 		start of a line, set to the start of the
+ * 					next line
+ * @param[in] 		end 		end of the data
+ * @param[out] 		values 		array for the m features
+ * @param[in] 		m 		number of features
+ * @param[in] 		has_labels 	whether the row ends with a label
+ * @param[out] 		label 		the label of the row
+ *
+ * @return 				1 if a row is parsed, 0 for a blank line
+ * 					and -1 if the line has the wrong format
+ */
+int gensvm_parse_dense_row(const char **str, const char *end,
+		double *values, long m, bool has_labels, long *label)
+{
+	long n_values;
+	double value;
+
+	n_values = gensvm_parse_values(str, end, values, m);
+	if (n_values == 0 && gensvm_parse_line_end(*str, end)) {
+		*str = gensvm_parse_next_line(*str, end);
+		return 0;
+	}
+	if (n_values != m)
+		return -1;
+	if (has_labels) {
+		if (!gensvm_parse_double(str, end, &value))
+			return -1;
+		*label = (long) value;
+	}
+	if (!gensvm_parse_line_end(*str, end))
+		return -1;
+	*str = gensvm_parse_next_line(*str, end);
+	return 1;
+}
+
+/**
+ * @brief Parse the rows of a data file in the dense format in parallel
+ *
+ * @details
+ * Every chunk is parsed by a single thread with gensvm_parse_dense_row(),
+ * directly into the rows of RAW. Every row of RAW gets a one in the first
+ * column, followed by the m features of the instance. If has_labels is
+ * true, the last number of every row is the label, which is stored in y.
+ * Rows after the first n are ignored. A row with too few or too many
+ * numbers results in an error.
+ *
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	end 		end of the data
+ * @param[in] 	n 		number of rows of RAW
+ * @param[in] 	m 		number of features
+ * @param[in] 	has_labels 	whether the rows end with a label
+ * @param[out] 	RAW 		allocated n x (m+1) matrix
+ * @param[out] 	y 		allocated array of n labels, or NULL if
+ * 				has_labels is false
+ *
+ * @return 			number of rows read, at most n
+ */
+long gensvm_parse_dense(struct GenParseChunk *chunks, long n_chunks,
+		const char *end, long n, long m, bool has_labels, double *RAW,
+		long *y)
+{
+	int status;
+	long c, i, label = 0;
+	const char *str = NULL;
+
+	#pragma omp parallel for schedule(dynamic) private(i, status, label, \
+		str)
+	for (c=0; c<n_chunks; c++) {
+		str = chunks[c].start;
+		i = chunks[c].row_start;
+		while (str < chunks[c].end && i < n) {
+			status = gensvm_parse_dense_row(&str, end,
+					&RAW[i*(m+1)+1], m, has_labels, &label);
+			if (status < 0) {
+				chunks[c].error_row = i;
+				break;
+			}
+			if (status == 0)
+				continue;
+			matrix_set(RAW, m+1, i, 0, 1.0);
+			if (has_labels)
+				y[i] = label;
+			i++;
+		}
+	}
+
+	return gensvm_parse_check_rows(chunks, n_chunks, n);
+}
+
+/**
+ * @brief Parse the rows of a data file in the dense format into CSR format
+ *
+ * @details
+ * This reads a data file in the dense format directly in a GenSparse
+ * structure, without allocating the dense matrix. The number of nonzeros of
+ * every chunk must be counted with gensvm_parse_chunks_nnz() first, which
+ * gives the position of the values of every chunk in the arrays of the
+ * GenSparse structure, so that the chunks can be parsed in parallel. Every
+ * row starts with a one in column 0, as in GenData::spZ. When the counted
+ * number of nonzeros was too large, the chunks are moved together
+ * afterwards. Rows after the first n are ignored and a row with the wrong
+ * number of values results in an error, as in gensvm_parse_dense().
+ *
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks(), with the
+ * 				nonzeros counted
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	end 		end of the data
+ * @param[in] 	n 		number of rows
+ * @param[in] 	m 		number of features
+ * @param[in] 	has_labels 	whether the rows end with a label
+ * @param[out] 	y 		allocated array of n labels, or NULL if
+ * 				has_labels is false
+ * @param[out] 	n_read 		number of rows read, at most n
+ *
+ * @return 			GenSparse structure with n rows and m+1
+ * 				columns
+ */
+struct GenSparse *gensvm_parse_sparse(struct GenParseChunk *chunks,
+		long n_chunks, const char *end, long n, long m,
+		bool has_labels, long *y, long *n_read)
+{
+	int status;
+	long c, i, j, pos, shift, last, label = 0,
+	     nnz = 0,
+	     *offset = Malloc(long, n_chunks+1);
+	double *row = NULL;
+	const char *str = NULL;
+	struct GenSparse *spZ = gensvm_init_sparse();
+
+	offset[0] = 0;
+	for (c=0; c<n_chunks; c++)
+		offset[c+1] = offset[c] + chunks[c].nnz + chunks[c].n_rows;
+
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	spZ->values = Malloc(double, offset[n_chunks]);
+	spZ->ja = Malloc(long, offset[n_chunks]);
+	spZ->ia = Malloc(long, n+1);
+	spZ->ia[0] = 0;
+
+	#pragma omp parallel private(i, j, pos, status, label, row, str)
+	{
+		row = Malloc(double, m);
+		#pragma omp for schedule(dynamic)
+		for (c=0; c<n_chunks; c++) {
+			str = chunks[c].start;
+			i = chunks[c].row_start;
+			pos = offset[c];
+			while (str < chunks[c].end && i < n) {
+				status = gensvm_parse_dense_row(&str, end,
+						row, m, has_labels, &label);
+				if (status < 0) {
+					chunks[c].error_row = i;
+					break;
+				}
+				if (status == 0)
+					continue;
+				spZ->values[pos] = 1.0;
+				spZ->ja[pos++] = 0;
+				for (j=0; j<m; j++) {
+					if (row[j] == 0.0)
+						continue;
+					spZ->values[pos] = row[j];
+					spZ->ja[pos++] = j+1;
+				}
+				spZ->ia[i+1] = pos;
+				if (has_labels)
+					y[i] = label;
+				i++;
+			}
+			// the number of values of this chunk, used below
+			chunks[c].nnz = pos - offset[c];
+		}
+		free(row);
+	}
+
+	*n_read = gensvm_parse_check_rows(chunks, n_chunks, n);
+
+	// move the chunks together if there are fewer nonzeros than counted
+	for (c=0; c<n_chunks; c++) {
+		shift = offset[c] - nnz;
+		if (shift > 0) {
+			memmove(&spZ->values[nnz], &spZ->values[offset[c]],
+					chunks[c].nnz*sizeof(double));
+			memmove(&spZ->ja[nnz], &spZ->ja[offset[c]],
+					chunks[c].nnz*sizeof(long));
+			last = minimum(n, chunks[c].row_start +
+					chunks[c].n_rows);
+			for (i=chunks[c].row_start; i<last; i++)
+				spZ->ia[i+1] -= shift;
+		}
+		nnz += chunks[c].nnz;
+	}
+	if (nnz < offset[n_chunks]) {
+		spZ->values = Realloc(spZ->values, double, maximum(nnz, 1));
+		spZ->ja = Realloc(spZ->ja, long, maximum(nnz, 1));
+	}
+	spZ->nnz = nnz;
+	free(offset);
+
+	return spZ;
+}
+
+/**
+ * @brief Parse a chunk of a data file in the dense format into a CSR fragment
+ *
+ * @details
+ * This is used when the number of nonzeros can't be counted in advance, 
+ * such as for a compressed file that is decompressed in blocks. The rows of 
+ * the chunk are parsed with gensvm_parse_dense_row(), and the nonzero 
+ * features are stored in a fragment as in gensvm_parse_libsvm_chunk(), 
+ * without the column of ones and with the features in columns 1 to m. The 
+ * fragments of all chunks can then be combined with 
+ * gensvm_parse_stitch_dense() or gensvm_parse_stitch_sparse() once the total 
+ * number of nonzeros is known. Rows after the first n rows of the file are 
+ * ignored. If a row has the wrong number of values, GenParseChunk::error_row 
+ * is set.
+ *
+ * @param[in,out] 	chunk 		a chunk with GenParseChunk::row_start
+ * 					and GenParseChunk::n_rows set
+ * @param[in] 		end 		end of the data
+ * @param[in] 		n 		number of rows of the file
+ * @param[in] 		m 		number of features
+ * @param[in] 		has_labels 	whether the rows end with a label
+ * @param[out] 		y 		allocated array of n labels, or NULL if
+ * 					has_labels is false
+ *
+ * @return 				CSR fragment of the chunk
+ */
+struct GenSparse *gensvm_parse_dense_chunk(struct GenParseChunk *chunk,
+		const char *end, long n, long m, bool has_labels, long *y)
+{
+	int status;
+	long j, label = 0,
+	     r = 0,
+	     cnt = 0,
+	     n_rows = minimum(chunk->n_rows, n - chunk->row_start),
+	     size = (chunk->end - chunk->start)/16 + m;
+	double *row = Malloc(double, m);
+	const char *str = chunk->start;
+	struct GenSparse *frag = gensvm_init_sparse();
+
+	n_rows = maximum(n_rows, 0);
+	frag->ia = Malloc(long, n_rows+1);
+	frag->values = Malloc(double, size);
+	frag->ja = Malloc(long, size);
+	frag->ia[0] = 0;
+
+	while (str < chunk->end && r < n_rows) {
+		status = gensvm_parse_dense_row(&str, end, row, m, has_labels,
+				&label);
+		if (status < 0) {
+			chunk->error_row = chunk->row_start + r;
+			break;
+		}
+		if (status == 0)
+			continue;
+		if (cnt + m > size) {
+			size = maximum(2*size, cnt + m);
+			frag->values = Realloc(frag->values, double, size);
+			frag->ja = Realloc(frag->ja, long, size);
+		}
+		for (j=0; j<m; j++) {
+			if (row[j] == 0.0)
+				continue;
+			frag->values[cnt] = row[j];
+			frag->ja[cnt++] = j+1;
+		}
+		if (has_labels)
+			y[chunk->row_start + r] = label;
+		frag->ia[++r] = cnt;
+	}
+	free(row);
+
+	frag->n_row = r;
+	frag->nnz = cnt;
+	frag->values = Realloc(frag->values, double, maximum(cnt, 1));
+	frag->ja = Realloc(frag->ja, long, maximum(cnt, 1));
+
+	return frag;
+}
+
+/**
+ * @brief Check the rows that are parsed from the chunks of a data file
+ *
+ * @details
+ * If a row with an invalid format was found in one of the chunks, an error
+ * is printed for the first such row and the program exits.
+ *
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	n 		maximum number of rows to read
+ *
+ * @return 			number of rows read, at most n
+ */
+long gensvm_parse_check_rows(struct GenParseChunk *chunks, long n_chunks,
+		long n)
+{
+	long c;
+
+	for (c=0; c<n_chunks; c++) {
+		if (chunks[c].error_row >= 0) {
+			err("[GenSVM Error]: Wrong input format for instance "
+					"%li\n", chunks[c].error_row + 1);
+			exit(EXIT_FAILURE);
+		}
+	}
+	return minimum(n, chunks[n_chunks-1].row_start +
+			chunks[n_chunks-1].n_rows);
+}
+
+/**
+ * @brief Parse a floating point number
+ *
+ * @details
+ * Blanks before the number are skipped, but the number must be on the same
+ * line. Numbers with at most 19 significant digits that can be written as
+ * an integer below @f$2^{53}@f$ times a power of ten between @f$10^{-22}@f$
+ * and @f$10^{22}@f$ are computed with a single rounded multiplication or
+ * division, which is exact. Other numbers, such as those with more digits,
+ * hexadecimal numbers and infinities, are parsed with strtod(), so that all
+ * numbers are parsed to the same value as with strtod().
+ *
+ * @param[in,out] 	str 	position in the data, set to the end of the
+ * 				number if a number was parsed
+ * @param[in] 		end 	end of the data
+ * @param[out] 		value 	the parsed number
+ *
+ * @return 			whether a number was parsed
+ */
+bool gensvm_parse_double(const char **str, const char *end, double *value)
+{
+	int exp_sign = 1;
+	long exp10 = 0,
+	     exponent = 0,
+	     n_digits = 0;
+	bool negative = false,
+	     truncated = false,
+	     has_digits = false;
+	uint64_t mantissa = 0;
+	size_t len;
+	char buffer[GENSVM_PARSE_MAX_TOKEN],
+	     *endptr = NULL;
+	const char *p = *str,
+	      *token_start = NULL,
+	      *token_end = NULL;
+
+	while (p < end && gensvm_parse_is_blank(*p))
+		p++;
+	*str = p;
+	if (p == end || *p == '\n')
+		return false;
+
+	token_start = p;
+	token_end = p;
+	while (token_end < end && !gensvm_parse_is_space(*token_end))
+		token_end++;
+
+	if (*p == '-' || *p == '+')
+		negative = (*p++ == '-');
+	for (; p < token_end && isdigit((unsigned char) *p); p++) {
+		has_digits = true;
+		if (mantissa == 0 && *p == '0')
+			continue;
+		if (n_digits < 19) {
+			mantissa = 10*mantissa + (*p - '0');
+			n_digits++;
+		} else {
+			exp10++;
+			truncated = truncated || *p != '0';
+		}
+	}
+	if (p < token_end && *p == '.') {
+		for (p++; p < token_end && isdigit((unsigned char) *p); p++) {
+			has_digits = true;
+			if (mantissa == 0 && *p == '0') {
+				exp10--;
+				continue;
+			}
+			if (n_digits < 19) {
+				mantissa = 10*mantissa + (*p - '0');
+				n_digits++;
+				exp10--;
+			} else {
+				truncated = truncated || *p != '0';
+			}
+		}
+	}
+	if (has_digits && p < token_end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (p < token_end && (*p == '-' || *p == '+'))
+			exp_sign = (*p++ == '-') ? -1 : 1;
+		if (p == token_end || !isdigit((unsigned char) *p))
+			has_digits = false;
+		for (; p < token_end && isdigit((unsigned char) *p); p++)
+			if (exponent < 100000)
+				exponent = 10*exponent + (*p - '0');
+		exp10 += exp_sign * exponent;
+	}
+
+	if (has_digits && p == token_end && !truncated &&
+			mantissa <= (1ULL << 53) && (mantissa == 0 ||
+				labs(exp10) <= 22)) {
+		if (mantissa == 0)
+			*value = 0.0;
+		else if (exp10 >= 0)
+			*value = ((double) mantissa) * GENSVM_PARSE_POW10[exp10];
+		else
+			*value = ((double) mantissa) /
+				GENSVM_PARSE_POW10[-exp10];
+		if (negative)
+			*value = -(*value);
+		*str = token_end;
+		return true;
+	}
+
+	// not exact with double precision arithmetic, use strtod()
+	len = token_end - token_start;
+	if (len >= GENSVM_PARSE_MAX_TOKEN)
+		return false;
+	memcpy(buffer, token_start, len);
+	buffer[len] = '\0';
+	*value = strtod(buffer, &endptr);
+	if (endptr != buffer + len)
+		return false;
+	*str = token_end;
+	return true;
+}
+
+/**
+ * @brief Parse an integer
+ *
+ * @details
+ * All white space before the integer is skipped, including newlines. This
+ * is used for the numbers in the header of a data file and the feature
+ * indices of LibSVM files. An integer that doesn't fit in a long is
+ * rejected, as strtol() would.
+ *
+ * @param[in,out] 	str 	position in the data, set to the end of the
+ * 				integer if an integer was parsed
+ * @param[in] 		end 	end of the data
+ * @param[out] 		value 	the parsed integer
+ *
+ * @return 			whether an integer was parsed
+ */
+bool gensvm_parse_long(const char **str, const char *end, long *value)
+{
+	int digit;
+	bool negative = false;
+	long result = 0;
+	const char *p = *str;
+
+	while (p < end && gensvm_parse_is_space(*p))
+		p++;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = (*p++ == '-');
+	if (p == end || !isdigit((unsigned char) *p))
+		return false;
+	for (; p < end && isdigit((unsigned char) *p); p++) {
+		digit = *p - '0';
+		if (result > (LONG_MAX - digit)/10)
+			return false;
+		result = 10*result + digit;
+	}
+	if (p < end && !gensvm_parse_is_space(*p))
+		return false;
+
+	*value = negative ? -result : result;
+	*str = p;
+	return true;
+}
+
+/**
+ * @brief Parse the numbers on a line
+ *
+ * @details
+ * Numbers are parsed with gensvm_parse_double() until max_values numbers
+ * are parsed, or until the end of the line or a token that isn't a number
+ * is reached. Use gensvm_parse_line_end() to check that the whole line is
+ * parsed.
+ *
+ * @param[in,out] 	str 		position in the data, set to the end of
+ * 					the last parsed number
+ * @param[in] 		end 		end of the data
+ * @param[out] 		values 		array for the parsed numbers
+ * @param[in] 		max_values 	maximum number of numbers to parse
+ *
+ * @return 				number of parsed numbers
+ */
+long gensvm_parse_values(const char **str, const char *end, double *values,
+		long max_values)
+{
+	long n_values = 0;
+
+	while (n_values < max_values &&
+			gensvm_parse_double(str, end, &values[n_values]))
+		n_values++;
+	return n_values;
+}
+
+/**
+ * @brief Check if only blanks are left on a line
+ *
+ * @param[in] 	str 	position in the data
+ * @param[in] 	end 	end of the data
+ *
+ * @return 		whether the rest of the line is blank
+ */
+bool gensvm_parse_line_end(const char *str, const char *end)
+{
+	while (str < end && gensvm_parse_is_blank(*str))
+		str++;
+	return str == end || *str == '\n';
+}
+
+/**
+ * @brief Find the start of the next line
+ *
+ * @param[in] 	str 	position in the data
+ * @param[in] 	end 	end of the data
+ *
+ * @return 		start of the line after the line of str, or end if
+ * 			this is the last line
+ */
+const char *gensvm_parse_next_line(const char *str, const char *end)
+{
+	const char *newline = NULL;
+
+	if (str >= end)
+		return end;
+	newline = memchr(str, '\n', end - str);
+	return (newline == NULL) ? end : newline + 1;
+}
+
+/**
+ * @brief Parse a data file in LibSVM format in parallel
+ *
+ * @details
+ * Every chunk is parsed by a single thread with
+ * gensvm_parse_libsvm_chunk() into a CSR fragment, so that the file is
+ * parsed in a single pass without knowing the number of features in
+ * advance. The fragments can be combined into a dense matrix or a GenSparse
+ * structure with gensvm_parse_stitch_dense() or
+ * gensvm_parse_stitch_sparse(). A row with an invalid format results in an
+ * error.
+ *
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	end 		end of the data
+ * @param[out] 	y 		array for the labels of all rows
+ * @param[out] 	n_labels 	number of rows with a label
+ * @param[out] 	min_index 	smallest feature index in the file
+ * @param[out] 	max_index 	largest feature index in the file
+ * @param[out] 	nnz 		number of index:value pairs in the file
+ *
+ * @return 			array of n_chunks fragments
+ */
+struct GenSparse **gensvm_parse_libsvm(struct GenParseChunk *chunks,
+		long n_chunks, const char *end, long *y, long *n_labels,
+		long *min_index, long *max_index, long *nnz)
+{
+	long c, labels = 0,
+	     pairs = 0,
+	     min_idx = LONG_MAX,
+	     max_idx = -1,
+	     *chunk_min = Malloc(long, n_chunks),
+	     *chunk_max = Malloc(long, n_chunks),
+	     *chunk_labels = Malloc(long, n_chunks);
+	struct GenSparse **fragments = Malloc(struct GenSparse *, n_chunks);
+
+	#pragma omp parallel for schedule(dynamic)
+	for (c=0; c<n_chunks; c++)
+		fragments[c] = gensvm_parse_libsvm_chunk(&chunks[c], end, y,
+				&chunk_labels[c], &chunk_min[c],
+				&chunk_max[c]);
+
+	for (c=0; c<n_chunks; c++) {
+		if (chunks[c].error_row >= 0) {
+			err("[GenSVM Error]: Wrong input format on line: "
+					"%li\n", chunks[c].error_row + 1);
+			exit(EXIT_FAILURE);
+		}
+		labels += chunk_labels[c];
+		pairs += fragments[c]->nnz;
+		min_idx = minimum(min_idx, chunk_min[c]);
+		max_idx = maximum(max_idx, chunk_max[c]);
+	}
+
+	*n_labels = labels;
+	*min_index = min_idx;
+	*max_index = max_idx;
+	*nnz = pairs;
+
+	free(chunk_min);
+	free(chunk_max);
+	free(chunk_labels);
+
+	return fragments;
+}
+
+/**
+ * @brief Parse a chunk of a data file in LibSVM format
+ *
+ * @details
+ * The rows of the chunk are tokenized in place. The first token of a row is
+ * the label if it doesn't contain a colon, other tokens without a colon are
+ * ignored. The index:value pairs are stored in a CSR fragment with
+ * GenSparse::n_row equal to the number of rows of the chunk, without the
+ * column of ones and with the indices as they are in the file. The arrays
+ * of the fragment grow geometrically and are shrunk to fit at the end, so
+ * there is no allocation for every token and no limit on the length of a
+ * line. If a row has an invalid
+ * format, GenParseChunk::error_row is set.
+ *
+ * @param[in,out] 	chunk 		a chunk of gensvm_parse_chunks()
+ * @param[in] 		end 		end of the data
+ * @param[out] 		y 		array for the labels of all rows
+ * @param[out] 		n_labels 	number of rows with a label
+ * @param[out] 		min_index 	smallest feature index in the chunk
+ * @param[out] 		max_index 	largest feature index in the chunk
+ *
+ * @return 				CSR fragment of the chunk
+ */
+struct GenSparse *gensvm_parse_libsvm_chunk(struct GenParseChunk *chunk,
+		const char *end, long *y, long *n_labels, long *min_index,
+		long *max_index)
+{
+	bool first;
+	long r = 0,
+	     index,
+	     label,
+	     cnt = 0,
+	     size = (chunk->end - chunk->start)/16 + 16;
+	double value;
+	const char *str = chunk->start,
+	      *p = NULL,
+	      *colon = NULL,
+	      *token_end = NULL;
+	struct GenSparse *frag = gensvm_init_sparse();
+
+	frag->n_row = chunk->n_rows;
+	frag->ia = Malloc(long, chunk->n_rows+1);
+	frag->values = Malloc(double, size);
+	frag->ja = Malloc(long, size);
+	frag->ia[0] = 0;
+
+	*n_labels = 0;
+	*min_index = LONG_MAX;
+	*max_index = -1;
+
+	while (str < chunk->end && r < chunk->n_rows) {
+		first = true;
+		while (true) {
+			while (str < end && gensvm_parse_is_blank(*str))
+				str++;
+			if (str == end || *str == '\n')
+				break;
+
+			token_end = str;
+			while (token_end < end &&
+					!gensvm_parse_is_space(*token_end))
+				token_end++;
+			colon = memchr(str, ':', token_end - str);
+
+			if (colon == NULL) {
+				// the label, or a token that is ignored
+				p = str;
+				if (first && (!gensvm_parse_long(&p, token_end,
+							&label) ||
+							p != token_end)) {
+					chunk->error_row = chunk->row_start + r;
+					return frag;
+				}
+				if (first) {
+					y[chunk->row_start + r] = label;
+					(*n_labels)++;
+				}
+				first = false;
+				str = token_end;
+				continue;
+			}
+			first = false;
+
+			p = str;
+			if (!gensvm_parse_long(&p, colon, &index) ||
+					p != colon || index < 0) {
+				chunk->error_row = chunk->row_start + r;
+				return frag;
+			}
+			p = colon + 1;
+			if (!gensvm_parse_double(&p, token_end, &value) ||
+					p != token_end) {
+				chunk->error_row = chunk->row_start + r;
+				return frag;
+			}
+
+			if (cnt == size) {
+				size *= 2;
+				frag->values = Realloc(frag->values, double,
+						size);
+				frag->ja = Realloc(frag->ja, long, size);
+			}
+			frag->values[cnt] = value;
+			frag->ja[cnt] = index;
+			cnt++;
+			*min_index = minimum(*min_index, index);
+			*max_index = maximum(*max_index, index);
+			str = token_end;
+		}
+		str = gensvm_parse_next_line(str, end);
+
+		// blank lines are not rows
+		if (first)
+			continue;
+		frag->ia[++r] = cnt;
+	}
+	frag->nnz = cnt;
+	frag->values = Realloc(frag->values, double, maximum(cnt, 1));
+	frag->ja = Realloc(frag->ja, long, maximum(cnt, 1));
+
+	return frag;
+}
+
+/**
+ * @brief Combine the CSR fragments of a LibSVM file into a GenSparse
+ *
+ * @details
+ * The fragments of gensvm_parse_libsvm() are copied in parallel into a
+ * GenSparse structure with n rows and m+1 columns, where every row starts
+ * with a one in column 0 and the feature indices are increased by shift.
+ * The fragments are freed.
+ *
+ * @param[in] 	fragments 	fragments of gensvm_parse_libsvm()
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	n 		number of rows
+ * @param[in] 	m 		number of features
+ * @param[in] 	shift 		number to add to the feature indices
+ *
+ * @return 			GenSparse structure of the data
+ */
+struct GenSparse *gensvm_parse_stitch_sparse(struct GenSparse **fragments,
+		struct GenParseChunk *chunks, long n_chunks, long n, long m,
+		long shift)
+{
+	long c, r, k, pos,
+	     *offset = Malloc(long, n_chunks+1);
+	struct GenSparse *frag = NULL,
+			 *spZ = gensvm_init_sparse();
+
+	offset[0] = 0;
+	for (c=0; c<n_chunks; c++)
+		offset[c+1] = offset[c] + fragments[c]->nnz +
+			fragments[c]->n_row;
+
+	spZ->nnz = offset[n_chunks];
+	spZ->n_row = n;
+	spZ->n_col = m+1;
+	spZ->values = Malloc(double, spZ->nnz);
+	spZ->ja = Malloc(long, spZ->nnz);
+	spZ->ia = Malloc(long, n+1);
+	spZ->ia[0] = 0;
+
+	#pragma omp parallel for schedule(dynamic) private(r, k, pos, frag)
+	for (c=0; c<n_chunks; c++) {
+		frag = fragments[c];
+		pos = offset[c];
+		for (r=0; r<frag->n_row; r++) {
+			spZ->values[pos] = 1.0;
+			spZ->ja[pos++] = 0;
+			for (k=frag->ia[r]; k<frag->ia[r+1]; k++) {
+				spZ->values[pos] = frag->values[k];
+				spZ->ja[pos++] = frag->ja[k] + shift;
+			}
+			spZ->ia[chunks[c].row_start + r + 1] = pos;
+		}
+		gensvm_free_sparse(frag);
+	}
+	free(offset);
+	free(fragments);
+
+	return spZ;
+}
+
+/**
+ * @brief Combine the CSR fragments of a LibSVM file into a dense matrix
+ *
+ * @details
+ * The fragments of gensvm_parse_libsvm() are written in parallel into the
+ * rows of RAW, which has a one in the first column. The feature indices are
+ * increased by shift. The fragments are freed.
+ *
+ * @param[in] 	fragments 	fragments of gensvm_parse_libsvm()
+ * @param[in] 	chunks 		chunks of gensvm_parse_chunks()
+ * @param[in] 	n_chunks 	number of chunks
+ * @param[in] 	m 		number of features
+ * @param[in] 	shift 		number to add to the feature indices
+ * @param[out] 	RAW 		allocated and zeroed n x (m+1) matrix
+ */
+void gensvm_parse_stitch_dense(struct GenSparse **fragments,
+		struct GenParseChunk *chunks, long n_chunks, long m,
+		long shift, double *RAW)
+{
+	long c, r, k, i;
+	struct GenSparse *frag = NULL;
+
+	#pragma omp parallel for schedule(dynamic) private(r, k, i, frag)
+	for (c=0; c<n_chunks; c++) {
+		frag = fragments[c];
+		for (r=0; r<frag->n_row; r++) {
+			i = chunks[c].row_start + r;
+			matrix_set(RAW, m+1, i, 0, 1.0);
+			for (k=frag->ia[r]; k<frag->ia[r+1]; k++)
+				matrix_set(RAW, m+1, i, frag->ja[k] + shift,
+						frag->values[k]);
+		}
+		gensvm_free_sparse(frag);
+	}
+	free(fragments);
+}
+
+/**
+ * @brief Hash a feature index into a space of 2^hash_bits columns
+ *
+ * @details
+ * This is the hashing trick for LibSVM files with a very large index space,
+ * such as hashed n-grams. The index is mixed with the finalizer of
+ * MurmurHash3, and the lowest hash_bits bits of the result give the column.
+ * If hash_signed is true, the highest bit gives the sign of the feature,
+ * such that collisions cancel out on average. Since the hash only depends
+ * on the index, training and test data are hashed in the same way.
+ *
+ * @param[in] 	index 		feature index in the file
+ * @param[in] 	hash_bits 	number of bits of the hashed space
+ * @param[in] 	hash_signed 	whether the features get a random sign
+ * @param[out] 	sign 		the sign of the feature, 1.0 or -1.0
+ *
+ * @return 			the column of the feature, between 1 and
+ * 				2^hash_bits
+ */
+long gensvm_parse_hash(long index, long hash_bits, bool hash_signed,
+		double *sign)
+{
+	uint64_t h = (uint64_t) index;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	*sign = (hash_signed && (h >> 63)) ? -1.0 : 1.0;
+	return (long) (h & ((1ULL << hash_bits) - 1)) + 1;
+}
+
+/**
+ * @brief Hash the feature indices of a row in place
+ *
+ * @details
+ * The indices of the row are replaced by their hashed columns with
+ * gensvm_parse_hash(), and the values by their signed values. Features
+ * that are hashed into the same column are added, such that every column
+ * occurs at most once in the row, and the row is sorted by column with
+ * gensvm_parse_sort_row(), as gensvm_get_ZAZ_ZB_sparse() expects.
+ *
+ * @param[in,out] 	ja 		feature indices of the row
+ * @param[in,out] 	values 		values of the row
+ * @param[in] 		nnz 		number of features in the row
+ * @param[in] 		hash_bits 	number of bits of the hashed space
+ * @param[in] 		hash_signed 	whether the features get a random
+ * 					sign
+ * @param[in,out] 	marker 		array of 2^hash_bits + 1 elements that
+ * 					are -1, which are -1 again on exit
+ *
+ * @return 				number of features of the hashed row
+ */
+long gensvm_parse_hash_row(long *ja, double *values, long nnz,
+		long hash_bits, bool hash_signed, long *marker)
+{
+	long k, col,
+	     cnt = 0;
+	double sign;
+
+	for (k=0; k<nnz; k++) {
+		col = gensvm_parse_hash(ja[k], hash_bits, hash_signed, &sign);
+		if (marker[col] >= 0) {
+			values[marker[col]] += sign * values[k];
+			continue;
+		}
+		marker[col] = cnt;
+		ja[cnt] = col;
+		values[cnt++] = sign * values[k];
+	}
+	for (k=0; k<cnt; k++)
+		marker[ja[k]] = -1;
+	gensvm_parse_sort_row(ja, values, cnt);
+
+	return cnt;
+}
+
+/**
+ * @brief Sort the features of a row by column
+ *
+ * @details
+ * The column indices and the values are sorted together in place with
+ * heapsort, which needs no extra memory and is fast for long rows. If
+ * values is NULL only the column indices are sorted.
+ *
+ * @param[in,out] 	ja 	column indices of the row
+ * @param[in,out] 	values 	values of the row, or NULL
+ * @param[in] 		nnz 	number of features in the row
+ */
+void gensvm_parse_sort_row(long *ja, double *values, long nnz)
+{
+	long i, end, root, child, tmp_j;
+	double tmp_v;
+
+	for (i=nnz/2-1, end=nnz; end > 1; ) {
+		if (i >= 0) {
+			// build the heap
+			root = i--;
+		} else {
+			// move the largest column to the end
+			end--;
+			tmp_j = ja[0];
+			ja[0] = ja[end];
+			ja[end] = tmp_j;
+			if (values != NULL) {
+				tmp_v = values[0];
+				values[0] = values[end];
+				values[end] = tmp_v;
+			}
+			root = 0;
+		}
+		// sift the root down
+		while ((child = 2*root + 1) < end) {
+			if (child + 1 < end && ja[child+1] > ja[child])
+				child++;
+			if (ja[root] >= ja[child])
+				break;
+			tmp_j = ja[root];
+			ja[root] = ja[child];
+			ja[child] = tmp_j;
+			if (values != NULL) {
+				tmp_v = values[root];
+				values[root] = values[child];
+				values[child] = tmp_v;
+			}
+			root = child;
+		}
+	}
+}
+
+/**
+ * @brief Hash the feature indices of the CSR fragments of a LibSVM file
+ *
+ * @details
+ * The rows of the fragments of gensvm_parse_libsvm() are hashed in place
+ * with gensvm_parse_hash_row(), in parallel. Afterwards the fragments hold
+ * 1-based columns of at most 2^hash_bits features, and can be combined
+ * with gensvm_parse_stitch_sparse() or gensvm_parse_stitch_dense() without
+ * a shift.
+ *
+ * @param[in,out] 	fragments 	fragments of gensvm_parse_libsvm()
+ * @param[in] 		n_chunks 	number of fragments
+ * @param[in] 		hash_bits 	number of bits of the hashed space
+ * @param[in] 		hash_signed 	whether the features get a random
+ * 					sign
+ */
+void gensvm_parse_hash_fragments(struct GenSparse **fragments,
+		long n_chunks, long hash_bits, bool hash_signed)
+{
+	long c, r, k, start, row_nnz,
+	     *marker = NULL;
+	struct GenSparse *frag = NULL;
+
+	#pragma omp parallel for schedule(dynamic) private(r, k, start, \
+		row_nnz, marker, frag)
+	for (c=0; c<n_chunks; c++) {
+		frag = fragments[c];
+		marker = Malloc(long, (1L << hash_bits) + 1);
+		for (k=0; k<(1L << hash_bits) + 1; k++)
+			marker[k] = -1;
+
+		start = 0;
+		for (r=0; r<frag->n_row; r++) {
+			row_nnz = frag->ia[r+1] - frag->ia[r];
+			memmove(frag->ja + start, frag->ja + frag->ia[r],
+					row_nnz*sizeof(long));
+			memmove(frag->values + start,
+					frag->values + frag->ia[r],
+					row_nnz*sizeof(double));
+			frag->ia[r] = start;
+			start += gensvm_parse_hash_row(frag->ja + start,
+					frag->values + start, row_nnz,
+					hash_bits, hash_signed, marker);
+		}
+		frag->ia[frag->n_row] = start;
+		frag->nnz = start;
+		free(marker);
+	}
+}
+
+/**
+ * @brief Sort an array of column indices and remove the duplicates
+ *
+ * @param[in,out] 	ja 	column indices, the first elements are the
+ * 				sorted unique indices on exit
+ * @param[in] 		nnz 	number of column indices
+ *
+ * @return 			number of unique column indices
+ */
+long gensvm_parse_unique(long *ja, long nnz)
+{
+	long k,
+	     cnt = 0;
+
+	gensvm_parse_sort_row(ja, NULL, nnz);
+	for (k=0; k<nnz; k++) {
+		if (cnt > 0 && ja[cnt-1] == ja[k])
+			continue;
+		ja[cnt++] = ja[k];
+	}
+	return cnt;
+}
+
+/**
+ * @brief Find the columns that are used in the CSR fragments of a LibSVM file
+ *
+ * @details
+ * The columns of every fragment are sorted and made unique in parallel, and
+ * the columns of all fragments are merged into the column map, which holds
+ * every 1-based column of the file that has a feature exactly once, in
+ * increasing order. With gensvm_parse_map_fragments() the columns are then
+ * renumbered to 1..n_columns, such that the number of features of the data
+ * is the number of columns that is actually used, rather than the largest
+ * index in the file. This is useful for files with a huge, sparsely used
+ * index space.
+ *
+ * @param[in] 	fragments 	fragments of gensvm_parse_libsvm()
+ * @param[in] 	n_chunks 	number of fragments
+ * @param[in] 	shift 		shift of the feature indices to 1-based
+ * 				columns (1 for a file with 0-based indexing)
+ * @param[out] 	n_columns 	number of columns in the map
+ *
+ * @return 			the column map
+ */
+long *gensvm_parse_column_map(struct GenSparse **fragments, long n_chunks,
+		long shift, long *n_columns)
+{
+	long c, k,
+	     total = 0,
+	     *counts = Malloc(long, n_chunks),
+	     **columns = Malloc(long *, n_chunks),
+	     *col_map = NULL;
+
+	#pragma omp parallel for schedule(dynamic) private(k)
+	for (c=0; c<n_chunks; c++) {
+		columns[c] = Malloc(long, fragments[c]->nnz + 1);
+		for (k=0; k<fragments[c]->nnz; k++)
+			columns[c][k] = fragments[c]->ja[k] + shift;
+		counts[c] = gensvm_parse_unique(columns[c],
+				fragments[c]->nnz);
+	}
+
+	for (c=0; c<n_chunks; c++)
+		total += counts[c];
+	col_map = Malloc(long, total + 1);
+	for (c=0, total=0; c<n_chunks; c++) {
+		memcpy(col_map + total, columns[c], counts[c]*sizeof(long));
+		total += counts[c];
+		free(columns[c]);
+	}
+	*n_columns = gensvm_parse_unique(col_map, total);
+
+	free(columns);
+	free(counts);
+
+	return col_map;
+}
+
+/**
+ * @brief Find the compacted column of a column with binary search
+ *
+ * @param[in] 	col 		1-based column of the file
+ * @param[in] 	col_map 	column map of gensvm_parse_column_map()
+ * @param[in] 	n_columns 	number of columns in the map
+ *
+ * @return 			the 1-based compacted column, or 0 if the
+ * 				column is not in the map
+ */
+long gensvm_parse_map_column(long col, long *col_map, long n_columns)
+{
+	long mid,
+	     low = 0,
+	     high = n_columns;
+
+	while (low < high) {
+		mid = low + (high - low)/2;
+		if (col_map[mid] < col)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return (low < n_columns && col_map[low] == col) ? low + 1 : 0;
+}
+
+/**
+ * @brief Renumber the columns of a row in place with a column map
+ *
+ * @details
+ * The columns of the row are replaced by their compacted columns with
+ * gensvm_parse_map_column(). Features in columns that are not in the map
+ * are removed, since the model has no weights for them. The map is
+ * increasing, so a sorted row stays sorted.
+ *
+ * @param[in,out] 	ja 		feature indices of the row
+ * @param[in,out] 	values 		values of the row
+ * @param[in] 		nnz 		number of features in the row
+ * @param[in] 		shift 		shift of the feature indices to 1-based
+ * 					columns
+ * @param[in] 		col_map 	column map of
+ * 					gensvm_parse_column_map()
+ * @param[in] 		n_columns 	number of columns in the map
+ *
+ * @return 				number of features of the mapped row
+ */
+long gensvm_parse_map_row(long *ja, double *values, long nnz, long shift,
+		long *col_map, long n_columns)
+{
+	long k, col,
+	     cnt = 0;
+
+	for (k=0; k<nnz; k++) {
+		col = gensvm_parse_map_column(ja[k] + shift, col_map,
+				n_columns);
+		if (col == 0)
+			continue;
+		ja[cnt] = col;
+		values[cnt++] = values[k];
+	}
+	return cnt;
+}
+
+/**
+ * @brief Renumber the columns of the CSR fragments of a LibSVM file
+ *
+ * @details
+ * The rows of the fragments of gensvm_parse_libsvm() are mapped in place
+ * with gensvm_parse_map_row(), in parallel. Afterwards the fragments hold
+ * 1-based columns of at most n_columns features, and can be combined with
+ * gensvm_parse_stitch_sparse() or gensvm_parse_stitch_dense() without a
+ * shift.
+ *
+ * @param[in,out] 	fragments 	fragments of gensvm_parse_libsvm()
+ * @param[in] 		n_chunks 	number of fragments
+ * @param[in] 		shift 		shift of the feature indices to 1-based
+ * 					columns
+ * @param[in] 		col_map 	column map of
+ * 					gensvm_parse_column_map()
+ * @param[in] 		n_columns 	number of columns in the map
+ */
+void gensvm_parse_map_fragments(struct GenSparse **fragments, long n_chunks,
+		long shift, long *col_map, long n_columns)
+{
+	long c, r, start, row_nnz;
+	struct GenSparse *frag = NULL;
+
+	#pragma omp parallel for schedule(dynamic) private(r, start, row_nnz, \
+		frag)
+	for (c=0; c<n_chunks; c++) {
+		frag = fragments[c];
+		start = 0;
+		for (r=0; r<frag->n_row; r++) {
+			row_nnz = frag->ia[r+1] - frag->ia[r];
+			memmove(frag->ja + start, frag->ja + frag->ia[r],
+					row_nnz*sizeof(long));
+			memmove(frag->values + start,
+					frag->values + frag->ia[r],
+					row_nnz*sizeof(double));
+			frag->ia[r] = start;
+			start += gensvm_parse_map_row(frag->ja + start,
+					frag->values + start, row_nnz, shift,
+					col_map, n_columns);
+		}
+		frag->ia[frag->n_row] = start;
+		frag->nnz = start;
+	}
+}
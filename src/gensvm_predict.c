@@ -31,6 +31,13 @@
 
 #include "gensvm_predict.h"
 
+/**
+ * Number of instances in a single block of rows in gensvm_predict_scores().
+ */
+#ifndef GENSVM_PREDICT_BLOCK_SIZE
+  #define GENSVM_PREDICT_BLOCK_SIZE 256
+#endif
+
 /**
  * @brief Predict class labels of data given and output in predy
  *
@@ -39,7 +46,7 @@
  * simplex space using the matrix V in the given model. Next, for each
  * instance the nearest simplex vertex is determined using an Euclidean
  * norm. The nearest simplex vertex determines the predicted class label,
- * which is recorded in predy.
+ * which is recorded in predy. See gensvm_predict_scores() for details.
  *
  * @param[in] 	testdata 	GenData to predict labels for
  * @param[in] 	model 		GenModel with optimized V
@@ -48,45 +55,128 @@
 void gensvm_predict_labels(struct GenData *testdata, struct GenModel *model,
 		long *predy)
 {
-	long i, j, k, n, K, label;
-	double norm, min_dist,
-	       *S = NULL,
-	       *ZV = NULL;
-
-	n = testdata->n;
-	K = model->K;
+	gensvm_predict_scores(testdata, model, predy, NULL);
+}
 
-	// allocate necessary memory
-	S = Calloc(double, K-1);
-	ZV = Calloc(double, n*(K-1));
+/**
+ * @brief Predict class labels and class scores of the given data
+ *
+ * @details
+ * All vertices of the simplex have the same norm, so the vertex nearest to 
+ * the simplex space vector @f$\textbf{z}'\textbf{V}@f$ of an instance is 
+ * the vertex @f$\textbf{u}_k@f$ for which the score @f$\textbf{z}' 
+ * \textbf{V} \textbf{u}_k@f$ is largest. The scores of all classes are 
+ * therefore computed with a single matrix product 
+ * @f$\textbf{Z}\textbf{V}\textbf{U}'@f$, and the predicted label is the 
+ * class with the largest score.
+ *
+ * The instances are processed in blocks of GENSVM_PREDICT_BLOCK_SIZE rows, 
+ * which are divided over threads with OpenMP. For each block the simplex 
+ * space vectors are computed with gensvm_calculate_ZV_block() (or with 
+ * gensvm_kernel_calculate_ZV_block() for a nonlinear model with the 
+ * collapsed coefficients in GenModel::W, in which case the test data does 
+ * not need to be postprocessed), and the scores with one call to 
+ * cblas_dgemm(). Each thread uses buffers for a single block, so the memory 
+ * needed does not grow with the number of instances. Wrapped test data (see 
+ * gensvm_wrap_dense()) is copied with gensvm_unwrap_data() for a nonlinear 
+ * model.
+ *
+ * @param[in] 	testdata 	GenData to predict labels for
+ * @param[in] 	model 		GenModel with optimized V
+ * @param[out] 	predy 		pre-allocated vector to record predictions in
+ * @param[out] 	scores 		pre-allocated matrix of size n x K for the
+ * 				scores of each class, or NULL if the scores 
+ * 				are not needed
+ */
+void gensvm_predict_scores(struct GenData *testdata, struct GenModel *model,
+		long *predy, double *scores)
+{
+	long b, i, start, rows,
+	     n = testdata->n,
+	     K = model->K,
+	     n_blocks = (n + GENSVM_PREDICT_BLOCK_SIZE - 1) /
+		     GENSVM_PREDICT_BLOCK_SIZE;
+	bool kernel_block = (model->W != NULL &&
+			model->kerneltype != K_PRECOMPUTED);
+	double *ZV = NULL,
+	       *S = NULL,
+	       *S_block = NULL,
+	       *K2 = NULL;
 
 	// Generate the simplex matrix
 	gensvm_simplex(model);
 
-	// Generate the simplex space vectors
-	gensvm_calculate_ZV(model, testdata, ZV);
-
-	// Calculate the distance to each of the vertices of the simplex.
-	// The closest vertex defines the class label
-	for (i=0; i<n; i++) {
-		label = 0;
-		min_dist = INFINITY;
-		for (j=0; j<K; j++) {
-			for (k=0; k<K-1; k++) {
-				S[k] = matrix_get(ZV, K-1, i, k) -
-					matrix_get(model->U, K-1, j, k);
-			}
-			norm = cblas_dnrm2(K-1, S, 1);
-			if (norm < min_dist) {
-				label = j+1;
-				min_dist = norm;
-			}
+	// the kernels need the augmented data matrix
+	if (model->kerneltype != K_LINEAR)
+		gensvm_unwrap_data(testdata);
+
+	#pragma omp parallel private(b, i, start, rows, ZV, S, S_block, K2)
+	{
+		ZV = Malloc(double, GENSVM_PREDICT_BLOCK_SIZE*(K-1));
+		S = NULL;
+		if (scores == NULL)
+			S = Malloc(double, GENSVM_PREDICT_BLOCK_SIZE*K);
+		K2 = NULL;
+		if (kernel_block)
+			K2 = Malloc(double,
+				GENSVM_PREDICT_BLOCK_SIZE*model->basis->n);
+
+		#pragma omp for schedule(dynamic)
+		for (b=0; b<n_blocks; b++) {
+			start = b * GENSVM_PREDICT_BLOCK_SIZE;
+			rows = minimum(GENSVM_PREDICT_BLOCK_SIZE, n - start);
+
+			// Generate the simplex space vectors of this block
+			if (model->W != NULL)
+				gensvm_kernel_calculate_ZV_block(model,
+						testdata, start, rows, K2, ZV);
+			else
+				gensvm_calculate_ZV_block(model, testdata,
+						start, rows, ZV);
+
+			// Compute the scores ZV * U'
+			S_block = (scores == NULL) ? S : scores + start*K;
+			cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans,
+					rows, K, K-1, 1.0, ZV, K-1, model->U,
+					K-1, 0.0, S_block, K);
+
+			// The class with the largest score defines the label
+			for (i=0; i<rows; i++)
+				predy[start+i] = gensvm_predict_argmax(
+						&S_block[i*K], K) + 1;
 		}
-		predy[i] = label;
+
+		free(ZV);
+		free(S);
+		free(K2);
 	}
+}
+
+/**
+ * @brief Find the index of the largest element of a vector
+ *
+ * @details
+ * The maximum is first found with a SIMD reduction, after which the first 
+ * element equal to the maximum is located. If no such element exists, for 
+ * instance because all elements are NaN, -1 is returned.
+ *
+ * @param[in] 	x 	vector
+ * @param[in] 	n 	length of the vector
+ * @returns 		index of the first largest element of x, or -1
+ */
+long gensvm_predict_argmax(double *x, long n)
+{
+	long j;
+	double max_value = -INFINITY;
+
+	#pragma omp simd reduction(max:max_value)
+	for (j=0; j<n; j++)
+		max_value = maximum(max_value, x[j]);
 
-	free(ZV);
-	free(S);
+	for (j=0; j<n; j++)
+		if (x[j] == max_value)
+			return j;
+	return -1;
 }
 
 /**
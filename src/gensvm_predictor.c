@@ -0,0 +1,385 @@
+/**
+ * @file gensvm_predictor.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for predicting the class label of a single instance
+ *
+ * @details
+ * The functions in gensvm_predict.c predict the labels of all instances in 
+ * a GenData structure at once. For online prediction, where instances arrive 
+ * one at a time, constructing a GenData structure and allocating the work 
+ * space for every instance is too costly. This file contains a GenPredictor 
+ * structure which is prepared once for a trained model, after which single 
+ * instances can be classified without any memory allocation.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_predictor.h"
+#include "gensvm_print.h"
+
+/**
+ * @brief Initialize a GenPredictor for a trained model
+ *
+ * @details
+ * This generates the simplex matrix of the model if necessary, and allocates 
+ * the work space needed for prediction. For a nonlinear model the basis and 
+ * the collapsed coefficients must be available in GenModel::basis and 
+ * GenModel::W (see gensvm_kernel_store_basis() and gensvm_read_model()), and 
+ * the squared norms of the basis instances are computed. The model is not 
+ * copied, so it should not be changed or freed while the predictor is used.
+ *
+ * @param[in] 	model 	a trained GenModel
+ * @returns 		an initialized GenPredictor
+ */
+struct GenPredictor *gensvm_predictor_init(struct GenModel *model)
+{
+	long i, m;
+	struct GenData *basis = model->basis;
+	struct GenPredictor *pred = NULL;
+
+	if (model->kerneltype != K_LINEAR &&
+			(basis == NULL || model->W == NULL)) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: No basis available for prediction with "
+				"a nonlinear model.\n");
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	if (model->U == NULL)
+		model->U = Calloc(double, model->K*(model->K-1));
+	gensvm_simplex(model);
+
+	pred = Malloc(struct GenPredictor, 1);
+	pred->model = model;
+	pred->K = model->K;
+	pred->m = model->m;
+	pred->n_basis = 0;
+	pred->norms = NULL;
+	pred->k = NULL;
+
+	if (model->kerneltype != K_LINEAR) {
+		pred->n_basis = basis->n;
+		pred->m = (model->kerneltype == K_PRECOMPUTED) ? basis->n :
+			basis->m;
+		pred->k = Calloc(double, basis->n);
+	}
+
+	if (model->kerneltype != K_LINEAR &&
+			model->kerneltype != K_PRECOMPUTED) {
+		m = basis->m;
+		pred->norms = Calloc(double, basis->n);
+		if (basis->RAW != NULL) {
+			for (i=0; i<basis->n; i++)
+				pred->norms[i] = cblas_ddot(m,
+						&basis->RAW[i*(m+1)+1], 1,
+						&basis->RAW[i*(m+1)+1], 1);
+		} else {
+			gensvm_kernel_sparse_norms(basis->spZ, pred->norms);
+		}
+	}
+
+	pred->w = Calloc(double, pred->m+1);
+	pred->zv = Calloc(double, pred->K-1);
+	pred->scores = Calloc(double, pred->K);
+
+	return pred;
+}
+
+/**
+ * @brief Free a GenPredictor
+ *
+ * @details
+ * This frees the work space of the predictor and the structure itself. The 
+ * model that the predictor was created for is not freed.
+ *
+ * @param[in] 	pred 	the GenPredictor to free
+ */
+void gensvm_predictor_free(struct GenPredictor *pred)
+{
+	if (pred == NULL)
+		return;
+
+	free(pred->norms);
+	free(pred->w);
+	free(pred->k);
+	free(pred->zv);
+	free(pred->scores);
+	free(pred);
+}
+
+/**
+ * @brief Predict the class label of a single dense instance
+ *
+ * @details
+ * The instance is given by its m features, without the column of ones that 
+ * is used in GenData::Z. For a model trained on hashed or compacted features 
+ * (see GenModel::hash_bits and GenModel::col_map) these are the columns of 
+ * the model, use gensvm_predictor_predict_one_sparse() for the indices of 
+ * the data file. For a linear model the simplex space vector is 
+ * computed directly with V. For a nonlinear model the kernel is evaluated 
+ * between the instance and each of the basis instances, and multiplied with 
+ * the collapsed coefficients in GenModel::W (see 
+ * gensvm_kernel_calculate_ZV()). For a precomputed kernel, x should contain 
+ * the kernel row between the instance and the basis instances.
+ *
+ * The scores of the classes are available from gensvm_predictor_scores() 
+ * until the next prediction. No memory is allocated.
+ *
+ * @param[in] 	pred 	an initialized GenPredictor
+ * @param[in] 	x 	the features of the instance
+ * @param[in] 	m 	the number of features, which should equal
+ * 			GenPredictor::m
+ * @returns 		the predicted class label, or 0 if m is invalid
+ */
+long gensvm_predictor_predict_one(struct GenPredictor *pred, const double *x,
+		long m)
+{
+	long i, j, K = pred->K;
+	double dot, norm;
+	struct GenModel *model = pred->model;
+	struct GenData *basis = model->basis;
+
+	if (m != pred->m)
+		return 0;
+
+	for (j=0; j<K-1; j++)
+		pred->zv[j] = matrix_get(model->V, K-1, 0, j);
+
+	if (model->kerneltype == K_LINEAR) {
+		cblas_dgemv(CblasRowMajor, CblasTrans, m, K-1, 1.0,
+				model->V + (K-1), K-1, x, 1, 1.0, pred->zv, 1);
+		return gensvm_predictor_label(pred);
+	}
+
+	if (model->kerneltype == K_PRECOMPUTED) {
+		cblas_dgemv(CblasRowMajor, CblasTrans, pred->n_basis, K-1, 1.0,
+				model->W, K-1, x, 1, 1.0, pred->zv, 1);
+		return gensvm_predictor_label(pred);
+	}
+
+	norm = cblas_ddot(m, x, 1, x, 1);
+
+	if (basis->RAW != NULL) {
+		for (i=0; i<pred->n_basis; i++) {
+			dot = cblas_ddot(m, x, 1, &basis->RAW[i*(m+1)+1], 1);
+			pred->k[i] = gensvm_kernel_dot_inner(model, dot, norm,
+					pred->norms[i]);
+		}
+	} else {
+		// the work vector is kept at zero between predictions
+		cblas_dcopy(m, x, 1, pred->w + 1, 1);
+		for (i=0; i<pred->n_basis; i++) {
+			dot = gensvm_kernel_sparse_gather(pred->w, basis->spZ,
+					i);
+			pred->k[i] = gensvm_kernel_dot_inner(model, dot, norm,
+					pred->norms[i]);
+		}
+		for (j=0; j<m; j++)
+			pred->w[j+1] = 0.0;
+	}
+
+	return gensvm_predictor_kernel_label(pred);
+}
+
+/**
+ * @brief Find the column of the model of a feature of a sparse instance
+ *
+ * @details
+ * Sparse instances are given by the feature indices of the data file. If 
+ * the model was trained on hashed features (see GenModel::hash_bits) the 
+ * index is hashed with gensvm_parse_hash(), and if the model has a column 
+ * map (see GenModel::col_map) the column is renumbered with 
+ * gensvm_parse_map_column(), in the same way as the training data was read.
+ *
+ * @param[in] 	pred 	an initialized GenPredictor
+ * @param[in] 	index 	the feature index in the data file (1-based)
+ * @param[out] 	sign 	the sign of the hashed feature, 1.0 or -1.0
+ * @returns 		the column of the feature (1-based), 0 if the model
+ * 			doesn't use the feature, or -1 if the index is
+ * 			invalid
+ */
+long gensvm_predictor_column(struct GenPredictor *pred, long index,
+		double *sign)
+{
+	struct GenModel *model = pred->model;
+
+	*sign = 1.0;
+	if (index < 1)
+		return -1;
+	if (model->hash_bits > 0)
+		index = gensvm_parse_hash(index, model->hash_bits,
+				model->hash_signed, sign);
+	if (model->col_map != NULL)
+		return gensvm_parse_map_column(index, model->col_map,
+				model->col_map_size);
+	return (index > pred->m) ? -1 : index;
+}
+
+/**
+ * @brief Predict the class label of a single sparse instance
+ *
+ * @details
+ * This function is the same as gensvm_predictor_predict_one(), but the 
+ * instance is given by its nonzero features only. The feature indices are 
+ * 1-based, as in the LibSVM format, and are mapped to the columns of the 
+ * model with gensvm_predictor_column(), such that hashed and compacted 
+ * models take the indices of the data file. Features that are hashed into 
+ * the same column are added. For a nonlinear model, the kernel with the 
+ * basis instances is computed from the nonzero features only. Prediction for 
+ * a precomputed kernel is not supported with this function. No memory is 
+ * allocated.
+ *
+ * @param[in] 	pred 	an initialized GenPredictor
+ * @param[in] 	idx 	indices of the nonzero features (1-based)
+ * @param[in] 	val 	values of the nonzero features
+ * @param[in] 	nnz 	number of nonzero features
+ * @returns 		the predicted class label, or 0 if an index is
+ * 			invalid or the kernel is precomputed
+ */
+long gensvm_predictor_predict_one_sparse(struct GenPredictor *pred,
+		const long *idx, const double *val, long nnz)
+{
+	long i, j, jj, col, K = pred->K,
+	     m = pred->m;
+	double dot, sign, norm = 0.0;
+	struct GenModel *model = pred->model;
+	struct GenData *basis = model->basis;
+
+	if (model->kerneltype == K_PRECOMPUTED)
+		return 0;
+	for (jj=0; jj<nnz; jj++)
+		if (gensvm_predictor_column(pred, idx[jj], &sign) < 0)
+			return 0;
+
+	for (j=0; j<K-1; j++)
+		pred->zv[j] = matrix_get(model->V, K-1, 0, j);
+
+	if (model->kerneltype == K_LINEAR) {
+		for (jj=0; jj<nnz; jj++) {
+			col = gensvm_predictor_column(pred, idx[jj], &sign);
+			if (col > 0)
+				cblas_daxpy(K-1, sign*val[jj],
+						&model->V[col*(K-1)], 1,
+						pred->zv, 1);
+		}
+		return gensvm_predictor_label(pred);
+	}
+
+	// scatter the instance to the columns of the model. The squared 
+	// norm is the sum of the scattered values times the contributions 
+	// to them, which also holds when features share a column.
+	for (jj=0; jj<nnz; jj++) {
+		col = gensvm_predictor_column(pred, idx[jj], &sign);
+		if (col > 0)
+			pred->w[col] += sign*val[jj];
+	}
+	for (jj=0; jj<nnz; jj++) {
+		col = gensvm_predictor_column(pred, idx[jj], &sign);
+		if (col > 0)
+			norm += pred->w[col] * sign*val[jj];
+	}
+
+	for (i=0; i<pred->n_basis; i++) {
+		if (basis->RAW != NULL) {
+			dot = 0.0;
+			for (jj=0; jj<nnz; jj++) {
+				col = gensvm_predictor_column(pred, idx[jj],
+						&sign);
+				if (col > 0)
+					dot += sign*val[jj] *
+						basis->RAW[i*(m+1) + col];
+			}
+		} else {
+			dot = gensvm_kernel_sparse_gather(pred->w, basis->spZ,
+					i);
+		}
+		pred->k[i] = gensvm_kernel_dot_inner(model, dot, norm,
+				pred->norms[i]);
+	}
+
+	// reset the work vector
+	for (jj=0; jj<nnz; jj++) {
+		col = gensvm_predictor_column(pred, idx[jj], &sign);
+		if (col > 0)
+			pred->w[col] = 0.0;
+	}
+
+	return gensvm_predictor_kernel_label(pred);
+}
+
+/**
+ * @brief Get the scores of the classes of the last prediction
+ *
+ * @details
+ * The score of class k is the inner product of the simplex space vector 
+ * with vertex k of the simplex, and the predicted label is the class with 
+ * the largest score (see gensvm_predict_scores()). The returned array is 
+ * overwritten by the next prediction.
+ *
+ * @param[in] 	pred 	a GenPredictor
+ * @returns 		array of length K with the scores
+ */
+double *gensvm_predictor_scores(struct GenPredictor *pred)
+{
+	return pred->scores;
+}
+
+/**
+ * @brief Predict the label from the cross kernel row of an instance
+ *
+ * @details
+ * Add the product of the cross kernel row in GenPredictor::k with 
+ * GenModel::W to the simplex space vector, and determine the label with 
+ * gensvm_predictor_label().
+ *
+ * @param[in] 	pred 	a GenPredictor with the kernel row computed
+ * @returns 		the predicted class label
+ */
+long gensvm_predictor_kernel_label(struct GenPredictor *pred)
+{
+	long K = pred->K;
+
+	cblas_dgemv(CblasRowMajor, CblasTrans, pred->n_basis, K-1, 1.0,
+			pred->model->W, K-1, pred->k, 1, 1.0, pred->zv, 1);
+
+	return gensvm_predictor_label(pred);
+}
+
+/**
+ * @brief Predict the label from the simplex space vector of an instance
+ *
+ * @details
+ * Compute the scores of the classes from the simplex space vector in 
+ * GenPredictor::zv, and return the class with the largest score.
+ *
+ * @param[in] 	pred 	a GenPredictor with the simplex space vector
+ * @returns 		the predicted class label
+ */
+long gensvm_predictor_label(struct GenPredictor *pred)
+{
+	long K = pred->K;
+
+	cblas_dgemv(CblasRowMajor, CblasNoTrans, K, K-1, 1.0, pred->model->U,
+			K-1, pred->zv, 1, 0.0, pred->scores, 1);
+
+	return gensvm_predict_argmax(pred->scores, K) + 1;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file gensvm_quantize.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for quantized prediction with linear models
+ *
+ * @details
+ * This file contains functions for predicting class labels with a linear 
+ * model of which the weights are quantized to 8 bit integers. The quantized 
+ * scores come with an error bound, and instances for which the bound doesn't 
+ * determine the label are predicted in double precision, so the predicted 
+ * labels are the same as those of gensvm_predict_labels().
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_quantize.h"
+
+/**
+ * @brief Quantize the weights of a linear model
+ *
+ * @details
+ * The matrix @f$\textbf{W} = \textbf{V}\textbf{U}'@f$ of size (m+1) x K is 
+ * computed, and for every class k the weights of the features are quantized 
+ * as @f$q_{jk} = \text{round}(w_{jk}/s_k)@f$ with @f$s_k = \max_j |w_{jk}| 
+ * / 127@f$. The other members of GenQuantModel are computed for the error 
+ * bound used in gensvm_quant_predict_row().
+ *
+ * @param[in] 	model 	a trained linear GenModel
+ * @returns 		the quantized model, or NULL if the model isn't linear
+ */
+struct GenQuantModel *gensvm_quantize_model(struct GenModel *model)
+{
+	long j, k, l,
+	     m = model->m,
+	     K = model->K;
+	double value, absmax,
+	       *W = NULL;
+	struct GenQuantModel *qmodel = NULL;
+
+	if (model->kerneltype != K_LINEAR)
+		return NULL;
+
+	if (model->U == NULL)
+		model->U = Calloc(double, K*(K-1));
+	gensvm_simplex(model);
+
+	// W = V * U'
+	W = Malloc(double, (m+1)*K);
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, m+1, K, K-1,
+			1.0, model->V, K-1, model->U, K-1, 0.0, W, K);
+
+	qmodel = Malloc(struct GenQuantModel, 1);
+	qmodel->model = model;
+	qmodel->m = m;
+	qmodel->K = K;
+	qmodel->Q = Calloc(int8_t, K*m);
+	qmodel->scale = Calloc(double, K);
+	qmodel->bias = Calloc(double, K);
+	qmodel->qnorm = Calloc(double, K);
+	qmodel->absbias = Calloc(double, K);
+	qmodel->absmax = Calloc(double, K);
+
+	for (k=0; k<K; k++) {
+		qmodel->bias[k] = matrix_get(W, K, 0, k);
+
+		absmax = 0.0;
+		for (j=1; j<m+1; j++) {
+			value = fabs(matrix_get(W, K, j, k));
+			absmax = maximum(absmax, value);
+		}
+		qmodel->scale[k] = (absmax > 0) ? absmax / 127.0 : 1.0;
+
+		for (j=1; j<m+1; j++) {
+			value = round(matrix_get(W, K, j, k) /
+					qmodel->scale[k]);
+			qmodel->Q[k*m + j - 1] = (int8_t) value;
+			qmodel->qnorm[k] += fabs(value);
+		}
+		qmodel->qnorm[k] *= qmodel->scale[k];
+
+		// bounds of the terms in the double precision scores
+		for (l=0; l<K-1; l++)
+			qmodel->absbias[k] += fabs(matrix_get(model->V, K-1,
+						0, l) * matrix_get(model->U,
+							K-1, k, l));
+		for (j=1; j<m+1; j++) {
+			value = 0.0;
+			for (l=0; l<K-1; l++)
+				value += fabs(matrix_get(model->V, K-1, j, l)
+						* matrix_get(model->U, K-1, k,
+							l));
+			qmodel->absmax[k] = maximum(qmodel->absmax[k], value);
+		}
+	}
+
+	free(W);
+
+	return qmodel;
+}
+
+/**
+ * @brief Free a quantized model
+ *
+ * @details
+ * The GenModel that was quantized is not freed.
+ *
+ * @param[in] 	qmodel 	the GenQuantModel to free
+ */
+void gensvm_free_quant_model(struct GenQuantModel *qmodel)
+{
+	if (qmodel == NULL)
+		return;
+
+	free(qmodel->Q);
+	free(qmodel->scale);
+	free(qmodel->bias);
+	free(qmodel->qnorm);
+	free(qmodel->absbias);
+	free(qmodel->absmax);
+	free(qmodel);
+}
+
+/**
+ * @brief Predict class labels with a quantized linear model
+ *
+ * @details
+ * The labels of the instances are predicted with gensvm_quant_predict_row(), 
+ * with the instances divided over threads with OpenMP. The instances for 
+ * which the quantized scores don't determine the label are collected and 
+ * predicted with gensvm_predict_labels() in double precision. The predicted 
+ * labels are therefore the same as those of gensvm_predict_labels().
+ *
+ * Quantization is only used for dense data. For sparse data all instances 
+ * are predicted with gensvm_predict_labels().
+ *
+ * @param[in] 	data 	GenData to predict labels for
+ * @param[in] 	qmodel 	quantized model
+ * @param[out] 	predy 	pre-allocated vector to record predictions in
+ * @returns 		number of instances predicted in double precision
+ */
+long gensvm_quant_predict_labels(struct GenData *data,
+		struct GenQuantModel *qmodel, long *predy)
+{
+	long i, j, n_exact = 0,
+	     n = data->n,
+	     m = qmodel->m,
+	     *exact = NULL,
+	     *exact_y = NULL;
+	int8_t *p = NULL;
+	double *a = NULL;
+	bool determined;
+	struct GenData *subdata = NULL;
+
+	if (data->Z == NULL) {
+		gensvm_predict_labels(data, qmodel->model, predy);
+		return n;
+	}
+
+	exact = Malloc(long, n);
+
+	#pragma omp parallel private(i, p, a, determined)
+	{
+		p = Malloc(int8_t, m);
+		a = Malloc(double, qmodel->K);
+
+		#pragma omp for schedule(static)
+		for (i=0; i<n; i++) {
+			determined = gensvm_quant_predict_row(qmodel,
+					data->wrapped ? &data->Z[i*m] :
+					&data->Z[i*(m+1)+1], p, a, &predy[i]);
+			exact[i] = !determined;
+		}
+
+		free(p);
+		free(a);
+	}
+
+	// collect the undetermined instances and predict them exactly
+	for (i=0; i<n; i++)
+		if (exact[i])
+			exact[n_exact++] = i;
+
+	if (n_exact > 0) {
+		subdata = gensvm_init_data();
+		subdata->n = n_exact;
+		subdata->m = m;
+		subdata->r = m;
+		subdata->Z = Malloc(double, n_exact*(m+1));
+		for (j=0; j<n_exact; j++) {
+			subdata->Z[j*(m+1)] = 1.0;
+			memcpy(&subdata->Z[j*(m+1)+1], data->wrapped ?
+					&data->Z[exact[j]*m] :
+					&data->Z[exact[j]*(m+1)+1],
+					m*sizeof(double));
+		}
+		exact_y = Malloc(long, n_exact);
+
+		gensvm_predict_labels(subdata, qmodel->model, exact_y);
+		for (j=0; j<n_exact; j++)
+			predy[exact[j]] = exact_y[j];
+
+		gensvm_free_data(subdata);
+		free(exact_y);
+	}
+
+	free(exact);
+
+	return n_exact;
+}
+
+/**
+ * @brief Predict the class label of an instance with quantized weights
+ *
+ * @details
+ * The instance is quantized to int8 with the scale @f$t = \max_j |x_j| / 
+ * 127@f$ (no rounding is needed if all @f$x_j@f$ are zero), and the 
+ * approximate score of class k is @f$a_k = b_k + t s_k \sum_j p_j 
+ * q_{jk}@f$, where the inner product is computed exactly with integers. 
+ * Since the rounding errors of @f$x_j@f$ and @f$w_{jk}@f$ are at most 
+ * @f$t/2@f$ and @f$s_k/2@f$, the exact score differs at most
+ * @f[
+ * 	e_k = \frac{1}{2}\left( s_k \|\textbf{x}\|_1 + t \sum_j s_k |q_{jk}| 
+ * 	\right)
+ * @f]
+ * from @f$a_k@f$. A bound for the floating point error of the double 
+ * precision scores is added to this. If the lower bound of the score of the 
+ * best class is larger than the upper bounds of all other classes, the label 
+ * is determined. Otherwise the instance should be predicted in double 
+ * precision. This is also the case for an instance with values that are not 
+ * finite.
+ *
+ * @param[in] 	qmodel 	quantized model
+ * @param[in] 	x 	the m features of the instance
+ * @param[in] 	p 	work vector of length m for the quantized instance
+ * @param[in] 	a 	work vector of length K for the scores
+ * @param[out] 	label 	the predicted label, if it is determined
+ * @returns 		whether the label is determined
+ */
+bool gensvm_quant_predict_row(struct GenQuantModel *qmodel, double *x,
+		int8_t *p, double *a, long *label)
+{
+	long j, k, best = 0,
+	     m = qmodel->m,
+	     K = qmodel->K;
+	double t, ex, fp, lower, upper, value,
+	       absmax = 0.0,
+	       norm = 0.0,
+	       gamma = 4.0 * (m + K + 2) * DBL_EPSILON;
+
+	for (j=0; j<m; j++) {
+		value = fabs(x[j]);
+		absmax = maximum(absmax, value);
+		norm += value;
+	}
+	if (!isfinite(norm))
+		return false;
+
+	// an instance of zeros is quantized exactly, with t = 0
+	t = absmax / 127.0;
+	for (j=0; j<m; j++)
+		p[j] = (t > 0) ? (int8_t) round(x[j] / t) : 0;
+
+	for (k=0; k<K; k++) {
+		a[k] = qmodel->bias[k] + t * qmodel->scale[k] *
+			(double) gensvm_quant_dot(p, &qmodel->Q[k*m], m);
+		if (a[k] > a[best])
+			best = k;
+	}
+
+	ex = 0.5 * (qmodel->scale[best] * norm + t * qmodel->qnorm[best]);
+	fp = gamma * (qmodel->absbias[best] + norm * qmodel->absmax[best] +
+			fabs(a[best]));
+	lower = a[best] - ex - fp;
+	for (k=0; k<K; k++) {
+		if (k == best)
+			continue;
+		ex = 0.5 * (qmodel->scale[k] * norm + t * qmodel->qnorm[k]);
+		fp = gamma * (qmodel->absbias[k] + norm * qmodel->absmax[k] +
+				fabs(a[k]));
+		upper = a[k] + ex + fp;
+		if (upper >= lower)
+			return false;
+	}
+
+	*label = best + 1;
+	return true;
+}
+
+/**
+ * @brief Inner product of two int8 vectors
+ *
+ * @details
+ * The products are accumulated in 32 bit integers for blocks of 
+ * GENSVM_QUANT_BLOCK_SIZE elements, which the compiler can vectorize, and 
+ * the sums of the blocks in a 64 bit integer.
+ *
+ * @param[in] 	a 	vector of length n
+ * @param[in] 	b 	vector of length n
+ * @param[in] 	n 	length of the vectors
+ * @returns 		the inner product
+ */
+int64_t gensvm_quant_dot(const int8_t *a, const int8_t *b, long n)
+{
+	long j, start, end;
+	int32_t acc;
+	int64_t dot = 0;
+
+	for (start=0; start<n; start+=GENSVM_QUANT_BLOCK_SIZE) {
+		end = start + GENSVM_QUANT_BLOCK_SIZE;
+		end = minimum(end, n);
+		acc = 0;
+		#pragma omp simd reduction(+:acc)
+		for (j=start; j<end; j++)
+			acc += (int32_t) a[j] * (int32_t) b[j];
+		dot += acc;
+	}
+
+	return dot;
+}
@@ -45,17 +45,34 @@
  */
 long gensvm_num_sv(struct GenModel *model)
 {
-	long i, j, num_correct, num_sv = 0;
+	long i, num_sv = 0;
+
+	for (i=0; i<model->n; i++)
+		num_sv += gensvm_is_sv(model, i);
+
+	return num_sv;
+}
+
+/**
+ * @brief Check if an instance is a support vector
+ *
+ * @details
+ * An instance is a support vector if the error q is larger than 1 for fewer 
+ * than K-1 classes, see gensvm_num_sv().
+ *
+ * @param[in] 	model 	GenModel with solution and up-to-date Q matrix
+ * @param[in] 	i 	index of the instance
+ * @return 		whether instance i is a support vector
+ */
+bool gensvm_is_sv(struct GenModel *model, long i)
+{
+	long j, num_correct = 0;
 	double value;
 
-	for (i=0; i<model->n; i++) {
-		num_correct = 0;
-		for (j=0; j<model->K; j++) {
-			value = matrix_get(model->Q, model->K, i, j);
-			num_correct += (value > 1);
-		}
-		num_sv += (num_correct < model->K - 1);
+	for (j=0; j<model->K; j++) {
+		value = matrix_get(model->Q, model->K, i, j);
+		num_correct += (value > 1);
 	}
 
-	return num_sv;
+	return num_correct < model->K - 1;
 }
@@ -408,7 +408,8 @@ void gensvm_get_update(struct GenModel *model, struct GenData *data,
  * the BLAS dsyrk function. The matrix Z'*B is calculated with successive
  * rank-1 updates using the BLAS dger function. These functions came out as
  * the most efficient way to do these computations in several simulation
- * studies.
+ * studies. For wrapped data (see gensvm_wrap_dense()) the rows of Z have m
+ * elements and the column of ones is implied.
  *
  * @param[in] 		model 	a GenModel holding the current model
  * @param[in] 		data 	a GenData with the data
@@ -419,7 +420,7 @@ void gensvm_get_ZAZ_ZB_dense(struct GenModel *model, struct GenData *data,
 		struct GenWork *work)
 {
 	long i;
-	double alpha, sqalpha;
+	double alpha, sqalpha, *z = NULL;
 
 	long n = model->n;
 	long m = model->m;
@@ -434,16 +435,18 @@ void gensvm_get_ZAZ_ZB_dense(struct GenModel *model, struct GenData *data,
 		// Note that we use the fact that the first column of Z is
 		// always 1, by only computing the product for m values and
 		// copying the first element over.
+		z = data->wrapped ? &data->Z[i*m] : &data->Z[i*(m+1)+1];
 		sqalpha = sqrt(alpha);
 		work->LZ[i*(m+1)] = sqalpha;
-		cblas_daxpy(m, sqalpha, &data->Z[i*(m+1)+1], 1,
-				&work->LZ[i*(m+1)+1], 1);
+		cblas_daxpy(m, sqalpha, z, 1, &work->LZ[i*(m+1)+1], 1);
 
-		// rank 1 update of matrix Z'*B
+		// rank 1 update of matrix Z'*B, where the first row is
+		// updated separately since the first element of z_i is 1.
 		// Note: LDA is the second dimension of ZB because of
 		// Row-Major order
-		cblas_dger(CblasRowMajor, m+1, K-1, 1, &data->Z[i*(m+1)], 1,
-				work->beta, 1, work->ZB, K-1);
+		cblas_daxpy(K-1, 1.0, work->beta, 1, work->ZB, 1);
+		cblas_dger(CblasRowMajor, m, K-1, 1, z, 1, work->beta, 1,
+				work->ZB + (K-1), K-1);
 	}
 
 	// calculate Z'*A*Z by symmetric multiplication of LZ with itself
@@ -462,6 +465,9 @@ void gensvm_get_ZAZ_ZB_dense(struct GenModel *model, struct GenData *data,
  * Z'*B matrix row-wise for each non-zero element of a row of Z, using a BLAS 
  * daxpy call.
  *
+ * For wrapped data (see gensvm_wrap_csr()) the column of ones isn't stored,
+ * it is then added to every row and the columns are shifted by one.
+ *
  * This function calculates the matrix product Z'*A*Z in separate blocks, 
  * based on the number of rows defined in the GENSVM_BLOCK_SIZE variable. This 
  * is done to improve numerical precision for very large datasets. Due to 
@@ -485,7 +491,8 @@ void gensvm_get_ZAZ_ZB_sparse(struct GenModel *model, struct GenData *data,
 	     *Zja = NULL;
 	long b, i, j, k, K, jj, kk, jj_start, jj_end, blk_start, blk_end,
 	     rem_size, n_blocks, n_row = data->spZ->n_row,
-	     n_col = data->spZ->n_col;
+	     shift = data->wrapped ? 1 : 0,
+	     n_col = data->spZ->n_col + shift;
 	double temp, alpha, z_ij, *vals = NULL;
 
 	K = model->K;
@@ -512,15 +519,26 @@ void gensvm_get_ZAZ_ZB_sparse(struct GenModel *model, struct GenData *data,
 			jj_start = Zia[i];
 			jj_end = Zia[i+1];
 
+			// the implied column of ones of wrapped data
+			if (shift) {
+				cblas_daxpy(K-1, 1.0, work->beta, 1,
+						work->ZB, 1);
+				matrix_add(work->tmpZAZ, n_col, 0, 0, alpha);
+				for (kk=jj_start; kk<jj_end; kk++)
+					matrix_add(work->tmpZAZ, n_col, 0,
+							Zja[kk] + 1,
+							alpha * vals[kk]);
+			}
+
 			for (jj=jj_start; jj<jj_end; jj++) {
-				j = Zja[jj];
+				j = Zja[jj] + shift;
 				z_ij = vals[jj];
 				cblas_daxpy(K-1, z_ij, work->beta, 1,
 						&work->ZB[j*(K-1)], 1);
 				z_ij *= alpha;
 				for (kk=jj; kk<jj_end; kk++) {
 					matrix_add(work->tmpZAZ, n_col, j, 
-							Zja[kk], 
+							Zja[kk] + shift, 
 							z_ij * vals[kk]);
 				}
 			}
@@ -0,0 +1,238 @@
+/**
+ * @file gensvm_writer.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Functions for buffered output
+ *
+ * @details
+ * This file contains a simple buffered writer with fast formatting of 
+ * integers and floating point numbers, which is used to write large numbers 
+ * of predictions.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "gensvm_writer.h"
+
+/**
+ * @brief Open a file for buffered writing
+ *
+ * @param[in] 	filename 	name of the output file
+ * @returns 			a GenWriter for the file
+ */
+struct GenWriter *gensvm_writer_open(char *filename)
+{
+	FILE *fid = NULL;
+	struct GenWriter *writer = NULL;
+
+	if ((fid = fopen(filename, "wb")) == NULL) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Error opening output file %s\n",
+				filename);
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+
+	writer = gensvm_writer_init(fid);
+	writer->close_file = true;
+
+	return writer;
+}
+
+/**
+ * @brief Initialize a buffered writer for an open file
+ *
+ * @details
+ * The file is not closed by gensvm_writer_close(), so this can be used to 
+ * write to stdout.
+ *
+ * @param[in] 	fid 	an open file
+ * @returns 		a GenWriter for the file
+ */
+struct GenWriter *gensvm_writer_init(FILE *fid)
+{
+	struct GenWriter *writer = Malloc(struct GenWriter, 1);
+
+	writer->fid = fid;
+	writer->buffer = Malloc(char, GENSVM_WRITER_BUFFER_SIZE);
+	writer->len = 0;
+	writer->close_file = false;
+
+	return writer;
+}
+
+/**
+ * @brief Flush and free a buffered writer
+ *
+ * @details
+ * The file is closed if it was opened with gensvm_writer_open(), and flushed 
+ * otherwise.
+ *
+ * @param[in] 	writer 	the GenWriter to close
+ */
+void gensvm_writer_close(struct GenWriter *writer)
+{
+	if (writer == NULL)
+		return;
+
+	gensvm_writer_flush(writer);
+	if (writer->close_file)
+		fclose(writer->fid);
+	else
+		fflush(writer->fid);
+
+	free(writer->buffer);
+	free(writer);
+}
+
+/**
+ * @brief Write the contents of the buffer to the file
+ *
+ * @param[in] 	writer 	a GenWriter
+ */
+void gensvm_writer_flush(struct GenWriter *writer)
+{
+	if (writer->len == 0)
+		return;
+
+	if (fwrite(writer->buffer, 1, writer->len, writer->fid) !=
+			(size_t) writer->len) {
+		// LCOV_EXCL_START
+		err("[GenSVM Error]: Error writing output: %s\n",
+				strerror(errno));
+		exit(EXIT_FAILURE);
+		// LCOV_EXCL_STOP
+	}
+	writer->len = 0;
+}
+
+/**
+ * @brief Write raw bytes
+ *
+ * @param[in] 	writer 	a GenWriter
+ * @param[in] 	data 	the bytes to write
+ * @param[in] 	len 	number of bytes
+ */
+void gensvm_writer_write(struct GenWriter *writer, const void *data, long len)
+{
+	const char *bytes = data;
+	long size;
+
+	while (len > 0) {
+		if (writer->len == GENSVM_WRITER_BUFFER_SIZE)
+			gensvm_writer_flush(writer);
+		size = GENSVM_WRITER_BUFFER_SIZE - writer->len;
+		size = minimum(size, len);
+		memcpy(writer->buffer + writer->len, bytes, size);
+		writer->len += size;
+		bytes += size;
+		len -= size;
+	}
+}
+
+/**
+ * @brief Write a single character
+ *
+ * @param[in] 	writer 	a GenWriter
+ * @param[in] 	c 	the character
+ */
+void gensvm_writer_char(struct GenWriter *writer, char c)
+{
+	if (writer->len == GENSVM_WRITER_BUFFER_SIZE)
+		gensvm_writer_flush(writer);
+	writer->buffer[writer->len++] = c;
+}
+
+/**
+ * @brief Write an integer in decimal notation
+ *
+ * @details
+ * The digits are generated directly, which is much faster than formatting 
+ * with printf().
+ *
+ * @param[in] 	writer 	a GenWriter
+ * @param[in] 	value 	the integer
+ */
+void gensvm_writer_long(struct GenWriter *writer, long value)
+{
+	char digits[24];
+	int i = 24;
+	unsigned long u = (value < 0) ? -((unsigned long) value) :
+		(unsigned long) value;
+
+	do {
+		digits[--i] = '0' + (u % 10);
+		u /= 10;
+	} while (u > 0);
+	if (value < 0)
+		digits[--i] = '-';
+
+	gensvm_writer_write(writer, digits + i, 24 - i);
+}
+
+/**
+ * @brief Write a floating point number in fixed point notation
+ *
+ * @details
+ * The number is written with GENSVM_WRITER_DECIMALS decimals, as with the 
+ * "%.8f" format of printf() for the default of 8 decimals. The integer part 
+ * and the rounded fractional part are generated as integers, which is much 
+ * faster than printf(). Since the fractional part is rounded in binary, the 
+ * last decimal can differ from printf() for numbers that are exactly 
+ * halfway. Numbers that are too large for this, and infinite or NaN values, 
+ * are written with printf().
+ *
+ * @param[in] 	writer 	a GenWriter
+ * @param[in] 	value 	the number
+ */
+void gensvm_writer_double(struct GenWriter *writer, double value)
+{
+	int i;
+	char buf[32];
+	double a = fabs(value),
+	       scale = 1.0;
+	uint64_t ip, fp;
+
+	if (!isfinite(value) || a >= 1e15) {
+		i = snprintf(buf, 32, "%.*g", 17, value);
+		gensvm_writer_write(writer, buf, i);
+		return;
+	}
+
+	for (i=0; i<GENSVM_WRITER_DECIMALS; i++)
+		scale *= 10.0;
+
+	ip = (uint64_t) a;
+	fp = (uint64_t) llround((a - (double) ip) * scale);
+	if (fp >= (uint64_t) scale) {
+		ip++;
+		fp -= (uint64_t) scale;
+	}
+
+	if (signbit(value))
+		gensvm_writer_char(writer, '-');
+	gensvm_writer_long(writer, (long) ip);
+	gensvm_writer_char(writer, '.');
+	for (i=GENSVM_WRITER_DECIMALS-1; i>=0; i--) {
+		buf[i] = '0' + (fp % 10);
+		fp /= 10;
+	}
+	gensvm_writer_write(writer, buf, GENSVM_WRITER_DECIMALS);
+}
@@ -61,7 +61,9 @@ void gensvm_calculate_ZV(struct GenModel *model, struct GenData *data,
  *
  * @details
  * This is a simple sparse-dense matrix multiplication, which uses 
- * cblas_daxpy() for each nonzero element of Z, to compute Z*V.
+ * cblas_daxpy() for each nonzero element of Z, to compute Z*V. For wrapped 
+ * data (see gensvm_wrap_csr()) the column of ones isn't stored, the first 
+ * row of V is then added to every row and the columns are shifted by one.
  *
  * @param[in] 	model 	a GenModel instance holding the model
  * @param[in] 	data 	a GenData instance with the data
@@ -71,7 +73,8 @@ void gensvm_calculate_ZV_sparse(struct GenModel *model,
 		struct GenData *data, double *ZV)
 {
 	long i, j, jj, jj_start, jj_end, K,
-	    n_row = data->spZ->n_row;
+	    n_row = data->spZ->n_row,
+	    shift = data->wrapped ? 1 : 0;
 	double z_ij;
 
 	K = model->K;
@@ -84,8 +87,10 @@ void gensvm_calculate_ZV_sparse(struct GenModel *model,
 		jj_start = Zia[i];
 		jj_end = Zia[i+1];
 
+		if (shift)
+			cblas_daxpy(K-1, 1.0, model->V, 1, &ZV[i*(K-1)], 1);
 		for (jj=jj_start; jj<jj_end; jj++) {
-			j = Zja[jj];
+			j = Zja[jj] + shift;
 			z_ij = vals[jj];
 
 			cblas_daxpy(K-1, z_ij, &model->V[j*(K-1)], 1,
@@ -99,7 +104,9 @@ void gensvm_calculate_ZV_sparse(struct GenModel *model,
  *
  * @details
  * This function uses cblas_dgemm() to compute the matrix product between Z 
- * and V.
+ * and V. For wrapped data (see gensvm_wrap_dense()) Z has no column of 
+ * ones, then every row of ZV starts as the first row of V and the product 
+ * with the remaining rows of V is added.
  *
  * @param[in] 	model 	a GenModel instance holding the model
  * @param[in] 	data 	a GenData instance with the data
@@ -109,10 +116,79 @@ void gensvm_calculate_ZV_dense(struct GenModel *model,
 		struct GenData *data, double *ZV)
 {
 	// use n from data, assume m and K are the same between model and data
-	long n = data->n;
-	long m = model->m;
-	long K = model->K;
+	gensvm_calculate_ZV_rows(model, data->Z, data->n, data->wrapped, ZV);
+}
+
+/**
+ * @brief Compute the product Z*V for a block of rows of a dense Z
+ *
+ * @details
+ * The rows of Z start at Z. If the rows are wrapped (see 
+ * gensvm_wrap_dense()), they have m elements and the column of ones is 
+ * implied, otherwise they have m+1 elements.
+ *
+ * @param[in] 	model 	a GenModel instance holding the model
+ * @param[in] 	Z 	the first row of the block
+ * @param[in] 	rows 	number of rows in the block
+ * @param[in] 	wrapped whether the column of ones is implied
+ * @param[out] 	ZV 	a pre-allocated matrix of size rows x (K-1)
+ */
+void gensvm_calculate_ZV_rows(struct GenModel *model, double *Z, long rows,
+		bool wrapped, double *ZV)
+{
+	long i,
+	     m = model->m,
+	     K = model->K;
+
+	if (!wrapped) {
+		cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows,
+				K-1, m+1, 1.0, Z, m+1, model->V, K-1, 0.0,
+				ZV, K-1);
+		return;
+	}
+
+	for (i=0; i<rows; i++)
+		memcpy(&ZV[i*(K-1)], model->V, (K-1)*sizeof(double));
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, K-1, m,
+			1.0, Z, m, model->V + (K-1), K-1, 1.0, ZV, K-1);
+}
 
-	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, K-1, m+1,
-			1.0, data->Z, m+1, model->V, K-1, 0, ZV, K-1);
+/**
+ * @brief Compute a block of rows of the product Z*V
+ *
+ * @details
+ * This computes the rows @f$\text{start}, \ldots, \text{start} + 
+ * \text{rows} - 1@f$ of the product Z*V, for either dense or sparse Z (see 
+ * gensvm_calculate_ZV()). The result is written to the start of ZV, such 
+ * that a buffer for a single block of rows suffices.
+ *
+ * @param[in] 	model 	a GenModel instance holding the model
+ * @param[in] 	data 	a GenData instance with the data
+ * @param[in] 	start 	index of the first row of the block
+ * @param[in] 	rows 	number of rows in the block
+ * @param[out] 	ZV 	a pre-allocated matrix of size rows x (K-1)
+ */
+void gensvm_calculate_ZV_block(struct GenModel *model, struct GenData *data,
+		long start, long rows, double *ZV)
+{
+	long i, jj, m = model->m,
+	     K = model->K,
+	     shift = data->wrapped ? 1 : 0;
+	struct GenSparse *spZ = data->spZ;
+
+	if (data->Z != NULL) {
+		gensvm_calculate_ZV_rows(model, data->Z + start*(m+1-shift),
+				rows, data->wrapped, ZV);
+		return;
+	}
+
+	for (i=0; i<rows*(K-1); i++)
+		ZV[i] = shift ? model->V[i % (K-1)] : 0.0;
+	for (i=0; i<rows; i++) {
+		for (jj=spZ->ia[start+i]; jj<spZ->ia[start+i+1]; jj++) {
+			cblas_daxpy(K-1, spZ->values[jj],
+					&model->V[(spZ->ja[jj]+shift)*(K-1)],
+					1, &ZV[i*(K-1)], 1);
+		}
+	}
 }
@@ -0,0 +1,97 @@
+/**
+ * @file test_fixtures.h
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Data and models for the tests of the prediction methods
+ *
+ * @details
+ * The tests of the predictor, the quantized models, and the generated
+ * source code compare their predictions with those of
+ * gensvm_predict_scores(). This header creates the test data and the
+ * models for these tests. Every test program is a single source file, so
+ * the functions are defined here.
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef TEST_FIXTURES_H
+#define TEST_FIXTURES_H
+
+#include "gensvm_kernel.h"
+
+/**
+ * Fill a data matrix with a column of ones and features in [-1, 1], of
+ * which roughly a third is zero.
+ */
+void fixture_data(struct GenData *data, long n, long m, long seed)
+{
+	long i, j;
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+	data->RAW = Calloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(data->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++) {
+			if ((i + j + seed) % 3 == 0)
+				continue;
+			matrix_set(data->RAW, m+1, i, j,
+				((double) ((7*i + 3*j*j + seed) % 23))/11.0
+				- 1.0);
+		}
+	}
+	data->Z = data->RAW;
+}
+
+/**
+ * Allocate the matrices of a model with m features and K classes, and fill
+ * V with values in [-0.5, 0.5].
+ */
+void fixture_model(struct GenModel *model, long m, long K, long seed)
+{
+	long i;
+
+	model->m = m;
+	model->K = K;
+	model->V = Calloc(double, (m+1)*(K-1));
+	model->U = Calloc(double, K*(K-1));
+	for (i=0; i<(m+1)*(K-1); i++)
+		model->V[i] = ((double) ((3*i + seed) % 13))/12.0 - 0.5;
+}
+
+/**
+ * Create a kernel model of the given type with K classes from the training
+ * data, with the basis for prediction.
+ */
+void fixture_kernel_model(struct GenModel *model, struct GenData *train,
+		KernelType kerneltype, long K)
+{
+	model->kerneltype = kerneltype;
+	model->gamma = 0.7;
+	model->coef = 0.5;
+	model->degree = 2.0;
+	model->K = K;
+	gensvm_kernel_preprocess(model, train);
+	fixture_model(model, train->r, K, 0);
+	gensvm_kernel_store_basis(model, train);
+}
+
+#endif
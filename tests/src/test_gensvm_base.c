@@ -92,6 +92,87 @@ char *test_init_free_data_3()
 	return NULL;
 }
 
+char *test_wrap_dense()
+{
+	long i;
+	double X[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+	long y[3] = {2, 1, 2};
+	struct GenData *data = gensvm_wrap_dense(3, 2, X, y);
+
+	mu_assert(data->n == 3, "Incorrect n");
+	mu_assert(data->m == 2, "Incorrect m");
+	mu_assert(data->r == 2, "Incorrect r");
+	mu_assert(data->K == 2, "Incorrect K");
+	mu_assert(data->wrapped, "Data not wrapped");
+	mu_assert(data->Z == X && data->RAW == X, "Matrix copied");
+	mu_assert(data->y != y, "Labels not copied");
+	for (i=0; i<3; i++)
+		mu_assert(data->y[i] == y[i], "Incorrect y");
+
+	gensvm_unwrap_data(data);
+	mu_assert(!data->wrapped, "Data still wrapped");
+	mu_assert(data->Z == data->RAW && data->Z != X, "Matrix not copied");
+	for (i=0; i<3; i++) {
+		mu_assert(matrix_get(data->Z, 3, i, 0) == 1.0,
+				"Incorrect column of ones");
+		mu_assert(matrix_get(data->Z, 3, i, 1) == X[2*i],
+				"Incorrect column 1");
+		mu_assert(matrix_get(data->Z, 3, i, 2) == X[2*i+1],
+				"Incorrect column 2");
+	}
+	gensvm_free_data(data);
+
+	// the matrix of the caller isn't freed
+	data = gensvm_wrap_dense(3, 2, X, NULL);
+	mu_assert(data->y == NULL, "Labels without labels");
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
+char *test_wrap_csr()
+{
+	long i;
+	double values[4] = {1.5, 2.5, 3.5, 4.5};
+	long ia[4] = {0, 2, 2, 4},
+	     ja[4] = {0, 2, 1, 2},
+	     y[3] = {1, 3, 2};
+	long exp_ia[4] = {0, 3, 4, 7},
+	     exp_ja[7] = {0, 1, 3, 0, 0, 2, 3};
+	double exp_values[7] = {1.0, 1.5, 2.5, 1.0, 1.0, 3.5, 4.5};
+	struct GenData *data = gensvm_wrap_csr(3, 3, values, ia, ja, y);
+
+	mu_assert(data->n == 3, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->K == 3, "Incorrect K");
+	mu_assert(data->Z == NULL, "Dense matrix set");
+	mu_assert(data->wrapped, "Data not wrapped");
+	mu_assert(data->spZ->nnz == 4, "Incorrect nnz");
+	mu_assert(data->spZ->values == values && data->spZ->ia == ia &&
+			data->spZ->ja == ja, "CSR matrix copied");
+
+	gensvm_unwrap_data(data);
+	mu_assert(!data->wrapped, "Data still wrapped");
+	mu_assert(data->spZ->nnz == 7, "Incorrect unwrapped nnz");
+	mu_assert(data->spZ->n_col == 4, "Incorrect unwrapped n_col");
+	for (i=0; i<4; i++)
+		mu_assert(data->spZ->ia[i] == exp_ia[i], "Incorrect ia");
+	for (i=0; i<7; i++) {
+		mu_assert(data->spZ->ja[i] == exp_ja[i], "Incorrect ja");
+		mu_assert(data->spZ->values[i] == exp_values[i],
+				"Incorrect values");
+	}
+	mu_assert(ia[3] == 4 && ja[3] == 2 && values[3] == 4.5,
+			"CSR matrix of the caller changed");
+	gensvm_free_data(data);
+
+	// the CSR matrix of the caller isn't freed
+	data = gensvm_wrap_csr(3, 3, values, ia, ja, y);
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
 char *test_init_free_work()
 {
 	struct GenModel *model = gensvm_init_model();
@@ -192,6 +273,8 @@ char *all_tests()
 	mu_run_test(test_init_free_data_1);
 	mu_run_test(test_init_free_data_2);
 	mu_run_test(test_init_free_data_3);
+	mu_run_test(test_wrap_dense);
+	mu_run_test(test_wrap_csr);
 
 	mu_run_test(test_init_free_work);
 	mu_run_test(test_reset_work);
@@ -0,0 +1,662 @@
+/**
+ * @file test_gensvm_binary.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_binary.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "minunit.h"
+#include "gensvm_binary.h"
+
+extern FILE *GENSVM_ERROR_FILE;
+
+/**
+ * Create a model with an RBF kernel and a dense basis of 4 instances.
+ */
+struct GenModel *kernel_model(void)
+{
+	long i, j;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *basis = gensvm_init_data();
+
+	model->p = 1.5;
+	model->lambda = 0.125;
+	model->kappa = 0.5;
+	model->weight_idx = 2;
+	model->kerneltype = K_RBF;
+	model->gamma = 0.75;
+	model->data_file = strdup("./data/test_file_read_data.txt");
+	model->n = 4;
+	model->m = 2;
+	model->K = 3;
+
+	model->V = Calloc(double, (model->m+1)*(model->K-1));
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		model->V[i] = 0.1 * (i + 1) - 0.25;
+
+	basis->n = 4;
+	basis->m = 3;
+	basis->r = 2;
+	basis->RAW = Calloc(double, basis->n*(basis->m+1));
+	for (i=0; i<basis->n; i++) {
+		matrix_set(basis->RAW, basis->m+1, i, 0, 1.0);
+		matrix_set(basis->RAW, basis->m+1, i, 1, 0.3 * i - 0.1);
+		matrix_set(basis->RAW, basis->m+1, i, 3, 1.0/(i + 3.0));
+	}
+	model->W = Calloc(double, basis->n*(model->K-1));
+	for (i=0; i<basis->n; i++)
+		for (j=0; j<model->K-1; j++)
+			matrix_set(model->W, model->K-1, i, j,
+					1.0/(i + 7.0*j + 1.0));
+	model->basis = basis;
+
+	return model;
+}
+
+char *test_write_read_model_binary_linear()
+{
+	long i;
+	struct GenModel *model = gensvm_init_model();
+	struct GenModel *read = gensvm_init_model();
+	char *filename = "./data/test_write_model_binary.bin";
+
+	model->p = 2.0;
+	model->lambda = 0.001;
+	model->kappa = 1.0;
+	model->epsilon = 1e-7;
+	model->data_file = strdup("./data/test_file_read_data.txt");
+	model->n = 10;
+	model->m = 4;
+	model->K = 4;
+	model->hash_bits = 2;
+	model->hash_signed = true;
+	model->col_map_size = 4;
+	model->col_map = Malloc(long, 4);
+	for (i=0; i<4; i++)
+		model->col_map[i] = 3*i + 2;
+	model->V = Calloc(double, (model->m+1)*(model->K-1));
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		model->V[i] = 1.0/(i + 1.0) - 0.3;
+
+	// start test code //
+	gensvm_write_model_binary(model, filename);
+	mu_assert(gensvm_is_binary_model(filename), "Binary model not "
+			"recognized");
+	gensvm_read_model(read, filename);
+
+	mu_assert(read->map != NULL, "Model not mapped");
+	mu_assert(read->p == 2.0, "Incorrect p");
+	mu_assert(read->lambda == 0.001, "Incorrect lambda");
+	mu_assert(read->kappa == 1.0, "Incorrect kappa");
+	mu_assert(read->epsilon == 1e-7, "Incorrect epsilon");
+	mu_assert(read->kerneltype == K_LINEAR, "Incorrect kerneltype");
+	mu_assert(read->n == 10, "Incorrect n");
+	mu_assert(read->m == 4, "Incorrect m");
+	mu_assert(read->K == 4, "Incorrect K");
+	mu_assert(read->hash_bits == 2, "Incorrect hash_bits");
+	mu_assert(read->hash_signed, "Incorrect hash_signed");
+	mu_assert(read->col_map_size == 4, "Incorrect col_map_size");
+	for (i=0; i<4; i++)
+		mu_assert(read->col_map[i] == 3*i + 2, "Incorrect col_map");
+	mu_assert(!strcmp(read->data_file, model->data_file),
+			"Incorrect data file");
+	mu_assert(((uintptr_t) read->V) % GENSVM_BINARY_ALIGN == 0,
+			"V not aligned");
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		mu_assert(read->V[i] == model->V[i], "Incorrect V");
+	mu_assert(read->U != NULL, "Simplex matrix not generated");
+	mu_assert(read->basis == NULL, "Basis read for linear model");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_write_read_model_binary_kernel()
+{
+	long i;
+	struct GenModel *model = kernel_model();
+	struct GenModel *read = gensvm_init_model();
+	struct GenData *basis = model->basis;
+	char *filename = "./data/test_write_model_binary_kernel.bin";
+
+	// start test code //
+	gensvm_write_model_binary(model, filename);
+	gensvm_read_model(read, filename);
+
+	mu_assert(read->kerneltype == K_RBF, "Incorrect kerneltype");
+	mu_assert(read->gamma == 0.75, "Incorrect gamma");
+	mu_assert(read->weight_idx == 2, "Incorrect weight_idx");
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		mu_assert(read->V[i] == model->V[i], "Incorrect V");
+
+	mu_assert(read->basis != NULL, "Basis not read");
+	mu_assert(read->basis->n == 4, "Incorrect basis n");
+	mu_assert(read->basis->m == 3, "Incorrect basis m");
+	mu_assert(read->basis->kerneltype == K_RBF, "Incorrect basis kernel");
+	mu_assert(read->basis->gamma == 0.75, "Incorrect basis gamma");
+	for (i=0; i<basis->n*(model->K-1); i++)
+		mu_assert(read->W[i] == model->W[i], "Incorrect coefficients");
+	mu_assert(read->basis->RAW != NULL, "Instances not read as dense");
+	for (i=0; i<basis->n*(basis->m+1); i++)
+		mu_assert(read->basis->RAW[i] == basis->RAW[i],
+				"Incorrect instances");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_write_model_binary_mapped()
+{
+	long i;
+	struct GenModel *model = kernel_model();
+	struct GenModel *other = gensvm_init_model();
+	struct GenModel *read = gensvm_init_model();
+	struct GenModel *read_other = gensvm_init_model();
+	struct GenData *basis = model->basis;
+	char *filename = "./data/test_write_model_binary_mapped.bin";
+
+	other->m = 1;
+	other->K = 2;
+	other->V = Calloc(double, 2);
+	other->V[0] = 0.5;
+	other->V[1] = -0.5;
+
+	// start test code //
+	gensvm_write_model_binary(model, filename);
+	gensvm_read_model(read, filename);
+
+	// replace the file while the first model is still mapped
+	gensvm_write_model_binary(other, filename);
+
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		mu_assert(read->V[i] == model->V[i], "Incorrect V");
+	for (i=0; i<basis->n*(model->K-1); i++)
+		mu_assert(read->W[i] == model->W[i], "Incorrect coefficients");
+	for (i=0; i<basis->n*(basis->m+1); i++)
+		mu_assert(read->basis->RAW[i] == basis->RAW[i],
+				"Incorrect instances");
+
+	gensvm_read_model(read_other, filename);
+	mu_assert(read_other->m == 1, "Incorrect m of new model");
+	mu_assert(read_other->V[0] == 0.5, "Incorrect V of new model");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(other);
+	gensvm_free_model(read);
+	gensvm_free_model(read_other);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_write_model_binary_failed()
+{
+	int status;
+	pid_t pid;
+	struct rlimit limit;
+	struct GenModel *model = kernel_model();
+	struct GenModel *read = gensvm_init_model();
+	char *filename = "./data/test_write_model_binary_failed.bin";
+	FILE *fid = NULL;
+
+	gensvm_write_model_binary(model, filename);
+
+	// start test code //
+	// a child that can only write small files fails to write the model,
+	// which should leave the existing file alone
+	pid = fork();
+	if (pid == 0) {
+		signal(SIGXFSZ, SIG_IGN);
+		limit.rlim_cur = limit.rlim_max = 128;
+		setrlimit(RLIMIT_FSIZE, &limit);
+		GENSVM_ERROR_FILE = NULL;
+		model->V[0] = 42.0;
+		gensvm_write_model_binary(model, filename);
+		_exit(EXIT_SUCCESS);
+	}
+	mu_assert(waitpid(pid, &status, 0) == pid, "No child process");
+	mu_assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE,
+			"Incomplete write not detected");
+
+	gensvm_read_model(read, filename);
+	mu_assert(read->V[0] == model->V[0], "Model file replaced");
+
+	fid = popen("ls ./data | grep -c test_write_model_binary_failed",
+			"r");
+	mu_assert(fscanf(fid, "%i", &status) == 1 && status == 1,
+			"Temporary file not removed");
+	pclose(fid);
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_write_read_model_binary_sparse()
+{
+	long i;
+	struct GenModel *model = kernel_model();
+	struct GenModel *read = gensvm_init_model();
+	struct GenData *basis = model->basis;
+	struct GenSparse *spZ = NULL;
+	char *filename = "./data/test_write_model_binary_sparse.bin";
+
+	basis->spZ = gensvm_dense_to_sparse(basis->RAW, basis->n, basis->m+1);
+	free(basis->RAW);
+	basis->RAW = NULL;
+	spZ = basis->spZ;
+
+	// start test code //
+	gensvm_write_model_binary(model, filename);
+	gensvm_read_model(read, filename);
+
+	mu_assert(read->basis->RAW == NULL, "Instances read as dense");
+	mu_assert(read->basis->spZ != NULL, "Instances not read as sparse");
+	mu_assert(read->basis->spZ->nnz == spZ->nnz, "Incorrect nnz");
+	mu_assert(read->basis->spZ->n_row == spZ->n_row, "Incorrect n_row");
+	mu_assert(read->basis->spZ->n_col == spZ->n_col, "Incorrect n_col");
+	for (i=0; i<spZ->nnz; i++) {
+		mu_assert(read->basis->spZ->values[i] == spZ->values[i],
+				"Incorrect values");
+		mu_assert(read->basis->spZ->ja[i] == spZ->ja[i],
+				"Incorrect ja");
+	}
+	for (i=0; i<spZ->n_row+1; i++)
+		mu_assert(read->basis->spZ->ia[i] == spZ->ia[i],
+				"Incorrect ia");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_check_model_header()
+{
+	uint64_t file_size;
+	struct GenModelHeader header;
+	struct GenModel *model = kernel_model();
+	char *filename = "./data/test_write_model_binary_header.bin";
+	FILE *fid = NULL;
+
+	gensvm_write_model_binary(model, filename);
+	fid = fopen(filename, "rb");
+	mu_assert(fread(&header, sizeof(struct GenModelHeader), 1, fid) == 1,
+			"Header not read");
+	fseek(fid, 0, SEEK_END);
+	file_size = ftell(fid);
+	fclose(fid);
+
+	// start test code //
+	mu_assert(file_size % GENSVM_BINARY_ALIGN == 0,
+			"File size not aligned");
+	mu_assert(header.file_size == file_size, "Incorrect file size");
+	mu_assert(gensvm_check_model_header(&header, file_size),
+			"Valid header rejected");
+	mu_assert(!gensvm_check_model_header(&header, file_size - 64),
+			"Truncated file accepted");
+
+	header.version++;
+	mu_assert(!gensvm_check_model_header(&header, file_size),
+			"Other version accepted");
+	header.version--;
+
+	header.byte_order = 0x04030201;
+	mu_assert(!gensvm_check_model_header(&header, file_size),
+			"Other byte order accepted");
+	header.byte_order = GENSVM_BINARY_BYTE_ORDER;
+
+	header.W_offset += 8;
+	mu_assert(!gensvm_check_model_header(&header, file_size),
+			"Unaligned offset accepted");
+	header.W_offset -= 8;
+
+	header.basis_n = 1000;
+	mu_assert(!gensvm_check_model_header(&header, file_size),
+			"Basis larger than file accepted");
+	// end test code //
+
+	gensvm_free_model(model);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_read_model_binary_invalid()
+{
+	long size;
+	struct GenModel *model = kernel_model();
+	struct GenModel *read = NULL;
+	char *filename = "./data/test_read_model_binary_invalid.bin";
+	FILE *fid = NULL,
+	     *error_file = GENSVM_ERROR_FILE;
+
+	gensvm_write_model_binary(model, filename);
+	fid = fopen(filename, "rb");
+	fseek(fid, 0, SEEK_END);
+	size = ftell(fid);
+	fclose(fid);
+
+	// start test code //
+	GENSVM_ERROR_FILE = NULL;
+
+	// a changed value fails the checksum
+	fid = fopen(filename, "r+b");
+	fseek(fid, size - 8, SEEK_SET);
+	fputc(0x5a, fid);
+	fclose(fid);
+	read = gensvm_init_model();
+	mu_assert(!gensvm_read_model_binary(read, filename),
+			"Changed file read");
+	gensvm_free_model(read);
+
+	// a truncated file fails the header check
+	mu_assert(truncate(filename, size / 2) == 0, "File not truncated");
+	read = gensvm_init_model();
+	mu_assert(!gensvm_read_model_binary(read, filename),
+			"Truncated file read");
+	gensvm_free_model(read);
+
+	// an empty file has no header
+	mu_assert(truncate(filename, 0) == 0, "File not truncated");
+	read = gensvm_init_model();
+	mu_assert(!gensvm_read_model_binary(read, filename),
+			"Empty file read");
+	gensvm_free_model(read);
+
+	GENSVM_ERROR_FILE = error_file;
+	// end test code //
+
+	gensvm_free_model(model);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_binary_checksum()
+{
+	double x[4] = {1.0, 2.0, 3.0, 4.0},
+	       y[4] = {1.0, 2.0, 3.0, 4.0};
+	uint64_t h1, h2;
+
+	// start test code //
+	h1 = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, x,
+			4*sizeof(double));
+	h2 = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, x,
+			2*sizeof(double));
+	h2 = gensvm_binary_checksum(h2, x + 2, 2*sizeof(double));
+	mu_assert(h1 == h2, "Checksum in parts differs");
+
+	y[3] = 4.000000000000001;
+	h2 = gensvm_binary_checksum(GENSVM_BINARY_CHECKSUM_INIT, y,
+			4*sizeof(double));
+	mu_assert(h1 != h2, "Checksum doesn't detect change");
+
+	mu_assert(gensvm_binary_align(0) == 0, "Incorrect alignment");
+	mu_assert(gensvm_binary_align(1) == GENSVM_BINARY_ALIGN,
+			"Incorrect alignment");
+	mu_assert(gensvm_binary_align(GENSVM_BINARY_ALIGN) ==
+			GENSVM_BINARY_ALIGN, "Incorrect alignment");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_write_read_data_binary_dense()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *read = gensvm_init_data();
+	char *filename = "./data/test_write_data_binary.bin";
+
+	gensvm_read_data(data, "./data/test_file_read_data.txt");
+
+	// start test code //
+	gensvm_write_data_binary(data, filename);
+	mu_assert(gensvm_is_binary_data(filename), "Binary data not "
+			"recognized");
+	mu_assert(!gensvm_is_binary_model(filename), "Binary data "
+			"recognized as model");
+	gensvm_read_data(read, filename);
+
+	mu_assert(read->map != NULL, "Data not mapped");
+	mu_assert(read->n == data->n, "Incorrect n");
+	mu_assert(read->m == data->m, "Incorrect m");
+	mu_assert(read->r == data->m, "Incorrect r");
+	mu_assert(read->K == data->K, "Incorrect K");
+	mu_assert(read->spZ == NULL, "Data read as sparse");
+	mu_assert(read->Z == read->RAW, "Z doesn't equal RAW");
+	mu_assert(((uintptr_t) read->RAW) % GENSVM_BINARY_ALIGN == 0,
+			"RAW not aligned");
+	for (i=0; i<data->n; i++)
+		mu_assert(read->y[i] == data->y[i], "Incorrect y");
+	for (i=0; i<data->n*(data->m+1); i++)
+		mu_assert(read->RAW[i] == data->RAW[i], "Incorrect RAW");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_write_read_data_binary_sparse()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *read = gensvm_init_data();
+	struct GenSparse *spZ = NULL;
+	char *filename = "./data/test_write_data_binary_sparse.bin";
+
+	gensvm_read_data_libsvm(data,
+			"./data/test_file_read_data_sparse_libsvm.txt");
+	if (data->spZ == NULL) {
+		data->spZ = gensvm_dense_to_sparse(data->RAW, data->n,
+				data->m+1);
+		free(data->RAW);
+		data->RAW = NULL;
+		data->Z = NULL;
+	}
+	spZ = data->spZ;
+
+	// start test code //
+	gensvm_write_data_binary(data, filename);
+	gensvm_read_data_libsvm(read, filename);
+
+	mu_assert(read->map != NULL, "Data not mapped");
+	mu_assert(read->n == data->n, "Incorrect n");
+	mu_assert(read->m == data->m, "Incorrect m");
+	mu_assert(read->RAW == NULL, "Data read as dense");
+	mu_assert(read->spZ != NULL, "Data not read as sparse");
+	mu_assert(read->spZ->nnz == spZ->nnz, "Incorrect nnz");
+	mu_assert(read->spZ->n_row == spZ->n_row, "Incorrect n_row");
+	mu_assert(read->spZ->n_col == spZ->n_col, "Incorrect n_col");
+	for (i=0; i<spZ->nnz; i++) {
+		mu_assert(read->spZ->values[i] == spZ->values[i],
+				"Incorrect values");
+		mu_assert(read->spZ->ja[i] == spZ->ja[i], "Incorrect ja");
+	}
+	for (i=0; i<spZ->n_row+1; i++)
+		mu_assert(read->spZ->ia[i] == spZ->ia[i], "Incorrect ia");
+	for (i=0; i<data->n; i++)
+		mu_assert(read->y[i] == data->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(read);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_read_data_chunk_binary()
+{
+	long i, j, n,
+	     n_total = 0;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+	char *filename = "./data/test_read_data_chunk_binary.bin";
+
+	gensvm_read_data(data, "./data/test_file_read_data.txt");
+	gensvm_write_data_binary(data, filename);
+
+	// start test code //
+	reader = gensvm_open_data_reader(filename, false, data->m, 0,
+			false, NULL);
+	mu_assert(reader->n == data->n, "Incorrect number of instances");
+	mu_assert(reader->has_labels, "Labels not detected");
+	while ((n = gensvm_read_data_chunk(reader, chunk, 2)) > 0) {
+		for (i=0; i<n; i++) {
+			mu_assert(chunk->y[i] == data->y[n_total+i],
+					"Incorrect label");
+			for (j=0; j<data->m+1; j++)
+				mu_assert(matrix_get(chunk->RAW, data->m+1,
+							i, j) ==
+						matrix_get(data->RAW,
+							data->m+1, n_total+i,
+							j),
+						"Incorrect value");
+		}
+		n_total += n;
+	}
+	mu_assert(n_total == data->n, "Incorrect number of instances read");
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+
+	// sparse chunks
+	data->spZ = gensvm_dense_to_sparse(data->RAW, data->n, data->m+1);
+	free(data->RAW);
+	data->RAW = NULL;
+	data->Z = NULL;
+	gensvm_write_data_binary(data, filename);
+
+	chunk = gensvm_init_data();
+	reader = gensvm_open_data_reader(filename, true, data->m + 2, 0,
+			false, NULL);
+	n = gensvm_read_data_chunk(reader, chunk, 3);
+	mu_assert(n == 3, "Incorrect chunk size");
+	n = gensvm_read_data_chunk(reader, chunk, 3);
+	mu_assert(chunk->spZ->n_row == n, "Incorrect n_row");
+	mu_assert(chunk->spZ->n_col == data->m + 3, "Incorrect n_col");
+	mu_assert(chunk->spZ->ia[0] == 0, "Incorrect first ia");
+	mu_assert(chunk->spZ->ia[n] == chunk->spZ->nnz, "Incorrect last ia");
+	for (i=0; i<chunk->spZ->nnz; i++)
+		mu_assert(chunk->spZ->values[i] == data->spZ->values[
+				data->spZ->ia[3] + i], "Incorrect values");
+	// end test code //
+
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+	gensvm_free_data(data);
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_check_data_header()
+{
+	uint64_t file_size;
+	struct GenDataHeader header;
+	struct GenData *data = gensvm_init_data();
+	char *filename = "./data/test_write_data_binary_header.bin";
+	FILE *fid = NULL;
+
+	gensvm_read_data(data, "./data/test_file_read_data.txt");
+	gensvm_write_data_binary(data, filename);
+	fid = fopen(filename, "rb");
+	mu_assert(fread(&header, sizeof(struct GenDataHeader), 1, fid) == 1,
+			"Header not read");
+	fseek(fid, 0, SEEK_END);
+	file_size = ftell(fid);
+	fclose(fid);
+
+	// start test code //
+	mu_assert(header.file_size == file_size, "Incorrect file size");
+	mu_assert(header.format == 1, "Incorrect format");
+	mu_assert(header.has_labels == 1, "Incorrect has_labels");
+	mu_assert(gensvm_check_data_header(&header, file_size),
+			"Valid header rejected");
+	mu_assert(!gensvm_check_data_header(&header, file_size - 64),
+			"Truncated file accepted");
+
+	header.dtype = 2;
+	mu_assert(!gensvm_check_data_header(&header, file_size),
+			"Other type accepted");
+	header.dtype = GENSVM_BINARY_FLOAT64;
+
+	header.RAW_offset += 8;
+	mu_assert(!gensvm_check_data_header(&header, file_size),
+			"Unaligned offset accepted");
+	header.RAW_offset -= 8;
+
+	header.n = 1000;
+	mu_assert(!gensvm_check_data_header(&header, file_size),
+			"Instances larger than file accepted");
+	// end test code //
+
+	gensvm_free_data(data);
+	remove(filename);
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_write_read_model_binary_linear);
+	mu_run_test(test_write_read_model_binary_kernel);
+	mu_run_test(test_write_model_binary_mapped);
+	mu_run_test(test_write_model_binary_failed);
+	mu_run_test(test_write_read_model_binary_sparse);
+	mu_run_test(test_check_model_header);
+	mu_run_test(test_read_model_binary_invalid);
+	mu_run_test(test_write_read_data_binary_dense);
+	mu_run_test(test_write_read_data_binary_sparse);
+	mu_run_test(test_read_data_chunk_binary);
+	mu_run_test(test_check_data_header);
+	mu_run_test(test_binary_checksum);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,287 @@
+/**
+ * @file test_gensvm_codegen.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_codegen.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "minunit.h"
+#include "gensvm_codegen.h"
+#include "gensvm_predict.h"
+#include "gensvm_parse.h"
+#include "test_fixtures.h"
+
+/**
+ * Write the model as C source with the name test_model, and start a driver
+ * program that includes it. The caller writes the rest of the driver to the
+ * returned file and runs it with run_driver().
+ */
+FILE *open_driver(struct GenModel *model)
+{
+	FILE *fid = NULL;
+
+	gensvm_write_model_source(model, "./data/test_codegen_model.c",
+			"test_model");
+	fid = fopen("./data/test_codegen_driver.c", "w");
+	fprintf(fid, "#include <stdio.h>\n");
+	fprintf(fid, "#include \"test_codegen_model.c\"\n");
+
+	return fid;
+}
+
+/**
+ * Close and compile the driver program, and run it. The output of the
+ * driver is read from the returned stream, which is NULL if the driver
+ * doesn't compile.
+ */
+FILE *run_driver(FILE *fid)
+{
+	fclose(fid);
+	if (system("gcc -Wall -Werror -o ./data/test_codegen_driver "
+				"./data/test_codegen_driver.c -lm") != 0)
+		return NULL;
+	return popen("./data/test_codegen_driver", "r");
+}
+
+/**
+ * Close the output of the driver program and remove its files.
+ */
+void close_driver(FILE *out)
+{
+	if (out != NULL)
+		pclose(out);
+	remove("./data/test_codegen_model.c");
+	remove("./data/test_codegen_driver.c");
+	remove("./data/test_codegen_driver");
+}
+
+/**
+ * Compile the model with a driver program that predicts the test
+ * instances, and compare the labels with those of gensvm_predict_labels().
+ */
+char *check_compiled(struct GenModel *model, struct GenData *test)
+{
+	long i, j, label,
+	     n = test->n,
+	     m = test->m,
+	     *predy = Calloc(long, n);
+	char *msg = NULL;
+	FILE *fid = open_driver(model);
+
+	// driver with the test instances
+	fprintf(fid, "static const double X[%li][%li] = {\n", n, m);
+	for (i=0; i<n; i++) {
+		fprintf(fid, "{");
+		for (j=1; j<m+1; j++)
+			fprintf(fid, "%.17g,", matrix_get(test->RAW, m+1, i,
+						j));
+		fprintf(fid, "},\n");
+	}
+	fprintf(fid, "};\n");
+	fprintf(fid, "int main(void)\n{\n\tlong i;\n");
+	fprintf(fid, "\tfor (i=0; i<%li; i++)\n", n);
+	fprintf(fid, "\t\tprintf(\"%%li\\n\", test_model_predict(X[i]));\n");
+	fprintf(fid, "\treturn 0;\n}\n");
+
+	gensvm_predict_labels(test, model, predy);
+
+	if ((fid = run_driver(fid)) == NULL)
+		msg = "Generated source doesn't compile";
+	for (i=0; i<n && msg == NULL; i++) {
+		if (fscanf(fid, "%li", &label) != 1 || label != predy[i])
+			msg = "Incorrect label of compiled model";
+	}
+	close_driver(fid);
+	free(predy);
+
+	return msg;
+}
+
+char *test_codegen_linear()
+{
+	long n = 40, m = 5, K = 4;
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *test = gensvm_init_data();
+
+	fixture_data(test, n, m, 2);
+	fixture_model(model, m, K, 0);
+
+	// start test code //
+	msg = check_compiled(model, test);
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(test);
+
+	return msg;
+}
+
+char *test_codegen_linear_loops()
+{
+	long n = 30, m = 300, K = 5;
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *test = gensvm_init_data();
+
+	fixture_data(test, n, m, 4);
+	fixture_model(model, m, K, 1);
+
+	// start test code //
+	mu_assert((m+1)*(K-1) > GENSVM_CODEGEN_UNROLL_MAX,
+			"Model too small to test loops");
+	msg = check_compiled(model, test);
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(test);
+
+	return msg;
+}
+
+char *test_codegen_kernel()
+{
+	long i, n = 30, n_test = 25, m = 4, K = 3;
+	char *msg = NULL;
+	KernelType types[3] = {K_RBF, K_POLY, K_SIGMOID};
+	struct GenModel *model = NULL;
+	struct GenData *train = NULL,
+		       *test = NULL;
+
+	for (i=0; i<3 && msg == NULL; i++) {
+		model = gensvm_init_model();
+		train = gensvm_init_data();
+		test = gensvm_init_data();
+		fixture_data(train, n, m, 0);
+		fixture_data(test, n_test, m, 5);
+		fixture_kernel_model(model, train, types[i], K);
+
+		// start test code //
+		msg = check_compiled(model, test);
+		// end test code //
+
+		gensvm_free_model(model);
+		gensvm_free_data(train);
+		gensvm_free_data(test);
+	}
+
+	return msg;
+}
+
+/**
+ * Compile the model with a driver program that prints the columns of some
+ * feature indices, and compare these with the columns of
+ * gensvm_parse_hash() and gensvm_parse_map_column().
+ */
+char *check_compiled_columns(struct GenModel *model)
+{
+	long i, col, exp_col, n = 7,
+	     idx[7] = {0, 1, 3, 7, 41, 2718, 123456789};
+	double sign, exp_sign;
+	char *msg = NULL;
+	FILE *fid = open_driver(model);
+
+	fprintf(fid, "static const long I[%li] = {", n);
+	for (i=0; i<n; i++)
+		fprintf(fid, "%li,", idx[i]);
+	fprintf(fid, "};\n");
+	fprintf(fid, "int main(void)\n{\n\tlong i, col;\n\tdouble s;\n");
+	fprintf(fid, "\tfor (i=0; i<%li; i++) {\n", n);
+	fprintf(fid, "\t\tcol = test_model_column(I[i], &s);\n");
+	fprintf(fid, "\t\tprintf(\"%%li %%g\\n\", col, s);\n\t}\n");
+	fprintf(fid, "\treturn 0;\n}\n");
+
+	if ((fid = run_driver(fid)) == NULL)
+		msg = "Generated source doesn't compile";
+	for (i=0; i<n && msg == NULL; i++) {
+		exp_col = idx[i];
+		exp_sign = 1.0;
+		if (idx[i] > 0 && model->hash_bits > 0)
+			exp_col = gensvm_parse_hash(idx[i], model->hash_bits,
+					model->hash_signed, &exp_sign);
+		if (idx[i] > 0 && model->col_map != NULL)
+			exp_col = gensvm_parse_map_column(exp_col,
+					model->col_map, model->col_map_size);
+		if (idx[i] < 1)
+			exp_col = 0;
+		if (fscanf(fid, "%li %lf", &col, &sign) != 2 ||
+				col != exp_col || sign != exp_sign)
+			msg = "Incorrect column of compiled model";
+	}
+	close_driver(fid);
+
+	return msg;
+}
+
+char *test_codegen_columns()
+{
+	long i, m = 8, K = 3;
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+
+	fixture_model(model, m, K, 0);
+
+	// start test code //
+	model->hash_bits = 3;
+	model->hash_signed = true;
+	msg = check_compiled_columns(model);
+
+	if (msg == NULL) {
+		model->hash_bits = 0;
+		model->hash_signed = false;
+		model->col_map_size = m;
+		model->col_map = Calloc(long, m);
+		for (i=0; i<m; i++)
+			model->col_map[i] = 1 + i*i;
+		msg = check_compiled_columns(model);
+	}
+	// end test code //
+
+	gensvm_free_model(model);
+
+	return msg;
+}
+
+char *test_is_identifier()
+{
+	mu_assert(gensvm_is_identifier("model"), "Valid name rejected");
+	mu_assert(gensvm_is_identifier("_model_2"), "Valid name rejected");
+	mu_assert(!gensvm_is_identifier(""), "Empty name accepted");
+	mu_assert(!gensvm_is_identifier("2model"), "Invalid name accepted");
+	mu_assert(!gensvm_is_identifier("my-model"), "Invalid name accepted");
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_codegen_linear);
+	mu_run_test(test_codegen_linear_loops);
+	mu_run_test(test_codegen_kernel);
+	mu_run_test(test_codegen_columns);
+	mu_run_test(test_is_identifier);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -26,6 +26,8 @@
 
 #include "minunit.h"
 #include "gensvm_consistency.h"
+#include "gensvm_binary.h"
+#include "gensvm_gridsearch.h"
 
 char *test_doublesort()
 {
@@ -124,7 +126,73 @@ char *test_top_queue()
 
 char *test_consistency_repeats()
 {
-	mu_test_missing();
+	int best_id;
+	long i, n = 90, m = 2;
+	char *filename = "./data/test_consistency_repeats.bin";
+	struct GenData *data = gensvm_init_data();
+	struct GenData *train_data = gensvm_init_data();
+	struct GenGrid *grid = gensvm_init_grid();
+	struct GenQueue *q = gensvm_init_queue();
+
+	// write a dataset with three classes to a binary file, such that 
+	// the grid search uses the memory mapped instances
+	data->n = n;
+	data->m = m;
+	data->K = 3;
+	data->y = Malloc(long, n);
+	data->RAW = Malloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		data->y[i] = i % 3 + 1;
+		matrix_set(data->RAW, m+1, i, 0, 1.0);
+		matrix_set(data->RAW, m+1, i, 1, data->y[i] + sin(i));
+		matrix_set(data->RAW, m+1, i, 2, -data->y[i] + cos(3*i));
+	}
+	data->Z = data->RAW;
+	gensvm_write_data_binary(data, filename);
+	gensvm_read_data(train_data, filename);
+
+	grid->kerneltype = K_RBF;
+	grid->folds = 3;
+	grid->Np = 1;
+	grid->Nl = 1;
+	grid->Nk = 1;
+	grid->Ne = 1;
+	grid->Nw = 1;
+	grid->Ng = 2;
+	grid->ps = Calloc(double, grid->Np);
+	grid->ps[0] = 1.0;
+	grid->lambdas = Calloc(double, grid->Nl);
+	grid->lambdas[0] = 0.01;
+	grid->kappas = Calloc(double, grid->Nk);
+	grid->kappas[0] = 0.0;
+	grid->epsilons = Calloc(double, grid->Ne);
+	grid->epsilons[0] = 1e-6;
+	grid->weight_idxs = Calloc(double, grid->Nw);
+	grid->weight_idxs[0] = 1;
+	grid->gammas = Calloc(double, grid->Ng);
+	grid->gammas[0] = 0.5;
+	grid->gammas[1] = 1.0;
+
+	// start test code //
+	gensvm_fill_queue(grid, q, train_data, NULL);
+	srand(123);
+	gensvm_train_queue(q);
+
+	// the model has the dimensions of the kernel rank after the cross 
+	// validation, which shouldn't be used for the full dataset
+	best_id = gensvm_consistency_repeats(q, 2, 0.0);
+	mu_assert(best_id >= 0 && best_id < q->N, "Incorrect best ID");
+	for (i=0; i<q->N; i++)
+		mu_assert(q->tasks[i]->performance >= 0.0 &&
+				q->tasks[i]->performance <= 100.0,
+				"Incorrect performance");
+	// end test code //
+
+	gensvm_free_queue(q);
+	gensvm_free_grid(grid);
+	gensvm_free_data(train_data);
+	gensvm_free_data(data);
+	remove(filename);
 
 	return NULL;
 }
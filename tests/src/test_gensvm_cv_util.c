@@ -262,6 +262,71 @@ char *test_get_tt_split_dense()
 	return NULL;
 }
 
+char *test_get_tt_split_kernel()
+{
+	long i, j;
+	struct GenData *full = gensvm_init_data();
+	full->K = 2;
+	full->n = 6;
+	full->m = 1;
+	full->r = 1;
+
+	full->y = Calloc(long, full->n);
+	full->RAW = Calloc(double, full->n * (full->m+1));
+	full->kernel = Calloc(double, full->n * full->n);
+	for (i=0; i<full->n; i++) {
+		full->y[i] = i % 2 + 1;
+		matrix_set(full->RAW, full->m+1, i, 0, 1.0);
+		matrix_set(full->RAW, full->m+1, i, 1, i);
+		for (j=0; j<full->n; j++)
+			matrix_set(full->kernel, full->n, i, j, 10.0*i + j);
+	}
+	full->Z = full->RAW;
+
+	long *cv_idx = Calloc(long, full->n);
+	cv_idx[0] = 1;
+	cv_idx[1] = 0;
+	cv_idx[2] = 1;
+	cv_idx[3] = 0;
+	cv_idx[4] = 1;
+	cv_idx[5] = 1;
+
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+
+	// start test code //
+	gensvm_get_tt_split(full, train, test, cv_idx, 0);
+
+	mu_assert(train->n == 4, "train_n incorrect.");
+	mu_assert(test->n == 2, "test_n incorrect.");
+
+	long train_idx[4] = {0, 2, 4, 5};
+	long test_idx[2] = {1, 3};
+
+	for (i=0; i<train->n; i++) {
+		for (j=0; j<train->n; j++) {
+			mu_assert(matrix_get(train->kernel, train->n, i, j) ==
+					10.0*train_idx[i] + train_idx[j],
+					"train kernel incorrect.");
+		}
+	}
+	for (i=0; i<test->n; i++) {
+		for (j=0; j<train->n; j++) {
+			mu_assert(matrix_get(test->kernel, train->n, i, j) ==
+					10.0*test_idx[i] + train_idx[j],
+					"test kernel incorrect.");
+		}
+	}
+
+	// end test code //
+	gensvm_free_data(full);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	free(cv_idx);
+
+	return NULL;
+}
+
 char *test_get_tt_split_sparse()
 {
 	struct GenData *full = gensvm_init_data();
@@ -427,6 +492,217 @@ char *test_get_tt_split_sparse()
 	return NULL;
 }
 
+char *test_get_fold_views_dense()
+{
+	long f, i, j, n = 7, m = 2;
+	long cv_idx[7] = {2, 0, 1, 0, 2, 1, 0};
+	long test_idx[3][3] = {{1, 3, 6}, {2, 5, 0}, {0, 4, 0}},
+	     train_idx[3][5] = {{2, 5, 0, 4, 0}, {0, 4, 1, 3, 6},
+		     {1, 3, 6, 2, 5}},
+	     test_n[3] = {3, 2, 2};
+	struct GenFolds *cv = NULL;
+	struct GenData *full = gensvm_init_data();
+	struct GenData *train = NULL;
+	struct GenData *test = NULL;
+
+	full->n = n;
+	full->m = m;
+	full->K = 3;
+	full->y = Malloc(long, n);
+	full->RAW = Malloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		full->y[i] = i % 3 + 1;
+		matrix_set(full->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(full->RAW, m+1, i, j, 10.0*i + j);
+	}
+	full->Z = full->RAW;
+
+	// start test code //
+	cv = gensvm_init_folds(full, cv_idx, 3);
+	mu_assert(cv->start[0] == 0 && cv->start[1] == 3 &&
+			cv->start[2] == 5 && cv->start[3] == 7,
+			"Incorrect start");
+
+	for (f=0; f<3; f++) {
+		train = gensvm_init_data();
+		test = gensvm_init_data();
+		gensvm_get_fold_views(full, cv, f, train, test);
+
+		mu_assert(test->n == test_n[f], "Incorrect test n");
+		mu_assert(train->n == n - test_n[f], "Incorrect train n");
+		mu_assert(train->m == m && test->m == m, "Incorrect m");
+		mu_assert(train->K == 3 && test->K == 3, "Incorrect K");
+		mu_assert(train->view && test->view, "Not a view");
+		mu_assert(train->Z == train->RAW && test->Z == test->RAW,
+				"Z doesn't equal RAW");
+		mu_assert(test->RAW >= cv->RAW && train->RAW >= cv->RAW,
+				"Instances copied");
+
+		for (i=0; i<test->n; i++) {
+			mu_assert(test->y[i] == full->y[test_idx[f][i]],
+					"Incorrect test y");
+			for (j=0; j<m+1; j++)
+				mu_assert(matrix_get(test->Z, m+1, i, j) ==
+						matrix_get(full->RAW, m+1,
+							test_idx[f][i], j),
+						"Incorrect test Z");
+		}
+		for (i=0; i<train->n; i++) {
+			mu_assert(train->y[i] == full->y[train_idx[f][i]],
+					"Incorrect train y");
+			for (j=0; j<m+1; j++)
+				mu_assert(matrix_get(train->Z, m+1, i, j) ==
+						matrix_get(full->RAW, m+1,
+							train_idx[f][i], j),
+						"Incorrect train Z");
+		}
+
+		// the instances belong to the GenFolds
+		gensvm_free_data(train);
+		gensvm_free_data(test);
+	}
+	// end test code //
+
+	gensvm_free_folds(cv);
+	gensvm_free_data(full);
+
+	return NULL;
+}
+
+char *test_get_fold_views_sparse()
+{
+	long f, i, jj, k;
+	double values[5] = {1.5, 2.5, 3.5, 4.5, 5.5};
+	long ia[6] = {0, 1, 1, 3, 4, 5},
+	     ja[5] = {1, 0, 1, 0, 1},
+	     y[5] = {1, 2, 1, 2, 1},
+	     cv_idx[5] = {1, 0, 0, 1, 0};
+	long test_idx[2][3] = {{1, 2, 4}, {0, 3, 0}},
+	     train_idx[2][3] = {{0, 3, 0}, {1, 2, 4}},
+	     test_n[2] = {3, 2};
+	struct GenFolds *cv = NULL;
+	struct GenData *full = gensvm_wrap_csr(5, 2, values, ia, ja, y);
+	struct GenData *train = NULL;
+	struct GenData *test = NULL;
+	struct GenData *view = NULL;
+	long *idx = NULL;
+
+	// start test code //
+	cv = gensvm_init_folds(full, cv_idx, 2);
+	mu_assert(cv->spZ != NULL && cv->RAW == NULL, "Folds not sparse");
+	mu_assert(cv->spZ->n_row == 8, "Incorrect number of rows");
+	mu_assert(cv->spZ->n_col == 3, "Incorrect number of columns");
+
+	for (f=0; f<2; f++) {
+		train = gensvm_init_data();
+		test = gensvm_init_data();
+		gensvm_get_fold_views(full, cv, f, train, test);
+
+		mu_assert(test->n == test_n[f], "Incorrect test n");
+		mu_assert(train->n == 5 - test_n[f], "Incorrect train n");
+		mu_assert(train->Z == NULL && test->Z == NULL,
+				"Dense view of sparse data");
+		mu_assert(!train->wrapped && !test->wrapped,
+				"View is wrapped");
+
+		// each row starts with the column of ones
+		view = test;
+		idx = test_idx[f];
+		while (view != NULL) {
+			mu_assert(view->spZ->ia[0] == 0, "Incorrect ia[0]");
+			mu_assert(view->spZ->nnz == view->spZ->ia[view->n],
+					"Incorrect nnz");
+			for (i=0; i<view->n; i++) {
+				jj = view->spZ->ia[i];
+				mu_assert(view->y[i] == y[idx[i]],
+						"Incorrect y");
+				mu_assert(view->spZ->ja[jj] == 0 &&
+						view->spZ->values[jj] == 1.0,
+						"Incorrect column of ones");
+				mu_assert(view->spZ->ia[i+1] - jj - 1 ==
+						ia[idx[i]+1] - ia[idx[i]],
+						"Incorrect row length");
+				for (k=1; k<view->spZ->ia[i+1] - jj; k++) {
+					mu_assert(view->spZ->ja[jj+k] ==
+							ja[ia[idx[i]]+k-1] + 1,
+							"Incorrect ja");
+					mu_assert(view->spZ->values[jj+k] ==
+							values[ia[idx[i]]+k-1],
+							"Incorrect values");
+				}
+			}
+			view = (view == test) ? train : NULL;
+			idx = train_idx[f];
+		}
+
+		gensvm_free_data(train);
+		gensvm_free_data(test);
+	}
+	// end test code //
+
+	gensvm_free_folds(cv);
+	gensvm_free_data(full);
+
+	return NULL;
+}
+
+char *test_get_fold_views_kernel()
+{
+	long i, j;
+	long cv_idx[6] = {1, 0, 1, 0, 1, 1};
+	long train_idx[4] = {0, 2, 4, 5},
+	     test_idx[2] = {1, 3};
+	struct GenFolds *cv = NULL;
+	struct GenData *full = gensvm_init_data();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+
+	full->K = 2;
+	full->n = 6;
+	full->m = 1;
+	full->y = Calloc(long, full->n);
+	full->RAW = Calloc(double, full->n * (full->m+1));
+	full->kernel = Calloc(double, full->n * full->n);
+	for (i=0; i<full->n; i++) {
+		full->y[i] = i % 2 + 1;
+		matrix_set(full->RAW, full->m+1, i, 0, 1.0);
+		matrix_set(full->RAW, full->m+1, i, 1, i);
+		for (j=0; j<full->n; j++)
+			matrix_set(full->kernel, full->n, i, j, 10.0*i + j);
+	}
+	full->Z = full->RAW;
+
+	// start test code //
+	cv = gensvm_init_folds(full, cv_idx, 2);
+	gensvm_get_fold_views(full, cv, 0, train, test);
+
+	mu_assert(train->n == 4, "train_n incorrect.");
+	mu_assert(test->n == 2, "test_n incorrect.");
+	for (i=0; i<train->n; i++) {
+		for (j=0; j<train->n; j++) {
+			mu_assert(matrix_get(train->kernel, train->n, i, j) ==
+					10.0*train_idx[i] + train_idx[j],
+					"train kernel incorrect.");
+		}
+	}
+	for (i=0; i<test->n; i++) {
+		for (j=0; j<train->n; j++) {
+			mu_assert(matrix_get(test->kernel, train->n, i, j) ==
+					10.0*test_idx[i] + train_idx[j],
+					"test kernel incorrect.");
+		}
+	}
+	// end test code //
+
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_folds(cv);
+	gensvm_free_data(full);
+
+	return NULL;
+}
+
 char *all_tests()
 {
 	mu_suite_start();
@@ -434,6 +710,10 @@ char *all_tests()
 	mu_run_test(test_make_cv_split_2);
 	mu_run_test(test_get_tt_split_dense);
 	mu_run_test(test_get_tt_split_sparse);
+	mu_run_test(test_get_tt_split_kernel);
+	mu_run_test(test_get_fold_views_dense);
+	mu_run_test(test_get_fold_views_sparse);
+	mu_run_test(test_get_fold_views_kernel);
 
 	return NULL;
 }
@@ -0,0 +1,371 @@
+/**
+ * @file test_gensvm_gzip.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_gzip.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "minunit.h"
+#include "gensvm_io.h"
+#include "gensvm_gzip.h"
+
+char *test_read_data_gzip()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	mu_assert(gensvm_is_gzip_data("./data/test_file_read_data.txt.gz"),
+			"Gzip file not recognized");
+	mu_assert(!gensvm_is_gzip_data("./data/test_file_read_data.txt"),
+			"Text file recognized as gzip file");
+	gensvm_read_data(data, "./data/test_file_read_data.txt.gz");
+	gensvm_read_data(text, "./data/test_file_read_data.txt");
+
+	mu_assert(data->n == 5, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->r == 3, "Incorrect r");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->spZ == NULL, "Data read as sparse");
+	mu_assert(data->Z == data->RAW, "Z doesn't equal RAW");
+	for (i=0; i<5*4; i++)
+		mu_assert(data->RAW[i] == text->RAW[i], "Incorrect RAW");
+	for (i=0; i<5; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+
+	return NULL;
+}
+
+char *test_read_data_libsvm_gzip()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	gensvm_read_data_libsvm(data,
+			"./data/test_file_read_data_sparse_libsvm.txt.gz");
+	gensvm_read_data_libsvm(text,
+			"./data/test_file_read_data_sparse_libsvm.txt");
+
+	mu_assert(data->n == 10, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->RAW == NULL, "Data read as dense");
+	mu_assert(data->spZ != NULL, "Data not read as sparse");
+	mu_assert(data->spZ->nnz == text->spZ->nnz, "Incorrect nnz");
+	for (i=0; i<data->spZ->nnz; i++) {
+		mu_assert(data->spZ->values[i] == text->spZ->values[i],
+				"Incorrect values");
+		mu_assert(data->spZ->ja[i] == text->spZ->ja[i],
+				"Incorrect ja");
+	}
+	for (i=0; i<11; i++)
+		mu_assert(data->spZ->ia[i] == text->spZ->ia[i],
+				"Incorrect ia");
+	for (i=0; i<10; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+
+	return NULL;
+}
+
+char *test_read_data_gzip_blocks()
+{
+	long i, j, n = 20000, m = 6;
+	double value;
+	char *filename = "./data/test_read_data_gzip_blocks.txt";
+	char *gzname = "./data/test_read_data_gzip_blocks.txt.gz";
+	FILE *fid = NULL;
+	gzFile gz = NULL;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	// write the file in two gzip members, which span many blocks
+	fid = fopen(filename, "w");
+	gz = gzopen(gzname, "wb");
+	fprintf(fid, "%li %li\n", n, m);
+	gzprintf(gz, "%li %li\n", n, m);
+	for (i=0; i<n; i++) {
+		if (i == n/2) {
+			gzclose(gz);
+			gz = gzopen(gzname, "ab");
+		}
+		for (j=0; j<m; j++) {
+			value = (double) ((i*m + j) % 97) / 7.0;
+			fprintf(fid, "%.6f ", value);
+			gzprintf(gz, "%.6f ", value);
+		}
+		fprintf(fid, "%li\n", i % 3 + 1);
+		gzprintf(gz, "%li\n", i % 3 + 1);
+	}
+	fclose(fid);
+	gzclose(gz);
+
+	gensvm_read_data(data, gzname);
+	gensvm_read_data(text, filename);
+
+	mu_assert(data->n == n, "Incorrect n");
+	mu_assert(data->m == m, "Incorrect m");
+	mu_assert(data->K == 3, "Incorrect K");
+	mu_assert(data->RAW != NULL, "Data read as sparse");
+	for (i=0; i<n*(m+1); i++)
+		mu_assert(data->RAW[i] == text->RAW[i], "Incorrect RAW");
+	for (i=0; i<n; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+	remove(filename);
+	remove(gzname);
+
+	return NULL;
+}
+
+char *test_read_data_gzip_sparse()
+{
+	long i, j, n = 60000, m = 10;
+	char *filename = "./data/test_read_data_gzip_sparse.txt";
+	char *gzname = "./data/test_read_data_gzip_sparse.txt.gz";
+	FILE *fid = NULL;
+	gzFile gz = NULL;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	// a file in the dense format with mostly zeros, over several blocks
+	fid = fopen(filename, "w");
+	gz = gzopen(gzname, "wb");
+	fprintf(fid, "%li %li\n", n, m);
+	gzprintf(gz, "%li %li\n", n, m);
+	for (i=0; i<n; i++) {
+		for (j=0; j<m; j++) {
+			if ((i + j) % 7 == 0) {
+				fprintf(fid, "%.3f ", (double) (i % 13) + 0.5);
+				gzprintf(gz, "%.3f ", (double) (i % 13) + 0.5);
+			} else {
+				fprintf(fid, "0 ");
+				gzprintf(gz, "0 ");
+			}
+		}
+		fprintf(fid, "%li\n", i % 4 + 1);
+		gzprintf(gz, "%li\n", i % 4 + 1);
+	}
+	fclose(fid);
+	gzclose(gz);
+
+	gensvm_read_data(data, gzname);
+	gensvm_read_data(text, filename);
+
+	mu_assert(data->n == n, "Incorrect n");
+	mu_assert(data->m == m, "Incorrect m");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->RAW == NULL, "Data read as dense");
+	mu_assert(data->spZ != NULL, "Data not read as sparse");
+	mu_assert(text->spZ != NULL, "Text data not read as sparse");
+	mu_assert(data->spZ->nnz == text->spZ->nnz, "Incorrect nnz");
+	mu_assert(data->spZ->n_row == n, "Incorrect n_row");
+	mu_assert(data->spZ->n_col == m+1, "Incorrect n_col");
+	for (i=0; i<data->spZ->nnz; i++) {
+		mu_assert(data->spZ->values[i] == text->spZ->values[i],
+				"Incorrect values");
+		mu_assert(data->spZ->ja[i] == text->spZ->ja[i],
+				"Incorrect ja");
+	}
+	for (i=0; i<n+1; i++)
+		mu_assert(data->spZ->ia[i] == text->spZ->ia[i],
+				"Incorrect ia");
+	for (i=0; i<n; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+	remove(filename);
+	remove(gzname);
+
+	return NULL;
+}
+
+char *test_read_data_chunk_gzip()
+{
+	long i, j, k, n_chunk, n_rows, n = 20000, m = 6;
+	double value;
+	char *filename = "./data/test_read_data_chunk_gzip.txt";
+	char *gzname = "./data/test_read_data_chunk_gzip.txt.gz";
+	FILE *fid = NULL;
+	gzFile gz = NULL;
+	struct GenData *text = NULL;
+	struct GenData *chunk = NULL;
+	struct GenDataReader *reader = NULL;
+	int libsvm;
+
+	// start test code //
+	for (libsvm=0; libsvm<2; libsvm++) {
+		// the file spans many blocks, and has blank lines
+		fid = fopen(filename, "w");
+		gz = gzopen(gzname, "wb");
+		if (!libsvm) {
+			fprintf(fid, "%li %li\n", n, m);
+			gzprintf(gz, "%li\n%li\n", n, m);
+		}
+		for (i=0; i<n; i++) {
+			if (i % 1000 == 0) {
+				fprintf(fid, "\n");
+				gzprintf(gz, " \n");
+			}
+			if (libsvm) {
+				fprintf(fid, "%li", i % 3 + 1);
+				gzprintf(gz, "%li", i % 3 + 1);
+			}
+			for (j=0; j<m; j++) {
+				value = (double) ((i*m + j) % 97) / 7.0;
+				if (libsvm) {
+					fprintf(fid, " %li:%.6f", j+1, value);
+					gzprintf(gz, " %li:%.6f", j+1, value);
+				} else {
+					fprintf(fid, "%.6f ", value);
+					gzprintf(gz, "%.6f ", value);
+				}
+			}
+			if (libsvm) {
+				fprintf(fid, "\n");
+				gzprintf(gz, "\n");
+			} else {
+				fprintf(fid, "%li\n", i % 3 + 1);
+				gzprintf(gz, "%li\n", i % 3 + 1);
+			}
+		}
+		fclose(fid);
+		gzclose(gz);
+
+		text = gensvm_init_data();
+		if (libsvm)
+			gensvm_read_data_libsvm(text, filename);
+		else
+			gensvm_read_data(text, filename);
+
+		reader = gensvm_open_data_reader(gzname, libsvm, m, 0, false,
+				NULL);
+		mu_assert(reader->n == n, "Incorrect number of instances");
+		chunk = gensvm_init_data();
+		n_rows = 0;
+		while ((n_chunk = gensvm_read_data_chunk(reader, chunk,
+						777)) > 0) {
+			// only the current block is kept
+			mu_assert(reader->gzip->first ==
+					reader->gzip->last,
+					"Blocks kept in memory");
+			for (i=0; i<n_chunk; i++) {
+				mu_assert(chunk->y[i] == text->y[n_rows+i],
+						"Incorrect y");
+				for (j=0; j<m+1; j++) {
+					if (libsvm) {
+						k = chunk->spZ->ia[i] + j;
+						value = chunk->spZ->values[k];
+						mu_assert(chunk->spZ->ja[k] ==
+								j, "Incorrect "
+								"column");
+					} else {
+						value = matrix_get(chunk->RAW,
+								m+1, i, j);
+					}
+					mu_assert(value == matrix_get(
+								text->RAW,
+								m+1, n_rows+i,
+								j),
+							"Incorrect value");
+				}
+			}
+			n_rows += n_chunk;
+		}
+		mu_assert(n_rows == n, "Not all instances read");
+		mu_assert(reader->has_labels, "Labels not found");
+
+		gensvm_close_data_reader(reader);
+		gensvm_free_data(chunk);
+		gensvm_free_data(text);
+	}
+	// end test code //
+
+	remove(filename);
+	remove(gzname);
+
+	return NULL;
+}
+
+char *test_gzip_read_block()
+{
+	long n_rows = 0;
+	struct GenGzipStream *stream = NULL;
+	struct GenGzipBlock *block = NULL;
+
+	// start test code //
+	stream = gensvm_gzip_open("./data/test_file_read_data.txt.gz");
+	mu_assert(gensvm_gzip_read_block(stream, 1), "No block read");
+	mu_assert(!gensvm_gzip_read_block(stream, 1), "Extra block read");
+	mu_assert(gensvm_gzip_queued(stream) == 1, "Incorrect queued");
+
+	gensvm_gzip_finish(stream);
+	block = gensvm_gzip_take(stream, true);
+	mu_assert(block != NULL, "Block not taken");
+	mu_assert(block->data[block->size-1] == '\n',
+			"Block doesn't end with a newline");
+	n_rows = block->chunk.n_rows;
+	mu_assert(n_rows == 7, "Incorrect number of rows");
+	mu_assert(block->chunk.row_start == 0, "Incorrect row_start");
+	mu_assert(gensvm_gzip_take(stream, true) == NULL,
+			"Block taken after the end");
+	mu_assert(gensvm_gzip_queued(stream) == 0, "Incorrect queued");
+	mu_assert(stream->n_rows == n_rows, "Incorrect n_rows");
+
+	gensvm_gzip_close(stream);
+	// end test code //
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_read_data_gzip);
+	mu_run_test(test_read_data_libsvm_gzip);
+	mu_run_test(test_read_data_gzip_blocks);
+	mu_run_test(test_read_data_gzip_sparse);
+	mu_run_test(test_read_data_chunk_gzip);
+	mu_run_test(test_gzip_read_block);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -27,6 +27,8 @@
 #include "minunit.h"
 #include "gensvm_io.h"
 
+extern FILE *GENSVM_ERROR_FILE;
+
 char *test_gensvm_read_data()
 {
 	char *filename = "./data/test_file_read_data.txt";
@@ -580,6 +582,313 @@ char *test_gensvm_read_data_libsvm_no_label()
 	return NULL;
 }
 
+char *test_gensvm_read_data_libsvm_hash()
+{
+	long i, k, n, col;
+	double sign,
+	       *X = NULL,
+	       *Q = NULL,
+	       *P = NULL,
+	       *C = NULL;
+	char *filename = "./data/test_file_read_data_sparse_libsvm.txt";
+	struct GenData *data = gensvm_init_data();
+	struct GenData *plain = gensvm_init_data();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+
+	// start test code //
+	data->hash_bits = 3;
+	data->hash_signed = true;
+	gensvm_read_data_libsvm(data, filename);
+	gensvm_read_data_libsvm(plain, filename);
+
+	mu_assert(data->n == 10, "Incorrect n");
+	mu_assert(data->m == 8, "Incorrect m");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->spZ != NULL, "Hashed data not sparse");
+	mu_assert(plain->spZ != NULL, "Data not sparse");
+
+	// every feature of a row is added to its hashed column with its sign
+	X = gensvm_sparse_to_dense(data->spZ);
+	Q = gensvm_sparse_to_dense(plain->spZ);
+	P = Calloc(double, 10*9);
+	for (i=0; i<10; i++) {
+		matrix_set(P, 9, i, 0, 1.0);
+		for (k=1; k<4; k++) {
+			col = gensvm_parse_hash(k, 3, true, &sign);
+			matrix_add(P, 9, i, col, sign * matrix_get(Q, 4, i, k));
+		}
+	}
+	for (i=0; i<10*9; i++)
+		mu_assert(X[i] == P[i], "Incorrect hashed value");
+
+	// the chunked reader hashes in the same way
+	reader = gensvm_open_data_reader(filename, true, 8, 3,
+			true, NULL);
+	n = gensvm_read_data_chunk(reader, chunk, 10);
+	mu_assert(n == 10, "Incorrect number of instances in chunk");
+	C = gensvm_sparse_to_dense(chunk->spZ);
+	for (i=0; i<10*9; i++)
+		mu_assert(C[i] == X[i], "Incorrect hashed chunk");
+	// end test code //
+
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(data);
+	gensvm_free_data(plain);
+	gensvm_free_data(chunk);
+	free(X);
+	free(Q);
+	free(P);
+	free(C);
+
+	return NULL;
+}
+
+char *test_gensvm_read_data_libsvm_compact()
+{
+	long i, n;
+	double *X = NULL,
+	       *C = NULL;
+	char *train_file = "./data/test_read_data_libsvm_compact.txt";
+	char *test_file = "./data/test_read_data_libsvm_compact_test.txt";
+	FILE *fid = NULL;
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+	double expect_train[] = {
+		1.0, 1.5, 0.0, 2.0,
+		1.0, 0.0, -1.0, 0.0,
+		1.0, 0.5, 3.0, 0.0};
+	double expect_test[] = {
+		1.0, 1.0, 0.0, 2.0,
+		1.0, 0.0, 0.0, 0.0};
+
+	fid = fopen(train_file, "w");
+	fprintf(fid, "1 5:1.5 1000000:2.0\n");
+	fprintf(fid, "2 70:-1.0\n");
+	fprintf(fid, "1 5:0.5 70:3.0\n");
+	fclose(fid);
+	fid = fopen(test_file, "w");
+	fprintf(fid, "2 5:1.0 6:4.0 1000000:2.0\n");
+	fprintf(fid, "1 2000000:1.0\n");
+	fclose(fid);
+
+	// start test code //
+	train->compact = true;
+	gensvm_read_data_libsvm(train, train_file);
+	mu_assert(train->n == 3, "Incorrect n");
+	mu_assert(train->m == 3, "Incorrect m");
+	mu_assert(train->col_map_size == 3, "Incorrect col_map_size");
+	mu_assert(train->col_map[0] == 5 && train->col_map[1] == 70 &&
+			train->col_map[2] == 1000000, "Incorrect col_map");
+	X = (train->spZ != NULL) ? gensvm_sparse_to_dense(train->spZ) :
+		train->RAW;
+	for (i=0; i<3*4; i++)
+		mu_assert(X[i] == expect_train[i], "Incorrect train data");
+
+	// the test data is read with the map of the training data
+	test->col_map_size = train->col_map_size;
+	test->col_map = Malloc(long, train->col_map_size);
+	memcpy(test->col_map, train->col_map, 3*sizeof(long));
+	gensvm_read_data_libsvm(test, test_file);
+	mu_assert(test->n == 2, "Incorrect test n");
+	mu_assert(test->m == 3, "Incorrect test m");
+	if (test->spZ != NULL)
+		C = gensvm_sparse_to_dense(test->spZ);
+	for (i=0; i<2*4; i++)
+		mu_assert(((C != NULL) ? C : test->RAW)[i] == expect_test[i],
+				"Incorrect test data");
+	free(C);
+
+	// the chunked reader uses the map in the same way
+	reader = gensvm_open_data_reader(test_file, true, 3, 0, false,
+			train->col_map);
+	n = gensvm_read_data_chunk(reader, chunk, 2);
+	mu_assert(n == 2, "Incorrect number of instances in chunk");
+	C = gensvm_sparse_to_dense(chunk->spZ);
+	for (i=0; i<2*4; i++)
+		mu_assert(C[i] == expect_test[i], "Incorrect chunk");
+	// end test code //
+
+	if (train->spZ != NULL)
+		free(X);
+	free(C);
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(chunk);
+	remove(train_file);
+	remove(test_file);
+
+	return NULL;
+}
+
+char *test_gensvm_read_data_chunk()
+{
+	long i, j, n, total = 0;
+	char *filename = "./data/test_file_read_data.txt";
+	struct GenData *data = gensvm_init_data();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+
+	gensvm_read_data(data, filename);
+
+	// start test code //
+	reader = gensvm_open_data_reader(filename, false, 3, 0,
+			false, NULL);
+	mu_assert(reader->n == 5, "Incorrect number of instances");
+
+	while ((n = gensvm_read_data_chunk(reader, chunk, 2)) > 0) {
+		mu_assert(n == ((total < 4) ? 2 : 1),
+				"Incorrect chunk size");
+		mu_assert(chunk->n == n, "Incorrect value for n");
+		mu_assert(chunk->m == 3, "Incorrect value for m");
+		mu_assert(chunk->Z == chunk->RAW, "Z doesn't equal RAW");
+		mu_assert(chunk->y != NULL, "Labels not read");
+		for (i=0; i<n; i++) {
+			for (j=0; j<4; j++)
+				mu_assert(matrix_get(chunk->RAW, 4, i, j) ==
+					matrix_get(data->RAW, 4, total+i, j),
+					"Incorrect value in chunk");
+			mu_assert(chunk->y[i] == data->y[total+i],
+					"Incorrect label in chunk");
+		}
+		total += n;
+	}
+	mu_assert(total == 5, "Incorrect number of instances read");
+	mu_assert(gensvm_read_data_chunk(reader, chunk, 2) == 0,
+			"Read beyond the end of the file");
+	// end test code //
+
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
+char *test_gensvm_read_data_chunk_libsvm()
+{
+	long i, jj, n;
+	double *row = Calloc(double, 4);
+	char *filename = "./data/test_file_read_data_libsvm.txt";
+	char *blank_file = "./data/test_read_data_chunk_blank.txt";
+	FILE *fid = NULL;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *chunk = gensvm_init_data();
+	struct GenDataReader *reader = NULL;
+
+	gensvm_read_data(data, "./data/test_file_read_data.txt");
+
+	// start test code //
+	reader = gensvm_open_data_reader(filename, true, 3, 0,
+			false, NULL);
+	mu_assert(reader->n == 5, "Incorrect number of instances");
+
+	n = gensvm_read_data_chunk(reader, chunk, 3);
+	mu_assert(n == 3, "Incorrect size of first chunk");
+	n = gensvm_read_data_chunk(reader, chunk, 3);
+	mu_assert(n == 2, "Incorrect size of second chunk");
+	mu_assert(chunk->Z == NULL, "Sparse chunk has dense data");
+	mu_assert(chunk->spZ->n_row == 2, "Incorrect number of rows");
+	mu_assert(chunk->spZ->n_col == 4, "Incorrect number of columns");
+	mu_assert(chunk->spZ->nnz == 8, "Incorrect number of nonzeros");
+	for (i=0; i<n; i++) {
+		for (jj=chunk->spZ->ia[i]; jj<chunk->spZ->ia[i+1]; jj++)
+			row[chunk->spZ->ja[jj]] = chunk->spZ->values[jj];
+		mu_assert(row[0] == 1.0, "Column of ones missing");
+		mu_assert(row[1] == matrix_get(data->RAW, 4, 3+i, 1),
+				"Incorrect value at column 1");
+		mu_assert(row[2] == matrix_get(data->RAW, 4, 3+i, 2),
+				"Incorrect value at column 2");
+		mu_assert(row[3] == matrix_get(data->RAW, 4, 3+i, 3),
+				"Incorrect value at column 3");
+		mu_assert(chunk->y[i] == data->y[3+i], "Incorrect label");
+	}
+	mu_assert(gensvm_read_data_chunk(reader, chunk, 3) == 0,
+			"Read beyond the end of the file");
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+
+	// a file with empty rows and rows with only a label
+	chunk = gensvm_init_data();
+	reader = gensvm_open_data_reader(
+			"./data/test_file_read_data_sparse_libsvm.txt", true,
+			3, 0, false, NULL);
+	mu_assert(reader->n == 10, "Incorrect number of instances");
+	n = gensvm_read_data_chunk(reader, chunk, 3);
+	mu_assert(n == 3, "Incorrect size of chunk");
+	mu_assert(chunk->spZ->nnz == 5, "Incorrect number of nonzeros");
+	mu_assert(chunk->spZ->ia[3] - chunk->spZ->ia[2] == 1,
+			"Incorrect number of nonzeros in empty row");
+	mu_assert(chunk->y[2] == 3, "Incorrect label of empty row");
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+
+	// blank lines aren't instances, as in gensvm_read_data_libsvm()
+	fid = fopen(blank_file, "w");
+	fprintf(fid, "1 1:0.5 3:1.5\n\n2 2:2.5\n  \n3 1:3.5\n\n");
+	fclose(fid);
+	chunk = gensvm_init_data();
+	reader = gensvm_open_data_reader(blank_file, true, 3, 0, false,
+			NULL);
+	mu_assert(reader->n == 3, "Blank lines counted as instances");
+	n = gensvm_read_data_chunk(reader, chunk, 2);
+	mu_assert(n == 2, "Incorrect size of chunk with blank lines");
+	mu_assert(chunk->y[1] == 2, "Incorrect label after blank line");
+	n = gensvm_read_data_chunk(reader, chunk, 2);
+	mu_assert(n == 1, "Incorrect size of last chunk");
+	mu_assert(chunk->y[0] == 3, "Incorrect label of last instance");
+	mu_assert(chunk->spZ->values[1] == 3.5, "Incorrect last value");
+	mu_assert(gensvm_read_data_chunk(reader, chunk, 2) == 0,
+			"Read beyond the end of the file");
+	// end test code //
+
+	gensvm_close_data_reader(reader);
+	gensvm_free_data(chunk);
+	gensvm_free_data(data);
+	free(row);
+	remove(blank_file);
+
+	return NULL;
+}
+
+char *test_gensvm_read_kernel()
+{
+	struct GenData *data = gensvm_init_data();
+	char *filename = "./data/test_kernel_file.bin";
+	data->n = 3;
+
+	// start test code //
+	gensvm_read_kernel(data, filename, 3);
+
+	mu_assert(data->kernel != NULL, "Kernel not read");
+	mu_assert(matrix_get(data->kernel, 3, 0, 0) == 1.0,
+			"Incorrect kernel element at 0, 0");
+	mu_assert(matrix_get(data->kernel, 3, 0, 1) == 0.5,
+			"Incorrect kernel element at 0, 1");
+	mu_assert(matrix_get(data->kernel, 3, 0, 2) == 0.25,
+			"Incorrect kernel element at 0, 2");
+	mu_assert(matrix_get(data->kernel, 3, 1, 0) == 0.5,
+			"Incorrect kernel element at 1, 0");
+	mu_assert(matrix_get(data->kernel, 3, 1, 1) == 1.0,
+			"Incorrect kernel element at 1, 1");
+	mu_assert(matrix_get(data->kernel, 3, 1, 2) == 0.125,
+			"Incorrect kernel element at 1, 2");
+	mu_assert(matrix_get(data->kernel, 3, 2, 0) == 0.25,
+			"Incorrect kernel element at 2, 0");
+	mu_assert(matrix_get(data->kernel, 3, 2, 1) == 0.125,
+			"Incorrect kernel element at 2, 1");
+	mu_assert(matrix_get(data->kernel, 3, 2, 2) == 1.0,
+			"Incorrect kernel element at 2, 2");
+	// end test code //
+
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
 char *test_gensvm_read_model()
 {
 	struct GenModel *model = gensvm_init_model();
@@ -623,6 +932,83 @@ char *test_gensvm_read_model()
 	return NULL;
 }
 
+/**
+ * Write the first len bytes of a file to another file.
+ */
+void copy_prefix(char *filename, char *prefix_filename, long len)
+{
+	char buffer[4096];
+	FILE *in = fopen(filename, "r"),
+	     *out = fopen(prefix_filename, "w");
+
+	len = fread(buffer, 1, len, in);
+	fwrite(buffer, 1, len, out);
+	fclose(in);
+	fclose(out);
+}
+
+char *test_gensvm_try_read_model_invalid()
+{
+	long len, size, last;
+	struct GenModel *model = NULL;
+	char *filenames[2] = {"./data/test_read_model.txt",
+		"./data/test_read_model_kernel_old.txt"},
+	     *prefix = "./data/test_try_read_model.txt";
+	FILE *fid = NULL,
+	     *error_file = GENSVM_ERROR_FILE;
+	int f;
+
+	// start test code //
+	GENSVM_ERROR_FILE = NULL;
+
+	// a model file that is cut off gives an error, up to the last line
+	// of the linear model, which may be cut off within a number
+	for (f=0; f<2; f++) {
+		fid = fopen(filenames[f], "r");
+		fseek(fid, 0, SEEK_END);
+		size = ftell(fid);
+		fclose(fid);
+		last = (f == 0) ? size - 15 : 0;
+		for (len=0; len<size; len++) {
+			copy_prefix(filenames[f], prefix, len);
+			model = gensvm_init_model();
+			mu_assert(!gensvm_try_read_model(model, prefix) ||
+					len >= last, "Incomplete file read");
+			gensvm_free_model(model);
+		}
+		model = gensvm_init_model();
+		mu_assert(gensvm_try_read_model(model, filenames[f]),
+				"Complete file not read");
+		gensvm_free_model(model);
+	}
+
+	// dimensions that don't fit in the file give an error before memory
+	// is allocated for them
+	fid = fopen(prefix, "w");
+	fprintf(fid, "Output file for GenSVM\nGenerated on:\n\nModel:\n"
+			"p = 1\nlambda = 1\nkappa = 0\nepsilon = 1e-6\n"
+			"weight_idx = 1\n\nData:\nfilename = data.txt\n"
+			"n = 10\nm = 1000000000000\nK = 3\n\nOutput:\n"
+			"1 2\n");
+	fclose(fid);
+	model = gensvm_init_model();
+	mu_assert(!gensvm_try_read_model(model, prefix),
+			"Invalid dimensions read");
+	gensvm_free_model(model);
+
+	// a missing file gives an error
+	remove(prefix);
+	model = gensvm_init_model();
+	mu_assert(!gensvm_try_read_model(model, prefix),
+			"Missing file read");
+	gensvm_free_model(model);
+
+	GENSVM_ERROR_FILE = error_file;
+	// end test code //
+
+	return NULL;
+}
+
 char *test_gensvm_write_model()
 {
 	struct GenModel *model = gensvm_init_model();
@@ -688,6 +1074,26 @@ char *test_gensvm_write_model()
 	mu_assert(strcmp(buffer, "weight_idx = 1\n") == 0,
 		       	"Line doesn't contain expected content (7).\n");
 
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "kerneltype = 0\n") == 0,
+		       	"Line doesn't contain expected content (7a).\n");
+
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "gamma = 1.0000000000000000\n") == 0,
+		       	"Line doesn't contain expected content (7b).\n");
+
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "coef = 0.0000000000000000\n") == 0,
+		       	"Line doesn't contain expected content (7c).\n");
+
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "degree = 2.0000000000000000\n") == 0,
+		       	"Line doesn't contain expected content (7d).\n");
+
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "kernel_eigen_cutoff = 1e-08\n") == 0,
+		       	"Line doesn't contain expected content (7e).\n");
+
 	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
 	mu_assert(strcmp(buffer, "\n") == 0,
 		       	"Line doesn't contain expected content (8).\n");
@@ -741,6 +1147,128 @@ char *test_gensvm_write_model()
 	return NULL;
 }
 
+char *test_gensvm_write_read_model_kernel()
+{
+	long i, j;
+	struct GenModel *model = gensvm_init_model();
+	struct GenModel *read = gensvm_init_model();
+	struct GenData *basis = gensvm_init_data();
+	char *filename = "./data/test_write_model_kernel.txt";
+
+	model->p = 1.5;
+	model->lambda = 0.125;
+	model->kappa = 0.5;
+	model->epsilon = 1e-6;
+	model->weight_idx = 2;
+	model->kerneltype = K_RBF;
+	model->gamma = 0.75;
+	model->data_file = strdup("./data/test_file_read_data.txt");
+	model->n = 4;
+	model->m = 2;
+	model->K = 3;
+	model->hash_bits = 1;
+	model->col_map_size = 3;
+	model->col_map = Malloc(long, 3);
+	for (i=0; i<3; i++)
+		model->col_map[i] = 5*i*i + 1;
+
+	model->V = Calloc(double, (model->m+1)*(model->K-1));
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		model->V[i] = 0.1 * (i + 1) - 0.25;
+
+	basis->n = 4;
+	basis->m = 3;
+	basis->r = 2;
+	basis->RAW = Calloc(double, basis->n*(basis->m+1));
+	for (i=0; i<basis->n; i++) {
+		matrix_set(basis->RAW, basis->m+1, i, 0, 1.0);
+		matrix_set(basis->RAW, basis->m+1, i, 1, 0.3 * i - 0.1);
+		matrix_set(basis->RAW, basis->m+1, i, 3, 1.0/(i + 3.0));
+	}
+	model->W = Calloc(double, basis->n*(model->K-1));
+	for (i=0; i<basis->n; i++)
+		for (j=0; j<model->K-1; j++)
+			matrix_set(model->W, model->K-1, i, j,
+					1.0/(i + 7.0*j + 1.0));
+	model->basis = basis;
+
+	// start test code //
+	gensvm_write_model(model, filename);
+	gensvm_read_model(read, filename);
+
+	mu_assert(read->kerneltype == K_RBF, "Incorrect kerneltype");
+	mu_assert(read->gamma == 0.75, "Incorrect gamma");
+	mu_assert(read->weight_idx == 2, "Incorrect weight_idx");
+	mu_assert(read->hash_bits == 1, "Incorrect hash_bits");
+	mu_assert(!read->hash_signed, "Incorrect hash_signed");
+	mu_assert(read->col_map_size == 3, "Incorrect col_map_size");
+	for (i=0; i<3; i++)
+		mu_assert(read->col_map[i] == 5*i*i + 1, "Incorrect col_map");
+	mu_assert(read->U != NULL, "Simplex matrix not generated");
+	for (i=0; i<(model->m+1)*(model->K-1); i++)
+		mu_assert(fabs(read->V[i] - model->V[i]) < 1e-15,
+				"Incorrect V");
+
+	mu_assert(read->basis != NULL, "Basis not read");
+	mu_assert(read->basis->n == 4, "Incorrect basis n");
+	mu_assert(read->basis->m == 3, "Incorrect basis m");
+	mu_assert(read->basis->kerneltype == K_RBF, "Incorrect basis kernel");
+	mu_assert(read->basis->gamma == 0.75, "Incorrect basis gamma");
+	mu_assert(read->W != NULL, "Coefficients not read");
+	for (i=0; i<basis->n*(model->K-1); i++)
+		mu_assert(read->W[i] == model->W[i], "Incorrect coefficients");
+	mu_assert(read->basis->RAW != NULL, "Instances not read as dense");
+	for (i=0; i<basis->n*(basis->m+1); i++)
+		mu_assert(read->basis->RAW[i] == basis->RAW[i],
+				"Incorrect instances");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(read);
+
+	return NULL;
+}
+
+char *test_gensvm_read_model_kernel_old()
+{
+	long i, j, k;
+	double value,
+	       Sigma[2] = {2.0, 0.5},
+	       M[6] = {0.5, -0.25, 1.0, 0.125, -0.5, 0.75};
+	struct GenModel *model = gensvm_init_model();
+	char *filename = "./data/test_read_model_kernel_old.txt";
+
+	// start test code //
+	gensvm_read_model(model, filename);
+
+	mu_assert(model->kerneltype == K_RBF, "Incorrect kerneltype");
+	mu_assert(model->m == 2, "Incorrect m");
+	mu_assert(model->basis != NULL, "Basis not read");
+	mu_assert(model->basis->n == 3, "Incorrect basis n");
+	mu_assert(model->basis->RAW != NULL, "Instances not read");
+	mu_assert(model->basis->Z == NULL, "Training factor not freed");
+	mu_assert(model->W != NULL, "Coefficients not computed");
+
+	// W = M * Sigma^{-2} * V[1:]
+	for (i=0; i<3; i++) {
+		for (j=0; j<model->K-1; j++) {
+			value = 0;
+			for (k=0; k<2; k++)
+				value += M[i*2 + k] / (Sigma[k] * Sigma[k]) *
+					matrix_get(model->V, model->K-1, k+1,
+							j);
+			mu_assert(fabs(matrix_get(model->W, model->K-1, i, j) -
+						value) < 1e-14,
+					"Incorrect coefficients");
+		}
+	}
+	// end test code //
+
+	gensvm_free_model(model);
+
+	return NULL;
+}
+
 char *test_gensvm_write_predictions()
 {
 	int n = 5,
@@ -837,6 +1365,75 @@ char *test_gensvm_write_predictions()
 	return NULL;
 }
 
+char *test_gensvm_write_predictions_chunk()
+{
+	long i, n = 3, K = 3,
+	     predy[3] = {3, 1, 12};
+	int32_t labels[3];
+	double scores[9] = {-0.5, 0.25, 0.75, 1.0, -1.0, 0.0, 0.125, -0.125,
+		2.0};
+	char buffer[GENSVM_MAX_LINE_LENGTH];
+	char *filename = "./data/test_write_predictions_chunk.txt";
+	FILE *fid = NULL;
+	struct GenWriter *writer = NULL;
+	struct GenData *data = gensvm_init_data();
+
+	data->n = n;
+	data->m = 2;
+
+	// start test code //
+	writer = gensvm_writer_open(filename);
+	gensvm_write_predictions_header(writer, n, 2, P_LABELS);
+	gensvm_write_predictions_chunk(writer, data, predy, NULL, K,
+			P_LABELS);
+	gensvm_writer_close(writer);
+
+	fid = fopen(filename, "r");
+	for (i=0; i<n; i++) {
+		fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+		mu_assert(atol(buffer) == predy[i], "Incorrect label");
+	}
+	mu_assert(fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid) == NULL,
+			"Too many lines");
+	fclose(fid);
+
+	writer = gensvm_writer_open(filename);
+	gensvm_write_predictions_chunk(writer, data, predy, scores, K,
+			P_SCORES);
+	gensvm_writer_close(writer);
+
+	fid = fopen(filename, "r");
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "3 -0.50000000 0.25000000 0.75000000\n") == 0,
+			"Incorrect line with scores (1)");
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "1 1.00000000 -1.00000000 0.00000000\n") == 0,
+			"Incorrect line with scores (2)");
+	fgets(buffer, GENSVM_MAX_LINE_LENGTH, fid);
+	mu_assert(strcmp(buffer, "12 0.12500000 -0.12500000 2.00000000\n")
+			== 0, "Incorrect line with scores (3)");
+	fclose(fid);
+
+	writer = gensvm_writer_open(filename);
+	gensvm_write_predictions_header(writer, n, 2, P_BINARY);
+	gensvm_write_predictions_chunk(writer, data, predy, NULL, K,
+			P_BINARY);
+	gensvm_writer_close(writer);
+
+	fid = fopen(filename, "rb");
+	mu_assert(fread(labels, sizeof(int32_t), 4, fid) == 3,
+			"Incorrect size of binary file");
+	fclose(fid);
+	for (i=0; i<n; i++)
+		mu_assert(labels[i] == predy[i], "Incorrect binary label");
+	// end test code //
+
+	remove(filename);
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
 char *test_gensvm_time_string()
 {
 	// not sure how to unit test this function.
@@ -855,10 +1452,19 @@ char *all_tests()
 	mu_run_test(test_gensvm_read_data_libsvm_0based);
 	mu_run_test(test_gensvm_read_data_libsvm_sparse);
 	mu_run_test(test_gensvm_read_data_libsvm_no_label);
+	mu_run_test(test_gensvm_read_data_libsvm_hash);
+	mu_run_test(test_gensvm_read_data_libsvm_compact);
+	mu_run_test(test_gensvm_read_data_chunk);
+	mu_run_test(test_gensvm_read_data_chunk_libsvm);
+	mu_run_test(test_gensvm_read_kernel);
 
 	mu_run_test(test_gensvm_read_model);
+	mu_run_test(test_gensvm_try_read_model_invalid);
 	mu_run_test(test_gensvm_write_model);
+	mu_run_test(test_gensvm_write_read_model_kernel);
+	mu_run_test(test_gensvm_read_model_kernel_old);
 	mu_run_test(test_gensvm_write_predictions);
+	mu_run_test(test_gensvm_write_predictions_chunk);
 	mu_run_test(test_gensvm_time_string);
 
 	return NULL;
@@ -1103,6 +1103,278 @@ char *test_kernel_postprocess_kernel()
 	return NULL;
 }
 
+char *test_kernel_postprocess_blocks()
+{
+	long i, j, n = 20, n_test = 600, m = 3;
+	double eps = 1e-12, *K2 = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *full_test = gensvm_init_data();
+
+	train->n = n;
+	test->n = full_test->n = n_test;
+	train->m = test->m = full_test->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	test->RAW = Calloc(double, n_test*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(train->RAW, m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	for (i=0; i<n_test; i++) {
+		matrix_set(test->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(test->RAW, m+1, i, j,
+					((double) ((5*i + 2*j) % 13))/13.0);
+	}
+	train->Z = train->RAW;
+	test->Z = test->RAW;
+	full_test->RAW = test->RAW;
+
+	model->kerneltype = K_POLY;
+	model->gamma = 0.8;
+	model->coef = 1.2;
+	model->degree = 2.0;
+	gensvm_kernel_preprocess(model, train);
+
+	// reference: the full cross kernel matrix
+	K2 = gensvm_kernel_cross(model, train, test);
+	gensvm_kernel_testfactor(full_test, train, K2);
+
+	// start test code //
+	gensvm_kernel_postprocess(model, train, test);
+	mu_assert(test->r == train->r, "Incorrect r");
+	for (i=0; i<n_test; i++) {
+		for (j=0; j<test->r+1; j++) {
+			mu_assert(fabs(matrix_get(test->Z, test->r+1, i, j) -
+					matrix_get(full_test->Z,
+						full_test->r+1, i, j)) < eps,
+					"Incorrect testfactor element");
+		}
+	}
+	// end test code //
+
+	free(K2);
+	full_test->RAW = NULL;
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(full_test);
+
+	return NULL;
+}
+
+char *test_kernel_calculate_ZV()
+{
+	long i, j, n = 20, n_test = 600, m = 3, K = 3;
+	double value, eps = 1e-10, *ZV = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *ref_test = gensvm_init_data();
+
+	train->n = n;
+	test->n = ref_test->n = n_test;
+	train->m = test->m = ref_test->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	test->RAW = Calloc(double, n_test*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(train->RAW, m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	for (i=0; i<n_test; i++) {
+		matrix_set(test->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(test->RAW, m+1, i, j,
+					((double) ((5*i + 2*j) % 13))/13.0);
+	}
+	train->Z = train->RAW;
+	test->Z = test->RAW;
+	ref_test->RAW = test->RAW;
+	ref_test->Z = test->RAW;
+
+	model->kerneltype = K_RBF;
+	model->gamma = 0.8;
+	model->K = K;
+	gensvm_kernel_preprocess(model, train);
+	model->m = train->r;
+	model->V = Calloc(double, (model->m+1)*(K-1));
+	for (i=0; i<(model->m+1)*(K-1); i++)
+		model->V[i] = ((double) ((3*i) % 7))/7.0 - 0.5;
+
+	// reference: the test factor multiplied with V
+	gensvm_kernel_postprocess(model, train, ref_test);
+
+	// start test code //
+	gensvm_kernel_store_basis(model, train);
+	mu_assert(model->W != NULL, "W not computed");
+	mu_assert(model->basis->Z == NULL, "Training factor stored");
+
+	ZV = Calloc(double, n_test*(K-1));
+	gensvm_kernel_calculate_ZV(model, test, ZV);
+	for (i=0; i<n_test; i++) {
+		for (j=0; j<K-1; j++) {
+			value = cblas_ddot(model->m+1, &ref_test->Z[i*(model->m+1)],
+					1, &model->V[j], K-1);
+			mu_assert(fabs(matrix_get(ZV, K-1, i, j) - value) < eps,
+					"Incorrect ZV element");
+		}
+	}
+	// end test code //
+
+	free(ZV);
+	ref_test->RAW = NULL;
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(ref_test);
+
+	return NULL;
+}
+
+char *test_kernel_prune_basis()
+{
+	long i, j, k, n = 10, m = 3, K = 3, s;
+	double value, *KS = NULL,
+	       *T = NULL,
+	       *R = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+
+	train->n = n;
+	train->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(train->RAW, m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	train->Z = train->RAW;
+
+	model->kerneltype = K_RBF;
+	model->gamma = 2.0;
+	model->n = n;
+	model->m = m;
+	model->K = K;
+	gensvm_allocate_model(model);
+	gensvm_kernel_preprocess(model, train);
+	gensvm_reallocate_model(model, n, train->r);
+	for (i=0; i<(model->m+1)*(K-1); i++)
+		model->V[i] = ((double) ((3*i) % 7))/7.0 - 0.5;
+
+	// instances 2 and 5 are not support vectors
+	for (i=0; i<n; i++)
+		for (j=0; j<K; j++)
+			matrix_set(model->Q, K, i, j, (i == 2 || i == 5) ?
+					2.0 : 0.5);
+
+	// start test code //
+	model->basis_tol = 1.0;
+	gensvm_kernel_store_basis(model, train);
+	s = model->basis->n;
+	mu_assert(s == n - 2, "Incorrect number of basis instances");
+	mu_assert(model->basis->RAW[1*(m+1) + 1] == train->RAW[1*(m+1) + 1],
+			"Incorrect basis instance");
+	mu_assert(model->basis->RAW[2*(m+1) + 1] == train->RAW[3*(m+1) + 1],
+			"Incorrect basis instance");
+
+	// the refitted coefficients satisfy the normal equations 
+	// K_S' (K_S W_S - M W) = 0
+	KS = gensvm_kernel_cross(model, model->basis, train);
+	T = Calloc(double, n*(K-1));
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, K-1,
+			train->r, 1.0, train->Z + 1, train->r+1,
+			model->V + (K-1), K-1, 0.0, T, K-1);
+	R = Calloc(double, n*(K-1));
+	cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, K-1, s,
+			1.0, KS, s, model->W, K-1, 0.0, R, K-1);
+	for (i=0; i<n*(K-1); i++)
+		R[i] -= T[i];
+	for (j=0; j<s; j++) {
+		for (k=0; k<K-1; k++) {
+			value = 0;
+			for (i=0; i<n; i++)
+				value += matrix_get(KS, s, i, j) *
+					matrix_get(R, K-1, i, k);
+			mu_assert(fabs(value) < 1e-10,
+					"Normal equations not satisfied");
+		}
+	}
+	// end test code //
+
+	free(KS);
+	free(T);
+	free(R);
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+
+	return NULL;
+}
+
+char *test_kernel_prune_basis_empty()
+{
+	long i, j, n = 10, m = 3, K = 3, i_max = 0;
+	double norm, max_norm = 0.0;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+
+	train->n = n;
+	train->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(train->RAW, m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	train->Z = train->RAW;
+
+	model->kerneltype = K_RBF;
+	model->gamma = 2.0;
+	model->n = n;
+	model->m = m;
+	model->K = K;
+	gensvm_allocate_model(model);
+	gensvm_kernel_preprocess(model, train);
+	gensvm_reallocate_model(model, n, train->r);
+	for (i=0; i<(model->m+1)*(K-1); i++)
+		model->V[i] = ((double) ((3*i) % 7))/7.0 - 0.5;
+
+	// there are no support vectors
+	for (i=0; i<n*K; i++)
+		model->Q[i] = 2.0;
+
+	gensvm_kernel_store_basis(model, train);
+	for (i=0; i<n; i++) {
+		norm = cblas_dnrm2(K-1, &model->W[i*(K-1)], 1);
+		if (norm > max_norm) {
+			max_norm = norm;
+			i_max = i;
+		}
+	}
+
+	// start test code //
+	model->basis_tol = 1.0;
+	gensvm_kernel_prune_basis(model, train);
+	mu_assert(model->basis->n == 1, "Incorrect number of basis instances");
+	for (j=0; j<m+1; j++)
+		mu_assert(model->basis->RAW[j] == train->RAW[i_max*(m+1) + j],
+				"Instance with the largest norm not kept");
+	for (j=0; j<K-1; j++)
+		mu_assert(isfinite(model->W[j]), "Invalid coefficients");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+
+	return NULL;
+}
+
 char *test_kernel_compute_rbf()
 {
 	struct GenModel *model = gensvm_init_model();
@@ -2581,6 +2853,192 @@ char *test_kernel_eigendecomp()
 	return NULL;
 }
 
+char *test_kernel_compute_packed()
+{
+	long i, j;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *data = gensvm_init_data();
+
+	data->n = 10;
+	data->m = 3;
+	data->RAW = Calloc(double, data->n * (data->m + 1));
+	for (i=0; i<data->n; i++) {
+		matrix_set(data->RAW, data->m+1, i, 0, 1.0);
+		for (j=1; j<data->m+1; j++)
+			matrix_set(data->RAW, data->m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+
+	model->kerneltype = K_POLY;
+	model->gamma = 1.5;
+	model->coef = 3.0;
+	model->degree = 1.78;
+
+	double *K = Calloc(double, data->n * data->n);
+	double *Kp = Calloc(double, data->n * (data->n + 1)/2);
+
+	// start test code //
+	gensvm_kernel_compute(model, data, K);
+	gensvm_kernel_compute_packed(model, data, Kp);
+
+	for (j=0; j<data->n; j++) {
+		for (i=0; i<=j; i++) {
+			mu_assert(Kp[i + j*(j+1)/2] ==
+					matrix_get(K, data->n, i, j),
+					"Incorrect packed kernel element");
+		}
+	}
+	// end test code //
+
+	free(K);
+	free(Kp);
+	gensvm_free_model(model);
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
+char *test_kernel_precomputed()
+{
+	long i, j, n = 10, n_test = 5, m = 3;
+	double eps = 1e-13;
+	struct GenModel *model = gensvm_init_model();
+	struct GenModel *pre_model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *pre_train = gensvm_init_data();
+	struct GenData *pre_test = gensvm_init_data();
+
+	train->n = pre_train->n = n;
+	test->n = pre_test->n = n_test;
+	train->m = pre_train->m = test->m = pre_test->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	test->RAW = Calloc(double, n_test*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(train->RAW, m+1, i, j,
+					((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	for (i=0; i<n_test; i++) {
+		matrix_set(test->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(test->RAW, m+1, i, j,
+					((double) ((5*i + 2*j) % 7))/7.0);
+	}
+	train->Z = train->RAW;
+	test->Z = test->RAW;
+
+	model->kerneltype = K_RBF;
+	model->gamma = 0.348;
+	pre_model->kerneltype = K_PRECOMPUTED;
+
+	// the precomputed kernels are the kernels of the RBF model
+	pre_train->kernel = Calloc(double, n*n);
+	gensvm_kernel_compute(model, train, pre_train->kernel);
+	pre_test->kernel = gensvm_kernel_cross(model, train, test);
+
+	// start test code //
+	gensvm_kernel_preprocess(model, train);
+	gensvm_kernel_preprocess(pre_model, pre_train);
+	mu_assert(train->r == pre_train->r, "Incorrect r");
+	mu_assert(pre_train->kerneltype == K_PRECOMPUTED,
+			"Incorrect kerneltype");
+	for (i=0; i<n; i++) {
+		for (j=0; j<train->r+1; j++) {
+			mu_assert(fabs(fabs(matrix_get(train->Z, train->r+1,
+							i, j)) -
+					fabs(matrix_get(pre_train->Z,
+							pre_train->r+1, i, j)))
+					< eps, "Incorrect train factor");
+		}
+	}
+
+	gensvm_kernel_postprocess(model, train, test);
+	gensvm_kernel_postprocess(pre_model, pre_train, pre_test);
+	mu_assert(test->r == pre_test->r, "Incorrect test r");
+	for (i=0; i<n_test; i++) {
+		for (j=0; j<test->r+1; j++) {
+			mu_assert(fabs(fabs(matrix_get(test->Z, test->r+1,
+							i, j)) -
+					fabs(matrix_get(pre_test->Z,
+							pre_test->r+1, i, j)))
+					< eps, "Incorrect test factor");
+		}
+	}
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(pre_model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(pre_train);
+	gensvm_free_data(pre_test);
+
+	return NULL;
+}
+
+char *test_kernel_eigendecomp_packed()
+{
+	long i, j, r_full, r_packed, n = 10;
+	double eps = 1e-13;
+	double *P_full = NULL,
+	       *Sigma_full = NULL,
+	       *P_packed = NULL,
+	       *Sigma_packed = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *data = gensvm_init_data();
+
+	data->n = n;
+	data->m = 4;
+	data->RAW = Calloc(double, data->n * (data->m + 1));
+	for (i=0; i<data->n; i++) {
+		matrix_set(data->RAW, data->m+1, i, 0, 1.0);
+		for (j=1; j<data->m+1; j++)
+			matrix_set(data->RAW, data->m+1, i, j,
+					((double) ((5*i + 3*j*j) % 13))/13.0);
+	}
+	model->kerneltype = K_RBF;
+	model->gamma = 0.75;
+
+	double *K = Calloc(double, n*n);
+	double *Kp = Calloc(double, n*(n+1)/2);
+	gensvm_kernel_compute(model, data, K);
+	gensvm_kernel_compute_packed(model, data, Kp);
+
+	// start test code //
+	r_full = gensvm_kernel_eigendecomp(K, n, 1e-3, &P_full, &Sigma_full);
+	r_packed = gensvm_kernel_eigendecomp_packed(Kp, n, 1e-3, &P_packed,
+			&Sigma_packed);
+
+	mu_assert(r_full == r_packed, "Incorrect number of eigenvalues");
+	for (j=0; j<r_full; j++) {
+		mu_assert(fabs(Sigma_full[j] - Sigma_packed[j]) < eps,
+				"Incorrect Sigma");
+		if (j > 0)
+			mu_assert(Sigma_packed[j-1] >= Sigma_packed[j],
+					"Sigma not in descending order");
+		for (i=0; i<n; i++) {
+			// packed P is in column-major order
+			mu_assert(fabs(fabs(matrix_get(P_full, r_full, i, j)) -
+					fabs(P_packed[i + j*n])) < eps,
+					"Incorrect P");
+		}
+	}
+	// end test code //
+
+	free(K);
+	free(Kp);
+	free(P_full);
+	free(P_packed);
+	free(Sigma_full);
+	free(Sigma_packed);
+	gensvm_free_model(model);
+	gensvm_free_data(data);
+
+	return NULL;
+}
+
 char *test_kernel_cross_rbf()
 {
 	struct GenModel *model = gensvm_init_model();
@@ -3324,6 +3782,246 @@ char *test_kernel_cross_sigmoid()
 	return NULL;
 }
 
+char *test_kernel_compute_sparse()
+{
+	long i, j, k, n = 12, m = 5;
+	double eps = 1e-13;
+	KernelType types[3] = {K_POLY, K_RBF, K_SIGMOID};
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *data = gensvm_init_data();
+	struct GenData *sp_data = gensvm_init_data();
+
+	data->n = sp_data->n = n;
+	data->m = sp_data->m = m;
+	data->RAW = Calloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(data->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++) {
+			if ((i + 2*j) % 3 == 0)
+				matrix_set(data->RAW, m+1, i, j,
+						((double) ((7*i + 3*j) % 11))/11.0);
+		}
+	}
+	data->Z = data->RAW;
+	sp_data->spZ = gensvm_dense_to_sparse(data->RAW, n, m+1);
+
+	model->gamma = 0.7;
+	model->coef = 1.1;
+	model->degree = 2.3;
+
+	double *K = Calloc(double, n*n);
+	double *K_sp = Calloc(double, n*n);
+	double *Kp = Calloc(double, n*(n+1)/2);
+	double *Kp_sp = Calloc(double, n*(n+1)/2);
+
+	// start test code //
+	for (k=0; k<3; k++) {
+		model->kerneltype = types[k];
+		gensvm_kernel_compute(model, data, K);
+		gensvm_kernel_compute(model, sp_data, K_sp);
+		gensvm_kernel_compute_packed(model, data, Kp);
+		gensvm_kernel_compute_packed(model, sp_data, Kp_sp);
+		for (i=0; i<n*n; i++)
+			mu_assert(fabs(K[i] - K_sp[i]) < eps,
+					"Incorrect sparse kernel element");
+		for (i=0; i<n*(n+1)/2; i++)
+			mu_assert(fabs(Kp[i] - Kp_sp[i]) < eps,
+					"Incorrect sparse packed kernel "
+					"element");
+	}
+	// end test code //
+
+	free(K);
+	free(K_sp);
+	free(Kp);
+	free(Kp_sp);
+	gensvm_free_model(model);
+	gensvm_free_data(data);
+	gensvm_free_data(sp_data);
+
+	return NULL;
+}
+
+char *test_kernel_cross_sparse()
+{
+	long i, j, k, n = 12, n_test = 7, m = 5;
+	double eps = 1e-13;
+	KernelType types[3] = {K_POLY, K_RBF, K_SIGMOID};
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *sp_train = gensvm_init_data();
+	struct GenData *sp_test = gensvm_init_data();
+
+	train->n = sp_train->n = n;
+	test->n = sp_test->n = n_test;
+	train->m = sp_train->m = test->m = sp_test->m = m;
+	train->RAW = Calloc(double, n*(m+1));
+	test->RAW = Calloc(double, n_test*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			if ((i + 2*j) % 3 == 0)
+				matrix_set(train->RAW, m+1, i, j,
+						((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	for (i=0; i<n_test; i++) {
+		matrix_set(test->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			if ((2*i + j) % 3 == 0)
+				matrix_set(test->RAW, m+1, i, j,
+						((double) ((5*i + 2*j) % 7))/7.0);
+	}
+	train->Z = train->RAW;
+	test->Z = test->RAW;
+	sp_train->spZ = gensvm_dense_to_sparse(train->RAW, n, m+1);
+	sp_test->spZ = gensvm_dense_to_sparse(test->RAW, n_test, m+1);
+
+	model->gamma = 0.7;
+	model->coef = 1.1;
+	model->degree = 2.3;
+
+	double *K2 = NULL,
+	       *K2_ss = NULL,
+	       *K2_sd = NULL,
+	       *K2_ds = NULL;
+
+	// start test code //
+	for (k=0; k<3; k++) {
+		model->kerneltype = types[k];
+		K2 = gensvm_kernel_cross(model, train, test);
+		K2_ss = gensvm_kernel_cross(model, sp_train, sp_test);
+		K2_sd = gensvm_kernel_cross(model, sp_train, test);
+		K2_ds = gensvm_kernel_cross(model, train, sp_test);
+		for (i=0; i<n*n_test; i++) {
+			mu_assert(fabs(K2[i] - K2_ss[i]) < eps,
+					"Incorrect sparse/sparse element");
+			mu_assert(fabs(K2[i] - K2_sd[i]) < eps,
+					"Incorrect sparse/dense element");
+			mu_assert(fabs(K2[i] - K2_ds[i]) < eps,
+					"Incorrect dense/sparse element");
+		}
+		free(K2);
+		free(K2_ss);
+		free(K2_sd);
+		free(K2_ds);
+	}
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(sp_train);
+	gensvm_free_data(sp_test);
+
+	return NULL;
+}
+
+char *test_kernel_cross_sparse_features()
+{
+	long c, i, j, k, n = 12, n_test = 7, m = 5, m_small = 2;
+	double eps = 1e-13;
+	KernelType types[3] = {K_POLY, K_RBF, K_SIGMOID};
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *small = gensvm_init_data();
+	struct GenData *sp_small = gensvm_init_data();
+	struct GenData *large = gensvm_init_data();
+	struct GenData *sp_large = gensvm_init_data();
+	struct GenData *small_train, *small_test, *large_train, *large_test;
+
+	// the reference datasets have m features, of which only the first 
+	// m_small are nonzero for the test instances
+	train->n = large->n = sp_large->n = n;
+	test->n = small->n = sp_small->n = n_test;
+	train->m = test->m = large->m = sp_large->m = m;
+	small->m = sp_small->m = m_small;
+	train->RAW = Calloc(double, n*(m+1));
+	test->RAW = Calloc(double, n_test*(m+1));
+	small->RAW = Calloc(double, n_test*(m_small+1));
+	for (i=0; i<n; i++) {
+		matrix_set(train->RAW, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			if ((i + 2*j) % 3 == 0)
+				matrix_set(train->RAW, m+1, i, j,
+						((double) ((7*i + 3*j) % 11))/11.0);
+	}
+	for (i=0; i<n_test; i++) {
+		matrix_set(test->RAW, m+1, i, 0, 1.0);
+		matrix_set(small->RAW, m_small+1, i, 0, 1.0);
+		for (j=1; j<m_small+1; j++) {
+			matrix_set(test->RAW, m+1, i, j,
+					((double) ((5*i + 2*j) % 7))/7.0);
+			matrix_set(small->RAW, m_small+1, i, j,
+					matrix_get(test->RAW, m+1, i, j));
+		}
+	}
+	train->Z = train->RAW;
+	test->Z = test->RAW;
+	small->Z = small->RAW;
+	large->RAW = train->RAW;
+	large->Z = train->RAW;
+	sp_small->spZ = gensvm_dense_to_sparse(small->RAW, n_test, m_small+1);
+	sp_large->spZ = gensvm_dense_to_sparse(train->RAW, n, m+1);
+
+	model->gamma = 0.7;
+	model->coef = 1.1;
+	model->degree = 2.3;
+
+	double *K2 = NULL,
+	       *K2_mis = NULL;
+
+	// start test code //
+	for (k=0; k<3; k++) {
+		model->kerneltype = types[k];
+		K2 = gensvm_kernel_cross(model, train, test);
+		for (c=0; c<4; c++) {
+			// all combinations of dense and sparse data where the 
+			// training data has more features than the test data
+			large_train = (c % 2 == 0) ? large : sp_large;
+			small_test = (c / 2 == 0) ? small : sp_small;
+			K2_mis = gensvm_kernel_cross(model, large_train,
+					small_test);
+			for (i=0; i<n*n_test; i++)
+				mu_assert(fabs(K2[i] - K2_mis[i]) < eps,
+						"Incorrect element with fewer "
+						"test features");
+			free(K2_mis);
+		}
+		free(K2);
+
+		// and where the test data has more features, using the test 
+		// instances as training data
+		K2 = gensvm_kernel_cross(model, test, train);
+		for (c=0; c<4; c++) {
+			small_train = (c % 2 == 0) ? small : sp_small;
+			large_test = (c / 2 == 0) ? large : sp_large;
+			K2_mis = gensvm_kernel_cross(model, small_train,
+					large_test);
+			for (i=0; i<n*n_test; i++)
+				mu_assert(fabs(K2[i] - K2_mis[i]) < eps,
+						"Incorrect element with fewer "
+						"training features");
+			free(K2_mis);
+		}
+		free(K2);
+	}
+	// end test code //
+
+	large->RAW = NULL;
+	large->Z = NULL;
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+	gensvm_free_data(small);
+	gensvm_free_data(sp_small);
+	gensvm_free_data(large);
+	gensvm_free_data(sp_large);
+
+	return NULL;
+}
+
 char *test_kernel_trainfactor()
 {
 	struct GenData *data = gensvm_init_data();
@@ -3890,16 +4588,26 @@ char *all_tests()
 
 	mu_run_test(test_kernel_postprocess_linear);
 	mu_run_test(test_kernel_postprocess_kernel);
+	mu_run_test(test_kernel_postprocess_blocks);
+	mu_run_test(test_kernel_calculate_ZV);
+	mu_run_test(test_kernel_prune_basis);
+	mu_run_test(test_kernel_prune_basis_empty);
 
 	mu_run_test(test_kernel_compute_rbf);
 	mu_run_test(test_kernel_compute_poly);
 	mu_run_test(test_kernel_compute_sigmoid);
 
+	mu_run_test(test_kernel_compute_packed);
 	mu_run_test(test_kernel_eigendecomp);
+	mu_run_test(test_kernel_eigendecomp_packed);
+	mu_run_test(test_kernel_precomputed);
+	mu_run_test(test_kernel_compute_sparse);
 
 	mu_run_test(test_kernel_cross_rbf);
 	mu_run_test(test_kernel_cross_poly);
 	mu_run_test(test_kernel_cross_sigmoid);
+	mu_run_test(test_kernel_cross_sparse);
+	mu_run_test(test_kernel_cross_sparse_features);
 
 	mu_run_test(test_kernel_trainfactor);
 
@@ -0,0 +1,273 @@
+/**
+ * @file test_gensvm_npy.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_npy.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "minunit.h"
+#include "gensvm_io.h"
+#include "gensvm_npy.h"
+
+char *test_read_data_npz_dense()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	mu_assert(gensvm_is_npy_data("./data/test_file_read_data.npz"),
+			"NumPy file not recognized");
+	mu_assert(!gensvm_is_npy_data("./data/test_file_read_data.txt"),
+			"Text file recognized as NumPy file");
+	gensvm_read_data(data, "./data/test_file_read_data.npz");
+	gensvm_read_data(text, "./data/test_file_read_data.txt");
+
+	mu_assert(data->n == 5, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->r == 3, "Incorrect r");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->spZ == NULL, "Data read as sparse");
+	mu_assert(data->Z == data->RAW, "Z doesn't equal RAW");
+	for (i=0; i<5*4; i++)
+		mu_assert(data->RAW[i] == text->RAW[i], "Incorrect RAW");
+	for (i=0; i<5; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+
+	return NULL;
+}
+
+char *test_read_data_npy_fortran()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	gensvm_read_data_libsvm(data, "./data/test_file_read_data.npy");
+	gensvm_read_data(text, "./data/test_file_read_data.txt");
+
+	mu_assert(data->n == 5, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->K == 0, "Incorrect K");
+	mu_assert(data->y == NULL, "Labels read from .npy file");
+	for (i=0; i<5*4; i++)
+		mu_assert(data->RAW[i] == (double) ((float) text->RAW[i]),
+				"Incorrect RAW");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+
+	return NULL;
+}
+
+char *test_read_data_npz_csr()
+{
+	long i;
+	struct GenData *data = gensvm_init_data();
+	struct GenData *text = gensvm_init_data();
+
+	// start test code //
+	gensvm_read_data(data, "./data/test_file_read_data_csr.npz");
+	gensvm_read_data_libsvm(text,
+			"./data/test_file_read_data_sparse_libsvm.txt");
+
+	mu_assert(data->n == 10, "Incorrect n");
+	mu_assert(data->m == 3, "Incorrect m");
+	mu_assert(data->K == 4, "Incorrect K");
+	mu_assert(data->RAW == NULL, "Data read as dense");
+	mu_assert(data->spZ != NULL, "Data not read as sparse");
+	mu_assert(data->spZ->nnz == text->spZ->nnz, "Incorrect nnz");
+	mu_assert(data->spZ->n_row == 10, "Incorrect n_row");
+	mu_assert(data->spZ->n_col == 4, "Incorrect n_col");
+	for (i=0; i<data->spZ->nnz; i++) {
+		mu_assert(data->spZ->values[i] == text->spZ->values[i],
+				"Incorrect values");
+		mu_assert(data->spZ->ja[i] == text->spZ->ja[i],
+				"Incorrect ja");
+	}
+	for (i=0; i<11; i++)
+		mu_assert(data->spZ->ia[i] == text->spZ->ia[i],
+				"Incorrect ia");
+	for (i=0; i<10; i++)
+		mu_assert(data->y[i] == text->y[i], "Incorrect y");
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_data(text);
+
+	return NULL;
+}
+
+char *test_read_data_chunk_npy()
+{
+	long i, j, n, f, total, off;
+	char *files[3] = {"./data/test_file_read_data.npz",
+		"./data/test_file_read_data.npy",
+		"./data/test_file_read_data_csr.npz"};
+	struct GenData *data = NULL;
+	struct GenData *chunk = NULL;
+	struct GenDataReader *reader = NULL;
+
+	// start test code //
+	for (f=0; f<3; f++) {
+		data = gensvm_init_data();
+		chunk = gensvm_init_data();
+		gensvm_read_data_libsvm(data, files[f]);
+		reader = gensvm_open_data_reader(files[f], true, 3, 0, false,
+				NULL);
+		mu_assert(reader->data == NULL, "NumPy file read in full");
+		mu_assert(reader->n == data->n, "Incorrect n");
+		mu_assert(reader->has_labels == (data->y != NULL),
+				"Incorrect has_labels");
+
+		total = 0;
+		while ((n = gensvm_read_data_chunk(reader, chunk, 3)) > 0) {
+			for (i=0; i<n; i++) {
+				if (data->y != NULL)
+					mu_assert(chunk->y[i] ==
+							data->y[total+i],
+							"Incorrect label");
+				if (data->spZ == NULL) {
+					for (j=0; j<4; j++)
+						mu_assert(matrix_get(
+							chunk->RAW, 4, i, j) ==
+							matrix_get(data->RAW,
+								4, total+i, j),
+							"Incorrect value");
+					continue;
+				}
+				off = data->spZ->ia[total+i] -
+					chunk->spZ->ia[i];
+				mu_assert(chunk->spZ->ia[i+1] + off ==
+						data->spZ->ia[total+i+1],
+						"Incorrect ia");
+				for (j=chunk->spZ->ia[i]; j<chunk->spZ->ia[i+1];
+						j++) {
+					mu_assert(chunk->spZ->values[j] ==
+						data->spZ->values[j+off],
+						"Incorrect values");
+					mu_assert(chunk->spZ->ja[j] ==
+						data->spZ->ja[j+off],
+						"Incorrect ja");
+				}
+			}
+			total += n;
+		}
+		mu_assert(total == data->n, "Incorrect number of instances");
+
+		gensvm_close_data_reader(reader);
+		gensvm_free_data(chunk);
+		gensvm_free_data(data);
+	}
+	// end test code //
+
+	return NULL;
+}
+
+char *test_npy_parse()
+{
+	struct GenNpyArray array;
+	char buffer[192];
+	const char *header = "{'descr': '<f8', 'fortran_order': False, "
+		"'shape': (2, 3), }";
+
+	memset(buffer, 0, 192);
+	memcpy(buffer, GENSVM_NPY_MAGIC, 6);
+	buffer[6] = 1;
+	buffer[8] = 118;
+	memcpy(buffer + 10, header, strlen(header));
+	memset(buffer + 10 + strlen(header), ' ', 118 - strlen(header));
+	buffer[127] = '\n';
+
+	// start test code //
+	mu_assert(gensvm_npy_parse(buffer, 128 + 48, &array),
+			"Valid header rejected");
+	mu_assert(array.kind == 'f', "Incorrect kind");
+	mu_assert(array.itemsize == 8, "Incorrect itemsize");
+	mu_assert(array.fortran_order == false, "Incorrect order");
+	mu_assert(array.ndim == 2, "Incorrect ndim");
+	mu_assert(array.shape[0] == 2, "Incorrect shape");
+	mu_assert(array.shape[1] == 3, "Incorrect shape");
+	mu_assert(array.size == 6, "Incorrect size");
+	mu_assert(array.data == buffer + 128, "Incorrect data");
+
+	mu_assert(!gensvm_npy_parse(buffer, 128 + 40, &array),
+			"Truncated array accepted");
+	mu_assert(!gensvm_npy_parse(buffer, 100, &array),
+			"Truncated header accepted");
+
+	mu_assert(gensvm_npy_parse_descr("|u1", 3, &array),
+			"Valid type rejected");
+	mu_assert(!gensvm_npy_parse_descr("<c16", 4, &array),
+			"Complex type accepted");
+	mu_assert(!gensvm_npy_parse_descr("|S3", 3, &array),
+			"String type accepted");
+	mu_assert(!gensvm_npy_parse_descr("<f2", 3, &array),
+			"Half precision accepted");
+
+	header = "(7,)";
+	mu_assert(gensvm_npy_parse_shape(header, header + 4, &array),
+			"Valid shape rejected");
+	mu_assert(array.ndim == 1 && array.size == 7, "Incorrect shape");
+	header = "(1, 2, 3)";
+	mu_assert(!gensvm_npy_parse_shape(header, header + 9, &array),
+			"Three dimensions accepted");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_npz_read()
+{
+	const char buffer[8] = {0x01, 0x02, 0x03, 0x04, (char) 0xff, 0, 0, 0};
+
+	// start test code //
+	mu_assert(gensvm_npz_read(buffer, 2) == 0x0201, "Incorrect u16");
+	mu_assert(gensvm_npz_read(buffer, 4) == 0x04030201, "Incorrect u32");
+	mu_assert(gensvm_npz_read(buffer, 8) == 0xff04030201ULL,
+			"Incorrect u64");
+	// end test code //
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_read_data_npz_dense);
+	mu_run_test(test_read_data_npy_fortran);
+	mu_run_test(test_read_data_npz_csr);
+	mu_run_test(test_read_data_chunk_npy);
+	mu_run_test(test_npy_parse);
+	mu_run_test(test_npz_read);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,550 @@
+/**
+ * @file test_gensvm_parse.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_parse.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "minunit.h"
+#include "gensvm_parse.h"
+
+/**
+ * Parse a string with gensvm_parse_double() and compare with strtod().
+ */
+bool parses_as_strtod(const char *token)
+{
+	double value, expected;
+	const char *str = token,
+	      *end = token + strlen(token);
+
+	expected = strtod(token, NULL);
+	if (!gensvm_parse_double(&str, end, &value) || str != end)
+		return false;
+	if (isnan(expected))
+		return isnan(value);
+	return memcmp(&value, &expected, sizeof(double)) == 0;
+}
+
+char *test_parse_double()
+{
+	long i;
+	double x;
+	char buffer[64];
+	const char *str = NULL;
+	const char *tokens[] = {"0", "-0", "+1", "1.", ".5", "0.1", "1e22",
+		"1e23", "-1.5E-7", "123456789012345678901234567890",
+		"0.7065937536993949", "0.70659375369939490000000000001",
+		"9007199254740993", "1e-320", "1e400", "2.2250738585072014e-308",
+		"inf", "-Infinity", "nan", "0x1.8p3",
+		"0.000000000000000000000000000001"};
+
+	// start test code //
+	for (i=0; i<21; i++)
+		mu_assert(parses_as_strtod(tokens[i]), "Incorrect value");
+
+	srand(123);
+	for (i=0; i<100000; i++) {
+		x = ((double) rand()) / RAND_MAX * pow(10.0, rand() % 60 - 30);
+		if (i % 2)
+			x = -x;
+		sprintf(buffer, (i % 3 == 0) ? "%.17g" : (i % 3 == 1) ?
+				"%.16g" : "%.6f", x);
+		mu_assert(parses_as_strtod(buffer), "Incorrect random value");
+	}
+
+	str = "  \t 2.5 3";
+	mu_assert(gensvm_parse_double(&str, str + 9, &x), "No number parsed");
+	mu_assert(x == 2.5, "Incorrect value after blanks");
+	mu_assert(*str == ' ', "Incorrect position after number");
+
+	str = "1.5e";
+	mu_assert(!gensvm_parse_double(&str, str + 4, &x),
+			"Invalid number parsed");
+	str = "abc";
+	mu_assert(!gensvm_parse_double(&str, str + 3, &x),
+			"Invalid number parsed");
+	str = "  \n1.0";
+	mu_assert(!gensvm_parse_double(&str, str + 6, &x),
+			"Number on next line parsed");
+	str = "1.2500";
+	mu_assert(gensvm_parse_double(&str, str + 3, &x) && x == 1.2,
+			"End of data not respected");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_long()
+{
+	long value;
+	const char *data = "\n 150\r\n-4 5x",
+	      *str = data,
+	      *end = data + strlen(data);
+
+	// start test code //
+	mu_assert(gensvm_parse_long(&str, end, &value), "No integer parsed");
+	mu_assert(value == 150, "Incorrect first integer");
+	mu_assert(gensvm_parse_long(&str, end, &value), "No integer parsed");
+	mu_assert(value == -4, "Incorrect second integer");
+	mu_assert(!gensvm_parse_long(&str, end, &value), "Invalid integer "
+			"parsed");
+
+	// integers that don't fit in a long
+	str = "9223372036854775807";
+	mu_assert(gensvm_parse_long(&str, str + 19, &value) &&
+			value == LONG_MAX, "Largest integer not parsed");
+	str = "9223372036854775808";
+	mu_assert(!gensvm_parse_long(&str, str + 19, &value),
+			"Overflowing integer parsed");
+	str = "18446744073709551617";
+	mu_assert(!gensvm_parse_long(&str, str + 20, &value),
+			"Overflowing integer parsed");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_values()
+{
+	double values[4];
+	const char *data = "1 2.5\t-3 \r\n4",
+	      *str = data,
+	      *end = data + strlen(data);
+
+	// start test code //
+	mu_assert(gensvm_parse_values(&str, end, values, 4) == 3,
+			"Incorrect number of values");
+	mu_assert(values[0] == 1.0 && values[1] == 2.5 && values[2] == -3.0,
+			"Incorrect values");
+	mu_assert(gensvm_parse_line_end(str, end), "Line end not found");
+	str = gensvm_parse_next_line(str, end);
+	mu_assert(*str == '4', "Incorrect next line");
+	mu_assert(gensvm_parse_next_line(str, end) == end,
+			"Incorrect end of data");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_chunks()
+{
+	long c, k, n_rows;
+	const char *data = "1 2\n\n3 4\n \t\n5 6\r\n7 8\n9 10",
+	      *end = data + strlen(data);
+	struct GenParseChunk *chunks = NULL;
+
+	// start test code //
+	mu_assert(gensvm_parse_count_rows(data, end) == 5,
+			"Incorrect number of rows");
+	for (c=1; c<30; c++) {
+		chunks = gensvm_parse_chunks(data, end, c);
+		mu_assert(chunks[0].start == data, "Incorrect first chunk");
+		mu_assert(chunks[c-1].end == end, "Incorrect last chunk");
+		n_rows = 0;
+		for (k=0; k<c; k++) {
+			mu_assert(chunks[k].start == data ||
+					chunks[k].start == end ||
+					chunks[k].start[-1] == '\n',
+					"Chunk doesn't start at a line");
+			mu_assert(chunks[k].row_start == n_rows,
+					"Incorrect first row of chunk");
+			n_rows += chunks[k].n_rows;
+		}
+		mu_assert(n_rows == 5, "Incorrect number of rows in chunks");
+		free(chunks);
+	}
+	// end test code //
+
+	return NULL;
+}
+
+/**
+ * Write n rows with m features and a label to a buffer, where the features
+ * are zero if (i + j) is divisible by 3.
+ */
+char *sparse_rows(long n, long m, char **end)
+{
+	long i, j;
+	char *data = Malloc(char, n*(m+1)*25),
+	     *str = data;
+
+	for (i=0; i<n; i++) {
+		for (j=0; j<m; j++) {
+			if ((i + j) % 3 == 0)
+				str += sprintf(str, (j % 2) ? "0 " : "0.000 ");
+			else
+				str += sprintf(str, "%.17g ",
+						(i + 1.0)/(j + 3.0));
+		}
+		str += sprintf(str, "%li%s", i % 4 + 1,
+				(i % 3) ? "\n" : "\r\n\n");
+	}
+	*end = str;
+	return data;
+}
+
+char *test_parse_count_nnz()
+{
+	const char *data = "0 0.0 -0.00e5 1e-2\n+0.  \t5 x 0x0 3\n\n0 1",
+	      *end = data + strlen(data);
+
+	// start test code //
+	mu_assert(gensvm_parse_count_nnz(data, end, 4) == 5,
+			"Incorrect number of nonzeros");
+	mu_assert(gensvm_parse_count_nnz(data, end, 2) == 2,
+			"Incorrect number of nonzeros in first values");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_dense()
+{
+	long c, i, j, n = 200, m = 3, n_chunks, n_read;
+	long y[200];
+	double value, RAW[200*4];
+	char *end = NULL,
+	     *data = sparse_rows(n, m, &end);
+	struct GenParseChunk *chunks = NULL;
+
+	// start test code //
+	for (n_chunks=1; n_chunks<64; n_chunks*=3) {
+		memset(RAW, 0, sizeof(RAW));
+		memset(y, 0, sizeof(y));
+		chunks = gensvm_parse_chunks(data, end, n_chunks);
+		n_read = gensvm_parse_dense(chunks, n_chunks, end, n, m, true,
+				RAW, y);
+		free(chunks);
+		mu_assert(n_read == n, "Incorrect number of rows read");
+		for (i=0; i<n; i++) {
+			mu_assert(matrix_get(RAW, m+1, i, 0) == 1.0,
+					"Incorrect column of ones");
+			for (j=0; j<m; j++) {
+				value = ((i + j) % 3 == 0) ? 0.0 :
+					(i + 1.0)/(j + 3.0);
+				mu_assert(matrix_get(RAW, m+1, i, j+1) ==
+						value, "Incorrect value");
+			}
+			mu_assert(y[i] == i % 4 + 1, "Incorrect label");
+		}
+	}
+
+	c = 7;
+	chunks = gensvm_parse_chunks(data, end, c);
+	n_read = gensvm_parse_dense(chunks, c, end, 50, m, true, RAW, y);
+	free(chunks);
+	mu_assert(n_read == 50, "Rows after n not ignored");
+	// end test code //
+
+	free(data);
+
+	return NULL;
+}
+
+char *test_parse_sparse()
+{
+	long i, j, k, n = 300, m = 5, n_chunks, n_read;
+	long y[300];
+	double value;
+	char *end = NULL,
+	     *data = sparse_rows(n, m, &end);
+	struct GenParseChunk *chunks = NULL;
+	struct GenSparse *spZ = NULL;
+
+	// start test code //
+	for (n_chunks=1; n_chunks<100; n_chunks*=4) {
+		chunks = gensvm_parse_chunks(data, end, n_chunks);
+		gensvm_parse_chunks_nnz(chunks, n_chunks, m, n*m);
+		// overestimate the nonzeros to test moving the chunks
+		for (i=0; i<n_chunks; i+=2)
+			chunks[i].nnz += 3;
+		spZ = gensvm_parse_sparse(chunks, n_chunks, end, n, m, true,
+				y, &n_read);
+		free(chunks);
+
+		mu_assert(n_read == n, "Incorrect number of rows read");
+		mu_assert(spZ->n_row == n, "Incorrect n_row");
+		mu_assert(spZ->n_col == m+1, "Incorrect n_col");
+		mu_assert(spZ->ia[0] == 0, "Incorrect first row start");
+		mu_assert(spZ->ia[n] == spZ->nnz, "Incorrect last row end");
+		for (i=0; i<n; i++) {
+			k = spZ->ia[i];
+			mu_assert(spZ->ja[k] == 0 && spZ->values[k] == 1.0,
+					"Incorrect column of ones");
+			k++;
+			for (j=0; j<m; j++) {
+				if ((i + j) % 3 == 0)
+					continue;
+				value = (i + 1.0)/(j + 3.0);
+				mu_assert(spZ->ja[k] == j+1,
+						"Incorrect column index");
+				mu_assert(spZ->values[k] == value,
+						"Incorrect value");
+				k++;
+			}
+			mu_assert(k == spZ->ia[i+1], "Incorrect row length");
+			mu_assert(y[i] == i % 4 + 1, "Incorrect label");
+		}
+		gensvm_free_sparse(spZ);
+	}
+	// end test code //
+
+	free(data);
+
+	return NULL;
+}
+
+char *test_parse_libsvm()
+{
+	long c, i, k, r, n = 120, n_chunks, n_labels, min_index, max_index,
+	     nnz, y[120];
+	double *RAW = NULL;
+	char *data = Malloc(char, n*2000),
+	     *str = data;
+	struct GenParseChunk *chunks = NULL;
+	struct GenSparse **fragments = NULL,
+			 *spZ = NULL;
+
+	// row i has label i % 5 + 1 and features 0, 3, ..., 3*(i % 80)
+	for (i=0; i<n; i++) {
+		str += sprintf(str, "%li", i % 5 + 1);
+		for (k=0; k<=i % 80; k++)
+			str += sprintf(str, " %li:%.17g", 3*k, (k + 1.0)/(i + 2.0));
+		str += sprintf(str, (i % 7) ? "\n" : " \r\n\n");
+	}
+
+	// start test code //
+	for (n_chunks=1; n_chunks<200; n_chunks*=5) {
+		chunks = gensvm_parse_chunks(data, str, n_chunks);
+		fragments = gensvm_parse_libsvm(chunks, n_chunks, str, y,
+				&n_labels, &min_index, &max_index, &nnz);
+		mu_assert(n_labels == n, "Incorrect number of labels");
+		mu_assert(min_index == 0, "Incorrect minimum index");
+		mu_assert(max_index == 237, "Incorrect maximum index");
+		mu_assert(nnz == 80*81/2 + 40*41/2, "Incorrect nnz");
+
+		spZ = gensvm_parse_stitch_sparse(fragments, chunks, n_chunks,
+				n, 238, 1);
+		mu_assert(spZ->nnz == nnz + n, "Incorrect sparse nnz");
+		mu_assert(spZ->n_col == 239, "Incorrect n_col");
+		for (i=0; i<n; i++) {
+			mu_assert(y[i] == i % 5 + 1, "Incorrect label");
+			r = spZ->ia[i];
+			mu_assert(spZ->ia[i+1] - r == i % 80 + 2,
+					"Incorrect row length");
+			mu_assert(spZ->ja[r] == 0 && spZ->values[r] == 1.0,
+					"Incorrect column of ones");
+			for (k=0; k<=i % 80; k++) {
+				mu_assert(spZ->ja[r+k+1] == 3*k + 1,
+						"Incorrect column index");
+				mu_assert(spZ->values[r+k+1] ==
+						(k + 1.0)/(i + 2.0),
+						"Incorrect value");
+			}
+		}
+		gensvm_free_sparse(spZ);
+		free(chunks);
+	}
+
+	c = 9;
+	chunks = gensvm_parse_chunks(data, str, c);
+	fragments = gensvm_parse_libsvm(chunks, c, str, y, &n_labels,
+			&min_index, &max_index, &nnz);
+	RAW = Calloc(double, n*239);
+	gensvm_parse_stitch_dense(fragments, chunks, c, 238, 1, RAW);
+	for (i=0; i<n; i++) {
+		mu_assert(matrix_get(RAW, 239, i, 0) == 1.0,
+				"Incorrect dense column of ones");
+		mu_assert(matrix_get(RAW, 239, i, 1) == 1.0/(i + 2.0),
+				"Incorrect dense value");
+		mu_assert(matrix_get(RAW, 239, i, 2) == 0.0,
+				"Incorrect dense zero");
+	}
+	free(RAW);
+	free(chunks);
+	// end test code //
+
+	free(data);
+
+	return NULL;
+}
+
+char *test_parse_hash()
+{
+	long i, col, col5, col17,
+	     ja[3] = {17, 5, 17},
+	     marker[17];
+	double sign, sign5, sign17,
+	       values[3] = {1.0, 2.0, 3.0};
+	bool seen[17] = {false};
+
+	// start test code //
+	for (i=0; i<1000; i++) {
+		col = gensvm_parse_hash(i, 4, false, &sign);
+		mu_assert(col >= 1 && col <= 16, "Hashed column out of range");
+		mu_assert(sign == 1.0, "Incorrect unsigned sign");
+		mu_assert(gensvm_parse_hash(i, 4, true, &sign) == col,
+				"Signed hash in different column");
+		mu_assert(sign == 1.0 || sign == -1.0, "Incorrect sign");
+		seen[col] = true;
+	}
+	for (i=1; i<17; i++)
+		mu_assert(seen[i], "Column never used");
+
+	// features in the same column are added
+	for (i=0; i<17; i++)
+		marker[i] = -1;
+	col5 = gensvm_parse_hash(5, 4, true, &sign5);
+	col17 = gensvm_parse_hash(17, 4, true, &sign17);
+	if (col5 == col17) {
+		mu_assert(gensvm_parse_hash_row(ja, values, 3, 4, true,
+					marker) == 1, "Incorrect row length");
+		mu_assert(values[0] == sign17*4.0 + sign5*2.0,
+				"Incorrect merged value");
+	} else {
+		mu_assert(gensvm_parse_hash_row(ja, values, 3, 4, true,
+					marker) == 2, "Incorrect row length");
+		i = (col5 < col17) ? 1 : 0;
+		mu_assert(ja[i] == col17 && ja[1-i] == col5,
+				"Incorrect hashed columns");
+		mu_assert(values[i] == sign17*4.0 && values[1-i] == sign5*2.0,
+				"Incorrect merged values");
+	}
+	for (i=0; i<17; i++)
+		mu_assert(marker[i] == -1, "Marker not reset");
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_sort_row()
+{
+	long i, n = 101,
+	     ja[101];
+	double values[101];
+
+	// start test code //
+	for (i=0; i<n; i++) {
+		ja[i] = (37*i) % n;
+		values[i] = 0.5 * ja[i];
+	}
+	gensvm_parse_sort_row(ja, values, n);
+	for (i=0; i<n; i++) {
+		mu_assert(ja[i] == i, "Row not sorted");
+		mu_assert(values[i] == 0.5 * i, "Value not moved with column");
+	}
+	gensvm_parse_sort_row(ja, values, 0);
+	gensvm_parse_sort_row(ja, values, 1);
+	// end test code //
+
+	return NULL;
+}
+
+char *test_parse_column_map()
+{
+	long i, n_columns,
+	     *col_map = NULL,
+	     ja_0[5] = {7, 0, 7, 1000, 3},
+	     ja_1[3] = {3, 52, 0},
+	     ia_0[3] = {0, 3, 5},
+	     ia_1[2] = {0, 3},
+	     expect_map[5] = {1, 4, 8, 53, 1001};
+	double values_0[5] = {1.0, 2.0, 3.0, 4.0, 5.0},
+	       values_1[3] = {6.0, 7.0, 8.0};
+	struct GenSparse *fragments[2];
+
+	// start test code //
+	for (i=0; i<2; i++)
+		fragments[i] = gensvm_init_sparse();
+	fragments[0]->n_row = 2;
+	fragments[0]->nnz = 5;
+	fragments[0]->ia = ia_0;
+	fragments[0]->ja = ja_0;
+	fragments[0]->values = values_0;
+	fragments[1]->n_row = 1;
+	fragments[1]->nnz = 3;
+	fragments[1]->ia = ia_1;
+	fragments[1]->ja = ja_1;
+	fragments[1]->values = values_1;
+
+	// the columns of a file with 0-based indexing
+	col_map = gensvm_parse_column_map(fragments, 2, 1, &n_columns);
+	mu_assert(n_columns == 5, "Incorrect number of columns");
+	for (i=0; i<5; i++)
+		mu_assert(col_map[i] == expect_map[i], "Incorrect column map");
+
+	mu_assert(gensvm_parse_map_column(1, col_map, 5) == 1,
+			"Incorrect first column");
+	mu_assert(gensvm_parse_map_column(53, col_map, 5) == 4,
+			"Incorrect column");
+	mu_assert(gensvm_parse_map_column(1001, col_map, 5) == 5,
+			"Incorrect last column");
+	mu_assert(gensvm_parse_map_column(2, col_map, 5) == 0,
+			"Column not in the map found");
+	mu_assert(gensvm_parse_map_column(2000, col_map, 5) == 0,
+			"Column after the map found");
+
+	// the rows are renumbered, features not in the map are removed
+	gensvm_parse_map_fragments(fragments, 2, 1, col_map + 1, 4);
+	mu_assert(fragments[0]->nnz == 4, "Incorrect nnz of fragment 0");
+	mu_assert(fragments[1]->nnz == 2, "Incorrect nnz of fragment 1");
+	mu_assert(ia_0[0] == 0 && ia_0[1] == 2 && ia_0[2] == 4,
+			"Incorrect ia of fragment 0");
+	mu_assert(ia_1[0] == 0 && ia_1[1] == 2,
+			"Incorrect ia of fragment 1");
+	mu_assert(ja_0[0] == 2 && ja_0[1] == 2 && ja_0[2] == 4 &&
+			ja_0[3] == 1, "Incorrect ja of fragment 0");
+	mu_assert(values_0[0] == 1.0 && values_0[1] == 3.0 &&
+			values_0[2] == 4.0 && values_0[3] == 5.0,
+			"Incorrect values of fragment 0");
+	mu_assert(ja_1[0] == 1 && ja_1[1] == 3,
+			"Incorrect ja of fragment 1");
+	mu_assert(values_1[0] == 6.0 && values_1[1] == 7.0,
+			"Incorrect values of fragment 1");
+	// end test code //
+
+	free(col_map);
+	free(fragments[0]);
+	free(fragments[1]);
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_parse_double);
+	mu_run_test(test_parse_long);
+	mu_run_test(test_parse_values);
+	mu_run_test(test_parse_chunks);
+	mu_run_test(test_parse_count_nnz);
+	mu_run_test(test_parse_dense);
+	mu_run_test(test_parse_sparse);
+	mu_run_test(test_parse_libsvm);
+	mu_run_test(test_parse_hash);
+	mu_run_test(test_parse_sort_row);
+	mu_run_test(test_parse_column_map);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
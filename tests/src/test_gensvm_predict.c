@@ -234,6 +234,92 @@ char *test_gensvm_predict_labels_sparse()
 	return NULL;
 }
 
+char *test_gensvm_predict_scores()
+{
+	long i, j, k, label,
+	     n = 600,
+	     m = 3,
+	     K = 4;
+	double value, dist, min_dist, *scores = NULL;
+	long *predy = NULL;
+	struct GenData *data = gensvm_init_data();
+	struct GenModel *model = gensvm_init_model();
+
+	model->n = n;
+	model->m = m;
+	model->K = K;
+	gensvm_allocate_model(model);
+
+	data->n = n;
+	data->m = m;
+	data->r = m;
+	data->K = K;
+	data->Z = Calloc(double, n*(m+1));
+	for (i=0; i<n; i++) {
+		matrix_set(data->Z, m+1, i, 0, 1.0);
+		for (j=1; j<m+1; j++)
+			matrix_set(data->Z, m+1, i, j,
+					((double) ((7*i + 5*j) % 17))/17.0 - 0.5);
+	}
+	for (i=0; i<(m+1)*(K-1); i++)
+		model->V[i] = ((double) ((3*i) % 7))/7.0 - 0.5;
+
+	// start test code //
+	predy = Calloc(long, n);
+	scores = Calloc(double, n*K);
+	gensvm_predict_scores(data, model, predy, scores);
+
+	for (i=0; i<n; i++) {
+		label = 0;
+		min_dist = INFINITY;
+		for (k=0; k<K; k++) {
+			// the score is the inner product of ZV and the vertex
+			value = 0;
+			for (j=0; j<K-1; j++)
+				value += cblas_ddot(m+1, &data->Z[i*(m+1)], 1,
+						&model->V[j], K-1) *
+					matrix_get(model->U, K-1, k, j);
+			mu_assert(fabs(matrix_get(scores, K, i, k) - value) <
+					1e-14, "Incorrect score");
+
+			// the label is given by the nearest vertex
+			dist = 0;
+			for (j=0; j<K-1; j++)
+				dist += pow(cblas_ddot(m+1, &data->Z[i*(m+1)], 1,
+							&model->V[j], K-1) -
+						matrix_get(model->U, K-1, k, j),
+						2.0);
+			if (dist < min_dist) {
+				min_dist = dist;
+				label = k+1;
+			}
+		}
+		mu_assert(predy[i] == label, "Incorrect label");
+	}
+	// end test code //
+
+	gensvm_free_data(data);
+	gensvm_free_model(model);
+	free(predy);
+	free(scores);
+
+	return NULL;
+}
+
+char *test_gensvm_predict_argmax()
+{
+	double x[5] = {0.5, -1.0, 2.5, 2.5, 1.0},
+	       y[2] = {NAN, NAN};
+
+	// start test code //
+	mu_assert(gensvm_predict_argmax(x, 5) == 2, "Incorrect argmax");
+	mu_assert(gensvm_predict_argmax(x, 2) == 0, "Incorrect argmax");
+	mu_assert(gensvm_predict_argmax(y, 2) == -1, "Incorrect argmax NaN");
+	// end test code //
+
+	return NULL;
+}
+
 char *test_gensvm_prediction_perf()
 {
 	int i, n = 8;
@@ -276,6 +362,8 @@ char *all_tests()
 	mu_suite_start();
 	mu_run_test(test_gensvm_predict_labels_dense);
 	mu_run_test(test_gensvm_predict_labels_sparse);
+	mu_run_test(test_gensvm_predict_scores);
+	mu_run_test(test_gensvm_predict_argmax);
 	mu_run_test(test_gensvm_prediction_perf);
 
 	return NULL;
@@ -0,0 +1,283 @@
+/**
+ * @file test_gensvm_predictor.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_predictor.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "minunit.h"
+#include "gensvm_predictor.h"
+#include "test_fixtures.h"
+
+/**
+ * Compare the predictions of a GenPredictor for dense and sparse instances 
+ * with those of gensvm_predict_scores().
+ */
+char *check_predictor(struct GenModel *model, struct GenData *test)
+{
+	long i, j, k, nnz, label, n = test->n,
+	     m = test->m,
+	     K = model->K,
+	     *idx = Calloc(long, m),
+	     *predy = Calloc(long, n);
+	double *val = Calloc(double, m),
+	       *scores = Calloc(double, n*K);
+	struct GenPredictor *pred = gensvm_predictor_init(model);
+
+	gensvm_predict_scores(test, model, predy, scores);
+
+	for (i=0; i<n; i++) {
+		label = gensvm_predictor_predict_one(pred,
+				&test->RAW[i*(m+1)+1], m);
+		mu_assert(label == predy[i], "Incorrect label (dense)");
+		for (k=0; k<K; k++)
+			mu_assert(fabs(gensvm_predictor_scores(pred)[k] -
+					matrix_get(scores, K, i, k)) < 1e-12,
+					"Incorrect score (dense)");
+
+		nnz = 0;
+		for (j=1; j<m+1; j++) {
+			if (matrix_get(test->RAW, m+1, i, j) == 0)
+				continue;
+			idx[nnz] = j;
+			val[nnz++] = matrix_get(test->RAW, m+1, i, j);
+		}
+		label = gensvm_predictor_predict_one_sparse(pred, idx, val,
+				nnz);
+		mu_assert(label == predy[i], "Incorrect label (sparse)");
+		for (k=0; k<K; k++)
+			mu_assert(fabs(gensvm_predictor_scores(pred)[k] -
+					matrix_get(scores, K, i, k)) < 1e-12,
+					"Incorrect score (sparse)");
+	}
+
+	gensvm_predictor_free(pred);
+	free(idx);
+	free(val);
+	free(predy);
+	free(scores);
+
+	return NULL;
+}
+
+char *test_predictor_linear()
+{
+	long n = 25, m = 4, K = 4;
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *test = gensvm_init_data();
+
+	fixture_data(test, n, m, 5);
+	fixture_model(model, m, K, 0);
+
+	// start test code //
+	msg = check_predictor(model, test);
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(test);
+
+	return msg;
+}
+
+char *test_predictor_kernel()
+{
+	long n = 30, n_test = 25, m = 4, K = 3;
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenData *test = gensvm_init_data();
+	struct GenData *basis = NULL;
+
+	fixture_data(train, n, m, 0);
+	fixture_data(test, n_test, m, 5);
+	fixture_kernel_model(model, train, K_RBF, K);
+
+	// start test code //
+	msg = check_predictor(model, test);
+
+	// same with a sparse basis
+	if (msg == NULL) {
+		basis = model->basis;
+		basis->spZ = gensvm_dense_to_sparse(basis->RAW, basis->n,
+				basis->m+1);
+		free(basis->RAW);
+		basis->RAW = NULL;
+		msg = check_predictor(model, test);
+	}
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+	gensvm_free_data(test);
+
+	return msg;
+}
+
+char *test_predictor_invalid()
+{
+	long i, m = 4, K = 3,
+	     idx[2] = {1, 5};
+	double x[5] = {0.1, 0.2, 0.3, 0.4, 0.5},
+	       val[2] = {1.0, 2.0};
+	struct GenModel *model = gensvm_init_model();
+	struct GenPredictor *pred = NULL;
+
+	model->m = m;
+	model->K = K;
+	model->V = Calloc(double, (m+1)*(K-1));
+	for (i=0; i<(m+1)*(K-1); i++)
+		model->V[i] = 0.1 * i;
+
+	// start test code //
+	pred = gensvm_predictor_init(model);
+	mu_assert(model->U != NULL, "Simplex not generated");
+	mu_assert(gensvm_predictor_predict_one(pred, x, 5) == 0,
+			"Invalid number of features accepted");
+	mu_assert(gensvm_predictor_predict_one(pred, x, 4) > 0,
+			"Valid instance not predicted");
+	mu_assert(gensvm_predictor_predict_one_sparse(pred, idx, val, 2) == 0,
+			"Invalid feature index accepted");
+	mu_assert(gensvm_predictor_predict_one_sparse(pred, idx, val, 1) > 0,
+			"Valid sparse instance not predicted");
+	// end test code //
+
+	gensvm_predictor_free(pred);
+	gensvm_free_model(model);
+
+	return NULL;
+}
+
+/**
+ * Compare the prediction for sparse features of a data file with the 
+ * prediction for the same instance in the column space of the model.
+ */
+char *check_columns(struct GenPredictor *pred, long *idx, double *val,
+		long nnz)
+{
+	long j, k, col, label,
+	     m = pred->m,
+	     K = pred->K;
+	double sign,
+	       *x = Calloc(double, m),
+	       *scores = Calloc(double, K);
+
+	for (j=0; j<nnz; j++) {
+		col = gensvm_predictor_column(pred, idx[j], &sign);
+		if (col > 0)
+			x[col-1] += sign * val[j];
+	}
+	label = gensvm_predictor_predict_one(pred, x, m);
+	for (k=0; k<K; k++)
+		scores[k] = gensvm_predictor_scores(pred)[k];
+
+	mu_assert(gensvm_predictor_predict_one_sparse(pred, idx, val, nnz) ==
+			label, "Incorrect label");
+	for (k=0; k<K; k++)
+		mu_assert(fabs(gensvm_predictor_scores(pred)[k] - scores[k]) <
+				1e-12, "Incorrect score");
+
+	free(x);
+	free(scores);
+
+	return NULL;
+}
+
+char *test_predictor_hashed()
+{
+	long i, m = 4, K = 3,
+	     idx[5] = {3, 17, 100, 2718, 12345};
+	double sign,
+	       val[5] = {0.5, -1.0, 2.0, 0.25, 1.5};
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenPredictor *pred = NULL;
+
+	fixture_model(model, m, K, 0);
+	model->hash_bits = 2;
+	model->hash_signed = true;
+
+	// start test code //
+	pred = gensvm_predictor_init(model);
+	for (i=0; i<5; i++)
+		mu_assert(gensvm_predictor_column(pred, idx[i], &sign) ==
+				gensvm_parse_hash(idx[i], 2, true, &sign),
+				"Incorrect hashed column");
+	msg = check_columns(pred, idx, val, 5);
+	// end test code //
+
+	gensvm_predictor_free(pred);
+	gensvm_free_model(model);
+
+	return msg;
+}
+
+char *test_predictor_col_map()
+{
+	long n = 30, m = 4, K = 3,
+	     idx[5] = {2, 5, 30, 41, 100};
+	double sign,
+	       val[5] = {0.5, -1.0, 2.0, 0.25, 1.5};
+	char *msg = NULL;
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *train = gensvm_init_data();
+	struct GenPredictor *pred = NULL;
+
+	fixture_data(train, n, m, 0);
+	fixture_kernel_model(model, train, K_RBF, K);
+	model->col_map_size = m;
+	model->col_map = Calloc(long, m);
+	model->col_map[0] = 2;
+	model->col_map[1] = 7;
+	model->col_map[2] = 30;
+	model->col_map[3] = 41;
+
+	// start test code //
+	pred = gensvm_predictor_init(model);
+	mu_assert(gensvm_predictor_column(pred, 30, &sign) == 3,
+			"Incorrect mapped column");
+	mu_assert(gensvm_predictor_column(pred, 5, &sign) == 0,
+			"Unknown feature not ignored");
+	msg = check_columns(pred, idx, val, 5);
+	// end test code //
+
+	gensvm_predictor_free(pred);
+	gensvm_free_model(model);
+	gensvm_free_data(train);
+
+	return msg;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_predictor_linear);
+	mu_run_test(test_predictor_kernel);
+	mu_run_test(test_predictor_invalid);
+	mu_run_test(test_predictor_hashed);
+	mu_run_test(test_predictor_col_map);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
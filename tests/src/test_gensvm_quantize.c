@@ -0,0 +1,182 @@
+/**
+ * @file test_gensvm_quantize.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_quantize.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "minunit.h"
+#include "gensvm_quantize.h"
+#include "test_fixtures.h"
+
+char *test_quant_dot()
+{
+	long j, n = 70000;
+	int64_t expected = 0;
+	int8_t *a = Malloc(int8_t, n),
+	       *b = Malloc(int8_t, n);
+
+	for (j=0; j<n; j++) {
+		a[j] = (j % 3 == 0) ? -127 : 127;
+		b[j] = (j % 5 == 0) ? 127 : -127;
+		expected += (int64_t) a[j] * (int64_t) b[j];
+	}
+
+	// start test code //
+	mu_assert(gensvm_quant_dot(a, b, n) == expected,
+			"Incorrect inner product");
+	mu_assert(gensvm_quant_dot(a, b, 10) == -2*127*127,
+			"Incorrect inner product of short vectors");
+	mu_assert(gensvm_quant_dot(a, b, 0) == 0,
+			"Incorrect inner product of empty vectors");
+	// end test code //
+
+	free(a);
+	free(b);
+
+	return NULL;
+}
+
+char *test_quantize_model()
+{
+	long i, j, k, m = 5, K = 4;
+	double w;
+	struct GenModel *model = gensvm_init_model();
+	struct GenQuantModel *qmodel = NULL;
+
+	fixture_model(model, m, K, 2);
+
+	// start test code //
+	qmodel = gensvm_quantize_model(model);
+	mu_assert(qmodel != NULL, "Linear model not quantized");
+	mu_assert(qmodel->m == m && qmodel->K == K, "Incorrect dimensions");
+	for (k=0; k<K; k++) {
+		w = 0;
+		for (i=0; i<K-1; i++)
+			w += matrix_get(model->V, K-1, 0, i) *
+				matrix_get(model->U, K-1, k, i);
+		mu_assert(fabs(qmodel->bias[k] - w) < 1e-14,
+				"Incorrect bias");
+		for (j=1; j<m+1; j++) {
+			w = 0;
+			for (i=0; i<K-1; i++)
+				w += matrix_get(model->V, K-1, j, i) *
+					matrix_get(model->U, K-1, k, i);
+			mu_assert(fabs(qmodel->Q[k*m+j-1]*qmodel->scale[k] -
+						w) <= 0.5*qmodel->scale[k] +
+					1e-14, "Incorrect quantized weight");
+		}
+	}
+	gensvm_free_quant_model(qmodel);
+
+	model->kerneltype = K_RBF;
+	mu_assert(gensvm_quantize_model(model) == NULL,
+			"Kernel model quantized");
+	// end test code //
+
+	gensvm_free_model(model);
+
+	return NULL;
+}
+
+char *test_quant_predict_labels()
+{
+	long i, n_exact, n = 500, m = 7, K = 5,
+	     *predy = Calloc(long, n),
+	     *qpredy = Calloc(long, n);
+	struct GenModel *model = gensvm_init_model();
+	struct GenData *test = gensvm_init_data();
+	struct GenQuantModel *qmodel = NULL;
+
+	fixture_data(test, n, m, 3);
+	fixture_model(model, m, K, 0);
+
+	// make some instances ambiguous: equal to another instance, but with
+	// a tiny perturbation
+	for (i=1; i<10; i++)
+		matrix_set(test->Z, m+1, 2*i, 1,
+				matrix_get(test->Z, m+1, 2*i, 1) + 1e-13);
+
+	// start test code //
+	gensvm_predict_labels(test, model, predy);
+	qmodel = gensvm_quantize_model(model);
+	n_exact = gensvm_quant_predict_labels(test, qmodel, qpredy);
+	mu_assert(n_exact < n, "No instances predicted with quantization");
+	for (i=0; i<n; i++)
+		mu_assert(qpredy[i] == predy[i], "Incorrect label");
+	// end test code //
+
+	gensvm_free_quant_model(qmodel);
+	gensvm_free_model(model);
+	gensvm_free_data(test);
+	free(predy);
+	free(qpredy);
+
+	return NULL;
+}
+
+char *test_quant_predict_row_ambiguous()
+{
+	long i, label = 0, m = 3, K = 3;
+	int8_t p[3];
+	double a[3],
+	       x[3] = {0.0, 0.0, 0.0},
+	       y[3] = {1.0, 2.0, NAN};
+	struct GenModel *model = gensvm_init_model();
+	struct GenQuantModel *qmodel = NULL;
+
+	model->m = m;
+	model->K = K;
+	model->V = Calloc(double, (m+1)*(K-1));
+	for (i=0; i<(m+1)*(K-1); i++)
+		model->V[i] = 0.25 * (i % 3);
+
+	// start test code //
+	qmodel = gensvm_quantize_model(model);
+	// with all features zero the scores only depend on the bias
+	mu_assert(gensvm_quant_predict_row(qmodel, x, p, a, &label),
+			"Zero instance not determined");
+	mu_assert(label > 0 && label <= K, "Invalid label");
+	// non-finite values are left to double precision
+	mu_assert(!gensvm_quant_predict_row(qmodel, y, p, a, &label),
+			"Non-finite instance determined");
+	// end test code //
+
+	gensvm_free_quant_model(qmodel);
+	gensvm_free_model(model);
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_quant_dot);
+	mu_run_test(test_quantize_model);
+	mu_run_test(test_quant_predict_labels);
+	mu_run_test(test_quant_predict_row_ambiguous);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -65,6 +65,10 @@ char *test_sv()
 	matrix_set(model->Q, model->K, 4, 2, 2.0);
 
 	mu_assert(gensvm_num_sv(model) == 3, "number of svs incorrect");
+	mu_assert(gensvm_is_sv(model, 0), "instance 0 should be an sv");
+	mu_assert(gensvm_is_sv(model, 2), "instance 2 should be an sv");
+	mu_assert(!gensvm_is_sv(model, 3), "instance 3 is not an sv");
+	mu_assert(!gensvm_is_sv(model, 4), "instance 4 is not an sv");
 
 	gensvm_free_model(model);
 	return NULL;
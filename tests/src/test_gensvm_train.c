@@ -26,6 +26,8 @@
 
 #include "minunit.h"
 #include "gensvm_train.h"
+#include "gensvm_copy.h"
+#include "gensvm_predict.h"
 
 char *test_gensvm_train_seed_linear()
 {
@@ -379,12 +381,109 @@ char *test_gensvm_train_seed_kernel()
 	return NULL;
 }
 
+char *test_gensvm_train_wrapped()
+{
+	long i, j, nnz = 0,
+	     n = 40,
+	     m = 5,
+	     K = 3,
+	     *y = Malloc(long, n),
+	     *ia = Malloc(long, n+1),
+	     *ja = Malloc(long, n*m),
+	     *predy = Malloc(long, n),
+	     *predy_wrapped = Malloc(long, n);
+	double value,
+	       *X = Malloc(double, n*m),
+	       *values = Malloc(double, n*m);
+	struct GenModel *model = gensvm_init_model();
+	struct GenModel *dense_model = gensvm_init_model();
+	struct GenModel *sparse_model = gensvm_init_model();
+	struct GenData *data = gensvm_init_data();
+	struct GenData *dense = NULL;
+	struct GenData *sparse = NULL;
+
+	// a dataset with about half of the values zero, as an augmented
+	// matrix and as the arrays of a caller
+	data->n = n;
+	data->m = m;
+	data->K = K;
+	data->RAW = Calloc(double, n*(m+1));
+	data->Z = data->RAW;
+	data->y = Malloc(long, n);
+	ia[0] = 0;
+	for (i=0; i<n; i++) {
+		y[i] = data->y[i] = i % K + 1;
+		matrix_set(data->Z, m+1, i, 0, 1.0);
+		for (j=0; j<m; j++) {
+			value = ((i*m + j) % 2 == 0) ? 0.0 :
+				sin(0.7*i + 1.3*j) + 0.5*(y[i] == j);
+			matrix_set(data->Z, m+1, i, j+1, value);
+			X[i*m+j] = value;
+			if (value != 0.0) {
+				values[nnz] = value;
+				ja[nnz++] = j;
+			}
+		}
+		ia[i+1] = nnz;
+	}
+	dense = gensvm_wrap_dense(n, m, X, y);
+	sparse = gensvm_wrap_csr(n, m, values, ia, ja, y);
+
+	model->seed = 123;
+	model->epsilon = 1e-10;
+	gensvm_copy_model(model, dense_model);
+	gensvm_copy_model(model, sparse_model);
+
+	// start test code //
+	gensvm_train(model, data, NULL);
+	gensvm_train(dense_model, dense, NULL);
+	gensvm_train(sparse_model, sparse, NULL);
+
+	mu_assert(dense->wrapped && sparse->wrapped, "Data unwrapped");
+	mu_assert(dense_model->m == m && sparse_model->m == m,
+			"Incorrect model m");
+	for (i=0; i<(m+1)*(K-1); i++) {
+		mu_assert(fabs(dense_model->V[i] - model->V[i]) < 1e-8,
+				"Incorrect V of wrapped dense data");
+		mu_assert(fabs(sparse_model->V[i] - model->V[i]) < 1e-8,
+				"Incorrect V of wrapped sparse data");
+	}
+
+	gensvm_predict_labels(data, model, predy);
+	gensvm_predict_labels(dense, model, predy_wrapped);
+	for (i=0; i<n; i++)
+		mu_assert(predy[i] == predy_wrapped[i],
+				"Incorrect prediction of wrapped dense data");
+	gensvm_predict_labels(sparse, model, predy_wrapped);
+	for (i=0; i<n; i++)
+		mu_assert(predy[i] == predy_wrapped[i],
+				"Incorrect prediction of wrapped sparse data");
+	// end test code //
+
+	gensvm_free_model(model);
+	gensvm_free_model(dense_model);
+	gensvm_free_model(sparse_model);
+	gensvm_free_data(data);
+	gensvm_free_data(dense);
+	gensvm_free_data(sparse);
+	free(X);
+	free(y);
+	free(values);
+	free(ia);
+	free(ja);
+	free(predy);
+	free(predy_wrapped);
+
+	return NULL;
+}
+
 char *all_tests()
 {
 	mu_suite_start();
 
 	mu_run_test(test_gensvm_train_seed_linear);
 	mu_run_test(test_gensvm_train_seed_kernel);
+	mu_run_test(test_gensvm_train_wrapped);
 
 	return NULL;
 }
@@ -0,0 +1,155 @@
+/**
+ * @file test_gensvm_writer.c
+ * @author G.J.J. van den Burg
+ * @date 2026-10-16
+ * @brief Unit tests for gensvm_writer.c functions
+ *
+ * @copyright
+ Copyright 2016, G.J.J. van den Burg.
+
+ This file is part of GenSVM.
+
+ GenSVM is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GenSVM is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GenSVM. If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "minunit.h"
+#include "gensvm_writer.h"
+
+/**
+ * Read the contents of a small file into a buffer
+ */
+long read_file(char *filename, char *buffer, long size)
+{
+	long len;
+	FILE *fid = fopen(filename, "rb");
+
+	len = fread(buffer, 1, size-1, fid);
+	buffer[len] = '\0';
+	fclose(fid);
+
+	return len;
+}
+
+char *test_writer_long()
+{
+	char expected[GENSVM_MAX_LINE_LENGTH],
+	     result[GENSVM_MAX_LINE_LENGTH];
+	char *filename = "./data/test_writer_long.txt";
+	struct GenWriter *writer = gensvm_writer_open(filename);
+
+	// start test code //
+	gensvm_writer_long(writer, 0);
+	gensvm_writer_char(writer, ' ');
+	gensvm_writer_long(writer, 7);
+	gensvm_writer_char(writer, ' ');
+	gensvm_writer_long(writer, -42);
+	gensvm_writer_char(writer, ' ');
+	gensvm_writer_long(writer, 1234567890123);
+	gensvm_writer_char(writer, ' ');
+	gensvm_writer_long(writer, LONG_MIN);
+	gensvm_writer_close(writer);
+
+	sprintf(expected, "0 7 -42 1234567890123 %li", LONG_MIN);
+	read_file(filename, result, GENSVM_MAX_LINE_LENGTH);
+	mu_assert(strcmp(result, expected) == 0,
+			"Incorrect integer formatting");
+	// end test code //
+
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_writer_double()
+{
+	long i, len = 0,
+	     n_values = 12;
+	double values[12] = {0.0, -0.0, 0.5, -0.25, 1.23456789, 3.14159265358979,
+		-2.718281828459045, 123.000000004, 0.999999996, 42.1e-9,
+		-1234567.87654321, 1e20};
+	char expected[GENSVM_MAX_LINE_LENGTH],
+	     result[GENSVM_MAX_LINE_LENGTH];
+	char *filename = "./data/test_writer_double.txt";
+	struct GenWriter *writer = gensvm_writer_open(filename);
+
+	// start test code //
+	for (i=0; i<n_values; i++) {
+		gensvm_writer_double(writer, values[i]);
+		gensvm_writer_char(writer, '\n');
+		if (values[i] < 1e15)
+			len += sprintf(expected + len, "%.8f\n", values[i]);
+		else
+			len += sprintf(expected + len, "%.17g\n", values[i]);
+	}
+	gensvm_writer_close(writer);
+
+	read_file(filename, result, GENSVM_MAX_LINE_LENGTH);
+	mu_assert(strcmp(result, expected) == 0,
+			"Incorrect floating point formatting");
+	// end test code //
+
+	remove(filename);
+
+	return NULL;
+}
+
+char *test_writer_write()
+{
+	long i, len, n = 3*GENSVM_WRITER_BUFFER_SIZE/2,
+	     chunk = 1000;
+	char *data = Malloc(char, n),
+	     *result = Malloc(char, n+1);
+	char *filename = "./data/test_writer_write.bin";
+	FILE *fid = NULL;
+	struct GenWriter *writer = gensvm_writer_open(filename);
+
+	for (i=0; i<n; i++)
+		data[i] = (char) (i % 251);
+
+	// start test code //
+	// write in pieces that don't align with the buffer size
+	for (i=0; i<n; i+=chunk) {
+		len = minimum(chunk, n-i);
+		gensvm_writer_write(writer, data + i, len);
+	}
+	gensvm_writer_close(writer);
+
+	fid = fopen(filename, "rb");
+	mu_assert(fread(result, 1, n+1, fid) == (size_t) n,
+			"Incorrect number of bytes written");
+	fclose(fid);
+	mu_assert(memcmp(data, result, n) == 0,
+			"Incorrect bytes written");
+	// end test code //
+
+	remove(filename);
+	free(data);
+	free(result);
+
+	return NULL;
+}
+
+char *all_tests()
+{
+	mu_suite_start();
+	mu_run_test(test_writer_long);
+	mu_run_test(test_writer_double);
+	mu_run_test(test_writer_write);
+
+	return NULL;
+}
+
+RUN_TESTS(all_tests);